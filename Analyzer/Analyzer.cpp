@@ -193,7 +193,7 @@ std::shared_ptr<Analyzer::Expr> OffsetInFragment::deep_copy() const {
 
 std::shared_ptr<Analyzer::Expr> WindowFunction::deep_copy() const {
   return makeExpr<WindowFunction>(
-      type_info, kind_, args_, partition_keys_, order_keys_, collation_);
+      type_info, kind_, args_, partition_keys_, order_keys_, collation_, frame_);
 }
 
 ExpressionPtr ArrayExpr::deep_copy() const {
@@ -2217,6 +2217,10 @@ bool WindowFunction::operator==(const Expr& rhs) const {
       order_keys_.size() != rhs_window->order_keys_.size()) {
     return false;
   }
+  if (static_cast<bool>(frame_) != static_cast<bool>(rhs_window->frame_) ||
+      (frame_ && !(*frame_ == *rhs_window->frame_))) {
+    return false;
+  }
   return expr_list_match(args_, rhs_window->args_) &&
          expr_list_match(partition_keys_, rhs_window->partition_keys_) &&
          expr_list_match(order_keys_, rhs_window->order_keys_);
@@ -2542,6 +2546,9 @@ std::string WindowFunction::toString() const {
   for (const auto& arg : args_) {
     result += " " + arg->toString();
   }
+  if (frame_) {
+    result += frame_->is_rows ? " ROWS" : " RANGE";
+  }
   return result + ") ";
 }
 
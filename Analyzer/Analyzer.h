@@ -1316,6 +1316,30 @@ struct OrderEntry {
  * @type WindowFunction
  * @brief A window function.
  */
+struct WindowFrameBound {
+  SqlWindowFrameBoundType bound_type;
+  int64_t offset; /* rows for ROWS frames, order key distance for RANGE frames */
+
+  bool operator==(const WindowFrameBound& rhs) const {
+    return bound_type == rhs.bound_type && offset == rhs.offset;
+  }
+};
+
+/*
+ * @type WindowFrame
+ * @brief An explicit ROWS or RANGE frame of an aggregate window function.
+ */
+struct WindowFrame {
+  bool is_rows;
+  WindowFrameBound lower_bound;
+  WindowFrameBound upper_bound;
+
+  bool operator==(const WindowFrame& rhs) const {
+    return is_rows == rhs.is_rows && lower_bound == rhs.lower_bound &&
+           upper_bound == rhs.upper_bound;
+  }
+};
+
 class WindowFunction : public Expr {
  public:
   WindowFunction(const SQLTypeInfo& ti,
@@ -1323,13 +1347,15 @@ class WindowFunction : public Expr {
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& args,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& partition_keys,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& order_keys,
-                 const std::vector<OrderEntry>& collation)
+                 const std::vector<OrderEntry>& collation,
+                 const std::shared_ptr<const WindowFrame>& frame = nullptr)
       : Expr(ti)
       , kind_(kind)
       , args_(args)
       , partition_keys_(partition_keys)
       , order_keys_(order_keys)
-      , collation_(collation){};
+      , collation_(collation)
+      , frame_(frame){};
 
   std::shared_ptr<Analyzer::Expr> deep_copy() const override;
 
@@ -1350,12 +1376,16 @@ class WindowFunction : public Expr {
 
   const std::vector<OrderEntry>& getCollation() const { return collation_; }
 
+  // The explicit frame, null if the frame is the default one for the function.
+  const std::shared_ptr<const WindowFrame>& getFrame() const { return frame_; }
+
  private:
   const SqlWindowFunctionKind kind_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> args_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> partition_keys_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> order_keys_;
   const std::vector<OrderEntry> collation_;
+  const std::shared_ptr<const WindowFrame> frame_;
 };
 
 /*
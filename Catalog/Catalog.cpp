@@ -29,6 +29,7 @@
 #include <list>
 #include <memory>
 #include <random>
+#include <set>
 #include <sstream>
 #include "SysCatalog.h"
 
@@ -46,6 +47,7 @@
 #endif
 
 #include "../QueryEngine/Execute.h"
+#include "../QueryEngine/ExternalCacheInvalidators.h"
 #include "../QueryEngine/TableOptimizer.h"
 
 #include "../Fragmenter/Fragmenter.h"
@@ -70,6 +72,7 @@ using std::string;
 using std::vector;
 
 int g_test_against_columnId_gap = 0;
+size_t g_column_statistics_persist_rows{1000000};
 extern bool g_cache_string_hash;
 
 namespace Catalog_Namespace {
@@ -152,6 +155,22 @@ Catalog::Catalog(const string& basePath,
 }
 
 Catalog::~Catalog() {
+  std::vector<int> unpersisted_table_ids;
+  {
+    std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+    for (const auto& table_and_rows : unpersistedColumnStatisticsRows_) {
+      unpersisted_table_ids.push_back(table_and_rows.first);
+    }
+  }
+  for (const auto table_id : unpersisted_table_ids) {
+    try {
+      persistColumnStatistics(table_id);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Could not persist the column statistics of table " << table_id
+                   << ": " << e.what();
+    }
+  }
+
   cat_write_lock write_lock(this);
   // must clean up heap-allocated TableDescriptor and ColumnDescriptor structs
   for (TableDescriptorMap::iterator tableDescIt = tableDescriptorMap_.begin();
@@ -523,6 +542,21 @@ void Catalog::updateDictionarySchema() {
   sqliteConnector_.query("END TRANSACTION");
 }
 
+void Catalog::updateColumnStatisticsSchema() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    sqliteConnector_.query(
+        "CREATE TABLE IF NOT EXISTS mapd_column_statistics (tableid integer, columnid "
+        "integer, num_rows bigint, num_nulls bigint, ndv_sketch text, histogram text, "
+        "primary key(tableid, columnid))");
+  } catch (const std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+}
+
 void Catalog::recordOwnershipOfObjectsInObjectPermissions() {
   cat_sqlite_lock sqlite_lock(this);
   sqliteConnector_.query("BEGIN TRANSACTION");
@@ -838,6 +872,7 @@ void Catalog::CheckAndExecuteMigrations() {
   updateDictionaryNames();
   updateLogicalToPhysicalTableLinkSchema();
   updateDictionarySchema();
+  updateColumnStatisticsSchema();
   updatePageSize();
   updateDeletedColumnIndicator();
   updateFrontendViewsToDashboards();
@@ -1022,6 +1057,22 @@ void Catalog::buildMaps() {
     linkDescriptorMapById_[ld->linkId] = ld;
   }
 
+  string columnStatisticsQuery(
+      "SELECT tableid, columnid, num_rows, num_nulls, ndv_sketch, histogram FROM "
+      "mapd_column_statistics");
+  sqliteConnector_.query(columnStatisticsQuery);
+  numRows = sqliteConnector_.getNumRows();
+  for (size_t r = 0; r < numRows; ++r) {
+    auto stats = std::make_shared<ColumnStatistics>();
+    stats->num_rows = sqliteConnector_.getData<int64_t>(r, 2);
+    stats->num_nulls = sqliteConnector_.getData<int64_t>(r, 3);
+    stats->deserializeNdvSketch(sqliteConnector_.getData<string>(r, 4));
+    stats->deserializeHistogram(sqliteConnector_.getData<string>(r, 5));
+    const ColumnIdKey column_id_key(sqliteConnector_.getData<int>(r, 0),
+                                    sqliteConnector_.getData<int>(r, 1));
+    columnStatisticsMap_[column_id_key] = stats;
+  }
+
   /* rebuild map linking logical tables to corresponding physical ones */
   string logicalToPhysicalTableMapQuery(
       "SELECT logical_table_id, physical_table_id "
@@ -2447,8 +2498,10 @@ void Catalog::doTruncateTable(const TableDescriptor* td) {
   // assuming deleteChunksWithPrefix is atomic
   dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::CPU_LEVEL);
   dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::GPU_LEVEL);
+  invalidateCachesForTable(tableId);
 
   dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
+  dropColumnStatistics(tableId);
 
   std::unique_ptr<StringDictionaryClient> client;
   if (SysCatalog::instance().isAggregator()) {
@@ -2520,6 +2573,7 @@ void Catalog::removeChunks(const int table_id) {
 
   dataMgr_->deleteChunksWithPrefix(chunkKey, MemoryLevel::CPU_LEVEL);
   dataMgr_->deleteChunksWithPrefix(chunkKey, MemoryLevel::GPU_LEVEL);
+  invalidateCachesForTable(table_id);
 }
 
 void Catalog::dropTable(const TableDescriptor* td) {
@@ -2579,6 +2633,7 @@ void Catalog::doDropTable(const TableDescriptor* td) {
       std::vector<std::string>{std::to_string(kENCODING_DICT), std::to_string(tableId)});
   sqliteConnector_.query_with_text_param("DELETE FROM mapd_columns WHERE tableid = ?",
                                          std::to_string(tableId));
+  dropColumnStatistics(tableId);
   if (td->isView) {
     sqliteConnector_.query_with_text_param("DELETE FROM mapd_views WHERE tableid = ?",
                                            std::to_string(tableId));
@@ -2963,6 +3018,7 @@ void Catalog::eraseTablePhysicalData(const TableDescriptor* td) {
     dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::CPU_LEVEL);
     dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::GPU_LEVEL);
   }
+  invalidateCachesForTable(tableId);
   if (!td->isView) {
     INJECT_TIMER(Remove_Table);
     dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
@@ -3062,4 +3118,187 @@ void Catalog::vacuumDeletedRows(const TableDescriptor* td) const {
   }
 }
 
+void Catalog::analyzeTable(const TableDescriptor* td) {
+  CHECK(!td->isView);
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    CHECK(physical_td->fragmenter);
+    const auto table_info = physical_td->fragmenter->getFragmentsForQuery();
+    std::map<int, ColumnStatistics> stats_per_column;
+    for (const auto cd :
+         getAllColumnMetadataForTable(physical_td->tableId, false, false, true)) {
+      if (!column_statistics_supported(cd->columnType)) {
+        continue;
+      }
+      stats_per_column[cd->columnId] = compute_column_statistics(
+          dataMgr_.get(), currentDB_.dbId, cd, table_info.fragments, 0);
+    }
+    LOG(INFO) << "Computed statistics for " << stats_per_column.size()
+              << " columns of table " << physical_td->tableName;
+    dropColumnStatistics(physical_td->tableId);
+    setColumnStatistics(physical_td->tableId, stats_per_column);
+  }
+}
+
+std::shared_ptr<const ColumnStatistics> Catalog::getColumnStatistics(
+    const int table_id,
+    const int column_id) const {
+  std::vector<int32_t> physical_table_ids{table_id};
+  {
+    cat_read_lock read_lock(this);
+    const auto physical_tables_it = logicalToPhysicalTableMapById_.find(table_id);
+    if (physical_tables_it != logicalToPhysicalTableMapById_.end()) {
+      physical_table_ids = physical_tables_it->second;
+    }
+  }
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  std::shared_ptr<ColumnStatistics> merged_stats;
+  for (const auto physical_table_id : physical_table_ids) {
+    const auto it = columnStatisticsMap_.find(ColumnIdKey(physical_table_id, column_id));
+    if (it == columnStatisticsMap_.end()) {
+      return nullptr;
+    }
+    if (physical_table_ids.size() == 1) {
+      return it->second;
+    }
+    if (!merged_stats) {
+      merged_stats = std::make_shared<ColumnStatistics>(*it->second);
+    } else {
+      merged_stats->merge(*it->second);
+    }
+  }
+  return merged_stats;
+}
+
+std::map<int, ColumnStatistics> Catalog::computeColumnStatisticsOnAppend(
+    const int table_id,
+    const Fragmenter_Namespace::InsertData& insert_data) const {
+  std::map<int, ColumnStatistics> stats_per_column;
+  if (insert_data.numRows == 0 || insert_data.replicate_count > 0) {
+    return stats_per_column;
+  }
+  std::set<int> column_ids;
+  {
+    std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+    for (auto it = columnStatisticsMap_.lower_bound(ColumnIdKey(table_id, 0));
+         it != columnStatisticsMap_.end() && std::get<0>(it->first) == table_id;
+         ++it) {
+      column_ids.insert(std::get<1>(it->first));
+    }
+  }
+  for (size_t i = 0; i < insert_data.columnIds.size(); ++i) {
+    const auto column_id = insert_data.columnIds[i];
+    if (!column_ids.count(column_id)) {
+      continue;
+    }
+    const auto cd = getMetadataForColumn(table_id, column_id);
+    if (!cd || !column_statistics_supported(cd->columnType)) {
+      continue;
+    }
+    stats_per_column[column_id] = compute_insert_data_statistics(
+        cd, insert_data.data[i].numbersPtr, insert_data.numRows);
+  }
+  return stats_per_column;
+}
+
+void Catalog::addColumnStatisticsOnAppend(
+    const int table_id,
+    const std::map<int, ColumnStatistics>& stats_per_column,
+    const size_t num_rows) {
+  if (stats_per_column.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+    for (const auto& column_and_stats : stats_per_column) {
+      const auto it =
+          columnStatisticsMap_.find(ColumnIdKey(table_id, column_and_stats.first));
+      if (it == columnStatisticsMap_.end()) {
+        continue;  // dropped since
+      }
+      auto stats = std::make_shared<ColumnStatistics>(*it->second);
+      stats->merge(column_and_stats.second);
+      it->second = stats;
+    }
+    auto& unpersisted_rows = unpersistedColumnStatisticsRows_[table_id];
+    unpersisted_rows += num_rows;
+    if (unpersisted_rows < g_column_statistics_persist_rows) {
+      return;
+    }
+  }
+  persistColumnStatistics(table_id);
+}
+
+void Catalog::invalidateCachesForTable(const int table_id) const {
+  std::vector<int32_t> table_ids{table_id};
+  {
+    cat_read_lock read_lock(this);
+    const auto physical_tables_it = logicalToPhysicalTableMapById_.find(table_id);
+    if (physical_tables_it != logicalToPhysicalTableMapById_.end()) {
+      table_ids.insert(table_ids.end(),
+                       physical_tables_it->second.begin(),
+                       physical_tables_it->second.end());
+    }
+  }
+  for (const auto id : table_ids) {
+    TableDataCacheInvalidator::invalidateCachesForTable(currentDB_.dbId, id);
+  }
+}
+
+// Merges the given statistics into the stored ones and persists the result.
+void Catalog::setColumnStatistics(
+    const int table_id,
+    const std::map<int, ColumnStatistics>& stats_per_column) {
+  {
+    std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+    for (const auto& column_and_stats : stats_per_column) {
+      const ColumnIdKey column_id_key(table_id, column_and_stats.first);
+      auto stats = std::make_shared<ColumnStatistics>(column_and_stats.second);
+      const auto it = columnStatisticsMap_.find(column_id_key);
+      if (it != columnStatisticsMap_.end()) {
+        stats->merge(*it->second);
+      }
+      columnStatisticsMap_[column_id_key] = stats;
+    }
+  }
+  persistColumnStatistics(table_id);
+}
+
+void Catalog::persistColumnStatistics(const int table_id) {
+  cat_sqlite_lock sqlite_lock(this);
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  unpersistedColumnStatisticsRows_.erase(table_id);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    for (auto it = columnStatisticsMap_.lower_bound(ColumnIdKey(table_id, 0));
+         it != columnStatisticsMap_.end() && std::get<0>(it->first) == table_id;
+         ++it) {
+      const auto& stats = it->second;
+      sqliteConnector_.query_with_text_params(
+          "INSERT OR REPLACE INTO mapd_column_statistics (tableid, columnid, num_rows, "
+          "num_nulls, ndv_sketch, histogram) VALUES (?1, ?2, ?3, ?4, ?5, ?6)",
+          std::vector<std::string>{std::to_string(table_id),
+                                   std::to_string(std::get<1>(it->first)),
+                                   std::to_string(stats->num_rows),
+                                   std::to_string(stats->num_nulls),
+                                   stats->serializeNdvSketch(),
+                                   stats->serializeHistogram()});
+    }
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+}
+
+void Catalog::dropColumnStatistics(const int table_id) {
+  cat_sqlite_lock sqlite_lock(this);
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  sqliteConnector_.query_with_text_param(
+      "DELETE FROM mapd_column_statistics WHERE tableid = ?", std::to_string(table_id));
+  columnStatisticsMap_.erase(
+      columnStatisticsMap_.lower_bound(ColumnIdKey(table_id, 0)),
+      columnStatisticsMap_.lower_bound(ColumnIdKey(table_id + 1, 0)));
+  unpersistedColumnStatisticsRows_.erase(table_id);
+}
+
 }  // namespace Catalog_Namespace
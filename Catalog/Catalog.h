@@ -41,6 +41,7 @@
 #include <vector>
 
 #include "ColumnDescriptor.h"
+#include "ColumnStatistics.h"
 #include "DashboardDescriptor.h"
 #include "DictDescriptor.h"
 #include "LinkDescriptor.h"
@@ -222,6 +223,40 @@ class Catalog final {
   void vacuumDeletedRows(const TableDescriptor* td) const;
   void vacuumDeletedRows(const int logicalTableId) const;
 
+  /**
+   * @brief Computes the statistics of all the supported columns of a table and
+   * replaces the stored ones.
+   */
+  void analyzeTable(const TableDescriptor* td);
+  /**
+   * @brief Returns the statistics of a column, merged over the shards of a sharded
+   * table, or nullptr if the table hasn't been analyzed.
+   */
+  std::shared_ptr<const ColumnStatistics> getColumnStatistics(const int table_id,
+                                                              const int column_id) const;
+  /**
+   * @brief Computes the statistics of the rows inserted into a physical table, from
+   * the insert buffers and for the columns which have statistics only.
+   */
+  std::map<int, ColumnStatistics> computeColumnStatisticsOnAppend(
+      const int table_id,
+      const Fragmenter_Namespace::InsertData& insert_data) const;
+  /**
+   * @brief Merges the statistics of rows appended to a physical table into its
+   * statistics. They're persisted once g_column_statistics_persist_rows rows have been
+   * appended since the last time, or when the catalog is closed.
+   */
+  void addColumnStatisticsOnAppend(
+      const int table_id,
+      const std::map<int, ColumnStatistics>& stats_per_column,
+      const size_t num_rows);
+  /**
+   * @brief Drops the entries built from the data of a table, or of its shards, from the
+   * caches kept outside of the buffer pools. Called whenever the data of the table is
+   * updated, appended to, rolled back, truncated or dropped.
+   */
+  void invalidateCachesForTable(const int table_id) const;
+
  protected:
   typedef std::map<std::string, TableDescriptor*> TableDescriptorMap;
   typedef std::map<int, TableDescriptor*> TableDescriptorMapById;
@@ -237,6 +272,8 @@ class Catalog final {
   typedef std::map<int, LinkDescriptor*> LinkDescriptorMapById;
   typedef std::unordered_map<const TableDescriptor*, const ColumnDescriptor*>
       DeletedColumnPerTableMap;
+  typedef std::map<ColumnIdKey, std::shared_ptr<const ColumnStatistics>>
+      ColumnStatisticsMap;
 
   void CheckAndExecuteMigrations();
   void CheckAndExecuteMigrationsPostBuildMaps();
@@ -249,6 +286,7 @@ class Catalog final {
   void updateLogicalToPhysicalTableLinkSchema();
   void updateLogicalToPhysicalTableMap(const int32_t logical_tb_id);
   void updateDictionarySchema();
+  void updateColumnStatisticsSchema();
   void updatePageSize();
   void updateDeletedColumnIndicator();
   void updateFrontendViewsToDashboards();
@@ -279,6 +317,10 @@ class Catalog final {
                           const bool is_on_error = false);
   void doDropTable(const TableDescriptor* td);
   void doTruncateTable(const TableDescriptor* td);
+  void setColumnStatistics(const int table_id,
+                           const std::map<int, ColumnStatistics>& stats_per_column);
+  void dropColumnStatistics(const int table_id);
+  void persistColumnStatistics(const int table_id);
   void renamePhysicalTable(const TableDescriptor* td, const std::string& newTableName);
   void instantiateFragmenter(TableDescriptor* td) const;
   void getAllColumnMetadataForTable(const TableDescriptor* td,
@@ -314,6 +356,9 @@ class Catalog final {
   std::shared_ptr<Calcite> calciteMgr_;
 
   LogicalToPhysicalTableMapById logicalToPhysicalTableMapById_;
+  ColumnStatisticsMap columnStatisticsMap_;
+  std::map<int, size_t> unpersistedColumnStatisticsRows_;  // per physical table id
+  mutable std::mutex columnStatisticsMutex_;
   static const std::string
       physicalTableNameTag_;  // extra component added to the name of each physical table
   int nextTempTableId_;
@@ -0,0 +1,438 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ColumnStatistics.h"
+
+#include "../Chunk/Chunk.h"
+#include "../QueryEngine/HyperLogLog.h"
+#include "../QueryEngine/HyperLogLogRank.h"
+#include "../QueryEngine/MurmurHash.h"
+#include "../QueryEngine/TypePunning.h"
+#include "../Shared/DateConverters.h"
+#include "../Shared/InlineNullValues.h"
+#include "../Shared/Logger.h"
+#include "../Shared/thread_count.h"
+
+#include <algorithm>
+#include <future>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// Fraction of the values described by the histogram bounds which are smaller than x, or
+// smaller or equal if inclusive is set. Values are assumed to be uniformly distributed
+// within each bucket.
+double histogram_mass(const std::vector<double>& bounds,
+                      const double x,
+                      const bool inclusive) {
+  CHECK_GE(bounds.size(), size_t(2));
+  const size_t bucket_count = bounds.size() - 1;
+  double mass{0};
+  for (size_t i = 0; i < bucket_count; ++i) {
+    const auto lo = bounds[i];
+    const auto hi = bounds[i + 1];
+    if (hi < x || (inclusive && hi == x)) {
+      mass += 1;
+    } else if (lo < x) {
+      mass += (x - lo) / (hi - lo);
+    } else {
+      break;
+    }
+  }
+  return mass / bucket_count;
+}
+
+// Builds the equi-depth histogram of the union of the value sets described by the
+// given histograms, weighted by the number of values in each set.
+std::vector<double> merge_histograms(
+    const std::vector<std::pair<const std::vector<double>*, int64_t>>& histograms) {
+  std::vector<double> candidates;
+  int64_t total_weight{0};
+  for (const auto& histogram_and_weight : histograms) {
+    const auto histogram = histogram_and_weight.first;
+    if (histogram->empty() || histogram_and_weight.second <= 0) {
+      continue;
+    }
+    candidates.insert(candidates.end(), histogram->begin(), histogram->end());
+    total_weight += histogram_and_weight.second;
+  }
+  if (!total_weight) {
+    return {};
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  // The merged cumulative distribution is linear between consecutive candidates and can
+  // only jump at a candidate, keep both its left limit and its value at each of them.
+  std::vector<double> mass_below(candidates.size());
+  std::vector<double> mass_upto(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    for (const auto& histogram_and_weight : histograms) {
+      const auto histogram = histogram_and_weight.first;
+      if (histogram->empty() || histogram_and_weight.second <= 0) {
+        continue;
+      }
+      const double weight =
+          static_cast<double>(histogram_and_weight.second) / total_weight;
+      mass_below[i] += weight * histogram_mass(*histogram, candidates[i], false);
+      mass_upto[i] += weight * histogram_mass(*histogram, candidates[i], true);
+    }
+  }
+  const size_t bucket_count = ColumnStatistics::histogram_buckets;
+  std::vector<double> merged{candidates.front()};
+  size_t crt = 0;
+  for (size_t i = 1; i < bucket_count; ++i) {
+    const double q = static_cast<double>(i) / bucket_count;
+    while (crt + 1 < candidates.size() && mass_upto[crt] < q) {
+      ++crt;
+    }
+    if (crt == 0 || q > mass_below[crt] || mass_below[crt] <= mass_upto[crt - 1]) {
+      merged.push_back(candidates[crt]);
+      continue;
+    }
+    const auto lo = candidates[crt - 1];
+    const auto hi = candidates[crt];
+    merged.push_back(lo + (q - mass_upto[crt - 1]) /
+                              (mass_below[crt] - mass_upto[crt - 1]) * (hi - lo));
+  }
+  merged.push_back(candidates.back());
+  return merged;
+}
+
+ColumnStatistics merge_column_statistics(
+    const std::vector<const ColumnStatistics*>& all_stats) {
+  ColumnStatistics merged;
+  merged.ndv_sketch.resize(1 << ColumnStatistics::ndv_sketch_bits, 0);
+  std::vector<std::pair<const std::vector<double>*, int64_t>> histograms;
+  for (const auto stats : all_stats) {
+    merged.num_rows += stats->num_rows;
+    merged.num_nulls += stats->num_nulls;
+    if (!stats->ndv_sketch.empty()) {
+      CHECK_EQ(stats->ndv_sketch.size(), merged.ndv_sketch.size());
+      for (size_t i = 0; i < merged.ndv_sketch.size(); ++i) {
+        merged.ndv_sketch[i] = std::max(merged.ndv_sketch[i], stats->ndv_sketch[i]);
+      }
+    }
+    histograms.emplace_back(&stats->histogram, stats->num_rows - stats->num_nulls);
+  }
+  merged.histogram = merge_histograms(histograms);
+  return merged;
+}
+
+// Accumulates the values of a fragment. The histogram is built from a uniform sample
+// of the values, the NDV sketch from all of them.
+class FragmentStatisticsBuilder {
+ public:
+  FragmentStatisticsBuilder(const bool with_histogram, const uint32_t seed)
+      : with_histogram_(with_histogram), rng_(seed) {
+    stats_.ndv_sketch.resize(1 << ColumnStatistics::ndv_sketch_bits, 0);
+  }
+
+  void addNull() {
+    ++stats_.num_rows;
+    ++stats_.num_nulls;
+  }
+
+  void addValue(const int64_t key, const double value) {
+    ++stats_.num_rows;
+    const uint32_t b = ColumnStatistics::ndv_sketch_bits;
+    const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+    auto& reg = stats_.ndv_sketch[hash >> (64 - b)];
+    reg = std::max(reg, static_cast<int8_t>(get_rank(hash << b, 64 - b)));
+    if (!with_histogram_) {
+      return;
+    }
+    const auto value_count = stats_.num_rows - stats_.num_nulls;
+    if (sample_.size() < sample_size_) {
+      sample_.push_back(value);
+      return;
+    }
+    std::uniform_int_distribution<int64_t> dist(0, value_count - 1);
+    const auto pos = dist(rng_);
+    if (static_cast<size_t>(pos) < sample_size_) {
+      sample_[pos] = value;
+    }
+  }
+
+  ColumnStatistics finish() {
+    if (!sample_.empty()) {
+      std::sort(sample_.begin(), sample_.end());
+      const size_t bucket_count = ColumnStatistics::histogram_buckets;
+      for (size_t i = 0; i <= bucket_count; ++i) {
+        stats_.histogram.push_back(sample_[i * (sample_.size() - 1) / bucket_count]);
+      }
+    }
+    return stats_;
+  }
+
+ private:
+  static constexpr size_t sample_size_{1024};
+
+  const bool with_histogram_;
+  std::mt19937_64 rng_;
+  std::vector<double> sample_;
+  ColumnStatistics stats_;
+};
+
+int64_t decode_int(const int8_t* buff,
+                   const size_t elem_sz,
+                   const bool is_unsigned,
+                   const size_t pos) {
+  switch (elem_sz) {
+    case 1:
+      return is_unsigned ? reinterpret_cast<const uint8_t*>(buff)[pos] : buff[pos];
+    case 2:
+      return is_unsigned ? reinterpret_cast<const uint16_t*>(buff)[pos]
+                         : reinterpret_cast<const int16_t*>(buff)[pos];
+    case 4:
+      return reinterpret_cast<const int32_t*>(buff)[pos];
+    case 8:
+      return reinterpret_cast<const int64_t*>(buff)[pos];
+    default:
+      CHECK(false);
+  }
+  return 0;
+}
+
+// Adds the values [begin, end) of a buffer laid out as ti. The NDV sketch hashes the
+// values as stored in the chunks, hence the days of a date in days column whose
+// values are given in seconds.
+void add_values(FragmentStatisticsBuilder& builder,
+                const SQLTypeInfo& ti,
+                const bool date_in_seconds,
+                const int8_t* buff,
+                const size_t begin,
+                const size_t end) {
+  switch (ti.get_type()) {
+    case kFLOAT: {
+      const auto values = reinterpret_cast<const float*>(buff);
+      for (size_t i = begin; i < end; ++i) {
+        if (values[i] == inline_fp_null_value<float>()) {
+          builder.addNull();
+          continue;
+        }
+        const double value = values[i];
+        builder.addValue(*reinterpret_cast<const int64_t*>(may_alias_ptr(&value)),
+                         value);
+      }
+      break;
+    }
+    case kDOUBLE: {
+      const auto values = reinterpret_cast<const double*>(buff);
+      for (size_t i = begin; i < end; ++i) {
+        if (values[i] == inline_fp_null_value<double>()) {
+          builder.addNull();
+          continue;
+        }
+        builder.addValue(*reinterpret_cast<const int64_t*>(may_alias_ptr(&values[i])),
+                         values[i]);
+      }
+      break;
+    }
+    default: {
+      const size_t elem_sz = ti.get_size();
+      const bool is_unsigned = ti.is_string() && elem_sz < sizeof(int32_t);
+      const auto null_val = inline_fixed_encoding_null_val(ti);
+      const bool is_date_in_days = ti.get_compression() == kENCODING_DATE_IN_DAYS;
+      for (size_t i = begin; i < end; ++i) {
+        const auto key = decode_int(buff, elem_sz, is_unsigned, i);
+        if (key == null_val) {
+          builder.addNull();
+          continue;
+        }
+        if (date_in_seconds) {
+          builder.addValue(DateConverters::get_epoch_days_from_seconds(key), key);
+          continue;
+        }
+        builder.addValue(
+            key,
+            is_date_in_days ? DateConverters::get_epoch_seconds_from_days(key) : key);
+      }
+      break;
+    }
+  }
+}
+
+ColumnStatistics compute_fragment_statistics(
+    Data_Namespace::DataMgr* data_mgr,
+    const int db_id,
+    const ColumnDescriptor* cd,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const size_t first_row) {
+  const auto& ti = cd->columnType;
+  FragmentStatisticsBuilder builder(!ti.is_string(), fragment.fragmentId);
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+  const auto chunk_metadata_it = chunk_metadata_map.find(cd->columnId);
+  if (chunk_metadata_it == chunk_metadata_map.end()) {
+    return builder.finish();
+  }
+  const auto& chunk_metadata = chunk_metadata_it->second;
+  const ChunkKey chunk_key{db_id, cd->tableId, cd->columnId, fragment.fragmentId};
+  const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                               data_mgr,
+                                               chunk_key,
+                                               Data_Namespace::CPU_LEVEL,
+                                               0,
+                                               chunk_metadata.numBytes,
+                                               chunk_metadata.numElements);
+  CHECK(chunk);
+  add_values(builder,
+             ti,
+             false,
+             chunk->get_buffer()->getMemoryPtr(),
+             first_row,
+             chunk_metadata.numElements);
+  return builder.finish();
+}
+
+}  // namespace
+
+size_t ColumnStatistics::getNdv() const {
+  if (ndv_sketch.empty()) {
+    return 0;
+  }
+  return std::min(hll_size(ndv_sketch.data(), ndv_sketch_bits),
+                  static_cast<size_t>(num_rows - num_nulls));
+}
+
+double ColumnStatistics::getNullFraction() const {
+  return num_rows ? static_cast<double>(num_nulls) / num_rows : 0;
+}
+
+double ColumnStatistics::getFractionInRange(const double lo, const double hi) const {
+  if (histogram.empty()) {
+    return 1;
+  }
+  if (lo > hi) {
+    return 0;
+  }
+  return histogram_mass(histogram, hi, true) - histogram_mass(histogram, lo, false);
+}
+
+void ColumnStatistics::merge(const ColumnStatistics& other) {
+  *this = merge_column_statistics({this, &other});
+}
+
+std::string ColumnStatistics::serializeNdvSketch() const {
+  std::string str;
+  for (const auto reg : ndv_sketch) {
+    str.push_back('0' + reg);
+  }
+  return str;
+}
+
+void ColumnStatistics::deserializeNdvSketch(const std::string& str) {
+  ndv_sketch.clear();
+  for (const auto c : str) {
+    ndv_sketch.push_back(c - '0');
+  }
+}
+
+std::string ColumnStatistics::serializeHistogram() const {
+  std::ostringstream oss;
+  oss.precision(17);
+  for (size_t i = 0; i < histogram.size(); ++i) {
+    oss << (i ? " " : "") << histogram[i];
+  }
+  return oss.str();
+}
+
+void ColumnStatistics::deserializeHistogram(const std::string& str) {
+  histogram.clear();
+  std::istringstream iss(str);
+  double bound;
+  while (iss >> bound) {
+    histogram.push_back(bound);
+  }
+}
+
+bool column_statistics_supported(const SQLTypeInfo& ti) {
+  if (ti.is_varlen() || ti.is_geometry() || ti.is_array()) {
+    return false;
+  }
+  if (ti.is_string()) {
+    return ti.get_compression() == kENCODING_DICT;
+  }
+  return ti.is_number() || ti.is_boolean() || ti.is_time();
+}
+
+ColumnStatistics compute_column_statistics(
+    Data_Namespace::DataMgr* data_mgr,
+    const int db_id,
+    const ColumnDescriptor* cd,
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
+    const size_t first_row) {
+  CHECK(column_statistics_supported(cd->columnType));
+  std::vector<std::pair<const Fragmenter_Namespace::FragmentInfo*, size_t>> work;
+  size_t crt_row{0};
+  for (const auto& fragment : fragments) {
+    const auto num_tuples = fragment.getPhysicalNumTuples();
+    if (crt_row + num_tuples > first_row) {
+      work.emplace_back(&fragment, first_row > crt_row ? first_row - crt_row : 0);
+    }
+    crt_row += num_tuples;
+  }
+  std::vector<ColumnStatistics> fragment_stats(work.size());
+  const size_t worker_count = std::min(work.size(), static_cast<size_t>(cpu_threads()));
+  std::vector<std::future<void>> workers;
+  for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+    workers.emplace_back(std::async(std::launch::async, [&, worker_idx] {
+      for (size_t i = worker_idx; i < work.size(); i += worker_count) {
+        fragment_stats[i] = compute_fragment_statistics(
+            data_mgr, db_id, cd, *work[i].first, work[i].second);
+      }
+    }));
+  }
+  for (auto& worker : workers) {
+    worker.wait();
+  }
+  for (auto& worker : workers) {
+    worker.get();
+  }
+  std::vector<const ColumnStatistics*> all_stats;
+  for (const auto& stats : fragment_stats) {
+    all_stats.push_back(&stats);
+  }
+  return merge_column_statistics(all_stats);
+}
+
+ColumnStatistics compute_insert_data_statistics(const ColumnDescriptor* cd,
+                                                const int8_t* values,
+                                                const size_t num_rows) {
+  const auto& ti = cd->columnType;
+  CHECK(column_statistics_supported(ti));
+  FragmentStatisticsBuilder builder(!ti.is_string(), num_rows);
+  if (ti.get_compression() == kENCODING_FIXED ||
+      ti.get_compression() == kENCODING_DATE_IN_DAYS) {
+    // the encoders only compress the values on append
+    const SQLTypeInfo insert_ti(ti.get_type(),
+                                ti.get_dimension(),
+                                ti.get_scale(),
+                                ti.get_notnull(),
+                                kENCODING_NONE,
+                                0,
+                                ti.get_subtype());
+    add_values(builder,
+               insert_ti,
+               ti.get_compression() == kENCODING_DATE_IN_DAYS,
+               values,
+               0,
+               num_rows);
+  } else {
+    add_values(builder, ti, false, values, 0, num_rows);
+  }
+  return builder.finish();
+}
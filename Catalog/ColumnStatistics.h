@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COLUMN_STATISTICS_H
+#define COLUMN_STATISTICS_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../DataMgr/DataMgr.h"
+#include "../Fragmenter/Fragmenter.h"
+#include "ColumnDescriptor.h"
+
+/**
+ * @type ColumnStatistics
+ * @brief distribution of the values of a column, computed by ANALYZE TABLE and merged
+ * with the statistics of the appended rows afterwards. Rows deleted or updated later on
+ * aren't accounted for, so the statistics are an approximation which is only used to
+ * guide planning decisions.
+ */
+struct ColumnStatistics {
+  static constexpr uint32_t ndv_sketch_bits{12};
+  static constexpr size_t histogram_buckets{64};
+
+  int64_t num_rows{0};
+  int64_t num_nulls{0};
+  // HyperLogLog registers for the non-null values.
+  std::vector<int8_t> ndv_sketch;
+  // Bounds of an equi-depth histogram of the non-null values, empty for strings.
+  std::vector<double> histogram;
+
+  size_t getNdv() const;
+
+  double getNullFraction() const;
+
+  // Fraction of the non-null values in [lo, hi] according to the histogram, 1 if there
+  // is no histogram.
+  double getFractionInRange(const double lo, const double hi) const;
+
+  void merge(const ColumnStatistics& other);
+
+  std::string serializeNdvSketch() const;
+  void deserializeNdvSketch(const std::string& str);
+  std::string serializeHistogram() const;
+  void deserializeHistogram(const std::string& str);
+};
+
+bool column_statistics_supported(const SQLTypeInfo& ti);
+
+/**
+ * @brief Computes the statistics of the rows of the given fragments of a physical table
+ * starting with first_row, over all the fragments in parallel.
+ */
+ColumnStatistics compute_column_statistics(
+    Data_Namespace::DataMgr* data_mgr,
+    const int db_id,
+    const ColumnDescriptor* cd,
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
+    const size_t first_row);
+
+/**
+ * @brief Computes the statistics of rows about to be appended to a column from their
+ * insert buffer, laid out as InsertData expects it.
+ */
+ColumnStatistics compute_insert_data_statistics(const ColumnDescriptor* cd,
+                                                const int8_t* values,
+                                                const size_t num_rows);
+
+#endif  // COLUMN_STATISTICS_H
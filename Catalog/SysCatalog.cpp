@@ -1023,6 +1023,10 @@ void SysCatalog::createDatabase(const string& name, int owner) {
         "CREATE TABLE mapd_logical_to_physical(logical_table_id integer, "
         "physical_table_id "
         "integer)");
+    dbConn->query(
+        "CREATE TABLE mapd_column_statistics (tableid integer, columnid integer, "
+        "num_rows bigint, num_nulls bigint, ndv_sketch text, histogram text, "
+        "primary key(tableid, columnid))");
     dbConn->query("CREATE TABLE mapd_record_ownership_marker (dummy integer)");
     dbConn->query_with_text_params(
         "INSERT INTO mapd_record_ownership_marker (dummy) VALUES (?1)",
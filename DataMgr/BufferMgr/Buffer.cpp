@@ -25,6 +25,7 @@
 //
 #include "DataMgr/BufferMgr/Buffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -59,7 +60,9 @@ void Buffer::reserve(const size_t num_bytes) {
 #ifdef BUFFER_MUTEX
   boost::unique_lock<boost::shared_mutex> write_lock(read_write_mutex_);
 #endif
-  size_t num_pages = (num_bytes + page_size_ - 1) / page_size_;
+  // A buffer using mapped memory has no pages reserved yet, the pages reserved when it
+  // moves to a slab must still fit all of its data.
+  size_t num_pages = (std::max(num_bytes, size_) + page_size_ - 1) / page_size_;
   // std::cout << "NumPages reserved: " << numPages << std::endl;
   if (num_pages > num_pages_) {
     // When running out of cpu buffers, reserveBuffer() will fail and
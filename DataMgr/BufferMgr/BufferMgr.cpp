@@ -28,11 +28,25 @@
 #include "DataMgr/BufferMgr/Buffer.h"
 #include "Shared/Logger.h"
 #include "Shared/measure.h"
+#include "Shared/scope.h"
 
 using namespace std;
 
 namespace Buffer_Namespace {
 
+namespace {
+
+bool key_has_prefix(const ChunkKey& key, const ChunkKey& key_prefix) {
+  return key.size() >= key_prefix.size() &&
+         std::equal(key_prefix.begin(), key_prefix.end(), key.begin());
+}
+
+bool is_pinned(const BufferList::iterator& seg_it) {
+  return seg_it->mem_status == USED && seg_it->buffer->getPinCount() > 0;
+}
+
+}  // namespace
+
 std::string BufferMgr::keyToString(const ChunkKey& key) {
   std::ostringstream oss;
 
@@ -51,11 +65,11 @@ BufferMgr::BufferMgr(const int device_id,
                      AbstractBufferMgr* parent_mgr)
     : AbstractBufferMgr(device_id)
     , page_size_(page_size)
+    , parent_mgr_(parent_mgr)
     , max_buffer_size_(max_buffer_size)
     , num_pages_allocated_(0)
     , max_slab_size_(max_slab_size)
     , allocations_capped_(false)
-    , parent_mgr_(parent_mgr)
     , max_buffer_id_(0)
     , buffer_epoch_(0) {
   CHECK(max_buffer_size_ > 0 && max_slab_size_ > 0 && page_size_ > 0 &&
@@ -89,6 +103,8 @@ void BufferMgr::clear() {
   }
 
   chunk_index_.clear();
+  free_segments_.clear();
+  used_segments_.clear();
   slabs_.clear();
   slab_segments_.clear();
   unsized_segs_.clear();
@@ -152,7 +168,13 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
       CHECK(evict_it->buffer->getPinCount() < 1);
     }
     num_pages += evict_it->num_pages;
+    if (evict_it->mem_status == FREE) {
+      removeFreeSegment(evict_it);
+    } else {
+      removeUsedSegment(evict_it);
+    }
     if (evict_it->mem_status == USED && evict_it->chunk_key.size() > 0) {
+      cacheEvictedChunk(evict_it->chunk_key, evict_it->buffer);
       chunk_index_.erase(evict_it->chunk_key);
     }
     evict_it = slab_segments_[slab_num].erase(
@@ -165,15 +187,19 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
   data_seg.slab_num = slab_num;
   auto data_seg_it =
       slab_segments_[slab_num].insert(evict_it, data_seg);  // Will insert before evict_it
+  addUsedSegment(data_seg_it);
   if (num_pages_requested < num_pages) {
     size_t excess_pages = num_pages - num_pages_requested;
     if (evict_it != slab_segments_[slab_num].end() &&
         evict_it->mem_status == FREE) {  // need to merge with current page
+      removeFreeSegment(evict_it);
       evict_it->start_page = start_page + num_pages_requested;
       evict_it->num_pages += excess_pages;
+      addFreeSegment(evict_it);
     } else {  // need to insert a free seg before evict_it for excess_pages
       BufferSeg free_seg(start_page + num_pages_requested, excess_pages, FREE);
-      slab_segments_[slab_num].insert(evict_it, free_seg);
+      free_seg.slab_num = slab_num;
+      addFreeSegment(slab_segments_[slab_num].insert(evict_it, free_seg));
     }
   }
   return data_seg_it;
@@ -197,10 +223,16 @@ BufferList::iterator BufferMgr::reserveBuffer(
     if (next_it != slab_segments_[slab_num].end() && next_it->mem_status == FREE &&
         next_it->num_pages >= num_pages_extra_needed) {
       // Then we can just use the next BufferSeg which happens to be free
+      removeFreeSegment(next_it);
       size_t leftover_pages = next_it->num_pages - num_pages_extra_needed;
       seg_it->num_pages = num_pages_requested;
-      next_it->num_pages = leftover_pages;
-      next_it->start_page = seg_it->start_page + seg_it->num_pages;
+      if (leftover_pages > 0) {
+        next_it->num_pages = leftover_pages;
+        next_it->start_page = seg_it->start_page + seg_it->num_pages;
+        addFreeSegment(next_it);
+      } else {
+        slab_segments_[slab_num].erase(next_it);
+      }
       return seg_it;
     }
   }
@@ -211,13 +243,15 @@ BufferList::iterator BufferMgr::reserveBuffer(
   // Below should be in copy constructor for BufferSeg?
   new_seg_it->buffer = seg_it->buffer;
   new_seg_it->chunk_key = seg_it->chunk_key;
+  new_seg_it->access_count = seg_it->access_count;
   int8_t* old_mem = new_seg_it->buffer->mem_;
   new_seg_it->buffer->mem_ =
       slabs_[new_seg_it->slab_num] + new_seg_it->start_page * page_size_;
 
   // now need to copy over memory
-  // only do this if the old segment is valid (i.e. not new w/ unallocated buffer
-  if (seg_it->start_page >= 0 && seg_it->buffer->mem_ != 0) {
+  // only do this if the old segment has memory (i.e. not new w/ unallocated buffer),
+  // which includes unsized segments of mapped chunks
+  if (old_mem) {
     new_seg_it->buffer->writeData(old_mem,
                                   new_seg_it->buffer->size(),
                                   0,
@@ -234,32 +268,58 @@ BufferList::iterator BufferMgr::reserveBuffer(
   return new_seg_it;
 }
 
-BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slab_num,
-                                                     const size_t num_pages_requested) {
-  for (auto buffer_it = slab_segments_[slab_num].begin();
-       buffer_it != slab_segments_[slab_num].end();
-       ++buffer_it) {
-    if (buffer_it->mem_status == FREE && buffer_it->num_pages >= num_pages_requested) {
-      // startPage doesn't change
-      size_t excess_pages = buffer_it->num_pages - num_pages_requested;
-      buffer_it->num_pages = num_pages_requested;
-      buffer_it->mem_status = USED;
-      buffer_it->last_touched = buffer_epoch_++;
-      buffer_it->slab_num = slab_num;
-      if (excess_pages > 0) {
-        BufferSeg free_seg(
-            buffer_it->start_page + num_pages_requested, excess_pages, FREE);
-        auto temp_it = buffer_it;  // this should make a copy and not be a reference
-        // - as we do not want to increment buffer_it
-        temp_it++;
-        slab_segments_[slab_num].insert(temp_it, free_seg);
-      }
-      return buffer_it;
-    }
+void BufferMgr::addFreeSegment(const BufferList::iterator& seg_it) {
+  CHECK_EQ(seg_it->mem_status, FREE);
+  CHECK_GE(seg_it->slab_num, 0);
+  const auto inserted = free_segments_.insert(seg_it).second;
+  CHECK(inserted);
+}
+
+void BufferMgr::removeFreeSegment(const BufferList::iterator seg_it) {
+  const auto erased = free_segments_.erase(seg_it);
+  CHECK_EQ(erased, size_t(1));
+}
+
+void BufferMgr::addUsedSegment(const BufferList::iterator& seg_it) {
+  CHECK_EQ(seg_it->mem_status, USED);
+  CHECK_GE(seg_it->slab_num, 0);
+  const auto inserted = used_segments_.insert(seg_it).second;
+  CHECK(inserted);
+}
+
+void BufferMgr::removeUsedSegment(const BufferList::iterator seg_it) {
+  const auto erased = used_segments_.erase(seg_it);
+  CHECK_EQ(erased, size_t(1));
+}
+
+void BufferMgr::touchSegment(const BufferList::iterator& seg_it) {
+  const bool in_slab = seg_it->slab_num >= 0;
+  if (in_slab) {
+    removeUsedSegment(seg_it);
+  }
+  seg_it->last_touched = buffer_epoch_++;
+  if (in_slab) {
+    addUsedSegment(seg_it);
+  }
+}
+
+BufferList::iterator BufferMgr::useFreeSegment(const BufferList::iterator seg_it,
+                                               const size_t num_pages_requested) {
+  removeFreeSegment(seg_it);
+  // startPage doesn't change
+  const size_t excess_pages = seg_it->num_pages - num_pages_requested;
+  seg_it->num_pages = num_pages_requested;
+  seg_it->mem_status = USED;
+  seg_it->last_touched = buffer_epoch_++;
+  seg_it->access_count = 0;
+  addUsedSegment(seg_it);
+  if (excess_pages > 0) {
+    BufferSeg free_seg(seg_it->start_page + num_pages_requested, excess_pages, FREE);
+    free_seg.slab_num = seg_it->slab_num;
+    addFreeSegment(
+        slab_segments_[seg_it->slab_num].insert(std::next(seg_it), free_seg));
   }
-  // If here then we did not find a free buffer of sufficient size in this slab,
-  // return the end iterator
-  return slab_segments_[slab_num].end();
+  return seg_it;
 }
 
 BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
@@ -270,11 +330,10 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
 
   size_t num_slabs = slab_segments_.size();
 
-  for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
-    auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
-    if (seg_it != slab_segments_[slab_num].end()) {
-      return seg_it;
-    }
+  // Best fit: the smallest free segment across all slabs which is large enough
+  const auto free_seg_it = free_segments_.lower_bound(num_pages_requested);
+  if (free_seg_it != free_segments_.end()) {
+    return useFreeSegment(*free_seg_it, num_pages_requested);
   }
 
   // If we're here then we didn't find a free segment of sufficient size
@@ -298,10 +357,13 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
       }
       // if here then addSlab succeeded
       num_pages_allocated_ += current_max_slab_page_size_;
-      return findFreeBufferInSlab(
-          num_slabs,
-          num_pages_requested);  // has to succeed since we made sure to request a slab
-                                 // big enough to accomodate request
+      CHECK_EQ(slab_segments_.size(), num_slabs + 1);
+      auto slab_seg_it = slab_segments_[num_slabs].begin();
+      slab_seg_it->slab_num = num_slabs;
+      addFreeSegment(slab_seg_it);
+      // has to succeed since we made sure to request a slab big enough to accomodate
+      // request
+      return useFreeSegment(slab_seg_it, num_pages_requested);
     } catch (std::runtime_error& error) {  // failed to allocate slab
       LOG(INFO) << "ALLOCATION Attempted slab of " << current_max_slab_page_size_
                 << " pages (" << current_max_slab_page_size_ * page_size_ << "B) failed "
@@ -333,68 +395,7 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   }
 
   // If here then we can't add a slab - so we need to evict
-
-  size_t min_score = std::numeric_limits<size_t>::max();
-  // We're going for lowest score here, like golf
-  // This is because score is the sum of the lastTouched score for all pages evicted.
-  // Evicting fewer pages and older pages will lower the score
-  BufferList::iterator best_eviction_start = slab_segments_[0].end();
-  int best_eviction_start_slab = -1;
-  int slab_num = 0;
-
-  for (auto slab_it = slab_segments_.begin(); slab_it != slab_segments_.end();
-       ++slab_it, ++slab_num) {
-    for (auto buffer_it = slab_it->begin(); buffer_it != slab_it->end(); ++buffer_it) {
-      // Note there are some shortcuts we could take here - like we should never consider
-      // a USED buffer coming after a free buffer as we would have used the FREE buffer,
-      // but we won't worry about this for now
-
-      // We can't evict pinned buffers - only normal usedbuffers
-
-      // if (buffer_it->mem_status == FREE || buffer_it->buffer->getPinCount() == 0) {
-      size_t page_count = 0;
-      size_t score = 0;
-      bool solution_found = false;
-      auto evict_it = buffer_it;
-      for (; evict_it != slab_segments_[slab_num].end(); ++evict_it) {
-        // pinCount should never go up - only down because we have
-        // global lock on buffer pool and pin count only increments
-        // on getChunk
-        if (evict_it->mem_status == USED && evict_it->buffer->getPinCount() > 0) {
-          break;
-        }
-        page_count += evict_it->num_pages;
-        if (evict_it->mem_status == USED) {
-          // MAT changed from
-          // score += evictIt->lastTouched;
-          // Issue was thrashing when going from 8M fragment size chunks back to 64M
-          // basically the large chunks were being evicted prior to small as many small
-          // chunk score was larger than one large chunk so it always would evict a large
-          // chunk so under memory pressure a query would evict its own current chunks and
-          // cause reloads rather than evict several smaller unused older chunks.
-          score = std::max(score, static_cast<size_t>(evict_it->last_touched));
-        }
-        if (page_count >= num_pages_requested) {
-          solution_found = true;
-          break;
-        }
-      }
-      if (solution_found && score < min_score) {
-        min_score = score;
-        best_eviction_start = buffer_it;
-        best_eviction_start_slab = slab_num;
-      } else if (evict_it == slab_segments_[slab_num].end()) {
-        // this means that every segment after this will fail as well, so our search has
-        // proven futile
-        // throw std::runtime_error ("Couldn't evict chunks to get free space");
-        break;
-        // in reality we should try to rearrange the buffer to get more contiguous free
-        // space
-      }
-      // other possibility is ending at PINNED - do nothing in this case
-      //}
-    }
-  }
+  auto best_eviction_start = findEvictionStart(num_pages_requested);
   if (best_eviction_start == slab_segments_[0].end()) {
     LOG(ERROR) << "ALLOCATION failed to find " << num_bytes << "B throwing out of memory "
                << getStringMgrType() << ":" << device_id_;
@@ -404,13 +405,97 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   LOG(INFO) << "ALLOCATION failed to find " << num_bytes << "B free. Forcing Eviction."
             << " Eviction start " << best_eviction_start->start_page
             << " Number pages requested " << num_pages_requested
-            << " Best Eviction Start Slab " << best_eviction_start_slab << " "
+            << " Best Eviction Start Slab " << best_eviction_start->slab_num << " "
             << getStringMgrType() << ":" << device_id_;
   best_eviction_start =
-      evict(best_eviction_start, num_pages_requested, best_eviction_start_slab);
+      evict(best_eviction_start, num_pages_requested, best_eviction_start->slab_num);
   return best_eviction_start;
 }
 
+// The pages to evict are a run of consecutive segments of a slab, none of them pinned.
+// We're going for the lowest score here, like golf: the score of a run is the most
+// recent lastTouched of its USED segments. Evicting fewer pages and older pages will
+// lower the score.
+// MAT changed from the sum of the lastTouched scores:
+// Issue was thrashing when going from 8M fragment size chunks back to 64M
+// basically the large chunks were being evicted prior to small as many small
+// chunk score was larger than one large chunk so it always would evict a large
+// chunk so under memory pressure a query would evict its own current chunks and
+// cause reloads rather than evict several smaller unused older chunks.
+//
+// The USED segments are visited from the least recently touched one. An unpinned one
+// joins the runs of its neighbours, if they have joined one already or are FREE. Every
+// segment of a run was touched no later than the one which joined last, so the first run
+// large enough has the lowest score. The search stops there, rather than going through
+// every segment of every slab.
+BufferList::iterator BufferMgr::findEvictionStart(const size_t num_pages_requested) {
+  struct Run {
+    BufferList::iterator first;
+    BufferList::iterator last;
+    size_t num_pages;
+  };
+  // the runs by their first and last segments
+  std::unordered_map<const BufferSeg*, Run> runs_by_first;
+  std::unordered_map<const BufferSeg*, Run> runs_by_last;
+  for (const auto& seg_it : used_segments_) {
+    // pinCount should never go up - only down because we have
+    // global lock on buffer pool and pin count only increments
+    // on getChunk
+    if (is_pinned(seg_it)) {
+      continue;
+    }
+    auto& segments = slab_segments_[seg_it->slab_num];
+    Run run{seg_it, seg_it, seg_it->num_pages};
+    if (seg_it != segments.begin()) {
+      const auto prev_it = std::prev(seg_it);
+      const auto prev_run_it = runs_by_last.find(&*prev_it);
+      if (prev_run_it != runs_by_last.end()) {
+        run.first = prev_run_it->second.first;
+        run.num_pages += prev_run_it->second.num_pages;
+        runs_by_first.erase(&*run.first);
+        runs_by_last.erase(prev_run_it);
+      } else if (prev_it->mem_status == FREE) {
+        run.first = prev_it;
+        run.num_pages += prev_it->num_pages;
+      }
+    }
+    const auto next_it = std::next(seg_it);
+    if (next_it != segments.end()) {
+      const auto next_run_it = runs_by_first.find(&*next_it);
+      if (next_run_it != runs_by_first.end()) {
+        run.last = next_run_it->second.last;
+        run.num_pages += next_run_it->second.num_pages;
+        runs_by_last.erase(&*run.last);
+        runs_by_first.erase(next_run_it);
+      } else if (next_it->mem_status == FREE) {
+        run.last = next_it;
+        run.num_pages += next_it->num_pages;
+      }
+    }
+    if (run.num_pages < num_pages_requested) {
+      runs_by_first[&*run.first] = run;
+      runs_by_last[&*run.last] = run;
+      continue;
+    }
+    // Evict from this segment on, or from before it if the end of the run is too close
+    auto eviction_start = seg_it;
+    size_t num_pages{0};
+    for (auto it = seg_it; num_pages < num_pages_requested; ++it) {
+      num_pages += it->num_pages;
+      if (it == run.last) {
+        break;
+      }
+    }
+    while (num_pages < num_pages_requested) {
+      CHECK(eviction_start != run.first);
+      --eviction_start;
+      num_pages += eviction_start->num_pages;
+    }
+    return eviction_start;
+  }
+  return slab_segments_[0].end();
+}
+
 std::string BufferMgr::printSlab(size_t slab_num) {
   std::ostringstream tss;
   // size_t lastEnd = 0;
@@ -454,6 +539,7 @@ std::string BufferMgr::printSlabs() {
 }
 
 void BufferMgr::clearSlabs() {
+  dropEvictedChunks({});
   bool pinned_exists = false;
   for (auto& segment_list : slab_segments_) {
     for (auto& segment : segment_list) {
@@ -466,6 +552,24 @@ void BufferMgr::clearSlabs() {
       }
     }
   }
+  // unsized segments of mapped chunks hold memory as well
+  std::vector<ChunkKey> unpinned_unsized_keys;
+  {
+    std::lock_guard<std::mutex> unsized_segs_lock(unsized_segs_mutex_);
+    for (const auto& segment : unsized_segs_) {
+      if (!segment.buffer || !segment.buffer->getMemoryPtr()) {
+        continue;
+      }
+      if (segment.buffer->getPinCount() < 1) {
+        unpinned_unsized_keys.push_back(segment.chunk_key);
+      } else {
+        pinned_exists = true;
+      }
+    }
+  }
+  for (const auto& key : unpinned_unsized_keys) {
+    deleteBuffer(key, true);
+  }
   if (!pinned_exists) {
     // lets actually clear the buffer from memory
     freeAllMem();
@@ -588,6 +692,7 @@ void BufferMgr::deleteBuffer(const ChunkKey& key, const bool) {
   auto seg_it = buffer_it->second;
   chunk_index_.erase(buffer_it);
   chunk_index_lock.unlock();
+  dropEvictedChunks(key);
   std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
   if (seg_it->buffer) {
     delete seg_it->buffer;  // Delete Buffer for segment
@@ -598,23 +703,19 @@ void BufferMgr::deleteBuffer(const ChunkKey& key, const bool) {
 
 void BufferMgr::deleteBuffersWithPrefix(const ChunkKey& key_prefix, const bool) {
   // Note: purge is unused
+  dropEvictedChunks(key_prefix);
   // lookup the buffer for the Chunk in chunk_index_
   std::lock_guard<std::mutex> sized_segs_lock(
       sized_segs_mutex_);  // Take this lock early to prevent deadlock with
                            // reserveBuffer which needs segs_mutex_ and then
                            // chunk_index_mutex_
   std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
-  auto startChunkIt = chunk_index_.lower_bound(key_prefix);
-  if (startChunkIt == chunk_index_.end()) {
-    return;
-  }
-
-  auto buffer_it = startChunkIt;
-  while (buffer_it != chunk_index_.end() &&
-         std::search(buffer_it->first.begin(),
-                     buffer_it->first.begin() + key_prefix.size(),
-                     key_prefix.begin(),
-                     key_prefix.end()) != buffer_it->first.begin() + key_prefix.size()) {
+  auto buffer_it = chunk_index_.begin();
+  while (buffer_it != chunk_index_.end()) {
+    if (!key_has_prefix(buffer_it->first, key_prefix)) {
+      ++buffer_it;
+      continue;
+    }
     auto seg_it = buffer_it->second;
     if (seg_it->buffer) {
       delete seg_it->buffer;  // Delete Buffer for segment
@@ -630,14 +731,17 @@ void BufferMgr::removeSegment(BufferList::iterator& seg_it) {
   int slab_num = seg_it->slab_num;
   // cout << "Slab num: " << slabNum << endl;
   if (slab_num < 0) {
+    unmapChunk(seg_it->chunk_key);
     std::lock_guard<std::mutex> unsized_segs_lock(unsized_segs_mutex_);
     unsized_segs_.erase(seg_it);
   } else {
+    removeUsedSegment(seg_it);
     if (seg_it != slab_segments_[slab_num].begin()) {
       auto prev_it = std::prev(seg_it);
       // LOG(INFO) << "PrevIt: " << " " << getStringMgrType() << ":" << device_id_;
       // printSeg(prev_it);
       if (prev_it->mem_status == FREE) {
+        removeFreeSegment(prev_it);
         seg_it->start_page = prev_it->start_page;
         seg_it->num_pages += prev_it->num_pages;
         slab_segments_[slab_num].erase(prev_it);
@@ -646,6 +750,7 @@ void BufferMgr::removeSegment(BufferList::iterator& seg_it) {
     auto next_it = std::next(seg_it);
     if (next_it != slab_segments_[slab_num].end()) {
       if (next_it->mem_status == FREE) {
+        removeFreeSegment(next_it);
         seg_it->num_pages += next_it->num_pages;
         slab_segments_[slab_num].erase(next_it);
       }
@@ -653,6 +758,7 @@ void BufferMgr::removeSegment(BufferList::iterator& seg_it) {
     seg_it->mem_status = FREE;
     // seg_it->pinCount = 0;
     seg_it->buffer = 0;
+    addFreeSegment(seg_it);
   }
 }
 
@@ -677,17 +783,11 @@ void BufferMgr::checkpoint(const int db_id, const int tb_id) {
   ChunkKey key_prefix;
   key_prefix.push_back(db_id);
   key_prefix.push_back(tb_id);
-  auto start_chunk_it = chunk_index_.lower_bound(key_prefix);
-  if (start_chunk_it == chunk_index_.end()) {
-    return;
-  }
-
-  auto buffer_it = start_chunk_it;
-  while (buffer_it != chunk_index_.end() &&
-         std::search(buffer_it->first.begin(),
-                     buffer_it->first.begin() + key_prefix.size(),
-                     key_prefix.begin(),
-                     key_prefix.end()) != buffer_it->first.begin() + key_prefix.size()) {
+  for (auto buffer_it = chunk_index_.begin(); buffer_it != chunk_index_.end();
+       ++buffer_it) {
+    if (!key_has_prefix(buffer_it->first, key_prefix)) {
+      continue;
+    }
     if (buffer_it->second->chunk_key[0] != -1 &&
         buffer_it->second->buffer->is_dirty_) {  // checks that buffer is actual chunk
                                                  // (not just buffer) and is dirty
@@ -695,13 +795,14 @@ void BufferMgr::checkpoint(const int db_id, const int tb_id) {
       parent_mgr_->putBuffer(buffer_it->second->chunk_key, buffer_it->second->buffer);
       buffer_it->second->buffer->clearDirtyBits();
     }
-    buffer_it++;
   }
 }
 
 /// Returns a pointer to the Buffer holding the chunk, if it exists; otherwise,
 /// throws a runtime_error.
 AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes) {
+  // Declared first to run once the lock below is released
+  ScopeGuard process_evicted_chunks = [this] { processEvictedChunks(); };
   std::lock_guard<std::mutex> lock(global_mutex_);  // granular lock
 
   std::unique_lock<std::mutex> sized_segs_lock(sized_segs_mutex_);
@@ -712,9 +813,10 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
   if (found_buffer) {
     CHECK(buffer_it->second->buffer);
     buffer_it->second->buffer->pin();
+    touchSegment(buffer_it->second);
     sized_segs_lock.unlock();
 
-    buffer_it->second->last_touched = buffer_epoch_++;  // race
+    ++buffer_it->second->access_count;
 
     if (buffer_it->second->buffer->size() < num_bytes) {
       // need to fetch part of buffer we don't have - up to numBytes
@@ -723,8 +825,14 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
     return buffer_it->second->buffer;
   } else {  // If wasn't in pool then we need to fetch it
     sized_segs_lock.unlock();
+    if (auto buffer = createMappedBuffer(key, num_bytes)) {
+      return buffer;
+    }
     // createChunk pins for us
     AbstractBuffer* buffer = createBuffer(key, page_size_, num_bytes);
+    if (restoreEvictedChunk(key, buffer, num_bytes)) {
+      return buffer;
+    }
     try {
       parent_mgr_->fetchBuffer(
           key, buffer, num_bytes);  // this should put buffer in a BufferSegment
@@ -750,15 +858,21 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   if (!found_buffer) {
     sized_segs_lock.unlock();
     CHECK(parent_mgr_ != 0);
-    buffer = createBuffer(key, page_size_, num_bytes);  // will pin buffer
-    try {
-      parent_mgr_->fetchBuffer(key, buffer, num_bytes);
-    } catch (std::runtime_error& error) {
-      LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
+    buffer = createMappedBuffer(key, num_bytes);
+    if (!buffer) {
+      buffer = createBuffer(key, page_size_, num_bytes);  // will pin buffer
+      if (!restoreEvictedChunk(key, buffer, num_bytes)) {
+        try {
+          parent_mgr_->fetchBuffer(key, buffer, num_bytes);
+        } catch (std::runtime_error& error) {
+          LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
+        }
+      }
     }
   } else {
     buffer = buffer_it->second->buffer;
     buffer->pin();
+    ++buffer_it->second->access_count;
     if (num_bytes > buffer->size()) {
       try {
         parent_mgr_->fetchBuffer(key, buffer, num_bytes);
@@ -787,6 +901,26 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   dest_buffer->setSize(chunk_size);
   dest_buffer->syncEncoder(buffer);
   buffer->unPin();
+  processEvictedChunks();
+}
+
+// Creates a pinned buffer for the chunk which uses the memory returned by mapChunk
+// instead of a slab, or returns nullptr if the chunk can't be mapped.
+AbstractBuffer* BufferMgr::createMappedBuffer(const ChunkKey& key,
+                                              const size_t num_bytes) {
+  AbstractBuffer* parent_buffer{nullptr};
+  auto mem = mapChunk(key, num_bytes, parent_buffer);
+  if (!mem) {
+    return nullptr;
+  }
+  CHECK(parent_buffer);
+  // A zero initial size keeps the buffer in an unsized segment, any write which grows
+  // it moves it to a slab and unmaps the chunk through removeSegment.
+  auto buffer = static_cast<Buffer*>(createBuffer(key, page_size_, 0));
+  buffer->mem_ = mem;
+  buffer->setSize(num_bytes == 0 ? parent_buffer->size() : num_bytes);
+  buffer->syncEncoder(parent_buffer);
+  return buffer;
 }
 
 AbstractBuffer* BufferMgr::putBuffer(const ChunkKey& key,
@@ -847,6 +981,31 @@ void BufferMgr::free(AbstractBuffer* buffer) {
   deleteBuffer(casted_buffer->seg_it_->chunk_key);
 }
 
+std::vector<std::pair<ChunkKey, size_t>> BufferMgr::getHotChunks() {
+  std::vector<std::tuple<unsigned int, ChunkKey, size_t>> chunks;
+  {
+    std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+    chunks.reserve(chunk_index_.size());
+    for (const auto& chunk : chunk_index_) {
+      const auto& seg_it = chunk.second;
+      // skips the buffers which don't hold chunk data
+      if (chunk.first[0] == -1 || !seg_it->buffer || !seg_it->buffer->size()) {
+        continue;
+      }
+      chunks.emplace_back(seg_it->access_count, chunk.first, seg_it->buffer->size());
+    }
+  }
+  std::sort(chunks.begin(), chunks.end(), [](const auto& lhs, const auto& rhs) {
+    return std::get<0>(lhs) > std::get<0>(rhs);
+  });
+  std::vector<std::pair<ChunkKey, size_t>> hot_chunks;
+  hot_chunks.reserve(chunks.size());
+  for (auto& chunk : chunks) {
+    hot_chunks.emplace_back(std::move(std::get<1>(chunk)), std::get<2>(chunk));
+  }
+  return hot_chunks;
+}
+
 size_t BufferMgr::getNumChunks() {
   std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
   return chunk_index_.size();
@@ -30,7 +30,11 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 
+#include <boost/functional/hash.hpp>
 #include <boost/stacktrace.hpp>
 
 #include "DataMgr/AbstractBuffer.h"
@@ -162,6 +166,8 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   /// Returns the total number of bytes allocated.
   size_t size();
   size_t getNumChunks() override;
+  /// Returns the keys and sizes of the resident chunks, most accessed first.
+  std::vector<std::pair<ChunkKey, size_t>> getHotChunks();
 
   BufferList::iterator reserveBuffer(BufferList::iterator& seg_it,
                                      const size_t num_bytes);
@@ -176,26 +182,97 @@ class BufferMgr : public AbstractBufferMgr {  // implements
                                 /// allocation of the buffer pool
   std::vector<BufferList> slab_segments_;
   size_t page_size_;
+  AbstractBufferMgr* parent_mgr_;
 
  private:
   BufferMgr(const BufferMgr&);             // private copy constructor
   BufferMgr& operator=(const BufferMgr&);  // private assignment
   void removeSegment(BufferList::iterator& seg_it);
-  BufferList::iterator findFreeBufferInSlab(const size_t slab_num,
-                                            const size_t num_pages_requested);
+  void addFreeSegment(const BufferList::iterator& seg_it);
+  void removeFreeSegment(const BufferList::iterator seg_it);
+  BufferList::iterator useFreeSegment(const BufferList::iterator seg_it,
+                                      const size_t num_pages_requested);
+  void addUsedSegment(const BufferList::iterator& seg_it);
+  void removeUsedSegment(const BufferList::iterator seg_it);
+  void touchSegment(const BufferList::iterator& seg_it);
+  BufferList::iterator findEvictionStart(const size_t num_pages_requested);
   int getBufferId();
+  AbstractBuffer* createMappedBuffer(const ChunkKey& key, const size_t num_bytes);
   virtual void addSlab(const size_t slab_size) = 0;
   virtual void freeAllMem() = 0;
   virtual void allocateBuffer(BufferList::iterator seg_it,
                               const size_t page_size,
                               const size_t num_bytes) = 0;
+  // Returns memory holding the first num_bytes of the chunk which is shared with the
+  // parent manager and sets parent_buffer to the parent's buffer for the chunk, or
+  // nullptr if the chunk has to be copied into a slab. A buffer using such memory
+  // stays outside of the slabs until it needs to grow.
+  virtual int8_t* mapChunk(const ChunkKey& key,
+                           const size_t num_bytes,
+                           AbstractBuffer*& parent_buffer) {
+    return nullptr;
+  }
+  // Releases the memory returned by mapChunk for the chunk, if any.
+  virtual void unmapChunk(const ChunkKey& key) {}
+  // Called for each chunk evicted from the pool, before its memory gets reused, to
+  // give the manager a chance to keep a copy of its data. Runs with the pool locked,
+  // any expensive work on the copy belongs in processEvictedChunks.
+  virtual void cacheEvictedChunk(const ChunkKey& key, AbstractBuffer* buffer) {}
+  // Called once the pool is unlocked again, after chunks may have been evicted.
+  virtual void processEvictedChunks() {}
+  // Fills the buffer just created for the chunk, still empty, from the copy kept by
+  // cacheEvictedChunk instead of the parent manager. Returns false if there's no such
+  // copy, or if it's stale.
+  virtual bool restoreEvictedChunk(const ChunkKey& key,
+                                   AbstractBuffer* buffer,
+                                   const size_t num_bytes) {
+    return false;
+  }
+  // Discards the copies of the evicted chunks whose key starts with the prefix.
+  virtual void dropEvictedChunks(const ChunkKey& key_prefix) {}
   std::mutex chunk_index_mutex_;
   std::mutex sized_segs_mutex_;
   std::mutex unsized_segs_mutex_;
   std::mutex buffer_id_mutex_;
   std::mutex global_mutex_;
 
-  std::map<ChunkKey, BufferList::iterator> chunk_index_;
+  std::unordered_map<ChunkKey, BufferList::iterator, boost::hash<ChunkKey>> chunk_index_;
+
+  // Orders the free segments of all slabs by size, then by position. The size-only
+  // overloads allow looking up the smallest free segment which fits a request.
+  struct FreeSegmentOrder {
+    using is_transparent = void;
+
+    bool operator()(const BufferList::iterator& lhs,
+                    const BufferList::iterator& rhs) const {
+      return std::tie(lhs->num_pages, lhs->slab_num, lhs->start_page) <
+             std::tie(rhs->num_pages, rhs->slab_num, rhs->start_page);
+    }
+
+    bool operator()(const BufferList::iterator& seg_it, const size_t num_pages) const {
+      return seg_it->num_pages < num_pages;
+    }
+
+    bool operator()(const size_t num_pages, const BufferList::iterator& seg_it) const {
+      return num_pages < seg_it->num_pages;
+    }
+  };
+  // Index of the FREE segments in slab_segments_. A segment must be removed from the
+  // index before its size or position changes and added back afterwards.
+  std::set<BufferList::iterator, FreeSegmentOrder> free_segments_;
+
+  // Orders the USED segments of all slabs by the time they were last touched, least
+  // recently used first, then by position.
+  struct LastTouchedOrder {
+    bool operator()(const BufferList::iterator& lhs,
+                    const BufferList::iterator& rhs) const {
+      return std::tie(lhs->last_touched, lhs->slab_num, lhs->start_page) <
+             std::tie(rhs->last_touched, rhs->slab_num, rhs->start_page);
+    }
+  };
+  // Index of the USED segments in slab_segments_, the eviction candidates. Same rules as
+  // free_segments_, a touch changes the position of a segment in the index.
+  std::set<BufferList::iterator, LastTouchedOrder> used_segments_;
   size_t max_buffer_size_;  /// max number of bytes allocated for the buffer pool
   size_t max_num_pages_;
   size_t num_pages_allocated_;
@@ -204,7 +281,6 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   size_t max_slab_size_;  /// size of the individual memory allocations that compose the
                           /// buffer pool (up to maxBufferSize_)
   bool allocations_capped_;
-  AbstractBufferMgr* parent_mgr_;
   int max_buffer_id_;
   unsigned int buffer_epoch_;
 
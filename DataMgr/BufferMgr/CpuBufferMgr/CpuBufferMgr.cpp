@@ -18,39 +18,385 @@
 
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/BufferMgr/CpuBufferMgr/CpuBuffer.h"
+#include "DataMgr/FileMgr/GlobalFileMgr.h"
+#include "Shared/Compressor.h"
+#include "Shared/Logger.h"
+
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
 
 namespace Buffer_Namespace {
 
+namespace {
+
+constexpr size_t huge_page_size{2 * 1024 * 1024};
+constexpr size_t node_mask_word_bits{8 * sizeof(unsigned long)};
+
+#ifdef __linux__
+// Same value as in <numaif.h>, which is only shipped along with libnuma.
+constexpr int mpol_interleave{3};
+
+std::vector<unsigned long> get_online_numa_nodes_mask(size_t& node_count) {
+  node_count = 0;
+  std::ifstream online_nodes_file("/sys/devices/system/node/online");
+  std::string online_nodes;
+  if (!online_nodes_file || !std::getline(online_nodes_file, online_nodes)) {
+    return {};
+  }
+  return parse_numa_node_list(online_nodes, node_count);
+}
+#endif  // __linux__
+
+}  // namespace
+
+std::vector<unsigned long> parse_numa_node_list(const std::string& node_list,
+                                                size_t& node_count) {
+  node_count = 0;
+  std::vector<std::string> node_ranges;
+  boost::split(node_ranges, boost::trim_copy(node_list), boost::is_any_of(","));
+  std::vector<unsigned long> mask;
+  try {
+    for (const auto& node_range : node_ranges) {
+      if (node_range.empty()) {
+        continue;
+      }
+      const auto dash_pos = node_range.find('-');
+      const size_t first_node = std::stoul(node_range.substr(0, dash_pos));
+      const size_t last_node = dash_pos == std::string::npos
+                                   ? first_node
+                                   : std::stoul(node_range.substr(dash_pos + 1));
+      for (size_t node = first_node; node <= last_node; ++node) {
+        const auto word_idx = node / node_mask_word_bits;
+        if (word_idx >= mask.size()) {
+          mask.resize(word_idx + 1, 0);
+        }
+        if (!(mask[word_idx] & (1UL << (node % node_mask_word_bits)))) {
+          mask[word_idx] |= 1UL << (node % node_mask_word_bits);
+          ++node_count;
+        }
+      }
+    }
+  } catch (const std::exception&) {
+    LOG(WARNING) << "Could not parse the NUMA node list " << node_list;
+    node_count = 0;
+    return {};
+  }
+  return mask;
+}
+
 CpuBufferMgr::CpuBufferMgr(const int device_id,
                            const size_t max_buffer_size,
                            CudaMgr_Namespace::CudaMgr* cuda_mgr,
                            const size_t buffer_alloc_increment,
                            const size_t page_size,
-                           AbstractBufferMgr* parent_mgr)
+                           AbstractBufferMgr* parent_mgr,
+                           const bool use_huge_pages,
+                           const bool numa_interleave,
+                           const bool mmap_reads,
+                           const size_t compressed_cache_size)
     : BufferMgr(device_id, max_buffer_size, buffer_alloc_increment, page_size, parent_mgr)
-    , cuda_mgr_(cuda_mgr) {}
+    , cuda_mgr_(cuda_mgr)
+    , use_huge_pages_(use_huge_pages)
+    , file_mgr_(mmap_reads ? dynamic_cast<File_Namespace::GlobalFileMgr*>(parent_mgr)
+                           : nullptr)
+    , evicted_chunks_size_(0)
+    , max_evicted_chunks_size_(compressed_cache_size)
+    , num_restored_chunks_(0) {
+  if (mmap_reads && !file_mgr_) {
+    LOG(WARNING) << "Mapping chunks requires the file manager as parent of the CPU "
+                    "buffer pool, reading them instead";
+  }
+  if (compressed_cache_size) {
+    LOG(INFO) << "Keeping up to " << compressed_cache_size
+              << " bytes of compressed chunks evicted from the CPU buffer pool";
+    compressed_chunks_.reset(new EvictedChunkCache(
+        std::numeric_limits<size_t>::max(),
+        EvictedChunkCache::default_shard_count,
+        compressed_cache_size,
+        [](const EvictedChunk& evicted_chunk) { return evicted_chunk.data.size(); }));
+  }
+  if (numa_interleave) {
+#ifdef __linux__
+    size_t node_count{0};
+    auto node_mask = get_online_numa_nodes_mask(node_count);
+    if (node_count > 1) {
+      LOG(INFO) << "Interleaving CPU buffer pool slabs across " << node_count
+                << " NUMA nodes";
+      numa_interleave_mask_ = std::move(node_mask);
+    }
+#else
+    LOG(WARNING) << "NUMA interleaving of the CPU buffer pool is only supported on Linux";
+#endif  // __linux__
+  }
+}
 
 CpuBufferMgr::~CpuBufferMgr() {
   freeAllMem();
 }
 
+int8_t* CpuBufferMgr::mapSlab(const size_t mapping_size, bool& huge_tlb) const {
+  void* slab{MAP_FAILED};
+#ifdef __linux__
+  if (use_huge_pages_) {
+    // Fails unless enough explicit huge pages have been reserved (vm.nr_hugepages)
+    slab = mmap(nullptr,
+                mapping_size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                -1,
+                0);
+  }
+#endif  // __linux__
+  huge_tlb = slab != MAP_FAILED;
+  if (slab == MAP_FAILED) {
+    slab = mmap(
+        nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (slab == MAP_FAILED) {
+      return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    if (use_huge_pages_ && madvise(slab, mapping_size, MADV_HUGEPAGE)) {
+      LOG(WARNING) << "Transparent huge pages are not available for the CPU buffer pool";
+    }
+#endif  // MADV_HUGEPAGE
+  }
+#ifdef __linux__
+  // The policy applies to the pages as they get faulted in, nothing has been touched yet
+  if (!numa_interleave_mask_.empty() &&
+      syscall(SYS_mbind,
+              slab,
+              mapping_size,
+              mpol_interleave,
+              numa_interleave_mask_.data(),
+              numa_interleave_mask_.size() * node_mask_word_bits + 1,
+              0)) {
+    LOG(WARNING) << "Could not interleave a CPU buffer pool slab across NUMA nodes";
+  }
+#endif  // __linux__
+  return static_cast<int8_t*>(slab);
+}
+
 void CpuBufferMgr::addSlab(const size_t slab_size) {
-  slabs_.resize(slabs_.size() + 1);
-  try {
-    slabs_.back() = new int8_t[slab_size];
-  } catch (std::bad_alloc&) {
-    slabs_.resize(slabs_.size() - 1);
+  const auto mapping_size =
+      use_huge_pages_ ? (slab_size + huge_page_size - 1) / huge_page_size * huge_page_size
+                      : slab_size;
+  bool huge_tlb{false};
+  auto slab = mapSlab(mapping_size, huge_tlb);
+  if (!slab) {
     throw FailedToCreateSlab(slab_size);
   }
+  if (huge_tlb) {
+    ++num_huge_tlb_slabs_;
+  }
+  slabs_.push_back(slab);
+  slab_mapping_sizes_.push_back(mapping_size);
   slab_segments_.resize(slab_segments_.size() + 1);
   slab_segments_[slab_segments_.size() - 1].push_back(
       BufferSeg(0, slab_size / page_size_));
 }
 
 void CpuBufferMgr::freeAllMem() {
-  for (auto buf_it = slabs_.begin(); buf_it != slabs_.end(); ++buf_it) {
-    delete[] * buf_it;
+  CHECK_EQ(slabs_.size(), slab_mapping_sizes_.size());
+  for (size_t slab_idx = 0; slab_idx < slabs_.size(); ++slab_idx) {
+    munmap(slabs_[slab_idx], slab_mapping_sizes_[slab_idx]);
+  }
+  slab_mapping_sizes_.clear();
+  num_huge_tlb_slabs_ = 0;
+  std::lock_guard<std::mutex> mapped_chunks_lock(mapped_chunks_mutex_);
+  for (const auto& mapped_chunk : mapped_chunks_) {
+    munmap(mapped_chunk.second.mappingAddr, mapped_chunk.second.mappingSize);
+  }
+  mapped_chunks_.clear();
+}
+
+int8_t* CpuBufferMgr::mapChunk(const ChunkKey& key,
+                               const size_t num_bytes,
+                               AbstractBuffer*& parent_buffer) {
+  if (!file_mgr_) {
+    return nullptr;
+  }
+  File_Namespace::MappedChunk mapped_chunk;
+  parent_buffer = file_mgr_->mapChunk(key, num_bytes, mapped_chunk);
+  if (!parent_buffer) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> mapped_chunks_lock(mapped_chunks_mutex_);
+  const auto inserted = mapped_chunks_.emplace(key, mapped_chunk).second;
+  CHECK(inserted);
+  return mapped_chunk.data;
+}
+
+void CpuBufferMgr::unmapChunk(const ChunkKey& key) {
+  std::lock_guard<std::mutex> mapped_chunks_lock(mapped_chunks_mutex_);
+  auto mapped_chunk_it = mapped_chunks_.find(key);
+  if (mapped_chunk_it == mapped_chunks_.end()) {
+    return;
+  }
+  munmap(mapped_chunk_it->second.mappingAddr, mapped_chunk_it->second.mappingSize);
+  mapped_chunks_.erase(mapped_chunk_it);
+}
+
+void CpuBufferMgr::cacheEvictedChunk(const ChunkKey& key, AbstractBuffer* buffer) {
+  if (!compressed_chunks_ || key.empty() || key[0] == -1) {
+    return;
+  }
+  // Older copies of the chunk are replaced, or dropped if the chunk isn't kept
+  std::lock_guard<std::mutex> evicted_chunks_lock(evicted_chunks_mutex_);
+  compressed_chunks_->erase(key);
+  for (auto it = evicted_chunks_.begin(); it != evicted_chunks_.end(); ++it) {
+    if (it->first == key) {
+      evicted_chunks_size_ -= it->second->size;
+      evicted_chunks_.erase(it);
+      break;
+    }
+  }
+  // Changes not checkpointed yet are lost by the eviction, the parent has the current
+  // data.
+  const auto num_bytes = buffer->size();
+  if (buffer->isDirty() || num_bytes == 0 ||
+      evicted_chunks_size_ + num_bytes > max_evicted_chunks_size_) {
+    return;
+  }
+  // Only copies the data, the pool is locked
+  const auto mem = reinterpret_cast<const uint8_t*>(buffer->getMemoryPtr());
+  evicted_chunks_.emplace_back(
+      key,
+      std::make_shared<EvictedChunk>(
+          EvictedChunk{std::vector<uint8_t>(mem, mem + num_bytes),
+                       num_bytes,
+                       File_Namespace::FileBuffer::currentUpdateVersion()}));
+  evicted_chunks_size_ += num_bytes;
+}
+
+void CpuBufferMgr::processEvictedChunks() {
+  if (!compressed_chunks_) {
+    return;
+  }
+  std::unique_lock<std::mutex> evicted_chunks_lock(evicted_chunks_mutex_);
+  while (!evicted_chunks_.empty()) {
+    const auto key = evicted_chunks_.front().first;
+    const auto evicted_chunk = evicted_chunks_.front().second;
+    evicted_chunks_.pop_front();
+    evicted_chunks_size_ -= evicted_chunk->size;
+    evicted_chunks_lock.unlock();
+    std::vector<uint8_t> compressed_data(evicted_chunk->size);
+    int64_t compressed_size{0};
+    try {
+      // Fails if the data doesn't compress to less than its size
+      compressed_size =
+          BloscCompressor::getCompressor()->compress(evicted_chunk->data.data(),
+                                                     evicted_chunk->size,
+                                                     compressed_data.data(),
+                                                     evicted_chunk->size,
+                                                     0);
+    } catch (const CompressionFailedError&) {
+    }
+    if (compressed_size > 0) {
+      compressed_data.resize(compressed_size);
+      compressed_data.shrink_to_fit();
+      evicted_chunk->data = std::move(compressed_data);
+      // A copy put in the tier after the chunk has been loaded again, or dropped, is
+      // rejected as stale once the chunk gets updated
+      compressed_chunks_->put(key, evicted_chunk);
+    }
+    evicted_chunks_lock.lock();
+  }
+}
+
+bool CpuBufferMgr::restoreEvictedChunk(const ChunkKey& key,
+                                       AbstractBuffer* buffer,
+                                       const size_t num_bytes) {
+  if (!compressed_chunks_) {
+    return false;
+  }
+  EvictedChunkCache::value_ptr_t evicted_chunk;
+  bool compressed{false};
+  {
+    std::lock_guard<std::mutex> evicted_chunks_lock(evicted_chunks_mutex_);
+    for (auto it = evicted_chunks_.begin(); it != evicted_chunks_.end(); ++it) {
+      if (it->first == key) {
+        evicted_chunk = it->second;
+        evicted_chunks_size_ -= evicted_chunk->size;
+        evicted_chunks_.erase(it);
+        break;
+      }
+    }
+  }
+  if (!evicted_chunk) {
+    evicted_chunk = compressed_chunks_->get(key);
+    if (!evicted_chunk) {
+      return false;
+    }
+    compressed_chunks_->erase(key);
+    compressed = true;
+  }
+  if (!parent_mgr_->isBufferOnDevice(key)) {
+    return false;
+  }
+  const auto parent_buffer =
+      dynamic_cast<File_Namespace::FileBuffer*>(parent_mgr_->getBuffer(key));
+  if (!parent_buffer ||
+      parent_buffer->lastUpdateVersion() > evicted_chunk->update_version) {
+    return false;
+  }
+  const auto chunk_size = num_bytes == 0 ? parent_buffer->size() : num_bytes;
+  if (evicted_chunk->size > chunk_size || chunk_size > parent_buffer->size()) {
+    return false;
+  }
+  buffer->reserve(evicted_chunk->size);
+  if (compressed) {
+    try {
+      BloscCompressor::getCompressor()->decompress(
+          evicted_chunk->data.data(),
+          reinterpret_cast<uint8_t*>(buffer->getMemoryPtr()),
+          evicted_chunk->size);
+    } catch (const CompressionFailedError& e) {
+      LOG(WARNING) << "Could not restore an evicted chunk of the CPU buffer pool: "
+                   << e.what();
+      return false;
+    }
+  } else {
+    std::memcpy(buffer->getMemoryPtr(), evicted_chunk->data.data(), evicted_chunk->size);
+  }
+  buffer->setSize(evicted_chunk->size);
+  if (evicted_chunk->size < chunk_size) {
+    // Only reads the data appended to the chunk since it has been evicted
+    parent_mgr_->fetchBuffer(key, buffer, chunk_size);
+  } else {
+    buffer->syncEncoder(parent_buffer);
+  }
+  ++num_restored_chunks_;
+  return true;
+}
+
+void CpuBufferMgr::dropEvictedChunks(const ChunkKey& key_prefix) {
+  if (!compressed_chunks_) {
+    return;
+  }
+  const auto has_prefix = [&key_prefix](const ChunkKey& key) {
+    return key.size() >= key_prefix.size() &&
+           std::equal(key_prefix.begin(), key_prefix.end(), key.begin());
+  };
+  std::lock_guard<std::mutex> evicted_chunks_lock(evicted_chunks_mutex_);
+  for (auto it = evicted_chunks_.begin(); it != evicted_chunks_.end();) {
+    if (has_prefix(it->first)) {
+      evicted_chunks_size_ -= it->second->size;
+      it = evicted_chunks_.erase(it);
+    } else {
+      ++it;
+    }
   }
+  compressed_chunks_->eraseIf(has_prefix);
 }
 
 void CpuBufferMgr::allocateBuffer(BufferList::iterator seg_it,
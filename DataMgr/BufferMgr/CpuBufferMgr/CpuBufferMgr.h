@@ -17,13 +17,33 @@
 #pragma once
 
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/FileMgr/FileMgr.h"
+#include "StringDictionary/ConcurrentLruCache.hpp"
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace CudaMgr_Namespace {
 class CudaMgr;
 }
 
+namespace File_Namespace {
+class GlobalFileMgr;
+}
+
 namespace Buffer_Namespace {
 
+// Parses a list of NUMA nodes in the format of /sys/devices/system/node/online, for
+// example "0-1,3", into a node mask for mbind. Returns an empty mask and no nodes if
+// the list is malformed.
+std::vector<unsigned long> parse_numa_node_list(const std::string& node_list,
+                                                size_t& node_count);
+
 class CpuBufferMgr : public BufferMgr {
  public:
   CpuBufferMgr(const int device_id,
@@ -31,19 +51,83 @@ class CpuBufferMgr : public BufferMgr {
                CudaMgr_Namespace::CudaMgr* cuda_mgr,
                const size_t buffer_alloc_increment = 2147483648,
                const size_t page_size = 512,
-               AbstractBufferMgr* parent_mgr = 0);
+               AbstractBufferMgr* parent_mgr = 0,
+               const bool use_huge_pages = false,
+               const bool numa_interleave = false,
+               const bool mmap_reads = false,
+               const size_t compressed_cache_size = 0);
   inline MgrType getMgrType() override { return CPU_MGR; }
   inline std::string getStringMgrType() override { return ToString(CPU_MGR); }
   ~CpuBufferMgr() override;
 
+  // Returns the number of chunks filled from the compressed tier instead of the parent.
+  size_t getNumRestoredChunks() const { return num_restored_chunks_; }
+
+  // Returns the number of chunks whose buffer uses the memory of a mapped data file.
+  size_t getNumMappedChunks() {
+    std::lock_guard<std::mutex> mapped_chunks_lock(mapped_chunks_mutex_);
+    return mapped_chunks_.size();
+  }
+
+  // Returns the number of slabs backed by explicit huge pages.
+  size_t getNumHugeTlbSlabs() const { return num_huge_tlb_slabs_; }
+
  private:
   void addSlab(const size_t slab_size) override;
   void freeAllMem() override;
   void allocateBuffer(BufferList::iterator segment_iter,
                       const size_t page_size,
                       const size_t initial_size) override;
+  // Sets huge_tlb if the slab is backed by explicit huge pages.
+  int8_t* mapSlab(const size_t mapping_size, bool& huge_tlb) const;
+  int8_t* mapChunk(const ChunkKey& key,
+                   const size_t num_bytes,
+                   AbstractBuffer*& parent_buffer) override;
+  void unmapChunk(const ChunkKey& key) override;
+  void cacheEvictedChunk(const ChunkKey& key, AbstractBuffer* buffer) override;
+  void processEvictedChunks() override;
+  bool restoreEvictedChunk(const ChunkKey& key,
+                           AbstractBuffer* buffer,
+                           const size_t num_bytes) override;
+  void dropEvictedChunks(const ChunkKey& key_prefix) override;
 
   CudaMgr_Namespace::CudaMgr* cuda_mgr_;
+  // Back the slabs with explicit huge pages if the system has reserved enough of them,
+  // transparent huge pages otherwise.
+  const bool use_huge_pages_;
+  // Mask of the online NUMA nodes to interleave the slab pages across, empty if the
+  // pages are placed on the node of the thread which first touches them.
+  std::vector<unsigned long> numa_interleave_mask_;
+  std::vector<size_t> slab_mapping_sizes_;
+  size_t num_huge_tlb_slabs_{0};
+  // Set when chunks are mapped from the data files instead of read into the slabs, the
+  // OS page cache then holds the only copy of their data.
+  File_Namespace::GlobalFileMgr* file_mgr_;
+  std::map<ChunkKey, File_Namespace::MappedChunk> mapped_chunks_;
+  std::mutex mapped_chunks_mutex_;
+
+  struct EvictedChunk {
+    std::vector<uint8_t> data;
+    size_t size;
+    // Latest FileBuffer update version when the chunk was evicted, the copy is stale
+    // once the parent's buffer has been updated since.
+    uint64_t update_version;
+  };
+  using EvictedChunkCache =
+      ConcurrentLruCache<ChunkKey, EvictedChunk, boost::hash<ChunkKey>>;
+  // Second tier of the pool, holds clean chunks evicted from the slabs compressed with
+  // Blosc, up to the given compressed size. Chunks found here are decompressed back
+  // into a slab instead of being read from the parent, and leave the tier. Null if the
+  // tier is disabled.
+  std::unique_ptr<EvictedChunkCache> compressed_chunks_;
+  // Chunks copied out of the slabs by cacheEvictedChunk, not compressed yet. The pool
+  // is locked while chunks get evicted, processEvictedChunks compresses them into the
+  // tier afterwards. Holds up to the size of the tier.
+  std::list<std::pair<ChunkKey, EvictedChunkCache::value_ptr_t>> evicted_chunks_;
+  size_t evicted_chunks_size_;
+  const size_t max_evicted_chunks_size_;
+  std::mutex evicted_chunks_mutex_;
+  std::atomic<size_t> num_restored_chunks_;
 };
 
 }  // namespace Buffer_Namespace
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    BufferMgrBench.cpp
+ * @brief   Microbenchmarks for the allocation, eviction and lookup paths of the
+ *          buffer pool.
+ *
+ * The pool is a CPU buffer manager without a parent, filled with the given number of
+ * resident chunks of random sizes. Buffers are never written, so the slab memory is
+ * mapped but mostly not touched.
+ */
+
+#include "BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace Buffer_Namespace;
+
+namespace {
+
+constexpr size_t kPageSize{64};
+constexpr size_t kMaxChunkPages{16};
+constexpr size_t kSlabSize{size_t(64) << 20};
+constexpr uint64_t kSeed{42};
+
+ChunkKey make_key(const int chunk_id) {
+  return {1, 1, 1, chunk_id};
+}
+
+// Creates chunk_count unpinned chunks of 1 to kMaxChunkPages pages.
+std::vector<ChunkKey> fill_pool(CpuBufferMgr& buffer_mgr,
+                                const size_t chunk_count,
+                                std::mt19937_64& gen) {
+  std::uniform_int_distribution<size_t> pages_dist(1, kMaxChunkPages);
+  std::vector<ChunkKey> keys;
+  keys.reserve(chunk_count);
+  for (size_t i = 0; i < chunk_count; ++i) {
+    keys.push_back(make_key(i));
+    auto buffer =
+        buffer_mgr.createBuffer(keys.back(), kPageSize, pages_dist(gen) * kPageSize);
+    buffer->unPin();
+  }
+  return keys;
+}
+
+}  // namespace
+
+// Allocates and frees a chunk in a fragmented pool: every other resident chunk is
+// deleted up front, which leaves as many free segments as there are resident chunks.
+static void BM_AllocFree(benchmark::State& state) {
+  const size_t chunk_count = state.range(0);
+  CpuBufferMgr buffer_mgr(0, 4 * kSlabSize, nullptr, kSlabSize, kPageSize);
+  std::mt19937_64 gen(kSeed);
+  const auto keys = fill_pool(buffer_mgr, chunk_count, gen);
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    buffer_mgr.deleteBuffer(keys[i]);
+  }
+  std::uniform_int_distribution<size_t> pages_dist(1, kMaxChunkPages);
+  const auto key = make_key(chunk_count);
+  for (auto _ : state) {
+    buffer_mgr.createBuffer(key, kPageSize, pages_dist(gen) * kPageSize);
+    buffer_mgr.deleteBuffer(key);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AllocFree)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17);
+
+// Creates chunks in a pool which has no free space left, each allocation evicts the
+// least recently touched resident chunks.
+static void BM_EvictingAlloc(benchmark::State& state) {
+  const size_t chunk_count = state.range(0);
+  const size_t pool_size = chunk_count * kPageSize * (kMaxChunkPages + 1) / 2;
+  const size_t slab_size = (pool_size + kPageSize - 1) / kPageSize * kPageSize;
+  CpuBufferMgr buffer_mgr(0, slab_size, nullptr, slab_size, kPageSize);
+  std::mt19937_64 gen(kSeed);
+  fill_pool(buffer_mgr, chunk_count, gen);
+  std::uniform_int_distribution<size_t> pages_dist(1, kMaxChunkPages);
+  int chunk_id = chunk_count;
+  for (auto _ : state) {
+    auto buffer = buffer_mgr.createBuffer(
+        make_key(chunk_id++), kPageSize, pages_dist(gen) * kPageSize);
+    buffer->unPin();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EvictingAlloc)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17);
+
+static void BM_ChunkLookup(benchmark::State& state) {
+  const size_t chunk_count = state.range(0);
+  CpuBufferMgr buffer_mgr(0, 4 * kSlabSize, nullptr, kSlabSize, kPageSize);
+  std::mt19937_64 gen(kSeed);
+  const auto keys = fill_pool(buffer_mgr, chunk_count, gen);
+  std::uniform_int_distribution<size_t> key_dist(0, 2 * chunk_count - 1);
+  std::vector<ChunkKey> probe_keys;
+  for (size_t i = 0; i < 4096; ++i) {
+    probe_keys.push_back(make_key(key_dist(gen)));
+  }
+  for (auto _ : state) {
+    size_t hit_count{0};
+    for (const auto& probe_key : probe_keys) {
+      hit_count += buffer_mgr.isBufferOnDevice(probe_key);
+    }
+    benchmark::DoNotOptimize(hit_count);
+  }
+  state.SetItemsProcessed(state.iterations() * probe_keys.size());
+}
+BENCHMARK(BM_ChunkLookup)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17);
+
+BENCHMARK_MAIN();
@@ -113,8 +113,17 @@ void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
     LOG(INFO) << "reserved GPU memory is " << (float)reservedGpuMem_ / (1024 * 1024)
               << "M includes render buffer allocation";
     bufferMgrs_.resize(3);
-    bufferMgrs_[1].push_back(new CpuBufferMgr(
-        0, cpuBufferSize, cudaMgr_.get(), cpuSlabSize, 512, bufferMgrs_[0][0]));
+    bufferMgrs_[1].push_back(
+        new CpuBufferMgr(0,
+                         cpuBufferSize,
+                         cudaMgr_.get(),
+                         cpuSlabSize,
+                         512,
+                         bufferMgrs_[0][0],
+                         mapd_parameters.cpu_buffer_huge_pages,
+                         mapd_parameters.cpu_buffer_numa_interleave,
+                         mapd_parameters.cpu_buffer_mmap_reads,
+                         mapd_parameters.cpu_buffer_compressed_cache_bytes));
     levelSizes_.push_back(1);
     int numGpus = cudaMgr_->getDeviceCount();
     for (int gpuNum = 0; gpuNum < numGpus; ++gpuNum) {
@@ -130,8 +139,17 @@ void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
     }
     levelSizes_.push_back(numGpus);
   } else {
-    bufferMgrs_[1].push_back(new CpuBufferMgr(
-        0, cpuBufferSize, cudaMgr_.get(), cpuSlabSize, 512, bufferMgrs_[0][0]));
+    bufferMgrs_[1].push_back(
+        new CpuBufferMgr(0,
+                         cpuBufferSize,
+                         cudaMgr_.get(),
+                         cpuSlabSize,
+                         512,
+                         bufferMgrs_[0][0],
+                         mapd_parameters.cpu_buffer_huge_pages,
+                         mapd_parameters.cpu_buffer_numa_interleave,
+                         mapd_parameters.cpu_buffer_mmap_reads,
+                         mapd_parameters.cpu_buffer_compressed_cache_bytes));
     levelSizes_.push_back(1);
   }
 }
@@ -320,6 +338,36 @@ bool DataMgr::isBufferOnDevice(const ChunkKey& key,
   return bufferMgrs_[memLevel][deviceId]->isBufferOnDevice(key);
 }
 
+std::vector<std::pair<ChunkKey, size_t>> DataMgr::getHotCpuChunks() {
+  auto cpu_buffer_mgr =
+      dynamic_cast<CpuBufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpu_buffer_mgr);
+  return cpu_buffer_mgr->getHotChunks();
+}
+
+size_t DataMgr::preloadCpuChunk(const ChunkKey& key, const size_t num_bytes) {
+  auto cpu_buffer_mgr = bufferMgrs_[MemoryLevel::CPU_LEVEL][0];
+  auto disk_buffer_mgr = bufferMgrs_[MemoryLevel::DISK_LEVEL][0];
+  if (cpu_buffer_mgr->isBufferOnDevice(key) || !disk_buffer_mgr->isBufferOnDevice(key)) {
+    return 0;
+  }
+  // the chunk may have shrunk since it was recorded
+  const auto preload_bytes = std::min(num_bytes, disk_buffer_mgr->getBuffer(key)->size());
+  if (!preload_bytes) {
+    return 0;
+  }
+  auto buffer = cpu_buffer_mgr->getBuffer(key, preload_bytes);
+  buffer->unPin();
+  return preload_bytes;
+}
+
+size_t DataMgr::getCpuBufferPoolSize() {
+  auto cpu_buffer_mgr =
+      dynamic_cast<CpuBufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpu_buffer_mgr);
+  return cpu_buffer_mgr->getMaxSize();
+}
+
 void DataMgr::getChunkMetadataVec(
     std::vector<std::pair<ChunkKey, ChunkMetadata>>& chunkMetadataVec) {
   // Can we always assume this will just be at the disklevel bc we just
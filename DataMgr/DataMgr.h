@@ -96,6 +96,11 @@ class DataMgr {
                         const MemoryLevel memLevel,
                         const int deviceId);
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
+  // returns the chunks resident in the CPU buffer pool, most accessed first
+  std::vector<std::pair<ChunkKey, size_t>> getHotCpuChunks();
+  // loads up to num_bytes of a chunk into the CPU buffer pool, returns the bytes read
+  size_t preloadCpuChunk(const ChunkKey& key, const size_t num_bytes);
+  size_t getCpuBufferPoolSize();
   std::string dumpLevel(const MemoryLevel memLevel);
   void clearMemory(const MemoryLevel memLevel);
 
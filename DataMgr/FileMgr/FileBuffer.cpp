@@ -35,6 +35,7 @@ using namespace std;
 
 namespace File_Namespace {
 size_t FileBuffer::headerBufferOffset_ = 32;
+std::atomic<uint64_t> FileBuffer::updateVersion_{0};
 
 FileBuffer::FileBuffer(FileMgr* fm,
                        const size_t pageSize,
@@ -48,6 +49,7 @@ FileBuffer::FileBuffer(FileMgr* fm,
   // Create a new FileBuffer
   CHECK(fm_);
   calcHeaderBuffer();
+  takeUpdateVersion();
   pageDataSize_ = pageSize_ - reservedHeaderSize_;
   //@todo reintroduce initialSize - need to develop easy way of
   // differentiating these pre-allocated pages from "written-to" pages
@@ -76,6 +78,7 @@ FileBuffer::FileBuffer(FileMgr* fm,
     , chunkKey_(chunkKey) {
   CHECK(fm_);
   calcHeaderBuffer();
+  takeUpdateVersion();
   pageDataSize_ = pageSize_ - reservedHeaderSize_;
 }
 
@@ -92,6 +95,7 @@ FileBuffer::FileBuffer(FileMgr* fm,
 
   CHECK(fm_);
   calcHeaderBuffer();
+  takeUpdateVersion();
   // MultiPage multiPage(pageSize_); // why was this here?
   int lastPageId = -1;
   // Page lastMetadataPage;
@@ -132,6 +136,11 @@ FileBuffer::FileBuffer(FileMgr* fm,
   // size_ = lastHeaderIt->chunkSize;
 }
 
+void FileBuffer::setUpdated() {
+  AbstractBuffer::setUpdated();
+  takeUpdateVersion();
+}
+
 FileBuffer::~FileBuffer() {
   // need to free pages
   // NOP
@@ -510,6 +519,7 @@ void FileBuffer::write(int8_t* src,
   is_dirty_ = true;
   if (offset < size_) {
     is_updated_ = true;
+    takeUpdateVersion();
   }
   bool tempIsAppended = false;
 
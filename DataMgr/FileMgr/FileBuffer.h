@@ -25,6 +25,7 @@
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/FileMgr/Page.h"
 
+#include <atomic>
 #include <iostream>
 #include <stdexcept>
 
@@ -148,6 +149,16 @@ class FileBuffer : public AbstractBuffer {
   /// flush/checkpoint.
   bool isDirty() const override { return is_dirty_; }
 
+  void setUpdated() override;
+
+  /// Returns the update version taken when the bytes already in the FileBuffer were
+  /// last overwritten, or when the FileBuffer was created. Appends leave it unchanged.
+  uint64_t lastUpdateVersion() const { return lastUpdateVersion_; }
+
+  /// Returns the latest update version taken by any FileBuffer. Update versions only
+  /// grow, unlike the epochs of the tables which are rolled back.
+  static uint64_t currentUpdateVersion() { return updateVersion_; }
+
  private:
   // FileBuffer(const FileBuffer&);      // private copy constructor
   // FileBuffer& operator=(const FileBuffer&); // private overloaded assignment operator
@@ -163,6 +174,7 @@ class FileBuffer : public AbstractBuffer {
   void writeMetadata(const int epoch);
   void readMetadata(const Page& page);
   void calcHeaderBuffer();
+  void takeUpdateVersion() { lastUpdateVersion_ = ++updateVersion_; }
 
   FileMgr* fm_;  // a reference to FileMgr is needed for writing to new pages in available
                  // files
@@ -173,6 +185,8 @@ class FileBuffer : public AbstractBuffer {
   size_t pageDataSize_;
   size_t reservedHeaderSize_;  // lets make this a constant now for simplicity - 128 bytes
   ChunkKey chunkKey_;
+  static std::atomic<uint64_t> updateVersion_;
+  std::atomic<uint64_t> lastUpdateVersion_;
 };
 
 }  // namespace File_Namespace
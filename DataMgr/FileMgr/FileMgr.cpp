@@ -23,8 +23,10 @@
 #include "DataMgr/FileMgr/FileMgr.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <algorithm>
+#include <cstring>
 #include <future>
 #include <string>
 #include <thread>
@@ -41,11 +43,35 @@
 
 #define EPOCH_FILENAME "epoch"
 #define DB_META_FILENAME "dbmeta"
+#define HEADER_SNAPSHOT_FILENAME "header_snapshot"
 
 using namespace std;
 
 namespace File_Namespace {
 
+namespace {
+
+constexpr int HEADER_SNAPSHOT_VERSION{1};
+constexpr int STALE_HEADER_SNAPSHOT_EPOCH{-1};
+
+template <typename T>
+void appendToSnapshot(std::vector<int8_t>& snapshot, const T value) {
+  const auto valuePtr = reinterpret_cast<const int8_t*>(&value);
+  snapshot.insert(snapshot.end(), valuePtr, valuePtr + sizeof(T));
+}
+
+template <typename T>
+bool readFromSnapshot(const std::vector<int8_t>& snapshot, size_t& offset, T& value) {
+  if (offset + sizeof(T) > snapshot.size()) {
+    return false;
+  }
+  memcpy(&value, &snapshot[offset], sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+}  // namespace
+
 bool headerCompare(const HeaderInfo& firstElem, const HeaderInfo& secondElem) {
   // HeaderInfo.first is a pair of Chunk key with a vector containing
   // pageId and version
@@ -134,7 +160,8 @@ void FileMgr::init(const size_t num_reader_threads) {
       LOG(FATAL) << "Specified path '" << fileMgrBasePath_
                  << "' for table data is not a directory.";
     }
-    if (epoch_ != -1) {  // if opening at previous epoch
+    const bool openingAtLastCheckpoint = epoch_ == -1;
+    if (!openingAtLastCheckpoint) {  // if opening at previous epoch
       int epochCopy = epoch_;
       openEpochFile(EPOCH_FILENAME);
       epoch_ = epochCopy;
@@ -144,66 +171,80 @@ void FileMgr::init(const size_t num_reader_threads) {
 
     auto clock_begin = timer_start();
 
-    boost::filesystem::directory_iterator
-        endItr;  // default construction yields past-the-end
     int maxFileId = -1;
     int fileCount = 0;
-    int threadCount = std::thread::hardware_concurrency();
     std::vector<HeaderInfo> headerVec;
-    std::vector<std::future<std::vector<HeaderInfo>>> file_futures;
-    for (boost::filesystem::directory_iterator fileIt(path); fileIt != endItr; ++fileIt) {
-      if (boost::filesystem::is_regular_file(fileIt->status())) {
-        // note that boost::filesystem leaves preceding dot on
-        // extension - hence MAPD_FILE_EXT is ".mapd"
-        std::string extension(fileIt->path().extension().string());
-
-        if (extension == MAPD_FILE_EXT) {
-          std::string fileStem(fileIt->path().stem().string());
-          // remove trailing dot if any
-          if (fileStem.size() > 0 && fileStem.back() == '.') {
-            fileStem = fileStem.substr(0, fileStem.size() - 1);
-          }
-          size_t dotPos = fileStem.find_last_of(".");  // should only be one
-          if (dotPos == std::string::npos) {
-            LOG(FATAL) << "File `" << fileIt->path()
-                       << "` does not carry page size information in the filename.";
-          }
-          int fileId = boost::lexical_cast<int>(fileStem.substr(0, dotPos));
-          if (fileId > maxFileId) {
-            maxFileId = fileId;
-          }
-          size_t pageSize =
-              boost::lexical_cast<size_t>(fileStem.substr(dotPos + 1, fileStem.size()));
-          std::string filePath(fileIt->path().string());
-          size_t fileSize = boost::filesystem::file_size(filePath);
-          assert(fileSize % pageSize == 0);  // should be no partial pages
-          size_t numPages = fileSize / pageSize;
-
-          VLOG(4) << "File id: " << fileId << " Page size: " << pageSize
-                  << " Num pages: " << numPages;
-
-          file_futures.emplace_back(std::async(
-              std::launch::async, [filePath, fileId, pageSize, numPages, this] {
-                std::vector<HeaderInfo> tempHeaderVec;
-                openExistingFile(filePath, fileId, pageSize, numPages, tempHeaderVec);
-                return tempHeaderVec;
-              }));
-          fileCount++;
-          if (fileCount % threadCount == 0) {
-            processFileFutures(file_futures, headerVec);
+    // the header snapshot spares reading the header of every page, it can only be
+    // used when the files haven't changed since the clean shutdown which wrote it
+    openedFromHeaderSnapshot_ =
+        openingAtLastCheckpoint && openHeaderSnapshot(headerVec, maxFileId, fileCount);
+    // stamped stale before the first page change, so that a crash from here on
+    // falls back to the page scan
+    invalidateHeaderSnapshot();
+    if (!openedFromHeaderSnapshot_) {
+      boost::filesystem::directory_iterator
+          endItr;  // default construction yields past-the-end
+      int threadCount = std::thread::hardware_concurrency();
+      std::vector<std::future<std::vector<HeaderInfo>>> file_futures;
+      for (boost::filesystem::directory_iterator fileIt(path); fileIt != endItr;
+           ++fileIt) {
+        if (boost::filesystem::is_regular_file(fileIt->status())) {
+          // note that boost::filesystem leaves preceding dot on
+          // extension - hence MAPD_FILE_EXT is ".mapd"
+          std::string extension(fileIt->path().extension().string());
+
+          if (extension == MAPD_FILE_EXT) {
+            std::string fileStem(fileIt->path().stem().string());
+            // remove trailing dot if any
+            if (fileStem.size() > 0 && fileStem.back() == '.') {
+              fileStem = fileStem.substr(0, fileStem.size() - 1);
+            }
+            size_t dotPos = fileStem.find_last_of(".");  // should only be one
+            if (dotPos == std::string::npos) {
+              LOG(FATAL)
+                  << "File `" << fileIt->path()
+                  << "` does not carry page size information in the filename.";
+            }
+            int fileId = boost::lexical_cast<int>(fileStem.substr(0, dotPos));
+            if (fileId > maxFileId) {
+              maxFileId = fileId;
+            }
+            size_t pageSize = boost::lexical_cast<size_t>(
+                fileStem.substr(dotPos + 1, fileStem.size()));
+            std::string filePath(fileIt->path().string());
+            size_t fileSize = boost::filesystem::file_size(filePath);
+            assert(fileSize % pageSize == 0);  // should be no partial pages
+            size_t numPages = fileSize / pageSize;
+
+            VLOG(4) << "File id: " << fileId << " Page size: " << pageSize
+                    << " Num pages: " << numPages;
+
+            file_futures.emplace_back(std::async(
+                std::launch::async, [filePath, fileId, pageSize, numPages, this] {
+                  std::vector<HeaderInfo> tempHeaderVec;
+                  openExistingFile(
+                      filePath, fileId, pageSize, numPages, tempHeaderVec);
+                  return tempHeaderVec;
+                }));
+            fileCount++;
+            if (fileCount % threadCount == 0) {
+              processFileFutures(file_futures, headerVec);
+            }
           }
         }
       }
-    }
 
-    if (file_futures.size() > 0) {
-      processFileFutures(file_futures, headerVec);
+      if (file_futures.size() > 0) {
+        processFileFutures(file_futures, headerVec);
+      }
     }
     int64_t queue_time_ms = timer_stop(clock_begin);
 
-    LOG(INFO) << "Completed Reading table's file metadata, Elapsed time : "
-              << queue_time_ms << "ms Epoch: " << epoch_ << " files read: " << fileCount
-              << " table location: '" << fileMgrBasePath_ << "'";
+    LOG(INFO) << "Completed Reading table's file metadata"
+              << (openedFromHeaderSnapshot_ ? " from header snapshot" : "")
+              << ", Elapsed time : " << queue_time_ms << "ms Epoch: " << epoch_
+              << " files read: " << fileCount << " table location: '"
+              << fileMgrBasePath_ << "'";
 
     /* Sort headerVec so that all HeaderInfos
      * from a chunk will be grouped together
@@ -533,6 +574,244 @@ void FileMgr::writeAndSyncEpochToDisk() {
   ++epoch_;
 }
 
+void FileMgr::writeHeaderSnapshot() {
+  if (lastPageChangeEpoch_ >= epoch_) {
+    // the page headers changed since the last checkpoint
+    return;
+  }
+  std::vector<int8_t> snapshot;
+  appendToSnapshot(snapshot, HEADER_SNAPSHOT_VERSION);
+  appendToSnapshot(snapshot, epoch_ - 1);  // the epoch of the last checkpoint
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(files_rw_mutex_);
+    const auto numFiles = std::count_if(
+        files_.begin(), files_.end(), [](const FileInfo* f) { return f != nullptr; });
+    appendToSnapshot(snapshot, static_cast<size_t>(numFiles));
+    for (const auto fileInfo : files_) {
+      if (fileInfo) {
+        appendToSnapshot(snapshot, fileInfo->fileId);
+        appendToSnapshot(snapshot, fileInfo->pageSize);
+        appendToSnapshot(snapshot, fileInfo->numPages);
+      }
+    }
+  }
+  {
+    mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+    size_t numHeaders{0};
+    for (const auto& chunk : chunkIndex_) {
+      numHeaders += chunk.second->metadataPages_.pageVersions.size();
+      for (const auto& multiPage : chunk.second->multiPages_) {
+        numHeaders += multiPage.pageVersions.size();
+      }
+    }
+    appendToSnapshot(snapshot, numHeaders);
+    const auto appendHeader = [&snapshot](const ChunkKey& chunkKey,
+                                          const int pageId,
+                                          const MultiPage& multiPage) {
+      for (size_t i = 0; i < multiPage.pageVersions.size(); ++i) {
+        appendToSnapshot(snapshot, chunkKey.size());
+        for (const auto keyElem : chunkKey) {
+          appendToSnapshot(snapshot, keyElem);
+        }
+        appendToSnapshot(snapshot, pageId);
+        appendToSnapshot(snapshot, multiPage.epochs[i]);
+        appendToSnapshot(snapshot, multiPage.pageVersions[i].fileId);
+        appendToSnapshot(snapshot, multiPage.pageVersions[i].pageNum);
+      }
+    };
+    for (const auto& chunk : chunkIndex_) {
+      appendHeader(chunk.first, -1, chunk.second->metadataPages_);
+      for (size_t pageId = 0; pageId < chunk.second->multiPages_.size(); ++pageId) {
+        appendHeader(chunk.first, pageId, chunk.second->multiPages_[pageId]);
+      }
+    }
+  }
+
+  // the snapshot is only an optimization, failing to write it isn't fatal
+  const std::string snapshotPath(fileMgrBasePath_ + "/" + HEADER_SNAPSHOT_FILENAME);
+  const std::string tmpSnapshotPath(snapshotPath + ".tmp");
+  FILE* snapshotFile = fopen(tmpSnapshotPath.c_str(), "wb");
+  bool written = snapshotFile != nullptr;
+  if (snapshotFile) {
+    written = fwrite(snapshot.data(), 1, snapshot.size(), snapshotFile) ==
+                  snapshot.size() &&
+              fflush(snapshotFile) == 0 && fsync(fileno(snapshotFile)) == 0;
+    written = fclose(snapshotFile) == 0 && written;
+  }
+  boost::system::error_code ec;
+  if (written) {
+    boost::filesystem::rename(tmpSnapshotPath, snapshotPath, ec);
+    written = !ec;
+  }
+  if (!written) {
+    LOG(WARNING) << "Could not write header snapshot `" << snapshotPath << "`";
+    boost::filesystem::remove(tmpSnapshotPath, ec);
+  }
+}
+
+bool FileMgr::openHeaderSnapshot(std::vector<HeaderInfo>& headerVec,
+                                 int& maxFileId,
+                                 int& fileCount) {
+  const std::string snapshotPath(fileMgrBasePath_ + "/" + HEADER_SNAPSHOT_FILENAME);
+  boost::system::error_code ec;
+  const auto snapshotSize = boost::filesystem::file_size(snapshotPath, ec);
+  if (ec) {
+    return false;
+  }
+  std::vector<int8_t> snapshot(snapshotSize);
+  FILE* snapshotFile = fopen(snapshotPath.c_str(), "rb");
+  if (!snapshotFile) {
+    return false;
+  }
+  const bool read = fread(snapshot.data(), 1, snapshotSize, snapshotFile) == snapshotSize;
+  fclose(snapshotFile);
+  if (!read) {
+    return false;
+  }
+
+  size_t offset{0};
+  int version;
+  int epoch;
+  size_t numFiles;
+  if (!readFromSnapshot(snapshot, offset, version) ||
+      version != HEADER_SNAPSHOT_VERSION || !readFromSnapshot(snapshot, offset, epoch) ||
+      epoch == STALE_HEADER_SNAPSHOT_EPOCH || epoch != epoch_ - 1 ||
+      !readFromSnapshot(snapshot, offset, numFiles)) {
+    return false;
+  }
+
+  struct SnapshotFile {
+    size_t pageSize;
+    size_t numPages;
+    std::vector<bool> usedPages;
+  };
+  std::map<int, SnapshotFile> snapshotFiles;
+  for (size_t i = 0; i < numFiles; ++i) {
+    int fileId;
+    SnapshotFile file;
+    if (!readFromSnapshot(snapshot, offset, fileId) ||
+        !readFromSnapshot(snapshot, offset, file.pageSize) ||
+        !readFromSnapshot(snapshot, offset, file.numPages)) {
+      return false;
+    }
+    // the data files must be exactly the ones listed in the snapshot
+    const std::string filePath(fileMgrBasePath_ + "/" + std::to_string(fileId) + "." +
+                               std::to_string(file.pageSize) +
+                               std::string(MAPD_FILE_EXT));
+    if (boost::filesystem::file_size(filePath, ec) != file.pageSize * file.numPages ||
+        ec) {
+      return false;
+    }
+    file.usedPages.resize(file.numPages);
+    snapshotFiles.emplace(fileId, std::move(file));
+  }
+  size_t numDataFiles{0};
+  for (boost::filesystem::directory_iterator fileIt(fileMgrBasePath_), endItr;
+       fileIt != endItr;
+       ++fileIt) {
+    if (fileIt->path().extension().string() == MAPD_FILE_EXT) {
+      ++numDataFiles;
+    }
+  }
+  if (numDataFiles != snapshotFiles.size()) {
+    return false;
+  }
+
+  size_t numHeaders;
+  if (!readFromSnapshot(snapshot, offset, numHeaders)) {
+    return false;
+  }
+  std::vector<HeaderInfo> snapshotHeaderVec;
+  snapshotHeaderVec.reserve(numHeaders);
+  for (size_t i = 0; i < numHeaders; ++i) {
+    size_t keySize;
+    if (!readFromSnapshot(snapshot, offset, keySize) ||
+        offset + keySize * sizeof(int) > snapshot.size()) {
+      return false;
+    }
+    ChunkKey chunkKey(keySize);
+    for (auto& keyElem : chunkKey) {
+      readFromSnapshot(snapshot, offset, keyElem);
+    }
+    int pageId;
+    int versionEpoch;
+    Page page;
+    if (!readFromSnapshot(snapshot, offset, pageId) ||
+        !readFromSnapshot(snapshot, offset, versionEpoch) ||
+        !readFromSnapshot(snapshot, offset, page.fileId) ||
+        !readFromSnapshot(snapshot, offset, page.pageNum)) {
+      return false;
+    }
+    auto fileIt = snapshotFiles.find(page.fileId);
+    if (fileIt == snapshotFiles.end() || page.pageNum >= fileIt->second.numPages ||
+        fileIt->second.usedPages[page.pageNum]) {
+      return false;
+    }
+    fileIt->second.usedPages[page.pageNum] = true;
+    snapshotHeaderVec.emplace_back(chunkKey, pageId, versionEpoch, page);
+  }
+  if (offset != snapshot.size()) {
+    return false;
+  }
+
+  // every page without a header in the snapshot is free
+  mapd_unique_lock<mapd_shared_mutex> write_lock(files_rw_mutex_);
+  for (const auto& file : snapshotFiles) {
+    const int fileId = file.first;
+    const std::string filePath(fileMgrBasePath_ + "/" + std::to_string(fileId) + "." +
+                               std::to_string(file.second.pageSize) +
+                               std::string(MAPD_FILE_EXT));
+    FileInfo* fInfo = new FileInfo(this,
+                                   fileId,
+                                   open(filePath),
+                                   file.second.pageSize,
+                                   file.second.numPages,
+                                   false);  // false means don't init file
+    for (size_t pageNum = 0; pageNum < file.second.numPages; ++pageNum) {
+      if (!file.second.usedPages[pageNum]) {
+        fInfo->freePages.insert(fInfo->freePages.end(), pageNum);
+      }
+    }
+    if (fileId >= static_cast<int>(files_.size())) {
+      files_.resize(fileId + 1);
+    }
+    files_[fileId] = fInfo;
+    fileIndex_.insert(std::pair<size_t, int>(file.second.pageSize, fileId));
+    maxFileId = std::max(maxFileId, fileId);
+    ++fileCount;
+  }
+  headerVec = std::move(snapshotHeaderVec);
+  return true;
+}
+
+void FileMgr::invalidateHeaderSnapshot() {
+  const std::string snapshotPath(fileMgrBasePath_ + "/" + HEADER_SNAPSHOT_FILENAME);
+  FILE* snapshotFile = fopen(snapshotPath.c_str(), "r+b");
+  if (!snapshotFile) {
+    return;  // no snapshot
+  }
+  // overwritten in place, unlike a removal this doesn't need the directory synced
+  const int staleEpoch = STALE_HEADER_SNAPSHOT_EPOCH;
+  bool stamped = fseek(snapshotFile, sizeof(HEADER_SNAPSHOT_VERSION), SEEK_SET) == 0 &&
+                 fwrite(&staleEpoch, sizeof(staleEpoch), 1, snapshotFile) == 1 &&
+                 fflush(snapshotFile) == 0 && fsync(fileno(snapshotFile)) == 0;
+  stamped = fclose(snapshotFile) == 0 && stamped;
+  if (!stamped) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(snapshotPath, ec);
+    if (ec) {
+      LOG(FATAL) << "Could not invalidate header snapshot `" << snapshotPath
+                 << "`: " << ec.message();
+    }
+    const int dirFd = ::open(fileMgrBasePath_.c_str(), O_RDONLY);
+    if (dirFd < 0 || fsync(dirFd) != 0) {
+      LOG(FATAL) << "Could not sync table directory `" << fileMgrBasePath_
+                 << "` to disk";
+    }
+    ::close(dirFd);
+  }
+}
+
 void FileMgr::createDBMetaFile(const std::string& DBMetaFileName) {
   std::string DBMetaFilePath(fileMgrBasePath_ + "/" + DBMetaFileName);
   if (boost::filesystem::exists(DBMetaFilePath)) {
@@ -606,6 +885,7 @@ void FileMgr::checkpoint() {
     free_page.first->freePageDeferred(free_page.second);
   }
   free_pages.clear();
+  freePagesWriteLock.unlock();
 }
 
 AbstractBuffer* FileMgr::createBuffer(const ChunkKey& key,
@@ -634,6 +914,7 @@ bool FileMgr::isBufferOnDevice(const ChunkKey& key) {
 }
 
 void FileMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
+  lastPageChangeEpoch_ = epoch_;
   mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
   auto chunkIt = chunkIndex_.find(key);
   // ensure the Chunk exists
@@ -651,6 +932,7 @@ void FileMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
 }
 
 void FileMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purge) {
+  lastPageChangeEpoch_ = epoch_;
   mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
   auto chunkIt = chunkIndex_.lower_bound(keyPrefix);
   if (chunkIt == chunkIndex_.end()) {
@@ -731,6 +1013,60 @@ void FileMgr::fetchBuffer(const ChunkKey& key,
   destBuffer->syncEncoder(chunk);
 }
 
+FileBuffer* FileMgr::mapChunk(const ChunkKey& key,
+                              const size_t numBytes,
+                              MappedChunk& mappedChunk) {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  auto chunkIt = chunkIndex_.find(key);
+  if (chunkIt == chunkIndex_.end()) {
+    LOG(FATAL) << "Chunk does not exist for key: " << showChunk(key);
+  }
+  chunkIndexReadLock.unlock();
+
+  FileBuffer* chunk = chunkIt->second;
+  const size_t chunkSize = numBytes == 0 ? chunk->size() : numBytes;
+  CHECK_LE(chunkSize, chunk->size());
+  if (chunkSize == 0 || chunk->pageCount() != 1 || !chunk->has_encoder) {
+    return nullptr;
+  }
+  const auto& sqlType = chunk->sql_type;
+  if (sqlType.is_varlen() || (sqlType.get_compression() != kENCODING_NONE &&
+                              sqlType.get_compression() != kENCODING_DICT)) {
+    return nullptr;
+  }
+
+  const Page page = chunk->multiPages_.front().current();
+  FileInfo* fileInfo = getFileInfoForFileId(page.fileId);
+  const size_t dataOffset =
+      page.pageNum * fileInfo->pageSize + chunk->reservedHeaderSize();
+  static const size_t osPageSize = getpagesize();
+  const size_t mappingOffset = dataOffset / osPageSize * osPageSize;
+  const size_t mappingSize = dataOffset - mappingOffset + chunkSize;
+  void* mappingAddr;
+  {
+    // writes go through the stdio buffer of the file, the mapping only sees them once
+    // they are flushed
+    std::lock_guard<std::mutex> lock(fileInfo->readWriteMutex_);
+    CHECK_EQ(fflush(fileInfo->f), 0);
+    mappingAddr = mmap(nullptr,
+                       mappingSize,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE,
+                       fileno(fileInfo->f),
+                       mappingOffset);
+  }
+  if (mappingAddr == MAP_FAILED) {
+    LOG(WARNING) << "Could not map chunk " << showChunk(key) << ", reading it instead: "
+                 << std::strerror(errno);
+    return nullptr;
+  }
+  madvise(mappingAddr, mappingSize, MADV_WILLNEED);
+  mappedChunk.mappingAddr = static_cast<int8_t*>(mappingAddr);
+  mappedChunk.mappingSize = mappingSize;
+  mappedChunk.data = mappedChunk.mappingAddr + (dataOffset - mappingOffset);
+  return chunk;
+}
+
 AbstractBuffer* FileMgr::putBuffer(const ChunkKey& key,
                                    AbstractBuffer* srcBuffer,
                                    const size_t numBytes) {
@@ -797,6 +1133,7 @@ void FileMgr::free(AbstractBuffer* buffer) {
 }
 
 Page FileMgr::requestFreePage(size_t pageSize, const bool isMetadata) {
+  lastPageChangeEpoch_ = epoch_;
   std::lock_guard<std::mutex> lock(getPageMutex_);
 
   auto candidateFiles = fileIndex_.equal_range(pageSize);
@@ -826,6 +1163,7 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
                                const bool isMetadata) {
   // not used currently
   // @todo add method to FileInfo to get more than one page
+  lastPageChangeEpoch_ = epoch_;
   std::lock_guard<std::mutex> lock(getPageMutex_);
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   size_t numPagesNeeded = numPagesRequested;
@@ -992,6 +1330,8 @@ void FileMgr::createTopLevelMetadata() {
 void FileMgr::setEpoch(int epoch) {
   epoch_ = epoch;
   writeAndSyncEpochToDisk();
+  // pages of later epochs may still be in use, the next checkpoint settles them
+  lastPageChangeEpoch_ = epoch_;
 }
 
 void FileMgr::free_page(std::pair<FileInfo*, int>&& page) {
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <future>
 #include <iostream>
 #include <map>
@@ -78,6 +79,19 @@ using Chunk = FileBuffer;
  */
 typedef std::map<ChunkKey, FileBuffer*> ChunkKeyToChunkMap;
 
+/**
+ * @type MappedChunk
+ * @brief The data of a chunk in a private memory mapping of its data file.
+ *
+ * The mapping starts at the OS page boundary preceding the chunk data and is released
+ * with munmap(mappingAddr, mappingSize).
+ */
+struct MappedChunk {
+  int8_t* data{nullptr};         /// first byte of the chunk data
+  int8_t* mappingAddr{nullptr};  /// start of the mapping
+  size_t mappingSize{0};         /// length of the mapping in bytes
+};
+
 /**
  * @class   FileMgr
  * @brief
@@ -137,6 +151,25 @@ class FileMgr : public AbstractBufferMgr {  // implements
                             AbstractBuffer* d,
                             const size_t numBytes = 0) override;
 
+  /**
+   * @brief Maps the first numBytes of the chunk data instead of reading them.
+   *
+   * Only chunks whose data lies in a single page of a data file can be mapped, the
+   * pages of larger chunks are interleaved with page headers. Their column must be
+   * fixed width and either unencoded or dictionary encoded. The mapping is private, so
+   * writes to it never reach the file, and the OS is asked to read it ahead.
+   *
+   * The pages of a mapped chunk must stay allocated until the mapping is released,
+   * which holds as long as the chunk is deleted from the upper memory levels whenever
+   * it is deleted here.
+   *
+   * @return The chunk, or nullptr if it can't be mapped. mappedChunk is only set when
+   * the chunk is returned.
+   */
+  FileBuffer* mapChunk(const ChunkKey& key,
+                       const size_t numBytes,
+                       MappedChunk& mappedChunk);
+
   // Buffer API
   AbstractBuffer* alloc(const size_t numBytes) override;
   void free(AbstractBuffer* buffer) override;
@@ -203,6 +236,21 @@ class FileMgr : public AbstractBufferMgr {  // implements
    */
   inline int epoch() { return epoch_; }
 
+  /**
+   * @brief Persists the headers of all the pages in use, so that the next open of the
+   * table doesn't have to read the header of every page of its files.
+   *
+   * Called on clean shutdown, it writes nothing if the page headers changed since the
+   * last checkpoint. The snapshot is stamped with the epoch of that checkpoint, and
+   * stamped stale as soon as the table is opened again.
+   */
+  void writeHeaderSnapshot();
+  /**
+   * @brief Returns true if the table was opened from the header snapshot rather
+   * than by reading the header of every page.
+   */
+  bool isOpenedFromHeaderSnapshot() const { return openedFromHeaderSnapshot_; }
+
   /**
    * @brief Returns number of threads defined by parameter num-reader-threads
    * which should be used during initial load and consequent read of data.
@@ -256,6 +304,9 @@ class FileMgr : public AbstractBufferMgr {  // implements
   mutable mapd_shared_mutex mutex_free_page;
   std::vector<std::pair<FileInfo*, int>> free_pages;
 
+  std::atomic<int> lastPageChangeEpoch_{-1};  /// epoch of the last page header change
+  bool openedFromHeaderSnapshot_{false};
+
   /**
    * @brief Adds a file to the file manager repository.
    *
@@ -281,6 +332,17 @@ class FileMgr : public AbstractBufferMgr {  // implements
   void createEpochFile(const std::string& epochFileName);
   void openEpochFile(const std::string& epochFileName);
   void writeAndSyncEpochToDisk();
+
+  /**
+   * @brief Opens the data files as described by the header snapshot.
+   *
+   * @return false, without opening any file, if there's no snapshot or it doesn't
+   * match the epoch file and the data files on disk.
+   */
+  bool openHeaderSnapshot(std::vector<HeaderInfo>& headerVec,
+                          int& maxFileId,
+                          int& fileCount);
+  void invalidateHeaderSnapshot();
   void createDBMetaFile(const std::string& DBMetaFileName);
   bool openDBMetaFile(const std::string& DBMetaFileName);
   void writeAndSyncDBMetaToDisk();
@@ -57,6 +57,7 @@ GlobalFileMgr::GlobalFileMgr(const int deviceId,
 GlobalFileMgr::~GlobalFileMgr() {
   mapd_lock_guard<mapd_shared_mutex> fileMgrsMutex(fileMgrs_mutex_);
   for (auto fileMgrsIt = fileMgrs_.begin(); fileMgrsIt != fileMgrs_.end(); ++fileMgrsIt) {
+    fileMgrsIt->second->writeHeaderSnapshot();
     delete fileMgrsIt->second;
   }
 }
@@ -101,6 +101,12 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
     return getFileMgr(key)->putBuffer(key, d, numBytes);
   }
 
+  FileBuffer* mapChunk(const ChunkKey& key,
+                       const size_t numBytes,
+                       MappedChunk& mappedChunk) {
+    return getFileMgr(key)->mapChunk(key, numBytes, mappedChunk);
+  }
+
   // Buffer API
   AbstractBuffer* alloc(const size_t numBytes) override {
     LOG(FATAL) << "Operation not supported";
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/HotChunks.h"
+
+#include "DataMgr/DataMgr.h"
+#include "Shared/Logger.h"
+#include "Shared/measure.h"
+#include "Shared/thread_count.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <fstream>
+
+namespace Data_Namespace {
+
+namespace {
+
+// Parses a "db_id,table_id,column_id,fragment_id[,varlen_id] num_bytes" line.
+bool parse_hot_chunk(const std::string& line, ChunkKey& key, size_t& num_bytes) {
+  std::vector<std::string> fields;
+  boost::split(fields, line, boost::is_any_of(" "), boost::token_compress_on);
+  if (fields.size() != 2) {
+    return false;
+  }
+  std::vector<std::string> key_fields;
+  boost::split(key_fields, fields[0], boost::is_any_of(","));
+  if (key_fields.size() < 4 || key_fields.size() > 5) {
+    return false;
+  }
+  try {
+    key.clear();
+    for (const auto& key_field : key_fields) {
+      key.push_back(std::stoi(key_field));
+    }
+    num_bytes = std::stoull(fields[1]);
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+void write_hot_chunks(const std::string& path, const HotChunks& hot_chunks) {
+  const auto tmp_path = path + ".tmp";
+  {
+    std::ofstream hot_chunks_file(tmp_path, std::ios::trunc);
+    for (const auto& hot_chunk : hot_chunks) {
+      const auto& key = hot_chunk.first;
+      for (size_t i = 0; i < key.size(); ++i) {
+        hot_chunks_file << (i ? "," : "") << key[i];
+      }
+      hot_chunks_file << " " << hot_chunk.second << "\n";
+    }
+    if (!hot_chunks_file) {
+      throw std::runtime_error("write to " + tmp_path + " failed");
+    }
+  }
+  boost::filesystem::rename(tmp_path, path);
+}
+
+HotChunks read_hot_chunks(const std::string& path, const size_t max_bytes) {
+  HotChunks hot_chunks;
+  size_t total_bytes{0};
+  std::ifstream hot_chunks_file(path);
+  std::string line;
+  while (std::getline(hot_chunks_file, line)) {
+    ChunkKey key;
+    size_t num_bytes{0};
+    if (!parse_hot_chunk(line, key, num_bytes)) {
+      LOG(WARNING) << "Skipping malformed hot chunk record: " << line;
+      continue;
+    }
+    if (total_bytes + num_bytes > max_bytes) {
+      break;
+    }
+    total_bytes += num_bytes;
+    hot_chunks.emplace_back(std::move(key), num_bytes);
+  }
+  return hot_chunks;
+}
+
+const std::string HotChunksRecorder::kFileName{"mapd_hot_chunks"};
+
+HotChunksRecorder::HotChunksRecorder(DataMgr* data_mgr,
+                                     const std::string& data_path,
+                                     const size_t record_interval,
+                                     const size_t preload_bytes_per_sec,
+                                     const size_t num_reader_threads,
+                                     const bool read_only,
+                                     PreloadGuard preload_guard)
+    : data_mgr_(data_mgr)
+    , path_((boost::filesystem::path(data_path) / kFileName).string())
+    , record_interval_(record_interval)
+    , preload_bytes_per_sec_(preload_bytes_per_sec)
+    , num_reader_threads_(num_reader_threads ? num_reader_threads
+                                             : static_cast<size_t>(cpu_threads()))
+    , read_only_(read_only)
+    , preload_guard_(std::move(preload_guard)) {
+  CHECK(data_mgr_);
+  CHECK(preload_guard_);
+  thread_ = std::thread([this] { run(); });
+}
+
+HotChunksRecorder::~HotChunksRecorder() {
+  stop();
+}
+
+void HotChunksRecorder::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void HotChunksRecorder::run() {
+  const bool preloaded = preload();
+  const auto interval = std::chrono::seconds(record_interval_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_for(lock, interval, [this] { return stop_.load(); })) {
+    lock.unlock();
+    record();
+    lock.lock();
+  }
+  lock.unlock();
+  // an interrupted preload leaves a partial set in the pool, keep the previous record
+  if (preloaded) {
+    record();
+  }
+}
+
+bool HotChunksRecorder::preload() {
+  if (!boost::filesystem::exists(path_)) {
+    return true;
+  }
+  const auto clock_begin = timer_start();
+  // the record is ordered by access count, keep the hottest chunks which fit the pool
+  const auto hot_chunks = read_hot_chunks(path_, data_mgr_->getCpuBufferPoolSize());
+  if (hot_chunks.empty()) {
+    return true;
+  }
+
+  // the workers share a token bucket, each chunk delays the next start by the time
+  // it takes to read at the configured rate
+  std::mutex pacing_mutex;
+  auto next_start = std::chrono::steady_clock::now();
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<size_t> preloaded_chunks{0};
+  std::atomic<size_t> preloaded_bytes{0};
+  auto preload_worker = [&] {
+    while (!stop_) {
+      const size_t chunk_idx = next_chunk++;
+      if (chunk_idx >= hot_chunks.size()) {
+        break;
+      }
+      const auto& hot_chunk = hot_chunks[chunk_idx];
+      if (preload_bytes_per_sec_) {
+        std::chrono::steady_clock::time_point start;
+        {
+          std::lock_guard<std::mutex> pacing_lock(pacing_mutex);
+          start = std::max(next_start, std::chrono::steady_clock::now());
+          next_start = start + std::chrono::microseconds(hot_chunk.second * 1000000 /
+                                                         preload_bytes_per_sec_);
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (cv_.wait_until(lock, start, [this] { return stop_.load(); })) {
+          break;
+        }
+      }
+      size_t num_bytes{0};
+      try {
+        num_bytes = preload_guard_(hot_chunk.first, [this, &hot_chunk] {
+          return data_mgr_->preloadCpuChunk(hot_chunk.first, hot_chunk.second);
+        });
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Hot chunk " << showChunk(hot_chunk.first)
+                     << " not preloaded: " << e.what();
+      }
+      if (num_bytes) {
+        ++preloaded_chunks;
+        preloaded_bytes += num_bytes;
+      }
+    }
+  };
+  const size_t worker_count = std::min(hot_chunks.size(), num_reader_threads_);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(preload_worker);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  LOG(INFO) << "Preloaded " << preloaded_chunks << " of " << hot_chunks.size()
+            << " hot chunks, " << preloaded_bytes << " bytes, in "
+            << timer_stop(clock_begin) << " ms";
+  return !stop_;
+}
+
+void HotChunksRecorder::record() {
+  if (read_only_) {
+    return;
+  }
+  try {
+    write_hot_chunks(path_, data_mgr_->getHotCpuChunks());
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Could not record the hot chunks: " << e.what();
+  }
+}
+
+}  // namespace Data_Namespace
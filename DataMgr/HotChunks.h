@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    HotChunks.h
+ * @brief   Records the hot chunks of the CPU buffer pool and preloads them on start.
+ */
+
+#ifndef DATAMGR_HOTCHUNKS_H
+#define DATAMGR_HOTCHUNKS_H
+
+#include "Shared/types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Data_Namespace {
+
+class DataMgr;
+
+// Chunks and their size in bytes, most accessed first
+using HotChunks = std::vector<std::pair<ChunkKey, size_t>>;
+
+// Writes the chunks to path as "db_id,table_id,column_id,fragment_id[,varlen_id]
+// num_bytes" lines. The file is replaced through a rename, a crash while writing doesn't
+// leave a truncated record behind. Throws on failure.
+void write_hot_chunks(const std::string& path, const HotChunks& hot_chunks);
+
+// Reads back the record written by write_hot_chunks, up to the first chunk which
+// doesn't fit in max_bytes along with the chunks before it. Malformed lines are skipped.
+HotChunks read_hot_chunks(const std::string& path, const size_t max_bytes);
+
+// Preloads the chunks recorded by the previous run into the CPU buffer pool, then
+// records the hot chunks every record_interval seconds, and once more when stopped.
+class HotChunksRecorder {
+ public:
+  // Calls preload, which loads the chunk and returns the bytes read, if the table and
+  // column of the chunk still exist, under the read lock of the table. Returns the
+  // bytes preloaded.
+  using PreloadGuard = std::function<size_t(const ChunkKey& key,
+                                            const std::function<size_t()>& preload)>;
+
+  HotChunksRecorder(DataMgr* data_mgr,
+                    const std::string& data_path,
+                    const size_t record_interval,
+                    const size_t preload_bytes_per_sec,
+                    const size_t num_reader_threads,
+                    const bool read_only,
+                    PreloadGuard preload_guard);
+  ~HotChunksRecorder();
+
+  // Interrupts the preload and waits for the last record.
+  void stop();
+
+  static const std::string kFileName;
+
+ private:
+  void run();
+  // Returns false if the preload was interrupted.
+  bool preload();
+  void record();
+
+  DataMgr* data_mgr_;
+  const std::string path_;
+  const size_t record_interval_;
+  const size_t preload_bytes_per_sec_;
+  const size_t num_reader_threads_;
+  const bool read_only_;
+  const PreloadGuard preload_guard_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace Data_Namespace
+
+#endif  // DATAMGR_HOTCHUNKS_H
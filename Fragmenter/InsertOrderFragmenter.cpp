@@ -314,6 +314,7 @@ void InsertOrderFragmenter::updateChunkStats(
 }
 
 void InsertOrderFragmenter::insertData(InsertData& insertDataStruct) {
+  const auto append_stats = computeColumnStatistics(insertDataStruct);
   // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
   try {
     mapd_unique_lock<mapd_shared_mutex> insertLock(
@@ -339,14 +340,39 @@ void InsertOrderFragmenter::insertData(InsertData& insertDataStruct) {
         insertDataStruct.databaseId, insertDataStruct.tableId, tableEpoch);
     throw;
   }
+  addColumnStatistics(append_stats, insertDataStruct.numRows);
 }
 
 void InsertOrderFragmenter::insertDataNoCheckpoint(InsertData& insertDataStruct) {
-  // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
-  mapd_unique_lock<mapd_shared_mutex> insertLock(
-      insertMutex_);  // prevent two threads from trying to insert into the same table
-                      // simultaneously
-  insertDataImpl(insertDataStruct);
+  const auto append_stats = computeColumnStatistics(insertDataStruct);
+  {
+    // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
+    mapd_unique_lock<mapd_shared_mutex> insertLock(
+        insertMutex_);  // prevent two threads from trying to insert into the same table
+                        // simultaneously
+    insertDataImpl(insertDataStruct);
+  }
+  addColumnStatistics(append_stats, insertDataStruct.numRows);
+}
+
+// Both run outside of the insert lock: the statistics come from the insert buffers,
+// not from the chunks.
+std::map<int, ColumnStatistics> InsertOrderFragmenter::computeColumnStatistics(
+    const InsertData& insertDataStruct) const {
+  if (!catalog_) {
+    return {};
+  }
+  return catalog_->computeColumnStatisticsOnAppend(physicalTableId_, insertDataStruct);
+}
+
+void InsertOrderFragmenter::addColumnStatistics(
+    const std::map<int, ColumnStatistics>& stats_per_column,
+    const size_t num_rows) {
+  if (catalog_) {
+    catalog_->addColumnStatisticsOnAppend(physicalTableId_, stats_per_column, num_rows);
+    // the cached join hash tables of the table don't cover the appended rows
+    catalog_->invalidateCachesForTable(physicalTableId_);
+  }
 }
 
 void InsertOrderFragmenter::replicateData(const InsertData& insertDataStruct) {
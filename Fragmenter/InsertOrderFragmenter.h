@@ -37,6 +37,8 @@ namespace Data_Namespace {
 class DataMgr;
 }
 
+struct ColumnStatistics;
+
 #define DEFAULT_FRAGMENT_ROWS 32000000     // in tuples
 #define DEFAULT_PAGE_SIZE 2097152          // in bytes
 #define DEFAULT_MAX_ROWS (1L) << 62        // in rows
@@ -222,6 +224,10 @@ class InsertOrderFragmenter : public AbstractFragmenter {
 
   void lockInsertCheckpointData(const InsertData& insertDataStruct);
   void insertDataImpl(InsertData& insertDataStruct);
+  std::map<int, ColumnStatistics> computeColumnStatistics(
+      const InsertData& insertDataStruct) const;
+  void addColumnStatistics(const std::map<int, ColumnStatistics>& stats_per_column,
+                           const size_t num_rows);
   void replicateData(const InsertData& insertDataStruct);
 
   InsertOrderFragmenter(const InsertOrderFragmenter&);
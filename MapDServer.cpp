@@ -66,9 +66,17 @@ unsigned send_timeout{300000};
 extern bool g_cache_string_hash;
 extern size_t g_leaf_count;
 extern bool g_skip_intermediate_count;
+extern bool g_release_intermediate_results;
+extern bool g_enable_late_materialization;
 extern bool g_enable_bump_allocator;
+extern bool g_enable_cpu_bump_allocator;
+extern bool g_enable_cpu_vectorization;
+extern bool g_enable_tiered_compilation;
+extern bool g_enable_runtime_join_filters;
+extern bool g_enable_async_reduction_compilation;
 extern size_t g_max_memory_allocation_size;
 extern size_t g_min_memory_allocation_size;
+extern size_t g_column_statistics_persist_rows;
 
 bool g_enable_thrift_logs{false};
 
@@ -375,6 +383,61 @@ void MapDProgramOptions::fillOptions() {
                           po::value<size_t>(&mapd_parameters.cpu_buffer_mem_bytes)
                               ->default_value(mapd_parameters.cpu_buffer_mem_bytes),
                           "Size of memory reserved for CPU buffers, in bytes.");
+  help_desc.add_options()(
+      "cpu-buffer-huge-pages",
+      po::value<bool>(&mapd_parameters.cpu_buffer_huge_pages)
+          ->default_value(mapd_parameters.cpu_buffer_huge_pages)
+          ->implicit_value(true),
+      "Back the CPU buffer pool with huge pages. Explicit huge pages are used when "
+      "enough of them are reserved, transparent huge pages otherwise.");
+  help_desc.add_options()(
+      "cpu-buffer-numa-interleave",
+      po::value<bool>(&mapd_parameters.cpu_buffer_numa_interleave)
+          ->default_value(mapd_parameters.cpu_buffer_numa_interleave)
+          ->implicit_value(true),
+      "Interleave the pages of the CPU buffer pool across all NUMA nodes instead of "
+      "placing them on the node which touches them first.");
+  help_desc.add_options()(
+      "cpu-buffer-mmap-reads",
+      po::value<bool>(&mapd_parameters.cpu_buffer_mmap_reads)
+          ->default_value(mapd_parameters.cpu_buffer_mmap_reads)
+          ->implicit_value(true),
+      "Map chunks stored in a single page of a data file into the CPU buffer pool "
+      "instead of copying them, so the OS page cache holds the only copy. Applies to "
+      "fixed width columns which are unencoded or dictionary encoded.");
+  help_desc.add_options()(
+      "cpu-buffer-compressed-cache-bytes",
+      po::value<size_t>(&mapd_parameters.cpu_buffer_compressed_cache_bytes)
+          ->default_value(mapd_parameters.cpu_buffer_compressed_cache_bytes),
+      "Size of memory reserved for chunks evicted from the CPU buffer pool, which are "
+      "kept compressed and restored without reading them from disk, in bytes. 0 "
+      "disables this tier.");
+  help_desc.add_options()(
+      "hot-chunks-record-interval",
+      po::value<size_t>(&mapd_parameters.hot_chunks_record_interval)
+          ->default_value(mapd_parameters.hot_chunks_record_interval),
+      "Interval between the records of the chunks most accessed in the CPU buffer pool, "
+      "in seconds. The recorded chunks are preloaded in the background on the next "
+      "start. 0 disables recording and preloading.");
+  help_desc.add_options()(
+      "hot-chunks-preload-bytes-per-sec",
+      po::value<size_t>(&mapd_parameters.hot_chunks_preload_bytes_per_sec)
+          ->default_value(mapd_parameters.hot_chunks_preload_bytes_per_sec),
+      "Disk bandwidth used to preload the recorded hot chunks on start, in bytes per "
+      "second. 0 doesn't limit it.");
+  help_desc.add_options()(
+      "query-memory-budget-bytes",
+      po::value<size_t>(&mapd_parameters.query_memory_budget_bytes)
+          ->default_value(mapd_parameters.query_memory_budget_bytes),
+      "Host memory a query may hold in output buffers, pinned CPU buffer pool chunks and "
+      "hash tables, in bytes. Queries going over it fail. 0 doesn't limit it.");
+  help_desc.add_options()(
+      "query-memory-watermark-bytes",
+      po::value<size_t>(&mapd_parameters.query_memory_watermark_bytes)
+          ->default_value(mapd_parameters.query_memory_watermark_bytes),
+      "Host memory the running queries may hold together, in bytes. New queries are "
+      "queued until they fit under it, counting the budget of each query. 0 disables "
+      "queuing.");
   help_desc.add_options()(
       "cpu-only",
       po::value<bool>(&cpu_only)->default_value(cpu_only)->implicit_value(true),
@@ -516,6 +579,32 @@ void MapDProgramOptions::fillOptions() {
       po::value<size_t>(&g_overlaps_max_table_size_bytes)
           ->default_value(g_overlaps_max_table_size_bytes),
       "The maximum size in bytes of the hash table for an overlaps hash join.");
+  help_desc.add_options()(
+      "join-hash-table-cache-max-bytes",
+      po::value<size_t>(&g_join_hash_table_cache_max_bytes)
+          ->default_value(g_join_hash_table_cache_max_bytes),
+      "The maximum size in bytes of each of the caches of join hash tables built on "
+      "CPU, 0 for no limit. The tables least recently used and cheapest to rebuild "
+      "are evicted first.");
+  help_desc.add_options()(
+      "max-dict-lookup-table-entries",
+      po::value<size_t>(&g_max_dict_lookup_table_entries)
+          ->default_value(g_max_dict_lookup_table_entries),
+      "The largest dictionary for which LENGTH / CHAR_LENGTH are computed once per "
+      "string id instead of once per row.");
+  help_desc.add_options()(
+      "column-statistics-persist-rows",
+      po::value<size_t>(&g_column_statistics_persist_rows)
+          ->default_value(g_column_statistics_persist_rows),
+      "The number of rows appended to an analyzed table after which the updated "
+      "column statistics are written to the catalog. They're also written on "
+      "shutdown.");
+  help_desc.add_options()(
+      "query-buffer-pool-bytes",
+      po::value<size_t>(&g_query_buffer_pool_bytes)
+          ->default_value(g_query_buffer_pool_bytes),
+      "The maximum size in bytes of the query output and count distinct buffers kept "
+      "in host memory for reuse by the following queries, 0 to disable the pool.");
   if (!dist_v5_) {
     help_desc.add_options()("port,p",
                             po::value<int>(&mapd_parameters.omnisci_server_port)
@@ -577,6 +666,12 @@ void MapDProgramOptions::fillAdvancedOptions() {
           ->default_value(g_enable_columnar_output)
           ->implicit_value(true),
       "Enable columnar output for intermediate/final query steps.");
+  developer_desc.add_options()(
+      "enable-columnar-projections",
+      po::value<bool>(&g_enable_columnar_projections)
+          ->default_value(g_enable_columnar_projections)
+          ->implicit_value(true),
+      "Output projections run on CPU columnar when all their targets are fixed width.");
   developer_desc.add_options()("enable-legacy-syntax",
                                po::value<bool>(&enable_legacy_syntax)
                                    ->default_value(enable_legacy_syntax)
@@ -618,6 +713,20 @@ void MapDProgramOptions::fillAdvancedOptions() {
           ->default_value(g_skip_intermediate_count)
           ->implicit_value(true),
       "Skip pre-flight counts for intermediate projections with no filters.");
+  developer_desc.add_options()(
+      "release-intermediate-results",
+      po::value<bool>(&g_release_intermediate_results)
+          ->default_value(g_release_intermediate_results)
+          ->implicit_value(true),
+      "Free the result of an intermediate query step as soon as the last step reading "
+      "it has finished, instead of at the end of the query.");
+  developer_desc.add_options()(
+      "enable-late-materialization",
+      po::value<bool>(&g_enable_late_materialization)
+          ->default_value(g_enable_late_materialization)
+          ->implicit_value(true),
+      "Run sorted projections with a LIMIT in two passes: the filters and the sort keys "
+      "first, then the other projected columns for the rows in the result only.");
   developer_desc.add_options()(
       "strip-join-covered-quals",
       po::value<bool>(&g_strip_join_covered_quals)
@@ -642,6 +751,34 @@ void MapDProgramOptions::fillAdvancedOptions() {
       "obtained, the query will be retried with different execution parameters and/or "
       "on "
       "CPU (if allow-cpu-retry is enabled). Requires bump allocator.");
+  developer_desc.add_options()(
+      "enable-cpu-vectorization",
+      po::value<bool>(&g_enable_cpu_vectorization)
+          ->default_value(g_enable_cpu_vectorization)
+          ->implicit_value(true),
+      "Run the LLVM loop and SLP vectorizers on CPU kernels and generate code for the "
+      "instruction set extensions of the host CPU (e.g. AVX2, AVX-512).");
+  developer_desc.add_options()(
+      "enable-tiered-compilation",
+      po::value<bool>(&g_enable_tiered_compilation)
+          ->default_value(g_enable_tiered_compilation)
+          ->implicit_value(true),
+      "Run new CPU queries with quickly generated code while the optimized code is "
+      "compiled in the background, subsequent runs use the optimized code.");
+  developer_desc.add_options()(
+      "enable-async-reduction-compilation",
+      po::value<bool>(&g_enable_async_reduction_compilation)
+          ->default_value(g_enable_async_reduction_compilation)
+          ->implicit_value(true),
+      "Compile the code for the reduction of group by results in the background, in a "
+      "separate LLVM context, while the query kernels are still running.");
+  developer_desc.add_options()(
+      "enable-runtime-join-filters",
+      po::value<bool>(&g_enable_runtime_join_filters)
+          ->default_value(g_enable_runtime_join_filters)
+          ->implicit_value(true),
+      "Skip outer table fragments outside the key range of inner join hash tables and "
+      "check a bloom filter before probing composite key hash tables on CPU.");
   developer_desc.add_options()("enable-bump-allocator",
                                po::value<bool>(&g_enable_bump_allocator)
                                    ->default_value(g_enable_bump_allocator)
@@ -655,6 +792,14 @@ void MapDProgramOptions::fillAdvancedOptions() {
                                "to CPU after execution. When disabled, pre-flight "
                                "count queries are used to size "
                                "the output buffer for projection queries.");
+  developer_desc.add_options()(
+      "enable-cpu-bump-allocator",
+      po::value<bool>(&g_enable_cpu_bump_allocator)
+          ->default_value(g_enable_cpu_bump_allocator)
+          ->implicit_value(true),
+      "Enable the bump allocator for projection queries on CPU. Each kernel starts with "
+      "an output buffer sized to its input fragments and grows it on overflow, which "
+      "makes the pre-flight count query unnecessary.");
   developer_desc.add_options()("ssl-cert",
                                po::value<std::string>(&mapd_parameters.ssl_cert_file)
                                    ->default_value(std::string("")),
@@ -2840,6 +2840,31 @@ void TruncateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   catalog.truncateTable(td);
 }
 
+void AnalyzeTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.getCatalog();
+  const TableDescriptor* td = catalog.getMetadataForTable(*table);
+  if (td == nullptr) {
+    throw std::runtime_error("Table " + *table + " does not exist.");
+  }
+
+  // check access privileges
+  std::vector<DBObject> privObjects;
+  DBObject dbObject(*table, TableDBObjectType);
+  dbObject.loadKey(catalog);
+  dbObject.setPrivileges(AccessPrivileges::SELECT_FROM_TABLE);
+  privObjects.push_back(dbObject);
+  if (!SysCatalog::instance().checkPrivileges(session.get_currentUser(), privObjects)) {
+    throw std::runtime_error("Table " + *table + " will not be analyzed. User " +
+                             session.get_currentUser().userName +
+                             " has no proper privileges.");
+  }
+
+  if (td->isView) {
+    throw std::runtime_error(*table + " is a view.  Cannot Analyze.");
+  }
+  catalog.analyzeTable(td);
+}
+
 void check_alter_table_privilege(const Catalog_Namespace::SessionInfo& session,
                                  const TableDescriptor* td) {
   if (session.get_currentUser().isSuper ||
@@ -1113,6 +1113,20 @@ class TruncateTableStmt : public DDLStmt {
   std::unique_ptr<std::string> table;
 };
 
+/*
+ * @type AnalyzeTableStmt
+ * @brief ANALYZE TABLE statement
+ */
+class AnalyzeTableStmt : public DDLStmt {
+ public:
+  AnalyzeTableStmt(std::string* tab) : table(tab) {}
+  const std::string* get_table() const { return table.get(); }
+  void execute(const Catalog_Namespace::SessionInfo& session) override;
+
+ private:
+  std::unique_ptr<std::string> table;
+};
+
 class OptimizeTableStmt : public DDLStmt {
  public:
   OptimizeTableStmt(std::string* table, std::list<NameValueAssign*>* o) : table_(table) {
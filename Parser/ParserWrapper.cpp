@@ -29,6 +29,7 @@
 using namespace std;
 
 const std::vector<std::string> ParserWrapper::ddl_cmd = {"ALTER",
+                                                         "ANALYZE",
                                                          "COPY",
                                                          "GRANT",
                                                          "CREATE",
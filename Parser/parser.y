@@ -91,7 +91,7 @@ using namespace Parser;
 
 	/* literal keyword tokens */
 
-%token ADD ALL ALTER AMMSC ANY ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
+%token ADD ALL ALTER AMMSC ANALYZE ANY ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
 %token CASE CAST CHAR_LENGTH CHARACTER CHECK CLOSE CLUSTER COLUMN COMMIT CONTINUE COPY CREATE CURRENT
 %token CURSOR DATABASE DATE DATETIME DATE_TRUNC DECIMAL DECLARE DEFAULT DELETE DESC DICTIONARY DISTINCT DOUBLE DROP
 %token ELSE END EXISTS EXTRACT FETCH FIRST FLOAT FOR FOREIGN FOUND FROM
@@ -124,6 +124,7 @@ sql:		/* schema {	$<nodeval>$ = $<nodeval>1; } */
 	| drop_view_statement { $<nodeval>$ = $<nodeval>1; }
 	| drop_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| truncate_table_statement { $<nodeval>$ = $<nodeval>1; }
+	| analyze_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| rename_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| rename_column_statement { $<nodeval>$ = $<nodeval>1; }
 	| add_column_statement { $<nodeval>$ = $<nodeval>1; }
@@ -275,6 +276,12 @@ truncate_table_statement:
 		  $<nodeval>$ = new TruncateTableStmt($<stringval>3);
 		}
 		;
+analyze_table_statement:
+		ANALYZE TABLE table
+		{
+		  $<nodeval>$ = new AnalyzeTableStmt($<stringval>3);
+		}
+		;
 rename_table_statement:
 		ALTER TABLE table RENAME TO table
 		{
@@ -15,19 +15,34 @@
  */
 
 #include "BaselineJoinHashTable.h"
+#include "../Parser/ParserNode.h"
 #include "CodeGenerator.h"
 #include "ColumnFetcher.h"
+#include "CompareKeysInl.h"
 #include "Execute.h"
 #include "ExpressionRewrite.h"
 #include "HashJoinKeyHandlers.h"
+#include "JoinBloomFilterInl.h"
 #include "JoinHashTableGpuUtils.h"
+#include "MurmurHash.h"
 
 #include <future>
-
-std::vector<std::pair<BaselineJoinHashTable::HashTableCacheKey,
-                      BaselineJoinHashTable::HashTableCacheValue>>
-    BaselineJoinHashTable::hash_table_cache_;
-std::mutex BaselineJoinHashTable::hash_table_cache_mutex_;
+#include <limits>
+
+ConcurrentLruCache<BaselineJoinHashTable::HashTableCacheKey,
+                   BaselineJoinHashTable::HashTableCacheValue,
+                   BaselineJoinHashTable::HashTableCacheKeyHash>
+    BaselineJoinHashTable::hash_table_cache_(
+        std::numeric_limits<size_t>::max(),
+        decltype(hash_table_cache_)::default_shard_count,
+        g_join_hash_table_cache_max_bytes,
+        [](const HashTableCacheValue& cache_value) {
+          size_t size_bytes = cache_value.buffer ? cache_value.buffer->size() : 0;
+          if (cache_value.bloom_filter) {
+            size_bytes += cache_value.bloom_filter->size() * sizeof(uint64_t);
+          }
+          return size_bytes;
+        });
 
 std::shared_ptr<BaselineJoinHashTable> BaselineJoinHashTable::getInstance(
     const std::shared_ptr<Analyzer::BinOper> condition,
@@ -81,6 +96,10 @@ std::shared_ptr<BaselineJoinHashTable> BaselineJoinHashTable::getInstance(
     throw HashJoinFail(
         std::string("Ran out of memory while building hash tables for equijoin | ") +
         e.what());
+  } catch (const QueryMemoryBudgetExceeded& e) {
+    // surfaced as ERR_OUT_OF_QUERY_MEMORY_BUDGET by the executor
+    join_hash_table->freeHashBufferMemory();
+    throw;
   } catch (const std::exception& e) {
     throw std::runtime_error(
         std::string("Fatal error while attempting to build hash tables for join: ") +
@@ -187,7 +206,12 @@ void BaselineJoinHashTable::reify(const int device_count) {
 #endif  // HAVE_CUDA
   const auto composite_key_info = getCompositeKeyInfo();
   const auto type_and_found = HashTypeCache::get(composite_key_info.cache_key_chunks);
-  const auto layout = type_and_found.second ? type_and_found.first : layout_;
+  auto layout = type_and_found.second ? type_and_found.first : layout_;
+  if (layout == JoinHashTableInterface::HashType::OneToOne &&
+      inner_keys_have_duplicates(inner_outer_pairs_, *executor_->getCatalog())) {
+    VLOG(1) << "Column statistics show duplicate keys, building one to many hash table";
+    layout = JoinHashTableInterface::HashType::OneToMany;
+  }
 
   if (condition_->is_overlaps_oper()) {
     try {
@@ -202,6 +226,9 @@ void BaselineJoinHashTable::reify(const int device_count) {
 
   try {
     reifyWithLayout(device_count, layout);
+  } catch (const QueryMemoryBudgetExceeded&) {
+    // a one to many layout would need even more memory
+    throw;
   } catch (const std::exception& e) {
     VLOG(1) << "Caught exception while building baseline hash table: " << e.what();
     freeHashBufferMemory();
@@ -425,7 +452,7 @@ JoinColumn BaselineJoinHashTable::fetchColumn(
       }
     }
   }
-  return {col_buff, elem_count};
+  return {col_buff, elem_count, 0};
 }
 
 BaselineJoinHashTable::ColumnsForDevice BaselineJoinHashTable::fetchColumnsForDevice(
@@ -555,6 +582,9 @@ int BaselineJoinHashTable::initHashTableOnCpu(
                               condition_->get_optype()};
   initHashTableOnCpuFromCache(cache_key);
   if (cpu_hash_table_buff_) {
+    if (!bloom_filter_) {
+      initRuntimeFilters();
+    }
     return 0;
   }
   const auto key_component_width = getKeyComponentWidth();
@@ -581,6 +611,10 @@ int BaselineJoinHashTable::initHashTableOnCpu(
           << " entries in the one to many buffer";
   VLOG(1) << "Total hash table size: " << hash_table_size << " Bytes";
 
+  const auto build_timer = timer_start();
+  if (const auto row_set_mem_owner = executor_->getRowSetMemoryOwner()) {
+    row_set_mem_owner->chargeMemoryBudget(hash_table_size);
+  }
   cpu_hash_table_buff_.reset(new std::vector<int8_t>(hash_table_size));
   int thread_count = cpu_threads();
   std::vector<std::future<void>> init_cpu_buff_threads;
@@ -734,12 +768,132 @@ int BaselineJoinHashTable::initHashTableOnCpu(
         CHECK(false);
     }
   }
+  initRuntimeFilters();
   if (!err && getInnerTableId() > 0) {
-    putHashTableOnCpuToCache(cache_key);
+    putHashTableOnCpuToCache(
+        cache_key,
+        timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+            build_timer));
   }
   return err;
 }
 
+namespace {
+
+template <typename T>
+void fill_join_runtime_filters(
+    std::vector<uint64_t>& bloom_filter,
+    std::vector<std::pair<int64_t, int64_t>>& key_component_ranges,
+    const T* composite_key_dict,
+    const size_t entry_size,
+    const size_t key_component_count,
+    const size_t start_entry,
+    const size_t end_entry) {
+  for (size_t i = start_entry; i < end_entry; ++i) {
+    const auto key = composite_key_dict + i * entry_size;
+    if (*key == get_invalid_key<T>()) {
+      continue;
+    }
+    const uint64_t h = MurmurHash64A(key, key_component_count * sizeof(T), 0);
+    __atomic_fetch_or(&bloom_filter[join_bloom_filter_word_idx(h, bloom_filter.size())],
+                      join_bloom_filter_mask(h),
+                      __ATOMIC_RELAXED);
+    for (size_t j = 0; j < key_component_count; ++j) {
+      auto& range = key_component_ranges[j];
+      range.first = std::min(range.first, static_cast<int64_t>(key[j]));
+      range.second = std::max(range.second, static_cast<int64_t>(key[j]));
+    }
+  }
+}
+
+}  // namespace
+
+// Builds a bloom filter and the range of each key component from the keys in the table,
+// the generated code checks the bloom filter before probing the table.
+void BaselineJoinHashTable::initRuntimeFilters() {
+  if (!g_enable_runtime_join_filters || memory_level_ != Data_Namespace::CPU_LEVEL) {
+    return;
+  }
+  CHECK(cpu_hash_table_buff_);
+  const auto key_component_width = getKeyComponentWidth();
+  const auto key_component_count = getKeyComponentCount();
+  const auto entry_size =
+      key_component_count +
+      (layout_ == JoinHashTableInterface::HashType::OneToOne ? 1 : 0);
+  // At most half of the entries hold a key, which gets 16 bits of the filter or more.
+  size_t word_count = 1;
+  while (word_count * 64 < entry_count_ * 8) {
+    word_count *= 2;
+  }
+  bloom_filter_ = std::make_shared<std::vector<uint64_t>>(word_count, 0);
+  const int thread_count = cpu_threads();
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> key_component_ranges_per_thread(
+      thread_count,
+      std::vector<std::pair<int64_t, int64_t>>(
+          key_component_count,
+          {std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()}));
+  std::vector<std::future<void>> fill_threads;
+  const size_t entries_per_thread = (entry_count_ + thread_count - 1) / thread_count;
+  for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    const auto start_entry = std::min(thread_idx * entries_per_thread, entry_count_);
+    const auto end_entry = std::min(start_entry + entries_per_thread, entry_count_);
+    auto& key_component_ranges = key_component_ranges_per_thread[thread_idx];
+    fill_threads.emplace_back(std::async(std::launch::async, [&, start_entry, end_entry] {
+      if (key_component_width == 4) {
+        fill_join_runtime_filters(
+            *bloom_filter_,
+            key_component_ranges,
+            reinterpret_cast<const int32_t*>(&(*cpu_hash_table_buff_)[0]),
+            entry_size,
+            key_component_count,
+            start_entry,
+            end_entry);
+      } else {
+        CHECK_EQ(size_t(8), key_component_width);
+        fill_join_runtime_filters(
+            *bloom_filter_,
+            key_component_ranges,
+            reinterpret_cast<const int64_t*>(&(*cpu_hash_table_buff_)[0]),
+            entry_size,
+            key_component_count,
+            start_entry,
+            end_entry);
+      }
+    }));
+  }
+  for (auto& child : fill_threads) {
+    child.get();
+  }
+  key_component_ranges_ = key_component_ranges_per_thread.front();
+  for (const auto& key_component_ranges : key_component_ranges_per_thread) {
+    for (size_t i = 0; i < key_component_count; ++i) {
+      key_component_ranges_[i].first =
+          std::min(key_component_ranges_[i].first, key_component_ranges[i].first);
+      key_component_ranges_[i].second =
+          std::max(key_component_ranges_[i].second, key_component_ranges[i].second);
+    }
+  }
+}
+
+std::vector<JoinKeyRange> BaselineJoinHashTable::getProbeKeyRanges() const {
+  if (isBitwiseEq()) {
+    // null keys match each other
+    return {};
+  }
+  std::vector<JoinKeyRange> probe_key_ranges;
+  for (size_t i = 0; i < key_component_ranges_.size(); ++i) {
+    const auto& inner_outer_pair = inner_outer_pairs_[i];
+    if (!inner_outer_pair.first->get_type_info().is_integer() ||
+        !inner_outer_pair.second->get_type_info().is_integer()) {
+      continue;
+    }
+    probe_key_ranges.push_back({inner_outer_pair.second,
+                                key_component_ranges_[i].first,
+                                key_component_ranges_[i].second});
+  }
+  return probe_key_ranges;
+}
+
 int BaselineJoinHashTable::initHashTableOnGpu(
     const std::vector<JoinColumn>& join_columns,
     const std::vector<JoinColumnTypeInfo>& join_column_types,
@@ -960,10 +1114,15 @@ llvm::Value* BaselineJoinHashTable::codegenSlot(const CompilationOptions& co,
   const auto key_ptr_lv =
       LL_BUILDER.CreatePointerCast(key_buff_lv, llvm::Type::getInt8PtrTy(LL_CONTEXT));
   const auto key_size_lv = LL_INT(getKeyComponentCount() * key_component_width);
-  return executor_->cgen_state_->emitExternalCall(
-      "baseline_hash_join_idx_" + std::to_string(key_component_width * 8),
-      get_int_type(64, LL_CONTEXT),
-      {hash_ptr, key_ptr_lv, key_size_lv, LL_INT(entry_count_)});
+  return codegenBloomFilteredLookup(
+      key_buff_lv,
+      [&] {
+        return executor_->cgen_state_->emitExternalCall(
+            "baseline_hash_join_idx_" + std::to_string(key_component_width * 8),
+            get_int_type(64, LL_CONTEXT),
+            {hash_ptr, key_ptr_lv, key_size_lv, LL_INT(entry_count_)});
+      },
+      co);
 }
 
 HashJoinMatchingSet BaselineJoinHashTable::codegenMatchingSet(
@@ -981,13 +1140,18 @@ HashJoinMatchingSet BaselineJoinHashTable::codegenMatchingSet(
           ? LL_BUILDER.CreatePointerCast(hash_ptr, composite_dict_ptr_type)
           : LL_BUILDER.CreateIntToPtr(hash_ptr, composite_dict_ptr_type);
   const auto key_component_count = getKeyComponentCount();
-  const auto key = executor_->cgen_state_->emitExternalCall(
-      "get_composite_key_index_" + std::to_string(key_component_width * 8),
-      get_int_type(64, LL_CONTEXT),
-      {key_buff_lv,
-       LL_INT(key_component_count),
-       composite_key_dict,
-       LL_INT(entry_count_)});
+  const auto key = codegenBloomFilteredLookup(
+      key_buff_lv,
+      [&] {
+        return executor_->cgen_state_->emitExternalCall(
+            "get_composite_key_index_" + std::to_string(key_component_width * 8),
+            get_int_type(64, LL_CONTEXT),
+            {key_buff_lv,
+             LL_INT(key_component_count),
+             composite_key_dict,
+             LL_INT(entry_count_)});
+      },
+      co);
   auto one_to_many_ptr = hash_ptr;
   if (one_to_many_ptr->getType()->isPointerTy()) {
     one_to_many_ptr =
@@ -1061,6 +1225,54 @@ llvm::Value* BaselineJoinHashTable::codegenKey(const CompilationOptions& co) {
   return key_buff_lv;
 }
 
+// Skips the lookup generated by codegen_lookup, which must return -1 for keys which
+// aren't in the table, when the bloom filter rules out the key.
+llvm::Value* BaselineJoinHashTable::codegenBloomFilteredLookup(
+    llvm::Value* key_buff_lv,
+    const std::function<llvm::Value*()>& codegen_lookup,
+    const CompilationOptions& co) {
+  if (!bloom_filter_ || !co.hoist_literals_) {
+    return codegen_lookup();
+  }
+  // Hoisted like the handle of an InValuesBitmap, the generated code doesn't depend on
+  // the address of the filter.
+  const int64_t bloom_filter_handle = reinterpret_cast<int64_t>(bloom_filter_->data());
+  const auto bloom_filter_handle_literal = std::dynamic_pointer_cast<Analyzer::Constant>(
+      Parser::IntLiteral::analyzeValue(bloom_filter_handle));
+  CHECK(bloom_filter_handle_literal);
+  CodeGenerator code_generator(executor_);
+  const auto bloom_filter_handle_lvs = code_generator.codegenHoistedConstants(
+      {bloom_filter_handle_literal.get()}, kENCODING_NONE, 0);
+  CHECK_EQ(size_t(1), bloom_filter_handle_lvs.size());
+  const auto bloom_filter_lv = LL_BUILDER.CreateIntToPtr(
+      bloom_filter_handle_lvs.front(), llvm::Type::getInt64PtrTy(LL_CONTEXT));
+  const auto key_ptr_lv =
+      LL_BUILDER.CreatePointerCast(key_buff_lv, llvm::Type::getInt8PtrTy(LL_CONTEXT));
+  const auto key_size_lv = LL_INT(getKeyComponentCount() * getKeyComponentWidth());
+  const auto may_contain_lv = executor_->cgen_state_->emitExternalCall(
+      "baseline_hash_join_bloom_filter_contains",
+      llvm::Type::getInt1Ty(LL_CONTEXT),
+      {bloom_filter_lv,
+       LL_INT(static_cast<int64_t>(bloom_filter_->size())),
+       key_ptr_lv,
+       key_size_lv});
+  const auto filter_bb = LL_BUILDER.GetInsertBlock();
+  const auto lookup_bb =
+      llvm::BasicBlock::Create(LL_CONTEXT, "bloom_filter_hit", ROW_FUNC);
+  const auto done_bb =
+      llvm::BasicBlock::Create(LL_CONTEXT, "bloom_filter_done", ROW_FUNC);
+  LL_BUILDER.CreateCondBr(may_contain_lv, lookup_bb, done_bb);
+  LL_BUILDER.SetInsertPoint(lookup_bb);
+  const auto lookup_lv = codegen_lookup();
+  const auto lookup_end_bb = LL_BUILDER.GetInsertBlock();
+  LL_BUILDER.CreateBr(done_bb);
+  LL_BUILDER.SetInsertPoint(done_bb);
+  auto result_lv = LL_BUILDER.CreatePHI(lookup_lv->getType(), 2);
+  result_lv->addIncoming(LL_INT(int64_t(-1)), filter_bb);
+  result_lv->addIncoming(lookup_lv, lookup_end_bb);
+  return result_lv;
+}
+
 llvm::Value* BaselineJoinHashTable::hashPtr(const size_t index) {
   auto hash_ptr = JoinHashTable::codegenHashTableLoad(index, executor_);
   const auto pi8_type = llvm::Type::getInt8PtrTy(LL_CONTEXT);
@@ -1114,50 +1326,46 @@ void BaselineJoinHashTable::checkHashJoinReplicationConstraint(const int table_i
   }
 }
 
-const BaselineJoinHashTable::HashTableCacheValue*
-BaselineJoinHashTable::findHashTableOnCpuInCache(const HashTableCacheKey& key) {
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      return &kv.second;
-    }
-  }
-  return nullptr;
+std::shared_ptr<BaselineJoinHashTable::HashTableCacheValue>
+BaselineJoinHashTable::findHashTableOnCpuInCache(const HashTableCacheKey& key) const {
+  return hash_table_cache_.get(key);
 }
 
 void BaselineJoinHashTable::initHashTableOnCpuFromCache(const HashTableCacheKey& key) {
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      cpu_hash_table_buff_ = kv.second.buffer;
-      layout_ = kv.second.type;
-      entry_count_ = kv.second.entry_count;
-      emitted_keys_count_ = kv.second.emitted_keys_count;
-      break;
-    }
+  const auto cache_value = findHashTableOnCpuInCache(key);
+  if (cache_value) {
+    cpu_hash_table_buff_ = cache_value->buffer;
+    layout_ = cache_value->type;
+    entry_count_ = cache_value->entry_count;
+    emitted_keys_count_ = cache_value->emitted_keys_count;
+    bloom_filter_ = cache_value->bloom_filter;
+    key_component_ranges_ = cache_value->key_component_ranges;
   }
 }
 
-void BaselineJoinHashTable::putHashTableOnCpuToCache(const HashTableCacheKey& key) {
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (std::get<0>(kv) == key) {
-      return;
-    }
+void BaselineJoinHashTable::putHashTableOnCpuToCache(const HashTableCacheKey& key,
+                                                     const size_t build_time_us) {
+  if (findHashTableOnCpuInCache(key)) {
+    return;
   }
-  hash_table_cache_.emplace_back(
+  hash_table_cache_.setBudget(std::numeric_limits<size_t>::max(),
+                              g_join_hash_table_cache_max_bytes);
+  hash_table_cache_.put(
       key,
-      HashTableCacheValue{
-          cpu_hash_table_buff_, layout_, entry_count_, emitted_keys_count_});
+      HashTableCacheValue{cpu_hash_table_buff_,
+                          layout_,
+                          entry_count_,
+                          emitted_keys_count_,
+                          bloom_filter_,
+                          key_component_ranges_},
+      get_hash_table_cache_credits(build_time_us, cpu_hash_table_buff_->size()));
 }
 
 std::pair<ssize_t, size_t> BaselineJoinHashTable::getApproximateTupleCountFromCache(
     const HashTableCacheKey& key) const {
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      return std::make_pair(kv.second.entry_count / 2, kv.second.emitted_keys_count);
-    }
+  const auto cache_value = findHashTableOnCpuInCache(key);
+  if (cache_value) {
+    return std::make_pair(cache_value->entry_count / 2, cache_value->emitted_keys_count);
   }
   return std::make_pair(-1, 0);
 }
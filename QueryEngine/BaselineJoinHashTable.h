@@ -18,16 +18,21 @@
 
 #include "../Analyzer/Analyzer.h"
 #include "../DataMgr/MemoryLevel.h"
+#include "../StringDictionary/ConcurrentLruCache.hpp"
 #include "ColumnarResults.h"
 #include "Descriptors/RowSetMemoryOwner.h"
 #include "HashJoinRuntime.h"
 #include "InputMetadata.h"
 #include "JoinHashTableInterface.h"
 
+#include <boost/functional/hash.hpp>
+
 #ifdef HAVE_CUDA
 #include <cuda.h>
 #endif
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <thread>
@@ -76,13 +81,23 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   size_t payloadBufferOff() const noexcept override;
 
+  std::vector<JoinKeyRange> getProbeKeyRanges() const override;
+
   static auto yieldCacheInvalidator() -> std::function<void()> {
-    return []() -> void {
-      std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-      hash_table_cache_.clear();
+    return []() -> void { hash_table_cache_.clear(); };
+  }
+
+  static auto yieldTableCacheInvalidator(const int db_id, const int table_id)
+      -> std::function<void()> {
+    return [db_id, table_id]() -> void {
+      hash_table_cache_.eraseIf([db_id, table_id](const HashTableCacheKey& key) {
+        return cacheKeyReferencesTable(key, db_id, table_id);
+      });
     };
   }
 
+  static size_t getCacheSizeBytes() { return hash_table_cache_.sizeBytes(); }
+
   virtual ~BaselineJoinHashTable() {}
 
  private:
@@ -177,6 +192,13 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   llvm::Value* hashPtr(const size_t index);
 
+  void initRuntimeFilters();
+
+  llvm::Value* codegenBloomFilteredLookup(
+      llvm::Value* key_buff_lv,
+      const std::function<llvm::Value*()>& codegen_lookup,
+      const CompilationOptions& co);
+
   struct HashTableCacheKey {
     const size_t num_elements;
     const std::vector<ChunkKey> chunk_keys;
@@ -211,9 +233,19 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
     }
   };
 
+  static bool cacheKeyReferencesTable(const HashTableCacheKey& key,
+                                      const int db_id,
+                                      const int table_id) {
+    return std::any_of(key.chunk_keys.begin(),
+                       key.chunk_keys.end(),
+                       [db_id, table_id](const ChunkKey& chunk_key) {
+                         return chunk_key[0] == db_id && chunk_key[1] == table_id;
+                       });
+  }
+
   void initHashTableOnCpuFromCache(const HashTableCacheKey&);
 
-  void putHashTableOnCpuToCache(const HashTableCacheKey&);
+  void putHashTableOnCpuToCache(const HashTableCacheKey&, const size_t build_time_us);
 
   std::pair<ssize_t, size_t> getApproximateTupleCountFromCache(
       const HashTableCacheKey&) const;
@@ -244,6 +276,9 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
   RowSetMemoryOwner linearized_multifrag_column_owner_;
   std::vector<InnerOuter> inner_outer_pairs_;
   const Catalog_Namespace::Catalog* catalog_;
+  // Filters on the keys of a table built on CPU, see g_enable_runtime_join_filters.
+  std::shared_ptr<std::vector<uint64_t>> bloom_filter_;
+  std::vector<std::pair<int64_t, int64_t>> key_component_ranges_;
 #ifdef HAVE_CUDA
   unsigned block_size_;
   unsigned grid_size_;
@@ -254,12 +289,25 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
     const JoinHashTableInterface::HashType type;
     const size_t entry_count;
     const size_t emitted_keys_count;
+    const std::shared_ptr<std::vector<uint64_t>> bloom_filter;
+    const std::vector<std::pair<int64_t, int64_t>> key_component_ranges;
+  };
+
+  // The overlaps bucket threshold is compared with a tolerance, leave it out of the hash.
+  struct HashTableCacheKeyHash {
+    size_t operator()(const HashTableCacheKey& key) const {
+      size_t seed = boost::hash_value(key.chunk_keys);
+      boost::hash_combine(seed, key.num_elements);
+      boost::hash_combine(seed, static_cast<int>(key.optype));
+      return seed;
+    }
   };
 
-  const HashTableCacheValue* findHashTableOnCpuInCache(const HashTableCacheKey&);
+  std::shared_ptr<HashTableCacheValue> findHashTableOnCpuInCache(
+      const HashTableCacheKey&) const;
 
-  static std::vector<std::pair<HashTableCacheKey, HashTableCacheValue>> hash_table_cache_;
-  static std::mutex hash_table_cache_mutex_;
+  static ConcurrentLruCache<HashTableCacheKey, HashTableCacheValue, HashTableCacheKeyHash>
+      hash_table_cache_;
 
   static const int ERR_FAILED_TO_FETCH_COLUMN{-3};
   static const int ERR_FAILED_TO_JOIN_ON_VIRTUAL_COLUMN{-4};
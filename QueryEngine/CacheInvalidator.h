@@ -22,6 +22,11 @@ class CacheInvalidator {
  public:
   static void invalidateCaches() { internalInvalidateCache<CACHE_HOLDING_TYPES...>(); }
 
+  // Only invalidates the cached entries which depend on the given table.
+  static void invalidateCachesForTable(const int db_id, const int table_id) {
+    internalInvalidateTableCache<CACHE_HOLDING_TYPES...>(db_id, table_id);
+  }
+
  private:
   CacheInvalidator() = delete;
   ~CacheInvalidator() = delete;
@@ -39,6 +44,20 @@ class CacheInvalidator {
     internalInvalidateCache<SECOND_CACHE_HOLDING_TYPE,
                             REMAINING_CACHE_HOLDING_TYPES...>();
   }
+
+  template <typename CACHE_HOLDING_TYPE>
+  static void internalInvalidateTableCache(const int db_id, const int table_id) {
+    CACHE_HOLDING_TYPE::yieldTableCacheInvalidator(db_id, table_id)();
+  }
+
+  template <typename FIRST_CACHE_HOLDING_TYPE,
+            typename SECOND_CACHE_HOLDING_TYPE,
+            typename... REMAINING_CACHE_HOLDING_TYPES>
+  static void internalInvalidateTableCache(const int db_id, const int table_id) {
+    FIRST_CACHE_HOLDING_TYPE::yieldTableCacheInvalidator(db_id, table_id)();
+    internalInvalidateTableCache<SECOND_CACHE_HOLDING_TYPE,
+                                 REMAINING_CACHE_HOLDING_TYPES...>(db_id, table_id);
+  }
 };
 
 #endif
@@ -134,7 +134,7 @@ llvm::Value* CgenState::castToTypeIn(llvm::Value* val, const size_t dst_bits) {
 llvm::Value* CgenState::emitCall(const std::string& fname,
                                  const std::vector<llvm::Value*>& args) {
   // Get the implementation from the runtime module.
-  auto func_impl = g_rt_module->getFunction(fname);
+  auto func_impl = (rt_module_ ? rt_module_ : g_rt_module.get())->getFunction(fname);
   CHECK(func_impl);
   // Get the function reference from the query module.
   auto func = module_->getFunction(fname);
@@ -20,6 +20,7 @@
 #include "InValuesBitmap.h"
 #include "InputMetadata.h"
 #include "LLVMGlobalContext.h"
+#include "StringIdLookupTable.h"
 
 #include "../Analyzer/Analyzer.h"
 
@@ -31,9 +32,22 @@ struct CgenState {
  public:
   CgenState(const std::vector<InputTableInfo>& query_infos,
             const bool contains_left_deep_outer_join)
+      : CgenState(query_infos,
+                  contains_left_deep_outer_join,
+                  getGlobalLLVMContext(),
+                  nullptr){};
+
+  // Generates code in the given context instead of the global one, which allows code
+  // generation concurrently with the queries. The runtime module must be loaded in the
+  // same context.
+  CgenState(const std::vector<InputTableInfo>& query_infos,
+            const bool contains_left_deep_outer_join,
+            llvm::LLVMContext& context,
+            llvm::Module* rt_module)
       : module_(nullptr)
       , row_func_(nullptr)
-      , context_(getGlobalLLVMContext())
+      , context_(context)
+      , rt_module_(rt_module)
       , ir_builder_(context_)
       , contains_left_deep_outer_join_(contains_left_deep_outer_join)
       , outer_join_match_found_per_level_(std::max(query_infos.size(), size_t(1)) - 1)
@@ -198,6 +212,12 @@ struct CgenState {
     in_values_bitmaps_.emplace_back(std::move(in_values_bitmap));
     return in_values_bitmaps_.back().get();
   }
+
+  const StringIdLookupTable* addStringIdLookupTable(
+      std::unique_ptr<StringIdLookupTable>& string_id_lookup_table) {
+    string_id_lookup_tables_.emplace_back(std::move(string_id_lookup_table));
+    return string_id_lookup_tables_.back().get();
+  }
   // look up a runtime function based on the name, return type and type of
   // the arguments and call it; x64 only, don't call from GPU codegen
   llvm::Value* emitExternalCall(
@@ -264,6 +284,7 @@ struct CgenState {
   llvm::Function* row_func_;
   std::vector<llvm::Function*> helper_functions_;
   llvm::LLVMContext& context_;
+  llvm::Module* rt_module_;       // null for the runtime module of the global context
   llvm::ValueToValueMapTy vmap_;  // used for cloning the runtime module
   llvm::IRBuilder<> ir_builder_;
   std::unordered_map<int, std::vector<llvm::Value*>> fetch_cache_;
@@ -279,6 +300,7 @@ struct CgenState {
   std::vector<llvm::Value*> outer_join_match_found_per_level_;
   std::unordered_map<int, llvm::Value*> scan_idx_to_hash_pos_;
   std::vector<std::unique_ptr<const InValuesBitmap>> in_values_bitmaps_;
+  std::vector<std::unique_ptr<const StringIdLookupTable>> string_id_lookup_tables_;
   const std::vector<InputTableInfo>& query_infos_;
   bool needs_error_check_;
   // Track whether external calls have been emitted.
@@ -18,7 +18,7 @@
 
 #include "CompilationOptions.h"
 
-#include "../StringDictionary/LruCache.hpp"
+#include "../StringDictionary/ConcurrentLruCache.hpp"
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
@@ -38,10 +38,16 @@ class ExecutionEngineWrapper {
   ExecutionEngineWrapper(ExecutionEngineWrapper&& other) = default;
 
   ExecutionEngineWrapper& operator=(const ExecutionEngineWrapper& other) = delete;
-  ExecutionEngineWrapper& operator=(ExecutionEngineWrapper&& other) = default;
+  ExecutionEngineWrapper& operator=(ExecutionEngineWrapper&& other);
 
   ExecutionEngineWrapper& operator=(llvm::ExecutionEngine* execution_engine);
 
+  // Takes ownership of the context of the compiled module, for modules which don't live
+  // in the global context.
+  void setContext(std::unique_ptr<llvm::LLVMContext> context) {
+    context_ = std::move(context);
+  }
+
   llvm::ExecutionEngine* get() { return execution_engine_.get(); }
   const llvm::ExecutionEngine* get() const { return execution_engine_.get(); }
 
@@ -52,6 +58,8 @@ class ExecutionEngineWrapper {
   const llvm::ExecutionEngine* operator->() const { return execution_engine_.get(); }
 
  private:
+  // declared first, the engine must be destroyed before the context of its module
+  std::unique_ptr<llvm::LLVMContext> context_;
   std::unique_ptr<llvm::ExecutionEngine> execution_engine_;
   std::unique_ptr<llvm::JITEventListener> intel_jit_listener_;
 };
@@ -63,4 +71,4 @@ using CodeCacheVal = std::vector<
     std::tuple<void*, ExecutionEngineWrapper, std::unique_ptr<GpuCompilationContext>>>;
 using CodeCacheValWithModule = std::pair<CodeCacheVal, llvm::Module*>;
 using CodeCache =
-    LruCache<CodeCacheKey, CodeCacheValWithModule, boost::hash<CodeCacheKey>>;
+    ConcurrentLruCache<CodeCacheKey, CodeCacheValWithModule, boost::hash<CodeCacheKey>>;
@@ -72,7 +72,8 @@ class CodeGenerator {
   static ExecutionEngineWrapper generateNativeCPUCode(
       llvm::Function* func,
       const std::unordered_set<llvm::Function*>& live_funcs,
-      const CompilationOptions& co);
+      const CompilationOptions& co,
+      const bool fast_codegen = false);
 
   static std::string generatePTX(const std::string& cuda_llir,
                                  llvm::TargetMachine* nvptx_target_machine,
@@ -349,6 +350,9 @@ class CodeGenerator {
   llvm::Value* codegenLogicalShortCircuit(const Analyzer::BinOper*,
                                           const CompilationOptions&);
 
+  llvm::Value* codegenDictCharLength(const Analyzer::CharLengthExpr*,
+                                     const CompilationOptions&);
+
   llvm::Value* codegenDictLike(const std::shared_ptr<Analyzer::Expr> arg,
                                const Analyzer::Constant* pattern,
                                const bool ilike,
@@ -17,6 +17,8 @@
 #include "ColumnFetcher.h"
 #include "Execute.h"
 
+#include <array>
+
 ColumnFetcher::ColumnFetcher(Executor* executor, const ColumnCacheMap& column_cache)
     : executor_(executor), columnarized_table_cache_(column_cache) {}
 
@@ -44,14 +46,19 @@ std::pair<const int8_t*, size_t> ColumnFetcher::getOneColumnFragment(
                        fragment.physicalTableId,
                        hash_col.get_column_id(),
                        fragment.fragmentId};
-    const auto chunk = Chunk_NS::Chunk::getChunk(
-        cd,
-        &catalog.getDataMgr(),
-        chunk_key,
-        effective_mem_lvl,
-        effective_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id,
-        chunk_meta_it->second.numBytes,
-        chunk_meta_it->second.numElements);
+    const int chunk_device_id =
+        effective_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id;
+    const bool was_resident = catalog.getDataMgr().isBufferOnDevice(
+        chunk_key, effective_mem_lvl, chunk_device_id);
+    const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                 &catalog.getDataMgr(),
+                                                 chunk_key,
+                                                 effective_mem_lvl,
+                                                 chunk_device_id,
+                                                 chunk_meta_it->second.numBytes,
+                                                 chunk_meta_it->second.numElements);
+    executor->query_profile_.addFetchedBytes(
+        effective_mem_lvl, chunk_meta_it->second.numBytes, was_resident);
     chunks_owner.push_back(chunk);
     CHECK(chunk);
     auto ab = chunk->get_buffer();
@@ -139,7 +146,10 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
     std::list<ChunkIter>& chunk_iter_holder,
     const Data_Namespace::MemoryLevel memory_level,
     const int device_id) const {
-  static std::mutex varlen_chunk_mutex;  // TODO(alex): remove
+  // Fetching a varlen chunk populates both its data and index buffers, which must not
+  // race with another fetch of the same chunk. Stripe the locks by chunk key so that
+  // fetches of unrelated chunks can proceed concurrently.
+  static std::array<std::mutex, 64> varlen_chunk_mutexes;
   static std::mutex chunk_list_mutex;
   const auto fragments_it = all_tables_fragments.find(table_id);
   CHECK(fragments_it != all_tables_fragments.end());
@@ -167,16 +177,27 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
         cat.getCurrentDB().dbId, fragment.physicalTableId, col_id, fragment.fragmentId};
     std::unique_ptr<std::lock_guard<std::mutex>> varlen_chunk_lock;
     if (is_varlen) {
+      auto& varlen_chunk_mutex =
+          varlen_chunk_mutexes[std::hash<ChunkKey>()(chunk_key) %
+                               varlen_chunk_mutexes.size()];
       varlen_chunk_lock.reset(new std::lock_guard<std::mutex>(varlen_chunk_mutex));
     }
-    chunk = Chunk_NS::Chunk::getChunk(
-        cd,
-        &cat.getDataMgr(),
-        chunk_key,
-        memory_level,
-        memory_level == Data_Namespace::CPU_LEVEL ? 0 : device_id,
-        chunk_meta_it->second.numBytes,
-        chunk_meta_it->second.numElements);
+    const int chunk_device_id = memory_level == Data_Namespace::CPU_LEVEL ? 0 : device_id;
+    ChunkKey data_buffer_key{chunk_key};
+    if (is_varlen) {
+      data_buffer_key.push_back(1);
+    }
+    const bool was_resident = cat.getDataMgr().isBufferOnDevice(
+        data_buffer_key, memory_level, chunk_device_id);
+    chunk = Chunk_NS::Chunk::getChunk(cd,
+                                      &cat.getDataMgr(),
+                                      chunk_key,
+                                      memory_level,
+                                      chunk_device_id,
+                                      chunk_meta_it->second.numBytes,
+                                      chunk_meta_it->second.numElements);
+    executor_->query_profile_.addFetchedBytes(
+        memory_level, chunk_meta_it->second.numBytes, was_resident);
     std::lock_guard<std::mutex> chunk_list_lock(chunk_list_mutex);
     chunk_holder.push_back(chunk);
   }
@@ -280,20 +301,20 @@ const int8_t* ColumnFetcher::transferColumnIfNeeded(
   if (!columnar_results) {
     return nullptr;
   }
-  const auto& col_buffers = columnar_results->getColumnBuffers();
-  CHECK_LT(static_cast<size_t>(col_id), col_buffers.size());
+  CHECK_LT(static_cast<size_t>(col_id), columnar_results->getColumnCount());
+  const auto col_buffer = columnar_results->getColumnBuffer(col_id);
   if (memory_level == Data_Namespace::GPU_LEVEL) {
     const auto& col_ti = columnar_results->getColumnType(col_id);
     const auto num_bytes = columnar_results->size() * col_ti.get_size();
     auto gpu_col_buffer = CudaAllocator::alloc(data_mgr, num_bytes, device_id);
     copy_to_gpu(data_mgr,
                 reinterpret_cast<CUdeviceptr>(gpu_col_buffer),
-                col_buffers[col_id],
+                col_buffer,
                 num_bytes,
                 device_id);
     return gpu_col_buffer;
   }
-  return col_buffers[col_id];
+  return col_buffer;
 }
 
 const int8_t* ColumnFetcher::getResultSetColumn(
@@ -44,7 +44,8 @@ ColumnarResults::ColumnarResults(
     const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
     const ResultSet& rows,
     const size_t num_columns,
-    const std::vector<SQLTypeInfo>& target_types)
+    const std::vector<SQLTypeInfo>& target_types,
+    const std::shared_ptr<const ResultSet>& rows_owner)
     : column_buffers_(num_columns)
     , num_rows_(use_parallel_algorithms(rows) || rows.isDirectColumnarConversionPossible()
                     ? rows.entryCount()
@@ -53,6 +54,14 @@ ColumnarResults::ColumnarResults(
     , parallel_conversion_(use_parallel_algorithms(rows))
     , direct_columnar_conversion_(rows.isDirectColumnarConversionPossible()) {
   column_buffers_.resize(num_columns);
+  const bool use_columns_in_place =
+      rows_owner && rows_owner.get() == &rows && isDirectColumnarConversionPossible() &&
+      rows.getQueryDescriptionType() == QueryDescriptionType::Projection;
+  if (use_columns_in_place) {
+    rows_owner_ = rows_owner;
+    in_place_column_buffers_.resize(num_columns, nullptr);
+  }
+  const auto& lazy_fetch_info = rows.getLazyFetchInfo();
   for (size_t i = 0; i < num_columns; ++i) {
     const bool is_varlen = target_types[i].is_array() ||
                            (target_types[i].is_string() &&
@@ -61,6 +70,14 @@ ColumnarResults::ColumnarResults(
     if (is_varlen) {
       throw ColumnarConversionNotSupported();
     }
+    if (use_columns_in_place &&
+        (lazy_fetch_info.empty() || !lazy_fetch_info[i].is_lazily_fetched) &&
+        rows.getPaddedSlotWidthBytes(i) == target_types[i].get_size()) {
+      in_place_column_buffers_[i] = rows.getColumnarBuffer(i);
+      if (in_place_column_buffers_[i]) {
+        continue;
+      }
+    }
     column_buffers_[i] =
         reinterpret_cast<int8_t*>(checked_malloc(num_rows_ * target_types[i].get_size()));
     row_set_mem_owner->addColBuffer(column_buffers_[i]);
@@ -179,7 +196,7 @@ std::unique_ptr<ColumnarResults> ColumnarResults::mergeResults(
         continue;
       }
       CHECK_EQ(byte_width, rs->getColumnType(col_idx).get_size());
-      memcpy(write_ptr, rs->column_buffers_[col_idx], rs->size() * byte_width);
+      memcpy(write_ptr, rs->getColumnBuffer(col_idx), rs->size() * byte_width);
       write_ptr += rs->size() * byte_width;
     }
   }
@@ -338,7 +355,7 @@ void ColumnarResults::copyAllNonLazyColumns(
   // parallelized by assigning each column to a thread
   std::vector<std::future<void>> direct_copy_threads;
   for (size_t col_idx = 0; col_idx < num_columns; col_idx++) {
-    if (is_column_non_lazily_fetched(col_idx)) {
+    if (is_column_non_lazily_fetched(col_idx) && !isColumnInPlace(col_idx)) {
       direct_copy_threads.push_back(std::async(
           std::launch::async,
           [&rows, this](const size_t column_index) {
@@ -446,7 +463,7 @@ ENTRY_TYPE ColumnarResults::getEntryAt(const size_t row_idx,
                                        const size_t column_idx) const {
   CHECK_LT(column_idx, column_buffers_.size());
   CHECK_LT(row_idx, num_rows_);
-  return reinterpret_cast<ENTRY_TYPE*>(column_buffers_[column_idx])[row_idx];
+  return reinterpret_cast<const ENTRY_TYPE*>(getColumnBuffer(column_idx))[row_idx];
 }
 template int64_t ColumnarResults::getEntryAt<int64_t>(const size_t row_idx,
                                                       const size_t column_idx) const;
@@ -462,7 +479,7 @@ float ColumnarResults::getEntryAt<float>(const size_t row_idx,
                                          const size_t column_idx) const {
   CHECK_LT(column_idx, column_buffers_.size());
   CHECK_LT(row_idx, num_rows_);
-  return reinterpret_cast<float*>(column_buffers_[column_idx])[row_idx];
+  return reinterpret_cast<const float*>(getColumnBuffer(column_idx))[row_idx];
 }
 
 template <>
@@ -470,7 +487,7 @@ double ColumnarResults::getEntryAt<double>(const size_t row_idx,
                                            const size_t column_idx) const {
   CHECK_LT(column_idx, column_buffers_.size());
   CHECK_LT(row_idx, num_rows_);
-  return reinterpret_cast<double*>(column_buffers_[column_idx])[row_idx];
+  return reinterpret_cast<const double*>(getColumnBuffer(column_idx))[row_idx];
 }
 
 /**
@@ -55,10 +55,14 @@ class ColumnBitmap {
 
 class ColumnarResults {
  public:
+  // If rows_owner owns rows, the columns a columnar projection already stores
+  // contiguously are used in place instead of being copied, and rows_owner keeps their
+  // storage alive for as long as this object. Such columns are read-only.
   ColumnarResults(const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
                   const ResultSet& rows,
                   const size_t num_columns,
-                  const std::vector<SQLTypeInfo>& target_types);
+                  const std::vector<SQLTypeInfo>& target_types,
+                  const std::shared_ptr<const ResultSet>& rows_owner = nullptr);
 
   ColumnarResults(const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
                   const int8_t* one_col_buffer,
@@ -69,7 +73,15 @@ class ColumnarResults {
       const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
       const std::vector<std::unique_ptr<ColumnarResults>>& sub_results);
 
-  const std::vector<int8_t*>& getColumnBuffers() const { return column_buffers_; }
+  // Columns used in place belong to the source result set, hence the buffers are
+  // handed out read-only.
+  const int8_t* getColumnBuffer(const size_t column_idx) const {
+    CHECK_LT(column_idx, column_buffers_.size());
+    return isColumnInPlace(column_idx) ? in_place_column_buffers_[column_idx]
+                                       : column_buffers_[column_idx];
+  }
+
+  size_t getColumnCount() const { return column_buffers_.size(); }
 
   const size_t size() const { return num_rows_; }
 
@@ -87,6 +99,9 @@ class ColumnarResults {
   }
   bool isParallelConversion() const { return parallel_conversion_; }
   bool isDirectColumnarConversionPossible() const { return direct_columnar_conversion_; }
+  bool isColumnInPlace(const size_t column_idx) const {
+    return !in_place_column_buffers_.empty() && in_place_column_buffers_[column_idx];
+  }
 
   using ReadFunctionPerfectHash =
       std::function<int64_t(const ResultSet&, const size_t, const size_t)>;
@@ -172,7 +187,9 @@ class ColumnarResults {
                                  const ResultSet& rows,
                                  const size_t num_columns);
 
-  std::vector<int8_t*> column_buffers_;
+  std::vector<int8_t*> column_buffers_;  // nullptr for the columns used in place
+  std::shared_ptr<const ResultSet> rows_owner_;  // set if columns are used in place
+  std::vector<const int8_t*> in_place_column_buffers_;
   size_t num_rows_;
   const std::vector<SQLTypeInfo> target_types_;
   bool parallel_conversion_;  // multi-threaded execution of columnar conversion
@@ -152,7 +152,8 @@ class DeepCopyVisitor : public ScalarExprVisitor<std::shared_ptr<Analyzer::Expr>
                                               args_copy,
                                               partition_keys_copy,
                                               order_keys_copy,
-                                              window_func->getCollation());
+                                              window_func->getCollation(),
+                                              window_func->getFrame());
   }
 
   RetType visitFunctionOper(const Analyzer::FunctionOper* func_oper) const override {
@@ -94,11 +94,18 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
 
   for (size_t i = 0; i < outer_fragments->size(); ++i) {
     const auto& fragment = (*outer_fragments)[i];
-    const auto skip_frag = executor->skipFragment(
+    auto skip_frag = executor->skipFragment(
         outer_table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
+    if (!skip_frag.first) {
+      skip_frag.first = executor->skipFragmentByProbeKeyRanges(
+          outer_table_desc, fragment, frag_offsets, i);
+    }
     if (skip_frag.first) {
+      executor->query_profile_.add(QueryCounter::FragmentsSkipped, 1);
       continue;
     }
+    executor->query_profile_.add(QueryCounter::FragmentsScanned, 1);
+    executor->query_profile_.add(QueryCounter::RowsScanned, fragment.getNumTuples());
     // NOTE: Using kernel index instead of frag index now
     outer_fragment_tuple_sizes_.push_back(fragment.getNumTuples());
     rowid_lookup_key_ = std::max(rowid_lookup_key_, skip_frag.second);
@@ -174,9 +181,16 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
       skip_frag = executor->skipFragmentInnerJoins(
           outer_table_desc, ra_exe_unit, fragment, frag_offsets, outer_frag_id);
     }
+    if (!skip_frag.first) {
+      skip_frag.first = executor->skipFragmentByProbeKeyRanges(
+          outer_table_desc, fragment, frag_offsets, outer_frag_id);
+    }
     if (skip_frag.first) {
+      executor->query_profile_.add(QueryCounter::FragmentsSkipped, 1);
       continue;
     }
+    executor->query_profile_.add(QueryCounter::FragmentsScanned, 1);
+    executor->query_profile_.add(QueryCounter::RowsScanned, fragment.getNumTuples());
     const int device_id =
         fragment.shard == -1
             ? fragment.deviceIds[static_cast<int>(Data_Namespace::GPU_LEVEL)]
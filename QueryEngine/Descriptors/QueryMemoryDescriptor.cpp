@@ -25,6 +25,7 @@
 
 bool g_enable_smem_group_by{true};
 extern bool g_enable_columnar_output;
+extern bool g_enable_columnar_projections;
 
 namespace {
 
@@ -140,6 +141,29 @@ int8_t pick_baseline_key_width(const RelAlgExecutionUnit& ra_exe_unit,
   return compact_width;
 }
 
+// Projections run on CPU output columnar when all their targets are fixed width, which
+// lets the next query step and the columnar consumers of the result copy whole columns
+// instead of reassembling them row by row. Sorted projections are left row-wise, as
+// streaming top n only supports that layout.
+bool use_columnar_projection_output(const RelAlgExecutionUnit& ra_exe_unit,
+                                    const ExecutorDeviceType device_type,
+                                    const RenderInfo* render_info) {
+  if (!g_enable_columnar_projections || device_type != ExecutorDeviceType::CPU ||
+      g_cluster || ra_exe_unit.use_bump_allocator ||
+      !ra_exe_unit.sort_info.order_entries.empty() ||
+      (render_info && render_info->isPotentialInSituRender())) {
+    return false;
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    if (!target_expr || dynamic_cast<const Analyzer::AggExpr*>(target_expr) ||
+        dynamic_cast<const Analyzer::WindowFunction*>(target_expr) ||
+        target_expr->get_type_info().is_varlen()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 std::unique_ptr<QueryMemoryDescriptor> QueryMemoryDescriptor::init(
@@ -316,6 +340,8 @@ std::unique_ptr<QueryMemoryDescriptor> QueryMemoryDescriptor::init(
     case QueryDescriptionType::Projection: {
       CHECK(!must_use_baseline_sort);
 
+      output_columnar = output_columnar ||
+                        use_columnar_projection_output(ra_exe_unit, device_type, render_info);
       if (use_streaming_top_n(ra_exe_unit, output_columnar)) {
         entry_count = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
       } else {
@@ -17,10 +17,14 @@
 #pragma once
 
 #include "../StringDictionary/StringDictionaryProxy.h"
+#include "Shared/HostBufferPool.h"
 #include "Shared/Logger.h"
+#include "Shared/QueryMemoryBudget.h"
 
 #include <boost/noncopyable.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <set>
@@ -28,16 +32,35 @@
 #include <unordered_map>
 #include <vector>
 
+extern size_t g_query_buffer_pool_bytes;
+
 class ResultSet;
 
 class RowSetMemoryOwner : boost::noncopyable {
  public:
+  // The buffers allocated through this owner, the hash tables and the pinned chunks
+  // are charged to the given budget, if any.
+  explicit RowSetMemoryOwner(std::shared_ptr<QueryMemoryBudget> memory_budget = nullptr)
+      : memory_budget_(std::move(memory_budget)) {}
+
   void addCountDistinctBuffer(int8_t* count_distinct_buffer,
                               const size_t bytes,
                               const bool system_allocated) {
+    chargeMemoryBudget(bytes);
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    count_distinct_bitmaps_.emplace_back(CountDistinctBitmapBuffer{
+        count_distinct_buffer, bytes, system_allocated, false});
+  }
+
+  // Allocates a count distinct bitmap from the query buffer pool.
+  int8_t* allocateCountDistinctBuffer(const size_t bytes, const bool zero_fill = true) {
+    chargeMemoryBudget(bytes);
+    auto count_distinct_buffer = getBufferPool().allocate(bytes, zero_fill);
     std::lock_guard<std::mutex> lock(state_mutex_);
     count_distinct_bitmaps_.emplace_back(
-        CountDistinctBitmapBuffer{count_distinct_buffer, bytes, system_allocated});
+        CountDistinctBitmapBuffer{count_distinct_buffer, bytes, true, true});
+    pooled_bytes_ += bytes;
+    return count_distinct_buffer;
   }
 
   void addCountDistinctSet(std::set<int64_t>* count_distinct_set) {
@@ -45,9 +68,104 @@ class RowSetMemoryOwner : boost::noncopyable {
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
-  void addGroupByBuffer(int64_t* group_by_buffer) {
+  // Allocates an uninitialized group by buffer from the query buffer pool.
+  int64_t* allocateGroupByBuffer(const size_t bytes) {
+    chargeMemoryBudget(bytes);
+    auto group_by_buffer =
+        reinterpret_cast<int64_t*>(getBufferPool().allocate(bytes, false));
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    group_by_buffers_.emplace_back(group_by_buffer, bytes);
+    pooled_bytes_ += bytes;
+    return group_by_buffer;
+  }
+
+  // Returns the given group by buffers to the pool ahead of the owner's destruction.
+  // Used to release intermediate query step results which have no readers left.
+  // Buffers which aren't owned by this object are ignored.
+  void releaseGroupByBuffers(const std::vector<int8_t*>& buffers) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    for (const auto buffer : buffers) {
+      auto it = std::find_if(
+          group_by_buffers_.begin(),
+          group_by_buffers_.end(),
+          [buffer](const std::pair<int64_t*, size_t>& group_by_buffer) {
+            return group_by_buffer.first == reinterpret_cast<int64_t*>(buffer);
+          });
+      if (it != group_by_buffers_.end()) {
+        getBufferPool().release(reinterpret_cast<int8_t*>(it->first), it->second);
+        pooled_bytes_ -= it->second;
+        releaseMemoryBudget(it->second);
+        group_by_buffers_.erase(it);
+      }
+    }
+  }
+
+  // Bytes of the buffers this owner currently holds from the query buffer pool.
+  size_t getPooledBytes() const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    return pooled_bytes_;
+  }
+
+  // Charges memory the query holds outside of this owner to the query's budget, throws
+  // QueryMemoryBudgetExceeded if that goes over. Charges not released are released when
+  // the owner is destroyed.
+  void chargeMemoryBudget(const size_t bytes) {
+    if (!memory_budget_) {
+      return;
+    }
+    memory_budget_->charge(bytes);
+    charged_bytes_ += bytes;
+  }
+
+  void releaseMemoryBudget(const size_t bytes) {
+    if (!memory_budget_) {
+      return;
+    }
+    memory_budget_->release(bytes);
+    charged_bytes_ -= bytes;
+  }
+
+  // Charges the chunk buffers a kernel keeps pinned to the budget. The kernels of a
+  // query pin the same inner table and single fragment chunks concurrently, a buffer is
+  // charged once and released along with its last pin.
+  void chargePinnedBuffers(const std::vector<std::pair<const void*, size_t>>& buffers) {
+    if (!memory_budget_) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    size_t newly_pinned_bytes{0};
+    for (const auto& buffer : buffers) {
+      auto& pinned_buffer = pinned_buffers_[buffer.first];
+      if (!pinned_buffer.pin_count++) {
+        pinned_buffer.bytes = buffer.second;
+        newly_pinned_bytes += buffer.second;
+      }
+    }
+    try {
+      chargeMemoryBudget(newly_pinned_bytes);
+    } catch (...) {
+      unpinBuffers(buffers);
+      throw;
+    }
+  }
+
+  void releasePinnedBuffers(const std::vector<std::pair<const void*, size_t>>& buffers) {
+    if (!memory_budget_) {
+      return;
+    }
     std::lock_guard<std::mutex> lock(state_mutex_);
-    group_by_buffers_.push_back(group_by_buffer);
+    releaseMemoryBudget(unpinBuffers(buffers));
+  }
+
+  // Process-wide pool of the large output buffers and count distinct bitmaps, which
+  // keeps up to g_query_buffer_pool_bytes of them between queries. Never destroyed,
+  // owners can outlive the static objects.
+  static HostBufferPool& getBufferPool() {
+    static auto buffer_pool = new HostBufferPool(g_query_buffer_pool_bytes);
+    if (buffer_pool->getMaxCachedBytes() != g_query_buffer_pool_bytes) {
+      buffer_pool->setMaxCachedBytes(g_query_buffer_pool_bytes);
+    }
+    return *buffer_pool;
   }
 
   void addVarlenBuffer(void* varlen_buffer) {
@@ -107,16 +225,20 @@ class RowSetMemoryOwner : boost::noncopyable {
   }
 
   ~RowSetMemoryOwner() {
+    auto& buffer_pool = getBufferPool();
     for (const auto& count_distinct_buffer : count_distinct_bitmaps_) {
-      if (count_distinct_buffer.system_allocated) {
+      if (count_distinct_buffer.pooled) {
+        buffer_pool.release(count_distinct_buffer.ptr, count_distinct_buffer.size);
+      } else if (count_distinct_buffer.system_allocated) {
         free(count_distinct_buffer.ptr);
       }
     }
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
-    for (auto group_by_buffer : group_by_buffers_) {
-      free(group_by_buffer);
+    for (const auto& group_by_buffer : group_by_buffers_) {
+      buffer_pool.release(reinterpret_cast<int8_t*>(group_by_buffer.first),
+                          group_by_buffer.second);
     }
     for (auto varlen_buffer : varlen_buffers_) {
       free(varlen_buffer);
@@ -128,24 +250,51 @@ class RowSetMemoryOwner : boost::noncopyable {
     for (auto dict_proxy : str_dict_proxy_owned_) {
       delete dict_proxy.second;
     }
+    if (memory_budget_) {
+      memory_budget_->release(charged_bytes_);
+    }
   }
 
  private:
+  // Drops a pin of each buffer, returns the bytes of the buffers left without pins.
+  size_t unpinBuffers(const std::vector<std::pair<const void*, size_t>>& buffers) {
+    size_t unpinned_bytes{0};
+    for (const auto& buffer : buffers) {
+      auto it = pinned_buffers_.find(buffer.first);
+      CHECK(it != pinned_buffers_.end());
+      if (!--it->second.pin_count) {
+        unpinned_bytes += it->second.bytes;
+        pinned_buffers_.erase(it);
+      }
+    }
+    return unpinned_bytes;
+  }
+
+  struct PinnedBuffer {
+    size_t pin_count{0};
+    size_t bytes{0};
+  };
+
   struct CountDistinctBitmapBuffer {
     int8_t* ptr;
     const size_t size;
     const bool system_allocated;
+    const bool pooled;
   };
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
   std::vector<std::set<int64_t>*> count_distinct_sets_;
-  std::vector<int64_t*> group_by_buffers_;
+  std::vector<std::pair<int64_t*, size_t>> group_by_buffers_;
+  size_t pooled_bytes_{0};
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
   std::list<std::vector<int64_t>> arrays_;
   std::unordered_map<int, StringDictionaryProxy*> str_dict_proxy_owned_;
   std::shared_ptr<StringDictionaryProxy> lit_str_dict_proxy_;
   std::vector<void*> col_buffers_;
+  std::unordered_map<const void*, PinnedBuffer> pinned_buffers_;
+  std::shared_ptr<QueryMemoryBudget> memory_budget_;
+  std::atomic<size_t> charged_bytes_{0};
   mutable std::mutex state_mutex_;
 
   friend class ResultSet;
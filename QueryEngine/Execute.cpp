@@ -82,10 +82,14 @@ float g_filter_push_down_low_frac{-1.0f};
 float g_filter_push_down_high_frac{-1.0f};
 size_t g_filter_push_down_passing_row_ubound{0};
 bool g_enable_columnar_output{false};
+bool g_enable_columnar_projections{true};
 bool g_enable_overlaps_hashjoin{false};
 bool g_cache_string_hash{false};
 size_t g_overlaps_max_table_size_bytes{1024 * 1024 * 1024};
+size_t g_join_hash_table_cache_max_bytes{size_t(4) * 1024 * 1024 * 1024};
+size_t g_query_buffer_pool_bytes{0};
 bool g_strip_join_covered_quals{false};
+size_t g_max_dict_lookup_table_entries{100000000};
 size_t g_constrained_by_in_threshold{10};
 size_t g_big_group_threshold{20000};
 bool g_enable_window_functions{true};
@@ -94,7 +98,10 @@ size_t g_min_memory_allocation_size{
     256};  // minimum memory allocation required for projection query output buffer
            // without pre-flight count
 bool g_enable_bump_allocator{false};
+bool g_enable_cpu_bump_allocator{false};
 double g_bump_allocator_step_reduction{0.75};
+bool g_enable_runtime_join_filters{false};
+bool g_enable_async_reduction_compilation{false};
 
 int const Executor::max_gpu_count;
 
@@ -119,6 +126,11 @@ Executor::Executor(const int db_id,
     , temporary_tables_(nullptr)
     , input_table_info_cache_(this) {}
 
+Executor::~Executor() {
+  cancel_tiered_compilations_ = true;
+  waitForTieredCompilations();
+}
+
 std::shared_ptr<Executor> Executor::getExecutor(
     const int db_id,
     const std::string& debug_dir,
@@ -1168,6 +1180,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
     std::unique_ptr<QueryMemoryDescriptor> query_mem_desc_owned;
     try {
       INJECT_TIMER(execution_dispatch_comp);
+      QueryPhaseTimer compilation_timer(query_profile_, QueryPhase::Compilation);
       std::tie(query_comp_desc_owned, query_mem_desc_owned) =
           execution_dispatch.compile(max_groups_buffer_entry_guess,
                                      crt_min_byte_width,
@@ -1185,6 +1198,9 @@ ResultSetPtr Executor::executeWorkUnitImpl(
     } catch (CompilationRetryNoCompaction&) {
       crt_min_byte_width = MAX_BYTE_WIDTH_SUPPORTED;
       continue;
+    } catch (const QueryMemoryBudgetExceeded& e) {
+      // thrown by the join hash tables built during code generation
+      throw QueryExecutionError(ERR_OUT_OF_QUERY_MEMORY_BUDGET, e.what());
     }
     if (eo.just_explain) {
       return executeExplain(*query_comp_desc_owned);
@@ -1256,6 +1272,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
       }
     }
     cat.getDataMgr().freeAllBuffers();
+    QueryPhaseTimer reduction_timer(query_profile_, QueryPhase::Reduction);
     if (is_agg) {
       try {
         return collectAllDeviceResults(execution_dispatch,
@@ -1385,11 +1402,8 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
       const auto& count_distinct_desc =
           query_mem_desc.getCountDistinctDescriptor(target_idx);
       if (count_distinct_desc.impl_type_ == CountDistinctImplType::Bitmap) {
-        auto count_distinct_buffer = static_cast<int8_t*>(
-            checked_calloc(count_distinct_desc.bitmapPaddedSizeBytes(), 1));
-        CHECK(row_set_mem_owner);
-        row_set_mem_owner->addCountDistinctBuffer(
-            count_distinct_buffer, count_distinct_desc.bitmapPaddedSizeBytes(), true);
+        auto count_distinct_buffer = row_set_mem_owner->allocateCountDistinctBuffer(
+            count_distinct_desc.bitmapPaddedSizeBytes());
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_buffer));
         continue;
       }
@@ -3035,6 +3049,14 @@ std::pair<bool, int64_t> Executor::skipFragment(
     const size_t frag_idx) {
   const int table_id = table_desc.getTableId();
   for (const auto simple_qual : simple_quals) {
+    const auto rowid_set =
+        std::dynamic_pointer_cast<const Analyzer::InIntegerSet>(simple_qual);
+    if (rowid_set) {
+      if (skipFragmentByRowidSet(*rowid_set, table_id, frag_offsets, frag_idx)) {
+        return {true, -1};
+      }
+      continue;
+    }
     const auto comp_expr =
         std::dynamic_pointer_cast<const Analyzer::BinOper>(simple_qual);
     if (!comp_expr) {
@@ -3194,6 +3216,48 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
   return skip_frag;
 }
 
+// Skips the fragment if none of the row ids in the set belongs to it. Such sets are
+// built by the late materialization of sorted projections, see
+// g_enable_late_materialization; sets over other columns never skip.
+bool Executor::skipFragmentByRowidSet(const Analyzer::InIntegerSet& rowid_set,
+                                      const int table_id,
+                                      const std::vector<uint64_t>& frag_offsets,
+                                      const size_t frag_idx) {
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(rowid_set.get_arg());
+  if (!col_var || table_id <= 0 || col_var->get_rte_idx()) {
+    return false;
+  }
+  const auto cd = get_column_descriptor(col_var->get_column_id(), table_id, *catalog_);
+  if (!cd->isVirtualCol) {
+    return false;
+  }
+  CHECK_EQ("rowid", cd->columnName);
+  const auto start_rowid = getTableGeneration(table_id).start_rowid;
+  const int64_t frag_min = frag_offsets[frag_idx] + start_rowid;
+  const int64_t frag_max = frag_offsets[frag_idx + 1] - 1 + start_rowid;
+  const auto& rowids = rowid_set.get_value_list();
+  return std::none_of(
+      rowids.begin(), rowids.end(), [frag_min, frag_max](const int64_t rowid) {
+        return rowid >= frag_min && rowid <= frag_max;
+      });
+}
+
+// Skips the fragments of the outer table which can't match any key of the hash tables
+// built for the inner joins of the query, see g_enable_runtime_join_filters.
+bool Executor::skipFragmentByProbeKeyRanges(
+    const InputDescriptor& table_desc,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::vector<uint64_t>& frag_offsets,
+    const size_t frag_idx) {
+  CHECK(plan_state_);
+  const auto& probe_key_range_quals = plan_state_->join_info_.probe_key_range_quals_;
+  if (probe_key_range_quals.empty()) {
+    return false;
+  }
+  return skipFragment(table_desc, fragment, probe_key_range_quals, frag_offsets, frag_idx)
+      .first;
+}
+
 std::map<std::pair<int, ::QueryRenderer::QueryRenderManager*>, std::shared_ptr<Executor>>
     Executor::executors_;
 std::mutex Executor::execute_mutex_;
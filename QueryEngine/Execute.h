@@ -29,6 +29,7 @@
 #include "LoopControlFlow/JoinLoop.h"
 #include "NvidiaKernel.h"
 #include "PlanState.h"
+#include "QueryProfile.h"
 #include "RelAlgExecutionUnit.h"
 #include "RelAlgTranslator.h"
 #include "StringDictionaryGenerations.h"
@@ -54,12 +55,15 @@
 
 #include <unistd.h>
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdlib>
 #include <deque>
 #include <functional>
+#include <future>
 #include <limits>
+#include <list>
 #include <map>
 #include <mutex>
 #include <stack>
@@ -76,18 +80,25 @@ extern bool g_allow_cpu_retry;
 extern bool g_null_div_by_zero;
 extern bool g_bigint_count;
 extern bool g_inner_join_fragment_skipping;
+extern bool g_enable_runtime_join_filters;
+extern bool g_enable_async_reduction_compilation;
 extern float g_filter_push_down_low_frac;
 extern float g_filter_push_down_high_frac;
 extern size_t g_filter_push_down_passing_row_ubound;
 extern bool g_enable_columnar_output;
+extern bool g_enable_columnar_projections;
 extern bool g_enable_overlaps_hashjoin;
 extern size_t g_overlaps_max_table_size_bytes;
+extern size_t g_join_hash_table_cache_max_bytes;
+extern size_t g_query_buffer_pool_bytes;
 extern bool g_strip_join_covered_quals;
+extern size_t g_max_dict_lookup_table_entries;
 extern size_t g_constrained_by_in_threshold;
 extern size_t g_big_group_threshold;
 extern bool g_enable_window_functions;
 extern size_t g_max_memory_allocation_size;
 extern double g_bump_allocator_step_reduction;
+extern bool g_enable_cpu_bump_allocator;
 
 class QueryCompilationDescriptor;
 using QueryCompilationDescriptorOwned = std::unique_ptr<QueryCompilationDescriptor>;
@@ -204,7 +215,7 @@ inline const ColumnarResults* rows_to_columnar_results(
   for (size_t i = 0; i < result->colCount(); ++i) {
     col_types.push_back(get_logical_type_info(result->getColType(i)));
   }
-  return new ColumnarResults(row_set_mem_owner, *result, number, col_types);
+  return new ColumnarResults(row_set_mem_owner, *result, number, col_types, result);
 }
 
 // TODO(alex): Adjust interfaces downstream and make this not needed.
@@ -339,6 +350,8 @@ class Executor {
            const std::string& debug_file,
            ::QueryRenderer::QueryRenderManager* render_manager);
 
+  ~Executor();
+
   static std::shared_ptr<Executor> getExecutor(
       const int db_id,
       const std::string& debug_dir = "",
@@ -462,6 +475,12 @@ class Executor {
   void interrupt();
   void resetInterrupt();
 
+  // Execution profile of the current (or last) query.
+  QueryProfile getQueryProfile() const { return query_profile_.get(); }
+
+  // Blocks until the optimized code of the queries compiled in tiered mode is cached.
+  void waitForTieredCompilations();
+
   static const size_t high_scan_limit{32000000};
 
  private:
@@ -477,6 +496,10 @@ class Executor {
   // Generate code for an aggregate window function target.
   llvm::Value* codegenWindowFunctionAggregate(const CompilationOptions& co);
 
+  // Generate code for an aggregate window function target with an explicit frame.
+  llvm::Value* codegenWindowFunctionFrame(
+      const WindowFunctionContext* window_func_context);
+
   // The aggregate state requires a state reset when starting a new partition. Generate
   // the new partition check and return the continuation basic block.
   llvm::BasicBlock* codegenWindowResetStateControlFlow();
@@ -540,6 +563,9 @@ class Executor {
     std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> all_fragment_results_;
     std::atomic_flag dynamic_watchdog_set_ = ATOMIC_FLAG_INIT;
     static std::mutex reduce_mutex_;
+    // Compilation of the reduction code, started with the first fragment result while
+    // the other kernels are still running.
+    std::future<void> reduction_precompilation_;
 
     void runImpl(const ExecutorDeviceType chosen_device_type,
                  int chosen_device_id,
@@ -872,6 +898,12 @@ class Executor {
       llvm::Function*,
       const std::unordered_set<llvm::Function*>&,
       const CompilationOptions&);
+  void compileOptimizedCPUCodeAsync(const CodeCacheKey&,
+                                    std::string bitcode,
+                                    const std::string& query_func_name,
+                                    const std::string& multifrag_query_func_name,
+                                    const std::vector<std::string>& live_func_names,
+                                    const CompilationOptions&);
   std::vector<std::pair<void*, void*>> optimizeAndCodegenGPU(
       llvm::Function*,
       llvm::Function*,
@@ -914,6 +946,16 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  bool skipFragmentByRowidSet(const Analyzer::InIntegerSet& rowid_set,
+                              const int table_id,
+                              const std::vector<uint64_t>& frag_offsets,
+                              const size_t frag_idx);
+
+  bool skipFragmentByProbeKeyRanges(const InputDescriptor& table_desc,
+                                    const Fragmenter_Namespace::FragmentInfo& fragment,
+                                    const std::vector<uint64_t>& frag_offsets,
+                                    const size_t frag_idx);
+
   std::pair<bool, int64_t> skipFragmentInnerJoins(
       const InputDescriptor& table_desc,
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -966,6 +1008,7 @@ class Executor {
   mutable uint32_t gpu_active_modules_device_mask_;
   mutable void* gpu_active_modules_[max_gpu_count];
   bool interrupted_;
+  mutable QueryProfileCounters query_profile_;
 
   mutable std::shared_ptr<StringDictionaryProxy> lit_str_dict_proxy_;
   mutable std::mutex str_dict_mutex_;
@@ -975,6 +1018,10 @@ class Executor {
   CodeCache cpu_code_cache_;
   CodeCache gpu_code_cache_;
 
+  // Background compilations of optimized CPU code, see g_enable_tiered_compilation.
+  std::list<std::future<void>> tiered_compilations_;
+  std::atomic<bool> cancel_tiered_compilations_{false};
+
   ::QueryRenderer::QueryRenderManager* render_manager_;
 
   static const size_t baseline_threshold{
@@ -1015,6 +1062,7 @@ class Executor {
   static const int32_t ERR_TOO_MANY_LITERALS{12};
   static const int32_t ERR_STRING_CONST_IN_RESULTSET{13};
   static const int32_t ERR_STREAMING_TOP_N_NOT_SUPPORTED_IN_RENDER_QUERY{14};
+  static const int32_t ERR_OUT_OF_QUERY_MEMORY_BUDGET{15};
   friend class BaselineJoinHashTable;
   friend class CodeGenerator;
   friend class ColumnFetcher;
@@ -20,8 +20,10 @@
 #include "DynamicWatchdog.h"
 #include "ErrorHandling.h"
 #include "Execute.h"
+#include "ResultSetReductionJIT.h"
 
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "Shared/scope.h"
 
 #include <numeric>
 
@@ -90,11 +92,18 @@ void Executor::ExecutionDispatch::runImpl(
         new std::lock_guard<std::mutex>(executor_->gpu_exec_mutex_[chosen_device_id]));
   }
   FetchResult fetch_result;
+  std::vector<std::pair<const void*, size_t>> pinned_buffers;
+  ScopeGuard release_pinned_buffers = [this, &pinned_buffers] {
+    if (row_set_mem_owner_) {
+      row_set_mem_owner_->releasePinnedBuffers(pinned_buffers);
+    }
+  };
   try {
     std::map<int, const TableFragments*> all_tables_fragments;
     QueryFragmentDescriptor::computeAllTablesFragments(
         all_tables_fragments, ra_exe_unit_, query_infos_);
 
+    QueryPhaseTimer fetch_timer(executor_->query_profile_, QueryPhase::Fetch);
     fetch_result = executor_->fetchChunks(column_fetcher,
                                           ra_exe_unit_,
                                           chosen_device_id,
@@ -107,6 +116,19 @@ void Executor::ExecutionDispatch::runImpl(
     if (fetch_result.num_rows.empty()) {
       return;
     }
+    if (memory_level == Data_Namespace::CPU_LEVEL && row_set_mem_owner_) {
+      // the chunks stay pinned in the buffer pool while the kernel runs
+      std::vector<std::pair<const void*, size_t>> chunk_buffers;
+      for (const auto& chunk : chunks) {
+        for (const auto buffer : {chunk->get_buffer(), chunk->get_index_buf()}) {
+          if (buffer) {
+            chunk_buffers.emplace_back(buffer, buffer->size());
+          }
+        }
+      }
+      row_set_mem_owner_->chargePinnedBuffers(chunk_buffers);
+      pinned_buffers = std::move(chunk_buffers);
+    }
     if (eo.with_dynamic_watchdog &&
         !dynamic_watchdog_set_.test_and_set(std::memory_order_acquire)) {
       CHECK_GT(eo.dynamic_watchdog_time_limit, 0u);
@@ -182,6 +204,7 @@ void Executor::ExecutionDispatch::runImpl(
   }
 
   ResultSetPtr device_results;
+  QueryPhaseTimer kernel_timer(executor_->query_profile_, QueryPhase::Kernel);
   if (ra_exe_unit_.groupby_exprs.empty()) {
     err = executor_->executePlanWithoutGroupBy(ra_exe_unit_,
                                                compilation_result,
@@ -233,6 +256,26 @@ void Executor::ExecutionDispatch::runImpl(
     std::lock_guard<std::mutex> lock(reduce_mutex_);
     if (!needs_skip_result(device_results)) {
       all_fragment_results_.emplace_back(std::move(device_results), outer_tab_frag_ids);
+#ifdef WITH_REDUCTION_JIT
+      // The reduction code only depends on the layout of the results, compile it in the
+      // background as soon as the first one is available instead of after all kernels
+      // are done. The reduction then finds it in the code cache.
+      if (g_enable_async_reduction_compilation && !reduction_precompilation_.valid() &&
+          query_infos_.front().info.fragments.size() > 1) {
+        const auto& first_result = all_fragment_results_.front().first;
+        const ResultSetReductionJIT reduction_jit(first_result->getQueryMemDesc(),
+                                                  first_result->getTargetInfos(),
+                                                  first_result->getTargetInitVals());
+        reduction_precompilation_ =
+            std::async(std::launch::async, [reduction_jit]() {
+              try {
+                reduction_jit.precompile();
+              } catch (const std::exception& e) {
+                LOG(WARNING) << "Reduction code compilation failed: " << e.what();
+              }
+            });
+      }
+#endif  // WITH_REDUCTION_JIT
     }
   }
 }
@@ -316,6 +359,8 @@ void Executor::ExecutionDispatch::run(const ExecutorDeviceType chosen_device_typ
             frag_list,
             kernel_dispatch_mode,
             rowid_lookup_key);
+  } catch (const QueryMemoryBudgetExceeded& e) {
+    throw QueryExecutionError(ERR_OUT_OF_QUERY_MEMORY_BUDGET, e.what());
   } catch (const std::bad_alloc& e) {
     throw QueryExecutionError(ERR_OUT_OF_CPU_MEM, e.what());
   } catch (const OutOfHostMemory& e) {
@@ -32,6 +32,9 @@
 using UpdateTriggeredCacheInvalidator =
     CacheInvalidator<OverlapsJoinHashTable, BaselineJoinHashTable, JoinHashTable>;
 using DeleteTriggeredCacheInvalidator = UpdateTriggeredCacheInvalidator;
+// Called through Catalog::invalidateCachesForTable when the data of a table is appended
+// to, rolled back, truncated or dropped, as well as on update and delete.
+using TableDataCacheInvalidator = UpdateTriggeredCacheInvalidator;
 
 // Note that this is functionally the same as the above two invalidators. The
 // JoinHashTableCacheInvalidator is a generic invalidator used during `clear_cpu` calls.
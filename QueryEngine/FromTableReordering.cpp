@@ -107,6 +107,79 @@ std::vector<std::map<node_t, cost_t>> build_join_cost_graph(
   return join_cost_graph;
 }
 
+// Estimates the number of matches per row of an outer table for the column equality
+// qual using the statistics collected by ANALYZE TABLE, -1 if no estimate is available.
+double get_equi_join_fanout(const Analyzer::ColumnVar* outer_col,
+                            const Analyzer::ColumnVar* inner_col,
+                            const InputTableInfo& inner_table_info,
+                            const Executor* executor) {
+  const auto cat = executor->getCatalog();
+  const auto outer_stats =
+      cat->getColumnStatistics(outer_col->get_table_id(), outer_col->get_column_id());
+  const auto inner_stats =
+      cat->getColumnStatistics(inner_col->get_table_id(), inner_col->get_column_id());
+  if (!outer_stats || !inner_stats) {
+    return -1;
+  }
+  const auto max_ndv = std::max(outer_stats->getNdv(), inner_stats->getNdv());
+  if (!max_ndv) {
+    return 0;
+  }
+  return inner_table_info.info.getNumTuplesUpperBound() *
+         (1 - inner_stats->getNullFraction()) / max_ndv;
+}
+
+// Builds a graph with nesting levels as nodes and the estimated fanout of joining the
+// destination level after the source one as edges. Edges without estimates are missing.
+std::vector<std::map<node_t, double>> build_join_fanout_graph(
+    const JoinQualsPerNestingLevel& left_deep_join_quals,
+    const std::vector<InputTableInfo>& table_infos,
+    const Executor* executor) {
+  std::vector<std::map<node_t, double>> join_fanout_graph(table_infos.size());
+  if (!executor) {
+    return join_fanout_graph;
+  }
+  const auto update_fanout =
+      [&join_fanout_graph](const node_t from, const node_t to, const double fanout) {
+        if (fanout < 0) {
+          return;
+        }
+        const auto it_ok = join_fanout_graph[from].emplace(to, fanout);
+        if (!it_ok.second) {
+          it_ok.first->second = std::min(it_ok.first->second, fanout);
+        }
+      };
+  for (const auto& current_level_join_conditions : left_deep_join_quals) {
+    for (const auto& qual : current_level_join_conditions.quals) {
+      const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual.get());
+      if (!bin_oper || !IS_EQUIVALENCE(bin_oper->get_optype())) {
+        continue;
+      }
+      const auto lhs_col =
+          dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_left_operand());
+      const auto rhs_col =
+          dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_right_operand());
+      if (!lhs_col || !rhs_col || lhs_col->get_rte_idx() == rhs_col->get_rte_idx() ||
+          lhs_col->get_table_id() < 0 || rhs_col->get_table_id() < 0) {
+        continue;
+      }
+      const node_t lhs_nest_level = lhs_col->get_rte_idx();
+      const node_t rhs_nest_level = rhs_col->get_rte_idx();
+      CHECK_LT(lhs_nest_level, table_infos.size());
+      CHECK_LT(rhs_nest_level, table_infos.size());
+      update_fanout(
+          lhs_nest_level,
+          rhs_nest_level,
+          get_equi_join_fanout(lhs_col, rhs_col, table_infos[rhs_nest_level], executor));
+      update_fanout(
+          rhs_nest_level,
+          lhs_nest_level,
+          get_equi_join_fanout(rhs_col, lhs_col, table_infos[lhs_nest_level], executor));
+    }
+  }
+  return join_fanout_graph;
+}
+
 // Tracks dependencies between nodes.
 class SchedulingDependencyTracking {
  public:
@@ -141,6 +214,7 @@ class SchedulingDependencyTracking {
 struct TraversalEdge {
   node_t nest_level;
   cost_t join_cost;
+  double join_fanout;  // negative if unknown
 };
 
 // Builds dependency tracking based on left joins and based on geo costs.
@@ -181,6 +255,7 @@ SchedulingDependencyTracking build_dependency_tracking(
 // joins.
 std::vector<node_t> traverse_join_cost_graph(
     const std::vector<std::map<node_t, cost_t>>& join_cost_graph,
+    const std::vector<std::map<node_t, double>>& join_fanout_graph,
     const std::vector<InputTableInfo>& table_infos,
     const std::function<bool(const node_t lhs_nest_level, const node_t rhs_nest_level)>&
         compare_node,
@@ -211,7 +286,7 @@ std::vector<node_t> traverse_join_cost_graph(
     CHECK(start_it != remaining_nest_levels.end());
     std::priority_queue<TraversalEdge, std::vector<TraversalEdge>, decltype(compare_edge)>
         worklist(compare_edge);
-    worklist.push(TraversalEdge{*start_it, 0});
+    worklist.push(TraversalEdge{*start_it, 0, -1});
     const auto it_ok = visited.insert(*start_it);
     CHECK(it_ok.second);
     while (!worklist.empty()) {
@@ -226,7 +301,11 @@ std::vector<node_t> traverse_join_cost_graph(
         if (!schedulable_node(succ)) {
           continue;
         }
-        worklist.push(TraversalEdge{succ, graph_edge.second});
+        const auto fanout_it = join_fanout_graph[crt.nest_level].find(succ);
+        const double join_fanout =
+            fanout_it != join_fanout_graph[crt.nest_level].end() ? fanout_it->second
+                                                                 : -1;
+        worklist.push(TraversalEdge{succ, graph_edge.second, join_fanout});
         const auto it_ok = visited.insert(succ);
         CHECK(it_ok.second);
       }
@@ -243,6 +322,8 @@ std::vector<node_t> get_node_input_permutation(
     const Executor* executor) {
   const auto join_cost_graph =
       build_join_cost_graph(left_deep_join_quals, table_infos, executor);
+  const auto join_fanout_graph =
+      build_join_fanout_graph(left_deep_join_quals, table_infos, executor);
   // Use the number of tuples in each table to break ties in BFS.
   const auto compare_node = [&table_infos](const node_t lhs_nest_level,
                                            const node_t rhs_nest_level) {
@@ -251,12 +332,22 @@ std::vector<node_t> get_node_input_permutation(
   };
   const auto compare_edge = [&compare_node](const TraversalEdge& lhs_edge,
                                             const TraversalEdge& rhs_edge) {
-    // Only use the number of tuples as a tie-breaker, if costs are equal.
+    // Only use the estimated fanout or the number of tuples as a tie-breaker, if costs
+    // are equal. The join with the smallest fanout goes first since it keeps the
+    // intermediate results small.
     if (lhs_edge.join_cost == rhs_edge.join_cost) {
+      if (lhs_edge.join_fanout >= 0 && rhs_edge.join_fanout >= 0 &&
+          lhs_edge.join_fanout != rhs_edge.join_fanout) {
+        return lhs_edge.join_fanout > rhs_edge.join_fanout;
+      }
       return compare_node(lhs_edge.nest_level, rhs_edge.nest_level);
     }
     return lhs_edge.join_cost < rhs_edge.join_cost;
   };
-  return traverse_join_cost_graph(
-      join_cost_graph, table_infos, compare_node, compare_edge, left_deep_join_quals);
+  return traverse_join_cost_graph(join_cost_graph,
+                                  join_fanout_graph,
+                                  table_infos,
+                                  compare_node,
+                                  compare_edge,
+                                  left_deep_join_quals);
 }
@@ -1459,7 +1459,7 @@ llvm::Value* GroupByAndAggregate::codegenWindowRowPointer(
     DiamondCodegen& diamond_codegen) {
   const auto window_func_context =
       WindowProjectNodeContext::getActiveWindowFunctionContext();
-  if (window_func_context && window_function_is_aggregate(window_func->getKind())) {
+  if (window_func_context && window_function_is_cumulative_aggregate(window_func)) {
     const int32_t row_size_quad = query_mem_desc.didOutputColumnar()
                                       ? 0
                                       : query_mem_desc.getRowSize() / sizeof(int64_t);
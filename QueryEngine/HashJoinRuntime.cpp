@@ -150,7 +150,8 @@ DEVICE auto fill_hash_join_buff_impl(int32_t* buff,
         << "Element " << elem << " less than min val " << type_info.min_val;
 #endif
     int32_t* entry_ptr = slot_sel(elem);
-    if (mapd_cas(entry_ptr, invalid_slot_val, i) != invalid_slot_val) {
+    if (mapd_cas(entry_ptr, invalid_slot_val, join_column.row_id_offset + i) !=
+        invalid_slot_val) {
       return -1;
     }
   }
@@ -248,7 +249,8 @@ DEVICE int fill_hash_join_buff_sharded_impl(int32_t* buff,
         << "Element " << elem << " less than min val " << type_info.min_val;
 #endif
     int32_t* entry_ptr = slot_sel(elem);
-    if (mapd_cas(entry_ptr, invalid_slot_val, i) != invalid_slot_val) {
+    if (mapd_cas(entry_ptr, invalid_slot_val, join_column.row_id_offset + i) !=
+        invalid_slot_val) {
       return -1;
     }
   }
@@ -799,7 +801,7 @@ DEVICE void fill_row_ids_impl(int32_t* buff,
 #endif
     const auto bin_idx = pos_ptr - pos_buff;
     const auto id_buff_idx = mapd_add(count_buff + bin_idx, 1) + *pos_ptr;
-    id_buff[id_buff_idx] = static_cast<int32_t>(i);
+    id_buff[id_buff_idx] = static_cast<int32_t>(join_column.row_id_offset + i);
   }
 }
 
@@ -926,7 +928,7 @@ DEVICE void fill_row_ids_sharded_impl(int32_t* buff,
 #endif
     const auto bin_idx = pos_ptr - pos_buff;
     const auto id_buff_idx = mapd_add(count_buff + bin_idx, 1) + *pos_ptr;
-    id_buff[id_buff_idx] = static_cast<int32_t>(i);
+    id_buff[id_buff_idx] = static_cast<int32_t>(join_column.row_id_offset + i);
   }
 }
 
@@ -1250,7 +1252,7 @@ template <typename COUNT_MATCHES_LAUNCH_FUNCTOR, typename FILL_ROW_IDS_LAUNCH_FU
 void fill_one_to_many_hash_table_impl(int32_t* buff,
                                       const int32_t hash_entry_count,
                                       const int32_t invalid_slot_val,
-                                      const JoinColumn& join_column,
+                                      const std::vector<JoinColumn>& join_columns,
                                       const JoinColumnTypeInfo& type_info,
                                       const void* sd_inner_proxy,
                                       const void* sd_outer_proxy,
@@ -1312,52 +1314,56 @@ void fill_one_to_many_hash_table_impl(int32_t* buff,
 void fill_one_to_many_hash_table(int32_t* buff,
                                  const HashEntryInfo hash_entry_info,
                                  const int32_t invalid_slot_val,
-                                 const JoinColumn& join_column,
+                                 const std::vector<JoinColumn>& join_columns,
                                  const JoinColumnTypeInfo& type_info,
                                  const void* sd_inner_proxy,
                                  const void* sd_outer_proxy,
                                  const unsigned cpu_thread_count) {
   auto launch_count_matches = [count_buff = buff + hash_entry_info.hash_entry_count,
                                invalid_slot_val,
-                               &join_column,
+                               &join_columns,
                                &type_info,
                                sd_inner_proxy,
                                sd_outer_proxy](auto cpu_thread_idx,
                                                auto cpu_thread_count) {
-    SUFFIX(count_matches)
-    (count_buff,
-     invalid_slot_val,
-     join_column,
-     type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
-     cpu_thread_idx,
-     cpu_thread_count);
+    for (const auto& join_column : join_columns) {
+      SUFFIX(count_matches)
+      (count_buff,
+       invalid_slot_val,
+       join_column,
+       type_info,
+       sd_inner_proxy,
+       sd_outer_proxy,
+       cpu_thread_idx,
+       cpu_thread_count);
+    }
   };
   auto launch_fill_row_ids = [hash_entry_count = hash_entry_info.hash_entry_count,
                               buff,
                               invalid_slot_val,
-                              &join_column,
+                              &join_columns,
                               &type_info,
                               sd_inner_proxy,
                               sd_outer_proxy](auto cpu_thread_idx,
                                               auto cpu_thread_count) {
-    SUFFIX(fill_row_ids)
-    (buff,
-     hash_entry_count,
-     invalid_slot_val,
-     join_column,
-     type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
-     cpu_thread_idx,
-     cpu_thread_count);
+    for (const auto& join_column : join_columns) {
+      SUFFIX(fill_row_ids)
+      (buff,
+       hash_entry_count,
+       invalid_slot_val,
+       join_column,
+       type_info,
+       sd_inner_proxy,
+       sd_outer_proxy,
+       cpu_thread_idx,
+       cpu_thread_count);
+    }
   };
 
   fill_one_to_many_hash_table_impl(buff,
                                    hash_entry_info.hash_entry_count,
                                    invalid_slot_val,
-                                   join_column,
+                                   join_columns,
                                    type_info,
                                    sd_inner_proxy,
                                    sd_outer_proxy,
@@ -1369,7 +1375,7 @@ void fill_one_to_many_hash_table(int32_t* buff,
 void fill_one_to_many_hash_table_bucketized(int32_t* buff,
                                             const HashEntryInfo hash_entry_info,
                                             const int32_t invalid_slot_val,
-                                            const JoinColumn& join_column,
+                                            const std::vector<JoinColumn>& join_columns,
                                             const JoinColumnTypeInfo& type_info,
                                             const void* sd_inner_proxy,
                                             const void* sd_outer_proxy,
@@ -1379,48 +1385,52 @@ void fill_one_to_many_hash_table_bucketized(int32_t* buff,
   auto launch_count_matches = [bucket_normalization,
                                count_buff = buff + hash_entry_count,
                                invalid_slot_val,
-                               &join_column,
+                               &join_columns,
                                &type_info,
                                sd_inner_proxy,
                                sd_outer_proxy](auto cpu_thread_idx,
                                                auto cpu_thread_count) {
-    SUFFIX(count_matches_bucketized)
-    (count_buff,
-     invalid_slot_val,
-     join_column,
-     type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
-     cpu_thread_idx,
-     cpu_thread_count,
-     bucket_normalization);
+    for (const auto& join_column : join_columns) {
+      SUFFIX(count_matches_bucketized)
+      (count_buff,
+       invalid_slot_val,
+       join_column,
+       type_info,
+       sd_inner_proxy,
+       sd_outer_proxy,
+       cpu_thread_idx,
+       cpu_thread_count,
+       bucket_normalization);
+    }
   };
   auto launch_fill_row_ids = [bucket_normalization,
                               hash_entry_count,
                               buff,
                               invalid_slot_val,
-                              &join_column,
+                              &join_columns,
                               &type_info,
                               sd_inner_proxy,
                               sd_outer_proxy](auto cpu_thread_idx,
                                               auto cpu_thread_count) {
-    SUFFIX(fill_row_ids_bucketized)
-    (buff,
-     hash_entry_count,
-     invalid_slot_val,
-     join_column,
-     type_info,
-     sd_inner_proxy,
-     sd_outer_proxy,
-     cpu_thread_idx,
-     cpu_thread_count,
-     bucket_normalization);
+    for (const auto& join_column : join_columns) {
+      SUFFIX(fill_row_ids_bucketized)
+      (buff,
+       hash_entry_count,
+       invalid_slot_val,
+       join_column,
+       type_info,
+       sd_inner_proxy,
+       sd_outer_proxy,
+       cpu_thread_idx,
+       cpu_thread_count,
+       bucket_normalization);
+    }
   };
 
   fill_one_to_many_hash_table_impl(buff,
                                    hash_entry_count,
                                    invalid_slot_val,
-                                   join_column,
+                                   join_columns,
                                    type_info,
                                    sd_inner_proxy,
                                    sd_outer_proxy,
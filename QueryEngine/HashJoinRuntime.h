@@ -98,9 +98,13 @@ void init_baseline_hash_join_buff_on_device_64(int8_t* hash_join_buff,
 
 enum ColumnType { SmallDate = 0, Signed = 1, Unsigned = 2 };
 
+// A join column, or the part of it held by a single fragment. The row ids stored in the
+// hash table for its elements start at row_id_offset, which lets us build the table
+// directly over the chunks of a multi-fragment inner table without linearizing them.
 struct JoinColumn {
   const int8_t* col_buff;
   const size_t num_elems;
+  const size_t row_id_offset;
 };
 
 struct JoinColumnTypeInfo {
@@ -190,7 +194,7 @@ void fill_hash_join_buff_on_device_sharded_bucketized(int32_t* buff,
 void fill_one_to_many_hash_table(int32_t* buff,
                                  const HashEntryInfo hash_entry_info,
                                  const int32_t invalid_slot_val,
-                                 const JoinColumn& join_column,
+                                 const std::vector<JoinColumn>& join_columns,
                                  const JoinColumnTypeInfo& type_info,
                                  const void* sd_inner_proxy,
                                  const void* sd_outer_proxy,
@@ -199,7 +203,7 @@ void fill_one_to_many_hash_table(int32_t* buff,
 void fill_one_to_many_hash_table_bucketized(int32_t* buff,
                                             const HashEntryInfo hash_entry_info,
                                             const int32_t invalid_slot_val,
-                                            const JoinColumn& join_column,
+                                            const std::vector<JoinColumn>& join_columns,
                                             const JoinColumnTypeInfo& type_info,
                                             const void* sd_inner_proxy,
                                             const void* sd_outer_proxy,
@@ -181,6 +181,25 @@ void add_qualifier_to_execution_unit(RelAlgExecutionUnit& ra_exe_unit,
       ra_exe_unit.quals.end(), qual_cf.quals.begin(), qual_cf.quals.end());
 }
 
+// Adds the predicates on the outer keys of an inner join implied by the keys actually
+// present in its hash table, used to skip fragments of the outer table.
+void add_probe_key_range_quals(JoinInfo& join_info,
+                               const JoinHashTableInterface& hash_table) {
+  for (const auto& key_range : hash_table.getProbeKeyRanges()) {
+    const auto outer_key = key_range.outer_key->deep_copy();
+    Datum min_datum;
+    min_datum.bigintval = key_range.min;
+    const auto min_constant = makeExpr<Analyzer::Constant>(kBIGINT, false, min_datum);
+    join_info.probe_key_range_quals_.push_back(
+        makeExpr<Analyzer::BinOper>(kBOOLEAN, kGE, kONE, outer_key, min_constant));
+    Datum max_datum;
+    max_datum.bigintval = key_range.max;
+    const auto max_constant = makeExpr<Analyzer::Constant>(kBIGINT, false, max_datum);
+    join_info.probe_key_range_quals_.push_back(
+        makeExpr<Analyzer::BinOper>(kBOOLEAN, kLE, kONE, outer_key, max_constant));
+  }
+}
+
 void check_if_loop_join_is_allowed(RelAlgExecutionUnit& ra_exe_unit,
                                    const ExecutionOptions& eo,
                                    const std::vector<InputTableInfo>& query_infos,
@@ -417,6 +436,11 @@ std::shared_ptr<JoinHashTableInterface> Executor::buildCurrentLevelHashTable(
     if (hash_table_or_error.hash_table) {
       plan_state_->join_info_.join_hash_tables_.push_back(hash_table_or_error.hash_table);
       plan_state_->join_info_.equi_join_tautologies_.push_back(qual_bin_oper);
+      if (g_enable_runtime_join_filters &&
+          current_level_join_conditions.type == JoinType::INNER) {
+        add_probe_key_range_quals(plan_state_->join_info_,
+                                  *hash_table_or_error.hash_table);
+      }
     } else {
       fail_reasons.push_back(hash_table_or_error.fail_reason);
       if (current_level_join_conditions.type == JoinType::INNER) {
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef QUERYENGINE_JOINBLOOMFILTERINL_H
+#define QUERYENGINE_JOINBLOOMFILTERINL_H
+
+#include "../Shared/funcannotations.h"
+
+#include <cstdint>
+
+// Blocked bloom filter over the keys of a join hash table, built on the host and
+// probed from the generated code. Both bits of a key are in the same 64-bit word,
+// picked from its 64-bit hash, so a probe reads a single word. The word count must
+// be a power of two.
+
+FORCE_INLINE DEVICE uint64_t join_bloom_filter_word_idx(const uint64_t key_hash,
+                                                        const uint64_t word_count) {
+  return (key_hash >> 12) & (word_count - 1);
+}
+
+FORCE_INLINE DEVICE uint64_t join_bloom_filter_mask(const uint64_t key_hash) {
+  return (uint64_t(1) << (key_hash & 63)) | (uint64_t(1) << ((key_hash >> 6) & 63));
+}
+
+#endif  // QUERYENGINE_JOINBLOOMFILTERINL_H
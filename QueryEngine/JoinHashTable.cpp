@@ -23,8 +23,10 @@
 #include "RangeTableIndexVisitor.h"
 #include "RuntimeFunctions.h"
 #include "Shared/Logger.h"
+#include "Shared/measure.h"
 
 #include <future>
+#include <limits>
 #include <numeric>
 #include <thread>
 
@@ -222,10 +224,16 @@ size_t get_hash_entry_count(const ExpressionRange& col_range, const bool is_bw_e
 
 }  // namespace
 
-std::vector<std::pair<JoinHashTable::JoinHashTableCacheKey,
-                      std::shared_ptr<std::vector<int32_t>>>>
-    JoinHashTable::join_hash_table_cache_;
-std::mutex JoinHashTable::join_hash_table_cache_mutex_;
+ConcurrentLruCache<JoinHashTable::JoinHashTableCacheKey,
+                   std::vector<int32_t>,
+                   JoinHashTable::JoinHashTableCacheKeyHash>
+    JoinHashTable::join_hash_table_cache_(
+        std::numeric_limits<size_t>::max(),
+        decltype(join_hash_table_cache_)::default_shard_count,
+        g_join_hash_table_cache_max_bytes,
+        [](const std::vector<int32_t>& hash_table) {
+          return hash_table.size() * sizeof(int32_t);
+        });
 
 size_t get_shard_count(const Analyzer::BinOper* join_condition,
                        const Executor* executor) {
@@ -388,6 +396,10 @@ std::shared_ptr<JoinHashTable> JoinHashTable::getInstance(
     throw HashJoinFail(
         std::string("Ran out of memory while building hash tables for equijoin | ") +
         e.what());
+  } catch (const QueryMemoryBudgetExceeded& e) {
+    // surfaced as ERR_OUT_OF_QUERY_MEMORY_BUDGET by the executor
+    join_hash_table->freeHashBufferMemory();
+    throw;
   } catch (const std::exception& e) {
     throw std::runtime_error(
         std::string("Fatal error while attempting to build hash tables for join: ") +
@@ -477,6 +489,31 @@ std::deque<Fragmenter_Namespace::FragmentInfo> only_shards_for_device(
   return shards_for_device;
 }
 
+bool inner_keys_have_duplicates(const std::vector<InnerOuter>& inner_outer_pairs,
+                                const Catalog_Namespace::Catalog& cat) {
+  CHECK(!inner_outer_pairs.empty());
+  double key_ndv{1};
+  int64_t num_rows{-1};
+  int64_t num_nulls{0};
+  for (const auto& inner_outer : inner_outer_pairs) {
+    const auto inner_col = inner_outer.first;
+    if (inner_col->get_table_id() < 0) {
+      return false;
+    }
+    const auto stats =
+        cat.getColumnStatistics(inner_col->get_table_id(), inner_col->get_column_id());
+    if (!stats) {
+      return false;
+    }
+    num_rows = std::max(num_rows, stats->num_rows);
+    num_nulls += stats->num_nulls;
+    key_ndv *= stats->getNdv();
+  }
+  // Leave a wide margin for the error of the distinct count sketch, picking the one to
+  // many layout for data without duplicates would only waste some memory.
+  return key_ndv * 1.1 < static_cast<double>(num_rows - num_nulls);
+}
+
 void JoinHashTable::reify(const int device_count) {
   CHECK_LT(0, device_count);
   const auto& catalog = *executor_->getCatalog();
@@ -497,6 +534,11 @@ void JoinHashTable::reify(const int device_count) {
 #endif  // HAVE_CUDA
   std::vector<std::future<void>> init_threads;
   const int shard_count = shardCount();
+  if (hash_type_ == JoinHashTableInterface::HashType::OneToOne &&
+      inner_keys_have_duplicates(std::vector<InnerOuter>{cols}, catalog)) {
+    VLOG(1) << "Column statistics show duplicate keys, building one to many hash table";
+    hash_type_ = JoinHashTableInterface::HashType::OneToMany;
+  }
 
   try {
     for (int device_id = 0; device_id < device_count; ++device_id) {
@@ -545,7 +587,27 @@ void JoinHashTable::reify(const int device_count) {
   }
 }
 
-std::pair<const int8_t*, size_t> JoinHashTable::fetchFragments(
+std::vector<JoinColumn> JoinHashTable::getColumnFragmentsPerFragment(
+    const Analyzer::ColumnVar& hash_col,
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
+  std::vector<JoinColumn> join_columns;
+  size_t row_id_offset{0};
+  for (const auto& fragment : fragments) {
+    const int8_t* col_buff = nullptr;
+    size_t elem_count = 0;
+    std::tie(col_buff, elem_count) = getOneColumnFragment(
+        hash_col, fragment, Data_Namespace::CPU_LEVEL, 0, chunks_owner);
+    if (!col_buff) {
+      continue;
+    }
+    join_columns.push_back(JoinColumn{col_buff, elem_count, row_id_offset});
+    row_id_offset += elem_count;
+  }
+  return join_columns;
+}
+
+std::vector<JoinColumn> JoinHashTable::fetchFragments(
     const Analyzer::ColumnVar* hash_col,
     const std::deque<Fragmenter_Namespace::FragmentInfo>& fragment_info,
     const Data_Namespace::MemoryLevel effective_memory_level,
@@ -560,6 +622,14 @@ std::pair<const int8_t*, size_t> JoinHashTable::fetchFragments(
   const int8_t* col_buff = nullptr;
   size_t elem_count = 0;
 
+  if (has_multi_frag && effective_memory_level == Data_Namespace::CPU_LEVEL) {
+    // Build the table directly over the chunks of each fragment. The row ids are offset
+    // by the number of rows in the preceding fragments, which matches the layout of the
+    // inner table columns as seen by the generated code.
+    std::lock_guard<std::mutex> fragment_fetch_lock(fragment_fetch_mutex);
+    return getColumnFragmentsPerFragment(*hash_col, fragment_info, chunks_owner);
+  }
+
   const size_t elem_width = hash_col->get_type_info().get_size();
   if (has_multi_frag) {
     std::tie(col_buff, elem_count) =
@@ -585,7 +655,7 @@ std::pair<const int8_t*, size_t> JoinHashTable::fetchFragments(
           *hash_col, first_frag, effective_memory_level, device_id, chunks_owner);
     }
   }
-  return {col_buff, elem_count};
+  return {JoinColumn{col_buff, elem_count, 0}};
 }
 
 ChunkKey JoinHashTable::genHashTableKey(
@@ -637,25 +707,20 @@ void JoinHashTable::reifyOneToOneForDevice(
     // No data in this fragment. Still need to create a hash table and initialize it
     // properly.
     ChunkKey empty_chunk;
-    initHashTableForDevice(
-        empty_chunk, nullptr, 0, cols, effective_memory_level, device_id);
+    initHashTableForDevice(empty_chunk, {}, cols, effective_memory_level, device_id);
   }
 
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   ThrustAllocator dev_buff_owner(&data_mgr, device_id);
-  const int8_t* col_buff = nullptr;
-  size_t elem_count = 0;
-
-  std::tie(col_buff, elem_count) = fetchFragments(inner_col,
-                                                  fragments,
-                                                  effective_memory_level,
-                                                  device_id,
-                                                  chunks_owner,
-                                                  dev_buff_owner);
+  const auto join_columns = fetchFragments(inner_col,
+                                           fragments,
+                                           effective_memory_level,
+                                           device_id,
+                                           chunks_owner,
+                                           dev_buff_owner);
 
   initHashTableForDevice(genHashTableKey(fragments, cols.second, inner_col),
-                         col_buff,
-                         elem_count,
+                         join_columns,
                          cols,
                          effective_memory_level,
                          device_id);
@@ -683,26 +748,21 @@ void JoinHashTable::reifyOneToManyForDevice(
           : memory_level_;
   if (fragments.empty()) {
     ChunkKey empty_chunk;
-    initOneToManyHashTable(
-        empty_chunk, nullptr, 0, cols, effective_memory_level, device_id);
+    initOneToManyHashTable(empty_chunk, {}, cols, effective_memory_level, device_id);
     return;
   }
 
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   ThrustAllocator dev_buff_owner(&data_mgr, device_id);
-  const int8_t* col_buff = nullptr;
-  size_t elem_count = 0;
-
-  std::tie(col_buff, elem_count) = fetchFragments(inner_col,
-                                                  fragments,
-                                                  effective_memory_level,
-                                                  device_id,
-                                                  chunks_owner,
-                                                  dev_buff_owner);
+  const auto join_columns = fetchFragments(inner_col,
+                                           fragments,
+                                           effective_memory_level,
+                                           device_id,
+                                           chunks_owner,
+                                           dev_buff_owner);
 
   initOneToManyHashTable(genHashTableKey(fragments, cols.second, inner_col),
-                         col_buff,
-                         elem_count,
+                         join_columns,
                          cols,
                          effective_memory_level,
                          device_id);
@@ -724,8 +784,7 @@ void JoinHashTable::checkHashJoinReplicationConstraint(const int table_id) const
 }
 
 void JoinHashTable::initHashTableOnCpu(
-    const int8_t* col_buff,
-    const size_t num_elements,
+    const std::vector<JoinColumn>& join_columns,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const HashEntryInfo hash_entry_info,
     const int32_t hash_join_invalid_val) {
@@ -733,6 +792,10 @@ void JoinHashTable::initHashTableOnCpu(
   CHECK(inner_col);
   const auto& ti = inner_col->get_type_info();
   if (!cpu_hash_table_buff_) {
+    if (const auto row_set_mem_owner = executor_->getRowSetMemoryOwner()) {
+      row_set_mem_owner->chargeMemoryBudget(
+          hash_entry_info.getNormalizedHashEntryCount() * sizeof(int32_t));
+    }
     cpu_hash_table_buff_ = std::make_shared<std::vector<int32_t>>(
         hash_entry_info.getNormalizedHashEntryCount());
     const StringDictionaryProxy* sd_inner_proxy{nullptr};
@@ -768,8 +831,7 @@ void JoinHashTable::initHashTableOnCpu(
     for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
       init_cpu_buff_threads.emplace_back([this,
                                           hash_join_invalid_val,
-                                          col_buff,
-                                          num_elements,
+                                          &join_columns,
                                           sd_inner_proxy,
                                           sd_outer_proxy,
                                           thread_idx,
@@ -777,23 +839,28 @@ void JoinHashTable::initHashTableOnCpu(
                                           &ti,
                                           &err,
                                           hash_entry_info] {
-        int partial_err =
-            fill_hash_join_buff_bucketized(&(*cpu_hash_table_buff_)[0],
-                                           hash_join_invalid_val,
-                                           {col_buff, num_elements},
-                                           {static_cast<size_t>(ti.get_size()),
-                                            col_range_.getIntMin(),
-                                            col_range_.getIntMax(),
-                                            inline_fixed_encoding_null_val(ti),
-                                            isBitwiseEq(),
-                                            col_range_.getIntMax() + 1,
-                                            get_join_column_type_kind(ti)},
-                                           sd_inner_proxy,
-                                           sd_outer_proxy,
-                                           thread_idx,
-                                           thread_count,
-                                           hash_entry_info.bucket_normalization);
-        __sync_val_compare_and_swap(&err, 0, partial_err);
+        for (const auto& join_column : join_columns) {
+          int partial_err =
+              fill_hash_join_buff_bucketized(&(*cpu_hash_table_buff_)[0],
+                                             hash_join_invalid_val,
+                                             join_column,
+                                             {static_cast<size_t>(ti.get_size()),
+                                              col_range_.getIntMin(),
+                                              col_range_.getIntMax(),
+                                              inline_fixed_encoding_null_val(ti),
+                                              isBitwiseEq(),
+                                              col_range_.getIntMax() + 1,
+                                              get_join_column_type_kind(ti)},
+                                             sd_inner_proxy,
+                                             sd_outer_proxy,
+                                             thread_idx,
+                                             thread_count,
+                                             hash_entry_info.bucket_normalization);
+          __sync_val_compare_and_swap(&err, 0, partial_err);
+          if (partial_err) {
+            break;
+          }
+        }
       });
     }
     for (auto& t : init_cpu_buff_threads) {
@@ -813,7 +880,7 @@ void JoinHashTable::initHashTableOnCpu(
 }
 
 void JoinHashTable::initOneToManyHashTableOnCpu(
-    const int8_t* col_buff,
+    const std::vector<JoinColumn>& join_columns,
     const size_t num_elements,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const HashEntryInfo hash_entry_info,
@@ -824,6 +891,11 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
   if (cpu_hash_table_buff_) {
     return;
   }
+  if (const auto row_set_mem_owner = executor_->getRowSetMemoryOwner()) {
+    row_set_mem_owner->chargeMemoryBudget(
+        (2 * hash_entry_info.getNormalizedHashEntryCount() + num_elements) *
+        sizeof(int32_t));
+  }
   cpu_hash_table_buff_ = std::make_shared<std::vector<int32_t>>(
       2 * hash_entry_info.getNormalizedHashEntryCount() + num_elements);
   const StringDictionaryProxy* sd_inner_proxy{nullptr};
@@ -861,7 +933,7 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
     fill_one_to_many_hash_table_bucketized(&(*cpu_hash_table_buff_)[0],
                                            hash_entry_info,
                                            hash_join_invalid_val,
-                                           {col_buff, num_elements},
+                                           join_columns,
                                            {static_cast<size_t>(ti.get_size()),
                                             col_range_.getIntMin(),
                                             col_range_.getIntMax(),
@@ -876,7 +948,7 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
     fill_one_to_many_hash_table(&(*cpu_hash_table_buff_)[0],
                                 hash_entry_info,
                                 hash_join_invalid_val,
-                                {col_buff, num_elements},
+                                join_columns,
                                 {static_cast<size_t>(ti.get_size()),
                                  col_range_.getIntMin(),
                                  col_range_.getIntMax(),
@@ -892,6 +964,14 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
 
 namespace {
 
+size_t get_join_column_element_count(const std::vector<JoinColumn>& join_columns) {
+  size_t element_count{0};
+  for (const auto& join_column : join_columns) {
+    element_count += join_column.num_elems;
+  }
+  return element_count;
+}
+
 #ifdef HAVE_CUDA
 // Number of entries per shard, rounded up.
 size_t get_entries_per_shard(const size_t total_entry_count, const size_t shard_count) {
@@ -904,8 +984,7 @@ size_t get_entries_per_shard(const size_t total_entry_count, const size_t shard_
 
 void JoinHashTable::initHashTableForDevice(
     const ChunkKey& chunk_key,
-    const int8_t* col_buff,
-    const size_t num_elements,
+    const std::vector<JoinColumn>& join_columns,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const Data_Namespace::MemoryLevel effective_memory_level,
     const int device_id) {
@@ -946,17 +1025,24 @@ void JoinHashTable::initHashTableForDevice(
   const auto& ti = inner_col->get_type_info();
 #endif
   const int32_t hash_join_invalid_val{-1};
+  const auto num_elements = get_join_column_element_count(join_columns);
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
     CHECK(!chunk_key.empty());
     initHashTableOnCpuFromCache(chunk_key, num_elements, cols);
+    const auto build_timer = timer_start();
     {
       std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      initHashTableOnCpu(
-          col_buff, num_elements, cols, hash_entry_info, hash_join_invalid_val);
+      initHashTableOnCpu(join_columns, cols, hash_entry_info, hash_join_invalid_val);
     }
     if (inner_col->get_table_id() > 0) {
-      putHashTableOnCpuToCache(chunk_key, num_elements, cols);
+      putHashTableOnCpuToCache(
+          chunk_key,
+          num_elements,
+          cols,
+          timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+              build_timer));
     }
+    initInsertedKeyRange(hash_entry_info);
     // Transfer the hash table on the GPU if we've only built it on CPU
     // but the query runs on GPU (join on dictionary encoded columns).
     if (memory_level_ == Data_Namespace::GPU_LEVEL) {
@@ -994,7 +1080,8 @@ void JoinHashTable::initHashTableForDevice(
     if (chunk_key.empty()) {
       return;
     }
-    JoinColumn join_column{col_buff, num_elements};
+    CHECK_EQ(size_t(1), join_columns.size());
+    const auto& join_column = join_columns.front();
     JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
                                  col_range_.getIntMin(),
                                  col_range_.getIntMax(),
@@ -1041,13 +1128,13 @@ void JoinHashTable::initHashTableForDevice(
 
 void JoinHashTable::initOneToManyHashTable(
     const ChunkKey& chunk_key,
-    const int8_t* col_buff,
-    const size_t num_elements,
+    const std::vector<JoinColumn>& join_columns,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const Data_Namespace::MemoryLevel effective_memory_level,
     const int device_id) {
   auto const inner_col = cols.first;
   CHECK(inner_col);
+  const auto num_elements = get_join_column_element_count(join_columns);
 
   auto hash_entry_info = get_bucketized_hash_entry_info(
       inner_col->get_type_info(), col_range_, isBitwiseEq());
@@ -1084,14 +1171,21 @@ void JoinHashTable::initOneToManyHashTable(
   const int32_t hash_join_invalid_val{-1};
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
     initHashTableOnCpuFromCache(chunk_key, num_elements, cols);
+    const auto build_timer = timer_start();
     {
       std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
       initOneToManyHashTableOnCpu(
-          col_buff, num_elements, cols, hash_entry_info, hash_join_invalid_val);
+          join_columns, num_elements, cols, hash_entry_info, hash_join_invalid_val);
     }
     if (inner_col->get_table_id() > 0) {
-      putHashTableOnCpuToCache(chunk_key, num_elements, cols);
+      putHashTableOnCpuToCache(
+          chunk_key,
+          num_elements,
+          cols,
+          timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+              build_timer));
     }
+    initInsertedKeyRange(hash_entry_info);
     // Transfer the hash table on the GPU if we've only built it on CPU
     // but the query runs on GPU (join on dictionary encoded columns).
     // Don't transfer the buffer if there was an error since we'll bail anyway.
@@ -1119,7 +1213,9 @@ void JoinHashTable::initOneToManyHashTable(
         hash_join_invalid_val,
         executor_->blockSize(),
         executor_->gridSize());
-    JoinColumn join_column{col_buff, num_elements};
+    CHECK_LE(join_columns.size(), size_t(1));
+    const auto join_column =
+        join_columns.empty() ? JoinColumn{nullptr, 0, 0} : join_columns.front();
     JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
                                  col_range_.getIntMin(),
                                  col_range_.getIntMax(),
@@ -1181,20 +1277,18 @@ void JoinHashTable::initHashTableOnCpuFromCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      cpu_hash_table_buff_ = kv.second;
-      break;
-    }
+  auto cached_hash_table = join_hash_table_cache_.get(cache_key);
+  if (cached_hash_table) {
+    std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+    cpu_hash_table_buff_ = std::move(cached_hash_table);
   }
 }
 
 void JoinHashTable::putHashTableOnCpuToCache(
     const ChunkKey& chunk_key,
     const size_t num_elements,
-    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols) {
+    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+    const size_t build_time_us) {
   const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(cols.second);
   JoinHashTableCacheKey cache_key{col_range_,
                                   *cols.first,
@@ -1202,13 +1296,16 @@ void JoinHashTable::putHashTableOnCpuToCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      return;
-    }
+  if (join_hash_table_cache_.get(cache_key)) {
+    return;
   }
-  join_hash_table_cache_.emplace_back(cache_key, cpu_hash_table_buff_);
+  join_hash_table_cache_.setBudget(std::numeric_limits<size_t>::max(),
+                                   g_join_hash_table_cache_max_bytes);
+  join_hash_table_cache_.put(
+      cache_key,
+      cpu_hash_table_buff_,
+      get_hash_table_cache_credits(build_time_us,
+                                   cpu_hash_table_buff_->size() * sizeof(int32_t)));
 }
 
 llvm::Value* JoinHashTable::codegenHashTableLoad(const size_t table_idx) {
@@ -1463,6 +1560,76 @@ size_t JoinHashTable::shardCount() const {
              : 0;
 }
 
+std::vector<JoinKeyRange> JoinHashTable::getProbeKeyRanges() const {
+  if (isBitwiseEq()) {
+    // null keys match each other
+    return {};
+  }
+  const auto cols = get_cols(
+      qual_bin_oper_.get(), *executor_->getCatalog(), executor_->temporary_tables_);
+  const auto outer_col = cols.second;
+  CHECK(outer_col);
+  if (!outer_col->get_type_info().is_integer() ||
+      !cols.first->get_type_info().is_integer()) {
+    return {};
+  }
+  if (!inserted_key_range_) {
+    return {};
+  }
+  return {{outer_col, inserted_key_range_->first, inserted_key_range_->second}};
+}
+
+// Computes the range of the keys inserted in the table built on CPU. It can be narrower
+// than the range of the inner column, whose chunk metadata only widens on updates. The
+// table is dense over the column range, only the first and last used slots are looked
+// up.
+void JoinHashTable::initInsertedKeyRange(const HashEntryInfo hash_entry_info) {
+  inserted_key_range_ = boost::none;
+  // the table of IS NOT DISTINCT FROM has a trailing slot for the null key, after the
+  // slots of the column range
+  if (!g_enable_runtime_join_filters || memory_level_ != Data_Namespace::CPU_LEVEL ||
+      isBitwiseEq()) {
+    return;
+  }
+  std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+  CHECK(cpu_hash_table_buff_);
+  const int32_t* slots{nullptr};
+  size_t slot_count{0};
+  int32_t empty_slot_val{0};
+  if (hash_type_ == JoinHashTableInterface::HashType::OneToOne) {
+    slots = cpu_hash_table_buff_->data();
+    slot_count = cpu_hash_table_buff_->size();
+    empty_slot_val = -1;
+  } else {
+    // the keys without a row have no count
+    slots = cpu_hash_table_buff_->data() + countBufferOff() / sizeof(int32_t);
+    slot_count = hash_entry_count_;
+  }
+  size_t first_slot = 0;
+  while (first_slot < slot_count && slots[first_slot] == empty_slot_val) {
+    ++first_slot;
+  }
+  if (first_slot == slot_count) {
+    return;
+  }
+  size_t last_slot = slot_count - 1;
+  while (slots[last_slot] == empty_slot_val) {
+    --last_slot;
+  }
+  // a bucket holds bucket_normalization consecutive keys
+  const auto bucket_normalization = hash_entry_info.bucket_normalization;
+  const int64_t min_key =
+      col_range_.getIntMin() + static_cast<int64_t>(first_slot) * bucket_normalization;
+  const int64_t max_key = col_range_.getIntMin() +
+                          static_cast<int64_t>(last_slot + 1) * bucket_normalization - 1;
+  if (min_key > col_range_.getIntMax()) {
+    // the slots don't match the column range, don't filter on it
+    return;
+  }
+  inserted_key_range_ =
+      std::make_pair(min_key, std::min(max_key, col_range_.getIntMax()));
+}
+
 bool JoinHashTable::isBitwiseEq() const {
   return qual_bin_oper_->get_optype() == kBW_EQ;
 }
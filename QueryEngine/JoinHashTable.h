@@ -28,15 +28,18 @@
 #include "../Catalog/Catalog.h"
 #include "../Chunk/Chunk.h"
 #include "../Shared/ExperimentalTypeUtilities.h"
+#include "../StringDictionary/ConcurrentLruCache.hpp"
 #include "Allocators/ThrustAllocator.h"
 #include "ColumnarResults.h"
 #include "Descriptors/InputDescriptors.h"
 #include "Descriptors/RowSetMemoryOwner.h"
 #include "ExpressionRange.h"
+#include "HashJoinRuntime.h"
 #include "InputMetadata.h"
 #include "JoinHashTableInterface.h"
 
 #include <llvm/IR/Value.h>
+#include <boost/functional/hash.hpp>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -102,6 +105,8 @@ class JoinHashTable : public JoinHashTableInterface {
 
   size_t payloadBufferOff() const noexcept override;
 
+  std::vector<JoinKeyRange> getProbeKeyRanges() const override;
+
   static HashJoinMatchingSet codegenMatchingSet(
       const std::vector<llvm::Value*>& hash_join_idx_args_in,
       const bool is_sharded,
@@ -114,12 +119,20 @@ class JoinHashTable : public JoinHashTableInterface {
   static llvm::Value* codegenHashTableLoad(const size_t table_idx, Executor* executor);
 
   static auto yieldCacheInvalidator() -> std::function<void()> {
-    return []() -> void {
-      std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-      join_hash_table_cache_.clear();
+    return []() -> void { join_hash_table_cache_.clear(); };
+  }
+
+  static auto yieldTableCacheInvalidator(const int db_id, const int table_id)
+      -> std::function<void()> {
+    return [db_id, table_id]() -> void {
+      join_hash_table_cache_.eraseIf([db_id, table_id](const JoinHashTableCacheKey& key) {
+        return key.chunk_key[0] == db_id && key.chunk_key[1] == table_id;
+      });
     };
   }
 
+  static size_t getCacheSizeBytes() { return join_hash_table_cache_.sizeBytes(); }
+
   virtual ~JoinHashTable() {}
 
  private:
@@ -157,6 +170,11 @@ class JoinHashTable : public JoinHashTableInterface {
       const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
       std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
 
+  std::vector<JoinColumn> getColumnFragmentsPerFragment(
+      const Analyzer::ColumnVar& hash_col,
+      const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
+      std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
+
   ChunkKey genHashTableKey(
       const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
       const Analyzer::Expr* outer_col,
@@ -172,15 +190,13 @@ class JoinHashTable : public JoinHashTableInterface {
   void checkHashJoinReplicationConstraint(const int table_id) const;
   void initHashTableForDevice(
       const ChunkKey& chunk_key,
-      const int8_t* col_buff,
-      const size_t num_elements,
+      const std::vector<JoinColumn>& join_columns,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
       const Data_Namespace::MemoryLevel effective_memory_level,
       const int device_id);
   void initOneToManyHashTable(
       const ChunkKey& chunk_key,
-      const int8_t* col_buff,
-      const size_t num_elements,
+      const std::vector<JoinColumn>& join_columns,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
       const Data_Namespace::MemoryLevel effective_memory_level,
       const int device_id);
@@ -191,19 +207,20 @@ class JoinHashTable : public JoinHashTableInterface {
   void putHashTableOnCpuToCache(
       const ChunkKey& chunk_key,
       const size_t num_elements,
-      const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols);
+      const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+      const size_t build_time_us);
   void initHashTableOnCpu(
-      const int8_t* col_buff,
-      const size_t num_elements,
+      const std::vector<JoinColumn>& join_columns,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
       const HashEntryInfo hash_entry_info,
       const int32_t hash_join_invalid_val);
   void initOneToManyHashTableOnCpu(
-      const int8_t* col_buff,
+      const std::vector<JoinColumn>& join_columns,
       const size_t num_elements,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
       const HashEntryInfo hash_entry_info,
       const int32_t hash_join_invalid_val);
+  void initInsertedKeyRange(const HashEntryInfo hash_entry_info);
 
   const InputTableInfo& getInnerQueryInfo(const Analyzer::ColumnVar* inner_col) const;
 
@@ -216,7 +233,7 @@ class JoinHashTable : public JoinHashTableInterface {
                                             const int shard_count,
                                             const CompilationOptions& co);
 
-  std::pair<const int8_t*, size_t> fetchFragments(
+  std::vector<JoinColumn> fetchFragments(
       const Analyzer::ColumnVar* hash_col,
       const std::deque<Fragmenter_Namespace::FragmentInfo>& fragment_info,
       const Data_Namespace::MemoryLevel effective_memory_level,
@@ -245,6 +262,8 @@ class JoinHashTable : public JoinHashTableInterface {
   std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_err_buff_;
 #endif
   ExpressionRange col_range_;
+  // min and max of the keys in the table, see getProbeKeyRanges
+  boost::optional<std::pair<int64_t, int64_t>> inserted_key_range_;
   Executor* executor_;
   ColumnCacheMap& column_cache_;
   const int device_count_;
@@ -267,10 +286,21 @@ class JoinHashTable : public JoinHashTableInterface {
     }
   };
 
-  static std::vector<
-      std::pair<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>>
+  struct JoinHashTableCacheKeyHash {
+    size_t operator()(const JoinHashTableCacheKey& key) const {
+      size_t seed = boost::hash_value(key.chunk_key);
+      boost::hash_combine(seed, key.num_elements);
+      boost::hash_combine(seed, static_cast<int>(key.optype));
+      boost::hash_combine(seed, key.inner_col.get_table_id());
+      boost::hash_combine(seed, key.inner_col.get_column_id());
+      return seed;
+    }
+  };
+
+  static ConcurrentLruCache<JoinHashTableCacheKey,
+                            std::vector<int32_t>,
+                            JoinHashTableCacheKeyHash>
       join_hash_table_cache_;
-  static std::mutex join_hash_table_cache_mutex_;
 };
 
 inline std::string get_table_name_by_id(const int table_id,
@@ -313,6 +343,11 @@ std::deque<Fragmenter_Namespace::FragmentInfo> only_shards_for_device(
     const int device_id,
     const int device_count);
 
+// Whether the statistics collected by ANALYZE TABLE show that the inner keys of the
+// join repeat, in which case building a one-to-one hash table is bound to fail.
+bool inner_keys_have_duplicates(const std::vector<InnerOuter>& inner_outer_pairs,
+                                const Catalog_Namespace::Catalog& cat);
+
 const InputTableInfo& get_inner_query_info(
     const int inner_table_id,
     const std::vector<InputTableInfo>& query_infos);
@@ -17,7 +17,9 @@
 #define QUERYENGINE_JOINHASHTABLEINTERFACE_H
 
 #include <llvm/IR/Value.h>
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 #include "CompilationOptions.h"
 
 class TooManyHashEntries : public std::runtime_error {
@@ -57,6 +59,13 @@ struct HashJoinMatchingSet {
 
 using InnerOuter = std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>;
 
+// Values of an outer (probe side) join key which can find a match in the hash table.
+struct JoinKeyRange {
+  const Analyzer::Expr* outer_key;
+  int64_t min;
+  int64_t max;
+};
+
 class JoinHashTableInterface {
  public:
   virtual int64_t getJoinHashBuffer(const ExecutorDeviceType device_type,
@@ -80,6 +89,24 @@ class JoinHashTableInterface {
   virtual size_t countBufferOff() const noexcept = 0;
 
   virtual size_t payloadBufferOff() const noexcept = 0;
+
+  // Ranges of the outer keys which can match, derived from the keys of the table once
+  // it's built. Used to skip the fragments of the outer table which can't match.
+  virtual std::vector<JoinKeyRange> getProbeKeyRanges() const { return {}; }
 };
 
+// Credits of a CPU hash table in the hash table caches, the number of sweeps of the
+// eviction clock it survives after its last use: tables which took long to build for
+// the memory they hold are worth keeping longer than cheap or large ones.
+inline size_t get_hash_table_cache_credits(const size_t build_time_us,
+                                           const size_t size_bytes) {
+  const size_t build_time_us_per_mb =
+      build_time_us * 1024 * 1024 / std::max(size_bytes, size_t(1));
+  size_t credits{1};
+  for (size_t cost = build_time_us_per_mb / 1000; cost; cost >>= 1) {
+    ++credits;
+  }
+  return credits;
+}
+
 #endif  // QUERYENGINE_JOINHASHTABLEINTERFACE_H
@@ -16,6 +16,7 @@
 
 #include "../Shared/geo_compression.h"
 #include "CompareKeysInl.h"
+#include "JoinBloomFilterInl.h"
 #include "MurmurHash.h"
 
 DEVICE bool compare_to_key(const int8_t* entry,
@@ -92,6 +93,18 @@ baseline_hash_join_idx_64(const int8_t* hash_buff,
   return baseline_hash_join_idx_impl<int64_t>(hash_buff, key, key_bytes, entry_count);
 }
 
+extern "C" NEVER_INLINE DEVICE bool baseline_hash_join_bloom_filter_contains(
+    const int64_t* bloom_filter,
+    const size_t word_count,
+    const int8_t* key,
+    const size_t key_bytes) {
+  const uint64_t h = MurmurHash64A(key, key_bytes, 0);
+  const uint64_t mask = join_bloom_filter_mask(h);
+  const auto word =
+      static_cast<uint64_t>(bloom_filter[join_bloom_filter_word_idx(h, word_count)]);
+  return (word & mask) == mask;
+}
+
 template <typename T>
 FORCE_INLINE DEVICE int64_t get_bucket_key_for_value_impl(const T value,
                                                           const double bucket_size) {
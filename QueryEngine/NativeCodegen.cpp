@@ -33,6 +33,7 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/GlobalValue.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
@@ -40,6 +41,7 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
@@ -51,6 +53,7 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Vectorize.h>
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Intrinsics.h"
 
@@ -63,11 +66,16 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <thread>
+
 std::unique_ptr<llvm::Module> udf_gpu_module;
 std::unique_ptr<llvm::Module> udf_cpu_module;
 std::unique_ptr<llvm::Module> rt_udf_gpu_module;
 std::unique_ptr<llvm::Module> rt_udf_cpu_module;
 
+bool g_enable_cpu_vectorization{false};
+bool g_enable_tiered_compilation{false};
+
 namespace {
 
 #if defined(HAVE_CUDA) || !defined(WITH_JIT_DEBUG)
@@ -96,11 +104,17 @@ void eliminate_dead_self_recursive_funcs(
   }
 }
 
+// When a target machine is given, the loops are also vectorized for it.
 void optimize_ir(llvm::Function* query_func,
                  llvm::Module* module,
                  const std::unordered_set<llvm::Function*>& live_funcs,
-                 const CompilationOptions& co) {
+                 const CompilationOptions& co,
+                 llvm::TargetMachine* vectorization_target = nullptr) {
   llvm::legacy::PassManager pass_manager;
+  if (vectorization_target) {
+    pass_manager.add(llvm::createTargetTransformInfoWrapperPass(
+        vectorization_target->getTargetIRAnalysis()));
+  }
 
   pass_manager.add(llvm::createAlwaysInlinerLegacyPass());
   pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
@@ -113,6 +127,15 @@ void optimize_ir(llvm::Function* query_func,
   pass_manager.add(llvm::createGlobalOptimizerPass());
 
   pass_manager.add(llvm::createLICMPass());
+  if (vectorization_target) {
+    // The row function is inlined in the query loop at this point, which lets the loop
+    // vectorizer process several rows per iteration.
+    pass_manager.add(llvm::createLoopRotatePass());
+    pass_manager.add(llvm::createLoopVectorizePass());
+    pass_manager.add(llvm::createSLPVectorizerPass());
+    pass_manager.add(llvm::createInstructionCombiningPass());
+    pass_manager.add(llvm::createCFGSimplificationPass());
+  }
   if (co.opt_level_ == ExecutorOptLevel::LoopStrengthReduction) {
     pass_manager.add(llvm::createLoopStrengthReducePass());
   }
@@ -122,6 +145,31 @@ void optimize_ir(llvm::Function* query_func,
 }
 #endif
 
+// Features of the host CPU (e.g. "+avx2") in the format expected by the engine builder.
+std::vector<std::string> get_host_cpu_features() {
+  std::vector<std::string> features;
+  llvm::StringMap<bool> host_features;
+  if (llvm::sys::getHostCPUFeatures(host_features)) {
+    for (const auto& feature : host_features) {
+      features.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+    }
+  }
+  return features;
+}
+
+// Target machine for the host CPU and its instruction set extensions, which gives the
+// vectorizers their cost model.
+std::unique_ptr<llvm::TargetMachine> create_host_target_machine() {
+  auto init_err = llvm::InitializeNativeTarget();
+  CHECK(!init_err);
+  llvm::EngineBuilder eb;
+  eb.setMCPU(llvm::sys::getHostCPUName().str());
+  eb.setMAttrs(get_host_cpu_features());
+  std::unique_ptr<llvm::TargetMachine> target_machine(eb.selectTarget());
+  CHECK(target_machine);
+  return target_machine;
+}
+
 }  // namespace
 
 template <class T>
@@ -151,6 +199,14 @@ ExecutionEngineWrapper::ExecutionEngineWrapper(llvm::ExecutionEngine* execution_
   }
 }
 
+ExecutionEngineWrapper& ExecutionEngineWrapper::operator=(
+    ExecutionEngineWrapper&& other) {
+  execution_engine_ = std::move(other.execution_engine_);
+  intel_jit_listener_ = std::move(other.intel_jit_listener_);
+  context_ = std::move(other.context_);
+  return *this;
+}
+
 ExecutionEngineWrapper& ExecutionEngineWrapper::operator=(
     llvm::ExecutionEngine* execution_engine) {
   execution_engine_.reset(execution_engine);
@@ -169,18 +225,20 @@ void verify_function_ir(const llvm::Function* func) {
 
 std::vector<std::pair<void*, void*>> Executor::getCodeFromCache(const CodeCacheKey& key,
                                                                 const CodeCache& cache) {
-  auto it = cache.find(key);
-  if (it != cache.cend()) {
+  const auto cached_code = cache.get(key);
+  if (cached_code) {
+    query_profile_.add(QueryCounter::CodeCacheHits, 1);
     delete cgen_state_->module_;
-    cgen_state_->module_ = it->second.second;
+    cgen_state_->module_ = cached_code->second;
     std::vector<std::pair<void*, void*>> native_functions;
-    for (auto& native_code : it->second.first) {
+    for (auto& native_code : cached_code->first) {
       GpuCompilationContext* gpu_context = std::get<2>(native_code).get();
       native_functions.emplace_back(std::get<0>(native_code),
                                     gpu_context ? gpu_context->module() : nullptr);
     }
     return native_functions;
   }
+  query_profile_.add(QueryCounter::CodeCacheMisses, 1);
   return {};
 }
 
@@ -221,12 +279,9 @@ void Executor::addCodeToCache(
 ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
     llvm::Function* func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const CompilationOptions& co,
+    const bool fast_codegen) {
   auto module = func->getParent();
-  // run optimizations
-#ifndef WITH_JIT_DEBUG
-  optimize_ir(func, module, live_funcs, co);
-#endif  // WITH_JIT_DEBUG
 
   auto init_err = llvm::InitializeNativeTarget();
   CHECK(!init_err);
@@ -235,6 +290,23 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
   llvm::InitializeNativeTargetAsmPrinter();
   llvm::InitializeNativeTargetAsmParser();
 
+  // Vectorized code targets the instruction set extensions of the host, the default
+  // target is the baseline of its architecture (i.e. SSE2 on x86-64).
+  const bool vectorize = g_enable_cpu_vectorization && !fast_codegen &&
+                         co.opt_level_ != ExecutorOptLevel::ReductionJIT;
+  const auto host_cpu_name = vectorize ? llvm::sys::getHostCPUName().str() : "";
+  const auto host_cpu_features =
+      vectorize ? get_host_cpu_features() : std::vector<std::string>{};
+
+  // run optimizations
+#ifndef WITH_JIT_DEBUG
+  if (vectorize) {
+    optimize_ir(func, module, live_funcs, co, create_host_target_machine().get());
+  } else {
+    optimize_ir(func, module, live_funcs, co);
+  }
+#endif  // WITH_JIT_DEBUG
+
   std::string err_str;
   std::unique_ptr<llvm::Module> owner(module);
   llvm::EngineBuilder eb(std::move(owner));
@@ -243,9 +315,13 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
   llvm::TargetOptions to;
   to.EnableFastISel = true;
   eb.setTargetOptions(to);
-  if (co.opt_level_ == ExecutorOptLevel::ReductionJIT) {
+  if (co.opt_level_ == ExecutorOptLevel::ReductionJIT || fast_codegen) {
     eb.setOptLevel(llvm::CodeGenOpt::None);
   }
+  if (vectorize) {
+    eb.setMCPU(host_cpu_name);
+    eb.setMAttrs(host_cpu_features);
+  }
 
   ExecutionEngineWrapper execution_engine(eb.create(), co);
   CHECK(execution_engine.get());
@@ -266,13 +342,35 @@ std::vector<std::pair<void*, void*>> Executor::optimizeAndCodegenCPU(
   for (const auto helper : cgen_state_->helper_functions_) {
     key.push_back(serialize_llvm_object(helper));
   }
+  if (g_enable_cpu_vectorization) {
+    // the same IR compiles to different native code in this mode
+    key.push_back("vectorized");
+  }
   auto cached_code = getCodeFromCache(key, cpu_code_cache_);
   if (!cached_code.empty()) {
     return cached_code;
   }
 
-  auto execution_engine =
-      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co);
+  // With tiered compilation, the query starts with code generated without machine level
+  // optimizations and the optimized code replaces it in the cache once it's ready. The
+  // module is consumed by the first compilation, keep a copy for the second one.
+  std::string bitcode;
+  std::vector<std::string> live_func_names;
+  if (g_enable_tiered_compilation) {
+    llvm::raw_string_ostream os(bitcode);
+#if LLVM_VERSION_MAJOR >= 7
+    llvm::WriteBitcodeToFile(*module, os);
+#else
+    llvm::WriteBitcodeToFile(module, os);
+#endif
+    os.flush();
+    for (const auto live_func : live_funcs) {
+      live_func_names.push_back(live_func->getName().str());
+    }
+  }
+
+  auto execution_engine = CodeGenerator::generateNativeCPUCode(
+      query_func, live_funcs, co, g_enable_tiered_compilation);
   auto native_code = execution_engine->getPointerToFunction(multifrag_query_func);
   CHECK(native_code);
 
@@ -280,9 +378,84 @@ std::vector<std::pair<void*, void*>> Executor::optimizeAndCodegenCPU(
   cache.emplace_back(native_code, std::move(execution_engine));
   addCodeToCache(key, std::move(cache), module, cpu_code_cache_);
 
+  if (g_enable_tiered_compilation) {
+    compileOptimizedCPUCodeAsync(key,
+                                 std::move(bitcode),
+                                 query_func->getName().str(),
+                                 multifrag_query_func->getName().str(),
+                                 live_func_names,
+                                 co);
+  }
+
   return {std::make_pair(native_code, nullptr)};
 }
 
+void Executor::compileOptimizedCPUCodeAsync(
+    const CodeCacheKey& key,
+    std::string bitcode,
+    const std::string& query_func_name,
+    const std::string& multifrag_query_func_name,
+    const std::vector<std::string>& live_func_names,
+    const CompilationOptions& co) {
+  tiered_compilations_.remove_if([](const std::future<void>& compilation) {
+    return compilation.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  });
+  tiered_compilations_.emplace_back(std::async(std::launch::async, [=]() {
+    try {
+      // The global context isn't thread safe, parse the module in a private one.
+      auto context = std::make_unique<llvm::LLVMContext>();
+      auto module_or_err =
+          llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, "tiered"), *context);
+      if (auto err = module_or_err.takeError()) {
+        throw std::runtime_error(llvm::toString(std::move(err)));
+      }
+      // owned by the execution engine once compiled
+      auto module = module_or_err.get().release();
+      auto query_func = module->getFunction(query_func_name);
+      auto multifrag_query_func = module->getFunction(multifrag_query_func_name);
+      CHECK(query_func);
+      CHECK(multifrag_query_func);
+      std::unordered_set<llvm::Function*> live_funcs;
+      for (const auto& live_func_name : live_func_names) {
+        const auto live_func = module->getFunction(live_func_name);
+        if (live_func) {
+          live_funcs.insert(live_func);
+        }
+      }
+      auto execution_engine =
+          CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co);
+      execution_engine.setContext(std::move(context));
+      auto native_code = execution_engine->getPointerToFunction(multifrag_query_func);
+      CHECK(native_code);
+
+      // Swap the code between queries, the unoptimized version could be running. Don't
+      // block on the lock, whoever holds it might be waiting for this thread to finish.
+      std::unique_lock<std::mutex> lock(execute_mutex_, std::defer_lock);
+      while (!lock.try_lock()) {
+        if (cancel_tiered_compilations_) {
+          return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      std::vector<std::tuple<void*, ExecutionEngineWrapper>> cache;
+      cache.emplace_back(native_code, std::move(execution_engine));
+      addCodeToCache(key, std::move(cache), module, cpu_code_cache_);
+      VLOG(1) << "Replaced the code of " << multifrag_query_func_name
+              << " with its optimized version";
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Optimized compilation failed, keeping the unoptimized code: "
+                   << e.what();
+    }
+  }));
+}
+
+void Executor::waitForTieredCompilations() {
+  for (auto& compilation : tiered_compilations_) {
+    compilation.wait();
+  }
+  tiered_compilations_.clear();
+}
+
 namespace {
 
 std::string cpp_to_llvm_name(const std::string& s) {
@@ -365,6 +538,7 @@ declare i64 @baseline_hash_join_idx_32(i8*, i8*, i64, i64);
 declare i64 @baseline_hash_join_idx_64(i8*, i8*, i64, i64);
 declare i64 @get_composite_key_index_32(i32*, i64, i32*, i64);
 declare i64 @get_composite_key_index_64(i64*, i64, i64*, i64);
+declare i1 @baseline_hash_join_bloom_filter_contains(i64*, i64, i8*, i64);
 declare i64 @get_bucket_key_for_range_compressed(i8*, i64, double);
 declare i64 @get_bucket_key_for_range_double(i8*, i64, double);
 declare i64 @agg_count_shared(i64*, i64);
@@ -903,6 +1077,24 @@ llvm::Module* read_template_module(llvm::LLVMContext& context) {
 
 namespace {
 
+// A CPU kernel goes through the rows of its fragments one by one. Unlike a call to
+// pos_step_impl, a constant step lets the loop vectorizer compute the trip count of the
+// query loop.
+void bind_cpu_pos_step(llvm::Function* query_func) {
+  for (auto it = llvm::inst_begin(query_func), e = llvm::inst_end(query_func); it != e;
+       ++it) {
+    if (!llvm::isa<llvm::CallInst>(*it)) {
+      continue;
+    }
+    auto& pos_call = llvm::cast<llvm::CallInst>(*it);
+    if (std::string(pos_call.getCalledFunction()->getName()) == "pos_step") {
+      pos_call.replaceAllUsesWith(llvm::ConstantInt::get(pos_call.getType(), 1));
+      pos_call.eraseFromParent();
+      break;
+    }
+  }
+}
+
 void bind_pos_placeholders(const std::string& pos_fn_name,
                            const bool use_resume_param,
                            llvm::Function* query_func,
@@ -1669,7 +1861,11 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
                                                  !!ra_exe_unit.estimator);
   bind_pos_placeholders("pos_start", true, query_func, cgen_state_->module_);
   bind_pos_placeholders("group_buff_idx", false, query_func, cgen_state_->module_);
-  bind_pos_placeholders("pos_step", false, query_func, cgen_state_->module_);
+  if (co.device_type_ == ExecutorDeviceType::CPU && g_enable_cpu_vectorization) {
+    bind_cpu_pos_step(query_func);
+  } else {
+    bind_pos_placeholders("pos_step", false, query_func, cgen_state_->module_);
+  }
 
   cgen_state_->query_func_ = query_func;
   cgen_state_->query_func_entry_ir_builder_.SetInsertPoint(
@@ -1774,7 +1970,16 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
       throw std::runtime_error(
           "Explain optimized not available when JIT runtime debug symbols are enabled");
 #else
-      optimize_ir(query_func, cgen_state_->module_, live_funcs, co);
+      if (co.device_type_ == ExecutorDeviceType::CPU && g_enable_cpu_vectorization) {
+        // the IR of the native code, see CodeGenerator::generateNativeCPUCode
+        optimize_ir(query_func,
+                    cgen_state_->module_,
+                    live_funcs,
+                    co,
+                    create_host_target_machine().get());
+      } else {
+        optimize_ir(query_func, cgen_state_->module_, live_funcs, co);
+      }
 #endif  // WITH_JIT_DEBUG
     }
     llvm_ir =
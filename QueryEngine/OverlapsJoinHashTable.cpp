@@ -65,6 +65,10 @@ std::shared_ptr<OverlapsJoinHashTable> OverlapsJoinHashTable::getInstance(
   } catch (const ColumnarConversionNotSupported& e) {
     throw HashJoinFail(std::string("Could not build hash tables for equijoin | ") +
                        e.what());
+  } catch (const QueryMemoryBudgetExceeded& e) {
+    // surfaced as ERR_OUT_OF_QUERY_MEMORY_BUDGET by the executor
+    join_hash_table->freeHashBufferMemory();
+    throw;
   } catch (const std::exception& e) {
     LOG(FATAL) << "Fatal error while attempting to build hash tables for join: "
                << e.what();
@@ -225,7 +229,7 @@ BaselineJoinHashTable::ColumnsForDevice OverlapsJoinHashTable::fetchColumnsForDe
     const auto join_column_info = fetchColumn(
         inner_col, effective_memory_level, fragments, chunks_owner, device_id);
     join_columns.emplace_back(
-        JoinColumn{join_column_info.col_buff, join_column_info.num_elems});
+        JoinColumn{join_column_info.col_buff, join_column_info.num_elems, 0});
     const auto& ti = inner_col->get_type_info();
     join_column_types.emplace_back(JoinColumnTypeInfo{static_cast<size_t>(ti.get_size()),
                                                       0,
@@ -441,6 +445,10 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
           << " entries in the one to many buffer";
   VLOG(1) << "Total hash table size: " << hash_table_size << " Bytes";
 
+  const auto build_timer = timer_start();
+  if (const auto row_set_mem_owner = executor_->getRowSetMemoryOwner()) {
+    row_set_mem_owner->chargeMemoryBudget(hash_table_size);
+  }
   cpu_hash_table_buff_.reset(new std::vector<int8_t>(hash_table_size));
   int thread_count = cpu_threads();
   std::vector<std::future<void>> init_cpu_buff_threads;
@@ -574,7 +582,10 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
       CHECK(false);
   }
   if (!err && getInnerTableId() > 0) {
-    putHashTableOnCpuToCache(cache_key);
+    putHashTableOnCpuToCache(
+        cache_key,
+        timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+            build_timer));
   }
   return err;
 }
@@ -64,6 +64,20 @@ class OverlapsJoinHashTable : public BaselineJoinHashTable {
     };
   }
 
+  static auto yieldTableCacheInvalidator(const int db_id, const int table_id)
+      -> std::function<void()> {
+    return [db_id, table_id]() -> void {
+      std::lock_guard<std::mutex> guard(auto_tuner_cache_mutex_);
+      for (auto it = auto_tuner_cache_.begin(); it != auto_tuner_cache_.end();) {
+        if (cacheKeyReferencesTable(it->first, db_id, table_id)) {
+          it = auto_tuner_cache_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    };
+  }
+
  protected:
   void reifyWithLayout(const int device_count,
                        const JoinHashTableInterface::HashType layout) override;
@@ -20,6 +20,7 @@
 #include "Descriptors/InputDescriptors.h"
 #include "JoinHashTableInterface.h"
 
+#include <list>
 #include <unordered_set>
 
 class Executor;
@@ -36,6 +37,9 @@ struct JoinInfo {
                                // fold them to true during code generation
   std::vector<std::shared_ptr<JoinHashTableInterface>> join_hash_tables_;
   std::unordered_set<size_t> sharded_range_table_indices_;
+  // Outer key range predicates derived from the built hash tables of inner joins, only
+  // used to skip fragments of the outer table.
+  std::list<std::shared_ptr<Analyzer::Expr>> probe_key_range_quals_;
 };
 
 struct PlanState {
@@ -608,85 +608,113 @@ std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
       join_hash_tables.size() == 1
           ? reinterpret_cast<int64_t*>(join_hash_tables[0])
           : (join_hash_tables.size() > 1 ? &join_hash_tables[0] : nullptr);
-  if (hoist_literals) {
-    using agg_query = void (*)(const int8_t***,  // col_buffers
-                               const uint64_t*,  // num_fragments
-                               const int8_t*,    // literals
-                               const int64_t*,   // num_rows
-                               const uint64_t*,  // frag_row_offsets
-                               const int32_t*,   // max_matched
-                               int32_t*,         // total_matched
-                               const int64_t*,   // init_agg_value
-                               int64_t**,        // out
-                               int32_t*,         // error_code
-                               const uint32_t*,  // num_tables
-                               const int64_t*);  // join_hash_tables_ptr
-    if (is_group_by) {
-      reinterpret_cast<agg_query>(fn_ptrs[0].first)(
-          multifrag_cols_ptr,
-          &num_fragments,
-          &literal_buff[0],
-          num_rows_ptr,
-          &flatened_frag_offsets[0],
-          &scan_limit,
-          &total_matched_init,
-          &cmpt_val_buff[0],
-          query_buffers_->getGroupByBuffersPtr(),
-          error_code,
-          &num_tables,
-          join_hash_tables_ptr);
+  // With the bump allocator, the projection output buffer starts with room for every
+  // input row. Joins can produce more rows than that, in which case the buffer doubles
+  // and the kernel runs again.
+  const bool use_cpu_bump_allocator = ra_exe_unit.use_bump_allocator && is_group_by;
+  int32_t max_matched = use_cpu_bump_allocator
+                            ? static_cast<int32_t>(std::min(
+                                  query_buffers_->cpu_bump_allocator_entry_count_,
+                                  static_cast<size_t>(
+                                      std::numeric_limits<int32_t>::max())))
+                            : scan_limit;
+  const int32_t start_error_code = *error_code;
+  while (true) {
+    if (hoist_literals) {
+      using agg_query = void (*)(const int8_t***,  // col_buffers
+                                 const uint64_t*,  // num_fragments
+                                 const int8_t*,    // literals
+                                 const int64_t*,   // num_rows
+                                 const uint64_t*,  // frag_row_offsets
+                                 const int32_t*,   // max_matched
+                                 int32_t*,         // total_matched
+                                 const int64_t*,   // init_agg_value
+                                 int64_t**,        // out
+                                 int32_t*,         // error_code
+                                 const uint32_t*,  // num_tables
+                                 const int64_t*);  // join_hash_tables_ptr
+      if (is_group_by) {
+        reinterpret_cast<agg_query>(fn_ptrs[0].first)(
+            multifrag_cols_ptr,
+            &num_fragments,
+            &literal_buff[0],
+            num_rows_ptr,
+            &flatened_frag_offsets[0],
+            &max_matched,
+            &total_matched_init,
+            &cmpt_val_buff[0],
+            query_buffers_->getGroupByBuffersPtr(),
+            error_code,
+            &num_tables,
+            join_hash_tables_ptr);
+      } else {
+        reinterpret_cast<agg_query>(fn_ptrs[0].first)(multifrag_cols_ptr,
+                                                      &num_fragments,
+                                                      &literal_buff[0],
+                                                      num_rows_ptr,
+                                                      &flatened_frag_offsets[0],
+                                                      &max_matched,
+                                                      &total_matched_init,
+                                                      &init_agg_vals[0],
+                                                      &out_vec[0],
+                                                      error_code,
+                                                      &num_tables,
+                                                      join_hash_tables_ptr);
+      }
     } else {
-      reinterpret_cast<agg_query>(fn_ptrs[0].first)(multifrag_cols_ptr,
-                                                    &num_fragments,
-                                                    &literal_buff[0],
-                                                    num_rows_ptr,
-                                                    &flatened_frag_offsets[0],
-                                                    &scan_limit,
-                                                    &total_matched_init,
-                                                    &init_agg_vals[0],
-                                                    &out_vec[0],
-                                                    error_code,
-                                                    &num_tables,
-                                                    join_hash_tables_ptr);
+      using agg_query = void (*)(const int8_t***,  // col_buffers
+                                 const uint64_t*,  // num_fragments
+                                 const int64_t*,   // num_rows
+                                 const uint64_t*,  // frag_row_offsets
+                                 const int32_t*,   // max_matched
+                                 int32_t*,         // total_matched
+                                 const int64_t*,   // init_agg_value
+                                 int64_t**,        // out
+                                 int32_t*,         // error_code
+                                 const uint32_t*,  // num_tables
+                                 const int64_t*);  // join_hash_tables_ptr
+      if (is_group_by) {
+        reinterpret_cast<agg_query>(fn_ptrs[0].first)(
+            multifrag_cols_ptr,
+            &num_fragments,
+            num_rows_ptr,
+            &flatened_frag_offsets[0],
+            &max_matched,
+            &total_matched_init,
+            &cmpt_val_buff[0],
+            query_buffers_->getGroupByBuffersPtr(),
+            error_code,
+            &num_tables,
+            join_hash_tables_ptr);
+      } else {
+        reinterpret_cast<agg_query>(fn_ptrs[0].first)(multifrag_cols_ptr,
+                                                      &num_fragments,
+                                                      num_rows_ptr,
+                                                      &flatened_frag_offsets[0],
+                                                      &max_matched,
+                                                      &total_matched_init,
+                                                      &init_agg_vals[0],
+                                                      &out_vec[0],
+                                                      error_code,
+                                                      &num_tables,
+                                                      join_hash_tables_ptr);
+      }
     }
-  } else {
-    using agg_query = void (*)(const int8_t***,  // col_buffers
-                               const uint64_t*,  // num_fragments
-                               const int64_t*,   // num_rows
-                               const uint64_t*,  // frag_row_offsets
-                               const int32_t*,   // max_matched
-                               int32_t*,         // total_matched
-                               const int64_t*,   // init_agg_value
-                               int64_t**,        // out
-                               int32_t*,         // error_code
-                               const uint32_t*,  // num_tables
-                               const int64_t*);  // join_hash_tables_ptr
-    if (is_group_by) {
-      reinterpret_cast<agg_query>(fn_ptrs[0].first)(
-          multifrag_cols_ptr,
-          &num_fragments,
-          num_rows_ptr,
-          &flatened_frag_offsets[0],
-          &scan_limit,
-          &total_matched_init,
-          &cmpt_val_buff[0],
-          query_buffers_->getGroupByBuffersPtr(),
-          error_code,
-          &num_tables,
-          join_hash_tables_ptr);
-    } else {
-      reinterpret_cast<agg_query>(fn_ptrs[0].first)(multifrag_cols_ptr,
-                                                    &num_fragments,
-                                                    num_rows_ptr,
-                                                    &flatened_frag_offsets[0],
-                                                    &scan_limit,
-                                                    &total_matched_init,
-                                                    &init_agg_vals[0],
-                                                    &out_vec[0],
-                                                    error_code,
-                                                    &num_tables,
-                                                    join_hash_tables_ptr);
+
+    if (!use_cpu_bump_allocator || *error_code >= 0 ||
+        max_matched > std::numeric_limits<int32_t>::max() / 2) {
+      break;
     }
+    VLOG(1) << "CPU projection ran out of " << max_matched
+            << " output slots, retrying the kernel with twice as many.";
+    max_matched *= 2;
+    query_buffers_->resizeProjectionBufferCpu(query_mem_desc_, max_matched);
+    total_matched_init = 0;
+    *error_code = start_error_code;
+  }
+  if (use_cpu_bump_allocator && !*error_code) {
+    CHECK_LE(total_matched_init, max_matched);
+    query_buffers_->result_sets_.front()->updateStorageEntryCount(total_matched_init);
   }
 
   if (ra_exe_unit.estimator) {
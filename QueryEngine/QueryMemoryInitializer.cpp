@@ -58,7 +58,8 @@ inline void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_des
 }
 
 int64_t* alloc_group_by_buffer(const size_t numBytes,
-                               RenderAllocatorMap* render_allocator_map) {
+                               RenderAllocatorMap* render_allocator_map,
+                               RowSetMemoryOwner* row_set_mem_owner) {
   if (render_allocator_map) {
     // NOTE(adb): If we got here, we are performing an in-situ rendering query and are not
     // using CUDA buffers. Therefore we need to allocate result set storage using CPU
@@ -67,7 +68,7 @@ int64_t* alloc_group_by_buffer(const size_t numBytes,
     auto render_allocator_ptr = render_allocator_map->getRenderAllocator(gpu_idx);
     return reinterpret_cast<int64_t*>(render_allocator_ptr->alloc(numBytes));
   } else {
-    return reinterpret_cast<int64_t*>(checked_malloc(numBytes));
+    return row_set_mem_owner->allocateGroupByBuffer(numBytes);
   }
 }
 
@@ -208,6 +209,12 @@ QueryMemoryInitializer::QueryMemoryInitializer(
     // the fragment
     if (dispatch_mode == ExecutorDispatchMode::KernelPerFragment) {
       group_buffer_size = num_rows * query_mem_desc.getRowSize();
+      if (device_type == ExecutorDeviceType::CPU) {
+        // The CPU kernel grows the buffer and runs again if it runs out of slots, see
+        // QueryExecutionContext::launchCpuCode
+        CHECK_GT(num_rows, 0);
+        cpu_bump_allocator_entry_count_ = static_cast<size_t>(num_rows);
+      }
     } else {
       // otherwise, allocate a GPU buffer equivalent to the maximum GPU allocation size
       group_buffer_size = g_max_memory_allocation_size / query_mem_desc.getRowSize();
@@ -218,8 +225,12 @@ QueryMemoryInitializer::QueryMemoryInitializer(
   }
   CHECK_GE(group_buffer_size, size_t(0));
 
+  // The kernel writes every projected row in full when using the bump allocator, there
+  // is nothing to initialize
+  const bool init_group_by_buffers =
+      !query_mem_desc.lazyInitGroups(device_type) && !ra_exe_unit.use_bump_allocator;
   std::unique_ptr<int64_t, CheckedAllocDeleter> group_by_buffer_template;
-  if (!query_mem_desc.lazyInitGroups(device_type)) {
+  if (init_group_by_buffers) {
     group_by_buffer_template.reset(
         static_cast<int64_t*>(checked_malloc(group_buffer_size)));
 
@@ -270,17 +281,16 @@ QueryMemoryInitializer::QueryMemoryInitializer(
   const auto group_buffers_count = !query_mem_desc.isGroupBy() ? 1 : num_buffers_;
 
   for (size_t i = 0; i < group_buffers_count; i += step) {
-    auto group_by_buffer =
-        alloc_group_by_buffer(actual_group_buffer_size, render_allocator_map);
-    if (!query_mem_desc.lazyInitGroups(device_type)) {
+    auto group_by_buffer = alloc_group_by_buffer(
+        actual_group_buffer_size, render_allocator_map, row_set_mem_owner_.get());
+    executor->query_profile_.add(QueryCounter::OutputBufferBytes,
+                                 actual_group_buffer_size);
+    if (init_group_by_buffers) {
       CHECK(group_by_buffer_template);
       memcpy(group_by_buffer + index_buffer_qw,
              group_by_buffer_template.get(),
              group_buffer_size);
     }
-    if (!render_allocator_map) {
-      row_set_mem_owner_->addGroupByBuffer(group_by_buffer);
-    }
     group_by_buffers_.push_back(group_by_buffer);
     for (size_t j = 1; j < step; ++j) {
       group_by_buffers_.push_back(nullptr);
@@ -492,10 +502,10 @@ void QueryMemoryInitializer::allocateCountDistinctGpuMem(
   device_allocator_->zeroDeviceMem(reinterpret_cast<int8_t*>(count_distinct_bitmap_mem_),
                                    count_distinct_bitmap_mem_bytes_);
 
+  // the host copy is filled from the device, no need to zero it
   count_distinct_bitmap_crt_ptr_ = count_distinct_bitmap_host_mem_ =
-      static_cast<int8_t*>(checked_malloc(count_distinct_bitmap_mem_bytes_));
-  row_set_mem_owner_->addCountDistinctBuffer(
-      count_distinct_bitmap_host_mem_, count_distinct_bitmap_mem_bytes_, true);
+      row_set_mem_owner_->allocateCountDistinctBuffer(count_distinct_bitmap_mem_bytes_,
+                                                      false);
 }
 
 // deferred is true for group by queries; initGroups will allocate a bitmap
@@ -554,8 +564,8 @@ int64_t QueryMemoryInitializer::allocateCountDistinctBitmap(const size_t bitmap_
     row_set_mem_owner_->addCountDistinctBuffer(ptr, bitmap_byte_sz, false);
     return reinterpret_cast<int64_t>(ptr);
   }
-  auto count_distinct_buffer = static_cast<int8_t*>(checked_calloc(bitmap_byte_sz, 1));
-  row_set_mem_owner_->addCountDistinctBuffer(count_distinct_buffer, bitmap_byte_sz, true);
+  auto count_distinct_buffer =
+      row_set_mem_owner_->allocateCountDistinctBuffer(bitmap_byte_sz);
   return reinterpret_cast<int64_t>(count_distinct_buffer);
 }
 
@@ -770,6 +780,22 @@ void QueryMemoryInitializer::compactProjectionBuffersCpu(
   result_sets_.front()->updateStorageEntryCount(num_allocated_rows);
 }
 
+void QueryMemoryInitializer::resizeProjectionBufferCpu(
+    const QueryMemoryDescriptor& query_mem_desc,
+    const size_t entry_count) {
+  CHECK_EQ(group_by_buffers_.size(), size_t(1));
+  CHECK_EQ(result_sets_.size(), size_t(1));
+  CHECK_GT(entry_count, cpu_bump_allocator_entry_count_);
+  auto group_by_buffer = row_set_mem_owner_->allocateGroupByBuffer(
+      entry_count * query_mem_desc.getRowSize());
+  // the previous contents are discarded, the kernel runs again from the first row
+  row_set_mem_owner_->releaseGroupByBuffers(
+      {reinterpret_cast<int8_t*>(group_by_buffers_.front())});
+  group_by_buffers_.front() = group_by_buffer;
+  result_sets_.front()->updateStorageBuffer(reinterpret_cast<int8_t*>(group_by_buffer));
+  cpu_bump_allocator_entry_count_ = entry_count;
+}
+
 void QueryMemoryInitializer::compactProjectionBuffersGpu(
     const QueryMemoryDescriptor& query_mem_desc,
     Data_Namespace::DataMgr* data_mgr,
@@ -147,6 +147,9 @@ class QueryMemoryInitializer {
 
   void compactProjectionBuffersCpu(const QueryMemoryDescriptor& query_mem_desc,
                                    const size_t projection_count);
+  // Replaces the CPU projection output buffer of the bump allocator with a larger one.
+  void resizeProjectionBufferCpu(const QueryMemoryDescriptor& query_mem_desc,
+                                 const size_t entry_count);
   void compactProjectionBuffersGpu(const QueryMemoryDescriptor& query_mem_desc,
                                    Data_Namespace::DataMgr* data_mgr,
                                    const GpuGroupByBuffers& gpu_group_by_buffers,
@@ -182,6 +185,8 @@ class QueryMemoryInitializer {
 
   const size_t num_buffers_;
   std::vector<int64_t*> group_by_buffers_;
+  // Number of rows the CPU projection output buffer can hold with the bump allocator.
+  size_t cpu_bump_allocator_entry_count_{0};
 
   CUdeviceptr count_distinct_bitmap_mem_;
   size_t count_distinct_bitmap_mem_bytes_;
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef QUERYENGINE_QUERYPROFILE_H
+#define QUERYENGINE_QUERYPROFILE_H
+
+#include "../DataMgr/MemoryLevel.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+enum class QueryPhase { Compilation, Fetch, Kernel, Reduction, Count };
+
+enum class QueryCounter {
+  CodeCacheHits,
+  CodeCacheMisses,
+  CpuFetchBytes,
+  CpuFetchBytesFromParent,
+  GpuFetchBytes,
+  GpuFetchBytesFromParent,
+  FragmentsScanned,
+  FragmentsSkipped,
+  RowsScanned,
+  OutputBufferBytes,
+  Count
+};
+
+// Snapshot of the execution profile of a query. Times are in microseconds. Fetch and
+// kernel times are summed over all the kernels of the query, hence they can exceed the
+// wall clock time when kernels run concurrently; the time of each individual kernel is
+// in kernel_times_us.
+struct QueryProfile {
+  int64_t compilation_us{0};
+  int64_t fetch_us{0};
+  int64_t kernel_us{0};
+  int64_t reduction_us{0};
+  std::vector<int64_t> kernel_times_us;
+
+  int64_t code_cache_hits{0};
+  int64_t code_cache_misses{0};
+
+  // Bytes of the chunks fetched at each memory level and the part of them which wasn't
+  // resident at that level yet, i.e. had to be read from disk (CPU) or the host (GPU).
+  int64_t cpu_fetch_bytes{0};
+  int64_t cpu_fetch_bytes_from_parent{0};
+  int64_t gpu_fetch_bytes{0};
+  int64_t gpu_fetch_bytes_from_parent{0};
+
+  // Outer table fragments dispatched to kernels or skipped based on their metadata,
+  // and the number of rows in the dispatched ones.
+  int64_t fragments_scanned{0};
+  int64_t fragments_skipped{0};
+  int64_t rows_scanned{0};
+
+  int64_t output_buffer_bytes{0};
+
+  // High-water mark of the host memory held by the query: the chunks pinned by its
+  // kernels, its output buffers and its join hash tables.
+  int64_t peak_memory_bytes{0};
+};
+
+class QueryProfileCounters {
+ public:
+  QueryProfileCounters() { reset(); }
+
+  void reset() {
+    for (auto& phase : phases_) {
+      phase = 0;
+    }
+    for (auto& counter : counters_) {
+      counter = 0;
+    }
+    peak_memory_bytes_ = 0;
+    std::lock_guard<std::mutex> lock(kernel_times_mutex_);
+    kernel_times_us_.clear();
+  }
+
+  void add(const QueryPhase phase, const int64_t elapsed_us) {
+    phases_[static_cast<size_t>(phase)] += elapsed_us;
+    if (phase == QueryPhase::Kernel) {
+      std::lock_guard<std::mutex> lock(kernel_times_mutex_);
+      kernel_times_us_.push_back(elapsed_us);
+    }
+  }
+
+  void add(const QueryCounter counter, const int64_t value) {
+    counters_[static_cast<size_t>(counter)] += value;
+  }
+
+  void addFetchedBytes(const Data_Namespace::MemoryLevel memory_level,
+                       const int64_t num_bytes,
+                       const bool was_resident) {
+    const bool is_gpu = memory_level == Data_Namespace::GPU_LEVEL;
+    add(is_gpu ? QueryCounter::GpuFetchBytes : QueryCounter::CpuFetchBytes, num_bytes);
+    if (!was_resident) {
+      add(is_gpu ? QueryCounter::GpuFetchBytesFromParent
+                 : QueryCounter::CpuFetchBytesFromParent,
+          num_bytes);
+    }
+  }
+
+  void setPeakMemoryBytes(const int64_t peak_memory_bytes) {
+    peak_memory_bytes_ = peak_memory_bytes;
+  }
+
+  QueryProfile get() const {
+    QueryProfile profile;
+    profile.compilation_us = get(QueryPhase::Compilation);
+    profile.fetch_us = get(QueryPhase::Fetch);
+    profile.kernel_us = get(QueryPhase::Kernel);
+    profile.reduction_us = get(QueryPhase::Reduction);
+    {
+      std::lock_guard<std::mutex> lock(kernel_times_mutex_);
+      profile.kernel_times_us = kernel_times_us_;
+    }
+    profile.code_cache_hits = get(QueryCounter::CodeCacheHits);
+    profile.code_cache_misses = get(QueryCounter::CodeCacheMisses);
+    profile.cpu_fetch_bytes = get(QueryCounter::CpuFetchBytes);
+    profile.cpu_fetch_bytes_from_parent = get(QueryCounter::CpuFetchBytesFromParent);
+    profile.gpu_fetch_bytes = get(QueryCounter::GpuFetchBytes);
+    profile.gpu_fetch_bytes_from_parent = get(QueryCounter::GpuFetchBytesFromParent);
+    profile.fragments_scanned = get(QueryCounter::FragmentsScanned);
+    profile.fragments_skipped = get(QueryCounter::FragmentsSkipped);
+    profile.rows_scanned = get(QueryCounter::RowsScanned);
+    profile.output_buffer_bytes = get(QueryCounter::OutputBufferBytes);
+    profile.peak_memory_bytes = peak_memory_bytes_.load();
+    return profile;
+  }
+
+ private:
+  int64_t get(const QueryPhase phase) const {
+    return phases_[static_cast<size_t>(phase)].load();
+  }
+
+  int64_t get(const QueryCounter counter) const {
+    return counters_[static_cast<size_t>(counter)].load();
+  }
+
+  std::array<std::atomic<int64_t>, static_cast<size_t>(QueryPhase::Count)> phases_;
+  std::array<std::atomic<int64_t>, static_cast<size_t>(QueryCounter::Count)> counters_;
+  std::atomic<int64_t> peak_memory_bytes_;
+  std::vector<int64_t> kernel_times_us_;
+  mutable std::mutex kernel_times_mutex_;
+};
+
+// Adds the lifetime of the object to the given phase of the profile.
+class QueryPhaseTimer {
+ public:
+  QueryPhaseTimer(QueryProfileCounters& counters, const QueryPhase phase)
+      : counters_(counters), phase_(phase), start_(std::chrono::steady_clock::now()) {}
+
+  ~QueryPhaseTimer() {
+    counters_.add(phase_,
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - start_)
+                      .count());
+  }
+
+ private:
+  QueryProfileCounters& counters_;
+  const QueryPhase phase_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+#endif  // QUERYENGINE_QUERYPROFILE_H
@@ -39,6 +39,8 @@
 #include <numeric>
 
 bool g_skip_intermediate_count{true};
+bool g_release_intermediate_results{false};
+bool g_enable_late_materialization{false};
 extern bool g_enable_bump_allocator;
 namespace {
 
@@ -48,6 +50,71 @@ bool node_is_aggregate(const RelAlgNode* ra) {
   return ((compound && compound->isAggregate()) || aggregate);
 }
 
+// Collects the nodes whose results are read while executing the given step. Joins
+// aren't execution steps, their inputs are read directly by the step which owns them.
+// A sort re-executes the work unit of its source, so it reads the source inputs too.
+void collect_step_inputs(const RelAlgNode* ra_node,
+                         std::unordered_set<const RelAlgNode*>& step_inputs) {
+  for (size_t i = 0; i < ra_node->inputCount(); ++i) {
+    const auto input = ra_node->getInput(i);
+    if (dynamic_cast<const RelJoin*>(input) ||
+        dynamic_cast<const RelLeftDeepInnerJoin*>(input)) {
+      collect_step_inputs(input, step_inputs);
+      continue;
+    }
+    step_inputs.insert(input);
+  }
+  if (dynamic_cast<const RelSort*>(ra_node)) {
+    CHECK_EQ(size_t(1), ra_node->inputCount());
+    collect_step_inputs(ra_node->getInput(0), step_inputs);
+  }
+}
+
+// Maps the index of a step to the indices of the steps it reads last, i.e. the steps
+// whose results can be released once it finishes. Nothing is released after the final
+// step since its result is returned to the caller.
+std::unordered_map<size_t, std::vector<size_t>> get_intermediate_result_release_schedule(
+    const std::vector<RaExecutionDesc>& exec_descs) {
+  std::unordered_map<const RelAlgNode*, size_t> step_idx_by_node;
+  for (size_t i = 0; i < exec_descs.size(); ++i) {
+    step_idx_by_node.emplace(exec_descs[i].getBody(), i);
+  }
+  std::vector<ssize_t> last_reader(exec_descs.size(), -1);
+  for (size_t i = 0; i < exec_descs.size(); ++i) {
+    std::unordered_set<const RelAlgNode*> step_inputs;
+    collect_step_inputs(exec_descs[i].getBody(), step_inputs);
+    for (const auto input : step_inputs) {
+      const auto it = step_idx_by_node.find(input);
+      if (it != step_idx_by_node.end()) {
+        last_reader[it->second] =
+            std::max(last_reader[it->second], static_cast<ssize_t>(i));
+      }
+    }
+  }
+  // A no-op step aliases the temporary table of its input, which therefore has to
+  // stay alive for as long as the no-op result is read. Walk backwards to handle
+  // chains of no-ops.
+  for (size_t i = exec_descs.size(); i > 0; --i) {
+    const auto body = exec_descs[i - 1].getBody();
+    if (!body->isNop()) {
+      continue;
+    }
+    CHECK_EQ(size_t(1), body->inputCount());
+    const auto it = step_idx_by_node.find(body->getInput(0));
+    CHECK(it != step_idx_by_node.end());
+    last_reader[it->second] = std::max(last_reader[it->second], last_reader[i - 1]);
+  }
+  std::unordered_map<size_t, std::vector<size_t>> release_schedule;
+  for (size_t i = 0; i < exec_descs.size(); ++i) {
+    if (last_reader[i] < 0 ||
+        static_cast<size_t>(last_reader[i]) + 1 == exec_descs.size()) {
+      continue;
+    }
+    release_schedule[last_reader[i]].push_back(i);
+  }
+  return release_schedule;
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeRelAlgQuery(const std::string& query_ra,
@@ -92,6 +159,15 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
   if (g_enable_dynamic_watchdog) {
     executor_->resetInterrupt();
   }
+  executor_->query_profile_.reset();
+  // without a budget to enforce, the query's memory is still accounted for its profile
+  const auto memory_budget = query_memory_budget_
+                                 ? query_memory_budget_
+                                 : std::make_shared<QueryMemoryBudget>(0);
+  ScopeGuard save_query_profile = [this, memory_budget] {
+    executor_->query_profile_.setPeakMemoryBytes(memory_budget->getPeakBytes());
+    query_profile_ = executor_->getQueryProfile();
+  };
   ScopeGuard row_set_holder = [this, &render_info] {
     if (render_info) {
       // need to hold onto the RowSetMemOwner for potential
@@ -100,7 +176,7 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
     }
     cleanupPostExecution();
   };
-  executor_->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>();
+  executor_->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>(memory_budget);
   executor_->catalog_ = &cat_;
   executor_->agg_col_range_cache_ = computeColRangesCache(ra.get());
   executor_->string_dictionary_generations_ =
@@ -279,7 +355,8 @@ void RelAlgExecutor::prepareLeafExecution(
     executor_->resetInterrupt();
   }
   queue_time_ms_ = timer_stop(clock_begin);
-  executor_->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>();
+  executor_->row_set_mem_owner_ =
+      std::make_shared<RowSetMemoryOwner>(query_memory_budget_);
   executor_->table_generations_ = table_generations;
   executor_->agg_col_range_cache_ = agg_col_range;
   executor_->string_dictionary_generations_ = string_dictionary_generations;
@@ -311,6 +388,17 @@ ExecutionResult RelAlgExecutor::executeRelAlgSeq(std::vector<RaExecutionDesc>& e
   CHECK(!exec_descs.empty());
   const auto exec_desc_count = eo.just_explain ? size_t(1) : exec_descs.size();
 
+  // Intermediate results are only kept around until their last reader has run. The
+  // distributed and filter push-down paths re-enter the sequence with the temporary
+  // tables of previous runs, so they have to keep everything.
+  const bool release_intermediate_results =
+      g_release_intermediate_results && !with_existing_temp_tables && !g_cluster &&
+      !eo.just_explain && !eo.find_push_down_candidates;
+  const auto release_schedule =
+      release_intermediate_results
+          ? get_intermediate_result_release_schedule(exec_descs)
+          : std::unordered_map<size_t, std::vector<size_t>>{};
+
   size_t i = 0;
   for (auto it = exec_descs.begin(); it != exec_descs.end(); ++it, i++) {
     // only render on the last step
@@ -320,6 +408,13 @@ ExecutionResult RelAlgExecutor::executeRelAlgSeq(std::vector<RaExecutionDesc>& e
                       eo,
                       (it == std::prev(exec_descs.end()) ? render_info : nullptr),
                       queue_time_ms);
+    const auto release_it = release_schedule.find(i);
+    if (release_it != release_schedule.end()) {
+      for (const auto released_step_idx : release_it->second) {
+        CHECK_LT(released_step_idx, i);
+        releaseIntermediateResult(exec_descs[released_step_idx]);
+      }
+    }
   }
 
   return exec_descs[exec_desc_count - 1].getResult();
@@ -465,6 +560,25 @@ void RelAlgExecutor::executeRelAlgStep(
   CHECK(false);
 }
 
+void RelAlgExecutor::releaseIntermediateResult(RaExecutionDesc& exec_desc) {
+  const auto body = exec_desc.getBody();
+  eraseFromTemporaryTables(-body->getId());
+  if (exec_desc.getResult().isFilterPushDownEnabled()) {
+    return;
+  }
+  auto rows = exec_desc.getResult().getRows();
+  exec_desc.setResult({ResultSetPtr(), body->getOutputMetainfo()});
+  // Other steps (no-ops) can share the same result set, only free the buffers once the
+  // last reference is gone.
+  if (!rows || rows.use_count() > 1) {
+    return;
+  }
+  const auto buffers = rows->getProvidedStorageBuffers();
+  rows.reset();
+  CHECK(executor_->row_set_mem_owner_);
+  executor_->row_set_mem_owner_->releaseGroupByBuffers(buffers);
+}
+
 void RelAlgExecutor::handleNop(RaExecutionDesc& ed) {
   // just set the result of the previous node as the result of no op
   auto body = ed.getBody();
@@ -1135,7 +1249,7 @@ void RelAlgExecutor::executeUpdateViaCompound(const RelCompound* compound,
   co_project.device_type_ = ExecutorDeviceType::CPU;
 
   try {
-    UpdateTriggeredCacheInvalidator::invalidateCaches();
+    cat_.invalidateCachesForTable(compound->getModifiedTableDescriptor()->tableId);
 
     UpdateTransactionParameters update_params(compound->getModifiedTableDescriptor(),
                                               compound->getTargetColumns(),
@@ -1186,7 +1300,7 @@ void RelAlgExecutor::executeUpdateViaProject(const RelProject* project,
   }
 
   try {
-    UpdateTriggeredCacheInvalidator::invalidateCaches();
+    cat_.invalidateCachesForTable(project->getModifiedTableDescriptor()->tableId);
 
     UpdateTransactionParameters update_params(project->getModifiedTableDescriptor(),
                                               project->getTargetColumns(),
@@ -1225,7 +1339,7 @@ void RelAlgExecutor::executeDeleteViaCompound(const RelCompound* compound,
   co_project.device_type_ = ExecutorDeviceType::CPU;
 
   try {
-    DeleteTriggeredCacheInvalidator::invalidateCaches();
+    cat_.invalidateCachesForTable(table_descriptor->tableId);
 
     DeleteTransactionParameters delete_params;
     auto delete_callback = yieldDeleteCallback(delete_params);
@@ -1273,7 +1387,7 @@ void RelAlgExecutor::executeDeleteViaProject(const RelProject* project,
   }
 
   try {
-    DeleteTriggeredCacheInvalidator::invalidateCaches();
+    cat_.invalidateCachesForTable(table_descriptor->tableId);
 
     DeleteTransactionParameters delete_params;
     auto delete_callback = yieldDeleteCallback(delete_params);
@@ -1487,6 +1601,27 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
     CHECK_EQ(join_col_elem_count, elem_count);
     context->addOrderColumn(column, order_col.get(), chunks_owner);
   }
+  const auto& args = window_func->getArgs();
+  if (window_func->getFrame() && !args.empty()) {
+    // Aggregates with an explicit frame are computed ahead of the projection, which
+    // requires the argument column as well.
+    const auto arg_col =
+        std::dynamic_pointer_cast<const Analyzer::ColumnVar>(args.front());
+    CHECK(arg_col);
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> arg_chunks_owner;
+    const int8_t* column;
+    size_t arg_col_elem_count;
+    std::tie(column, arg_col_elem_count) =
+        ColumnFetcher::getOneColumnFragment(executor_,
+                                            *arg_col,
+                                            query_infos.front().info.fragments.front(),
+                                            memory_level,
+                                            0,
+                                            arg_chunks_owner,
+                                            column_cache_map);
+    CHECK_EQ(arg_col_elem_count, elem_count);
+    context->addFrameArgColumn(column, arg_col.get(), arg_chunks_owner);
+  }
   return context;
 }
 
@@ -1584,6 +1719,101 @@ bool first_oe_is_desc(const std::list<Analyzer::OrderEntry>& order_entries) {
   return !order_entries.empty() && order_entries.front().is_desc;
 }
 
+// Largest LIMIT + OFFSET of a sorted projection for which the projected columns are
+// materialized late, the row ids of the result are passed to the second pass as a set.
+constexpr size_t late_materialization_max_rows{10000};
+
+std::set<int> get_used_column_ids(const std::vector<const Analyzer::Expr*>& exprs) {
+  std::set<const Analyzer::ColumnVar*,
+           bool (*)(const Analyzer::ColumnVar*, const Analyzer::ColumnVar*)>
+      colvar_set(Analyzer::ColumnVar::colvar_comp);
+  for (const auto expr : exprs) {
+    expr->collect_column_var(colvar_set, true);
+  }
+  std::set<int> col_ids;
+  for (const auto col_var : colvar_set) {
+    col_ids.insert(col_var->get_column_id());
+  }
+  return col_ids;
+}
+
+std::vector<const Analyzer::Expr*> get_late_materialization_key_exprs(
+    const RelAlgExecutionUnit& ra_exe_unit) {
+  std::vector<const Analyzer::Expr*> key_exprs;
+  for (const auto& qual : ra_exe_unit.simple_quals) {
+    key_exprs.push_back(qual.get());
+  }
+  for (const auto& qual : ra_exe_unit.quals) {
+    key_exprs.push_back(qual.get());
+  }
+  for (const auto& order_entry : ra_exe_unit.sort_info.order_entries) {
+    CHECK_GT(order_entry.tle_no, 0);
+    CHECK_LE(static_cast<size_t>(order_entry.tle_no), ra_exe_unit.target_exprs.size());
+    key_exprs.push_back(ra_exe_unit.target_exprs[order_entry.tle_no - 1]);
+  }
+  return key_exprs;
+}
+
+/**
+ * Determines whether a sorted projection with a LIMIT over a single physical table can
+ * be executed with late materialization: first the filters and the sort keys, then the
+ * other projected columns for the rows which made it into the result. Requires at least
+ * one projected column which isn't needed by the filters and the sort keys.
+ */
+bool can_use_late_materialization(const RelAlgExecutionUnit& ra_exe_unit,
+                                  const CompilationOptions& co) {
+  const auto& sort_info = ra_exe_unit.sort_info;
+  if (g_cluster || !co.hoist_literals_ || sort_info.order_entries.empty() ||
+      !sort_info.limit ||
+      sort_info.limit + sort_info.offset > late_materialization_max_rows) {
+    return false;
+  }
+  if (ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty()) {
+    return false;
+  }
+  const auto& table_desc = ra_exe_unit.input_descs.front();
+  if (table_desc.getSourceType() != InputSourceType::TABLE ||
+      table_desc.getTableId() <= 0) {
+    return false;
+  }
+  if (ra_exe_unit.groupby_exprs.size() != 1 || ra_exe_unit.groupby_exprs.front() ||
+      is_window_execution_unit(ra_exe_unit)) {
+    return false;
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    if (dynamic_cast<const Analyzer::AggExpr*>(target_expr)) {
+      return false;
+    }
+  }
+  const auto key_col_ids =
+      get_used_column_ids(get_late_materialization_key_exprs(ra_exe_unit));
+  const auto target_col_ids = get_used_column_ids(std::vector<const Analyzer::Expr*>(
+      ra_exe_unit.target_exprs.begin(), ra_exe_unit.target_exprs.end()));
+  return std::any_of(
+      target_col_ids.begin(), target_col_ids.end(), [&key_col_ids](const int col_id) {
+        return !key_col_ids.count(col_id);
+      });
+}
+
+// Keeps the input columns used by the given expressions and adds the row id column.
+std::list<std::shared_ptr<const InputColDescriptor>> get_late_materialization_input_cols(
+    const std::list<std::shared_ptr<const InputColDescriptor>>& input_col_descs,
+    const std::vector<const Analyzer::Expr*>& exprs,
+    const std::shared_ptr<const InputColDescriptor>& rowid_col_desc) {
+  const auto used_col_ids = get_used_column_ids(exprs);
+  std::list<std::shared_ptr<const InputColDescriptor>> used_input_col_descs;
+  for (const auto& input_col_desc : input_col_descs) {
+    if (*input_col_desc == *rowid_col_desc) {
+      continue;
+    }
+    if (used_col_ids.count(input_col_desc->getColId())) {
+      used_input_col_descs.push_back(input_col_desc);
+    }
+  }
+  used_input_col_descs.push_back(rowid_col_desc);
+  return used_input_col_descs;
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeSort(const RelSort* sort,
@@ -1631,6 +1861,12 @@ ExecutionResult RelAlgExecutor::executeSort(const RelSort* sort,
       const auto source_work_unit = createSortInputWorkUnit(sort, eo.just_explain);
       is_desc = first_oe_is_desc(source_work_unit.exe_unit.sort_info.order_entries);
       groupby_exprs = source_work_unit.exe_unit.groupby_exprs;
+      if (g_enable_late_materialization && !render_info && !eo.just_explain &&
+          !eo.find_push_down_candidates && !is_aggregate &&
+          can_use_late_materialization(source_work_unit.exe_unit, co)) {
+        return executeLateMaterializedSort(
+            source_work_unit, source->getOutputMetainfo(), co, eo, queue_time_ms);
+      }
       auto source_result = executeWorkUnit(source_work_unit,
                                            source->getOutputMetainfo(),
                                            is_aggregate,
@@ -1685,6 +1921,108 @@ ExecutionResult RelAlgExecutor::executeSort(const RelSort* sort,
           {}};
 }
 
+ExecutionResult RelAlgExecutor::executeLateMaterializedSort(
+    const WorkUnit& source_work_unit,
+    const std::vector<TargetMetaInfo>& targets_meta,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    const int64_t queue_time_ms) {
+  const auto& exe_unit = source_work_unit.exe_unit;
+  const auto& sort_info = exe_unit.sort_info;
+  CHECK_EQ(targets_meta.size(), exe_unit.target_exprs.size());
+  const int table_id = exe_unit.input_descs.front().getTableId();
+  const auto rowid_cd = cat_.getMetadataForColumn(table_id, "rowid");
+  CHECK(rowid_cd);
+  CHECK(rowid_cd->isVirtualCol);
+  const auto rowid = makeExpr<Analyzer::ColumnVar>(
+      rowid_cd->columnType, table_id, rowid_cd->columnId, 0);
+  target_exprs_owned_.push_back(rowid);
+  const auto rowid_col_desc =
+      std::make_shared<const InputColDescriptor>(rowid_cd->columnId, table_id, 0);
+
+  // The first pass only fetches the columns needed by the filters and the sort keys and
+  // projects the sort keys and the row id.
+  std::vector<Analyzer::Expr*> key_target_exprs;
+  std::vector<TargetMetaInfo> key_targets_meta;
+  std::list<Analyzer::OrderEntry> key_order_entries;
+  for (const auto& order_entry : sort_info.order_entries) {
+    key_target_exprs.push_back(exe_unit.target_exprs[order_entry.tle_no - 1]);
+    key_targets_meta.push_back(targets_meta[order_entry.tle_no - 1]);
+    key_order_entries.emplace_back(static_cast<int>(key_target_exprs.size()),
+                                   order_entry.is_desc,
+                                   order_entry.nulls_first);
+  }
+  key_target_exprs.push_back(rowid.get());
+  key_targets_meta.emplace_back("rowid", rowid_cd->columnType);
+  const WorkUnit keys_work_unit{
+      {exe_unit.input_descs,
+       get_late_materialization_input_cols(exe_unit.input_col_descs,
+                                           get_late_materialization_key_exprs(exe_unit),
+                                           rowid_col_desc),
+       exe_unit.simple_quals,
+       exe_unit.quals,
+       exe_unit.join_quals,
+       exe_unit.groupby_exprs,
+       key_target_exprs,
+       nullptr,
+       {key_order_entries, sort_info.algorithm, sort_info.limit, sort_info.offset},
+       exe_unit.scan_limit,
+       exe_unit.query_features},
+      source_work_unit.body,
+      source_work_unit.max_groups_buffer_entry_guess,
+      nullptr};
+  auto keys_result = executeWorkUnit(
+      keys_work_unit, key_targets_meta, false, co, eo, nullptr, queue_time_ms);
+  auto key_rows = keys_result.getRows();
+  if (!key_rows->definitelyHasNoRows()) {
+    key_rows->sort(key_order_entries, sort_info.limit + sort_info.offset);
+  }
+  key_rows->dropFirstN(sort_info.offset);
+  key_rows->keepFirstN(sort_info.limit);
+  std::vector<int64_t> rowids;
+  while (true) {
+    const auto row = key_rows->getNextRow(false, false);
+    if (row.empty()) {
+      break;
+    }
+    const auto rowid_tv = boost::get<ScalarTargetValue>(&row.back());
+    CHECK(rowid_tv);
+    const auto rowid_ptr = boost::get<int64_t>(rowid_tv);
+    CHECK(rowid_ptr);
+    rowids.push_back(*rowid_ptr);
+  }
+
+  // The second pass computes all the targets for the selected rows only. Fragments
+  // without any of them are skipped, see Executor::skipFragmentByRowidSet, and the
+  // filters don't have to be evaluated again.
+  const WorkUnit project_work_unit{
+      {exe_unit.input_descs,
+       get_late_materialization_input_cols(
+           exe_unit.input_col_descs,
+           std::vector<const Analyzer::Expr*>(exe_unit.target_exprs.begin(),
+                                              exe_unit.target_exprs.end()),
+           rowid_col_desc),
+       {makeExpr<Analyzer::InIntegerSet>(rowid, rowids, true)},
+       {},
+       {},
+       exe_unit.groupby_exprs,
+       exe_unit.target_exprs,
+       nullptr,
+       {sort_info.order_entries, sort_info.algorithm, sort_info.limit, 0},
+       exe_unit.scan_limit,
+       exe_unit.query_features},
+      source_work_unit.body,
+      source_work_unit.max_groups_buffer_entry_guess,
+      nullptr};
+  auto project_result = executeWorkUnit(
+      project_work_unit, targets_meta, false, co, eo, nullptr, queue_time_ms);
+  auto rows = project_result.getRows();
+  if (!rows->definitelyHasNoRows()) {
+    rows->sort(sort_info.order_entries, sort_info.limit);
+  }
+  return {rows, project_result.getTargetsMeta()};
+}
+
 RelAlgExecutor::WorkUnit RelAlgExecutor::createSortInputWorkUnit(
     const RelSort* sort,
     const bool just_explain) {
@@ -1753,6 +2091,32 @@ size_t groups_approx_upper_bound(const std::vector<InputTableInfo>& table_infos)
   return std::max(max_num_groups, size_t(1));
 }
 
+/**
+ * Upper bound for the number of groups from the distinct counts collected by ANALYZE
+ * TABLE for the group by columns. Returns 0 if some group by expression isn't a column
+ * of a physical table with statistics.
+ */
+size_t groups_upper_bound_from_statistics(const RelAlgExecutionUnit& ra_exe_unit,
+                                          const Catalog_Namespace::Catalog& cat) {
+  double num_groups{1};
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(groupby_expr.get());
+    if (!col_var || col_var->get_table_id() < 0) {
+      return 0;
+    }
+    const auto stats =
+        cat.getColumnStatistics(col_var->get_table_id(), col_var->get_column_id());
+    if (!stats) {
+      return 0;
+    }
+    num_groups *= stats->getNdv() + (stats->num_nulls ? 1 : 0);
+    if (num_groups > std::numeric_limits<int64_t>::max()) {
+      return 0;
+    }
+  }
+  return std::max(static_cast<size_t>(num_groups), size_t(1));
+}
+
 /**
  * Determines whether a query needs to compute the size of its output buffer. Returns true
  * for projection queries with no LIMIT or a LIMIT that exceeds the high scan limit
@@ -1881,8 +2245,11 @@ void build_render_targets(
 inline bool can_use_bump_allocator(const RelAlgExecutionUnit& ra_exe_unit,
                                    const CompilationOptions& co,
                                    const ExecutionOptions& eo) {
-  return g_enable_bump_allocator && (co.device_type_ == ExecutorDeviceType::GPU) &&
-         !eo.output_columnar_hint && ra_exe_unit.sort_info.order_entries.empty();
+  const bool enabled_for_device = co.device_type_ == ExecutorDeviceType::GPU
+                                      ? g_enable_bump_allocator
+                                      : g_enable_cpu_bump_allocator;
+  return enabled_for_device && !eo.output_columnar_hint &&
+         ra_exe_unit.sort_info.order_entries.empty();
 }
 
 }  // namespace
@@ -2010,9 +2377,13 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
         max_groups_buffer_entry_guess,
         groups_approx_upper_bound(table_infos) <= g_big_group_threshold);
   } catch (const CardinalityEstimationRequired&) {
+    // Use the column statistics, if available, to avoid running the estimator query.
+    auto ndv_estimation = groups_upper_bound_from_statistics(ra_exe_unit, cat_);
+    if (!ndv_estimation) {
+      ndv_estimation = getNDVEstimation(work_unit, is_agg, co, eo);
+    }
     const auto estimated_groups_buffer_entry_guess =
-        2 * std::min(groups_approx_upper_bound(table_infos),
-                     getNDVEstimation(work_unit, is_agg, co, eo));
+        2 * std::min(groups_approx_upper_bound(table_infos), ndv_estimation);
     CHECK_GT(estimated_groups_buffer_entry_guess, size_t(0));
     result = execute_and_handle_errors(estimated_groups_buffer_entry_guess, true);
   }
@@ -2289,6 +2660,8 @@ std::string RelAlgExecutor::getErrorMessageFromCode(const int32_t error_code) {
       return "Not enough OpenGL memory to render the query results";
     case Executor::ERR_STREAMING_TOP_N_NOT_SUPPORTED_IN_RENDER_QUERY:
       return "Streaming-Top-N not supported in Render Query";
+    case Executor::ERR_OUT_OF_QUERY_MEMORY_BUDGET:
+      return "Query exceeded its memory budget";
   }
   return "Other error: code " + std::to_string(error_code);
 }
@@ -33,6 +33,8 @@
 #include "StorageIOFacility.h"
 
 extern bool g_skip_intermediate_count;
+extern bool g_release_intermediate_results;
+extern bool g_enable_late_materialization;
 
 enum class MergeType { Union, Reduce };
 
@@ -121,6 +123,15 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   Executor* getExecutor() const;
 
+  // Execution profile of the last query run by this object, captured before the
+  // executor is released to other queries.
+  const QueryProfile& getQueryProfile() const { return query_profile_; }
+
+  // Memory budget charged by the queries run by this object, none by default.
+  void setQueryMemoryBudget(std::shared_ptr<QueryMemoryBudget> query_memory_budget) {
+    query_memory_budget_ = std::move(query_memory_budget);
+  }
+
   void cleanupPostExecution();
 
   static std::string getErrorMessageFromCode(const int32_t error_code);
@@ -223,6 +234,16 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   WorkUnit createSortInputWorkUnit(const RelSort*, const bool just_explain);
 
+  // Runs a sorted projection with a LIMIT in two passes: the filters and the sort keys
+  // first, to find the row ids of the result, then the other projected columns for
+  // those rows only.
+  ExecutionResult executeLateMaterializedSort(
+      const WorkUnit& source_work_unit,
+      const std::vector<TargetMetaInfo>& targets_meta,
+      const CompilationOptions& co,
+      const ExecutionOptions& eo,
+      const int64_t queue_time_ms);
+
   ExecutionResult executeWorkUnit(const WorkUnit& work_unit,
                                   const std::vector<TargetMetaInfo>& targets_meta,
                                   const bool is_agg,
@@ -305,6 +326,10 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   void handleNop(RaExecutionDesc& ed);
 
+  // Drops the temporary table of a step whose readers have all run and frees the memory
+  // backing its result, unless the result is still shared with another step.
+  void releaseIntermediateResult(RaExecutionDesc& exec_desc);
+
   JoinQualsPerNestingLevel translateLeftDeepJoinFilter(
       const RelLeftDeepInnerJoin* join,
       const std::vector<InputDescriptor>& input_descs,
@@ -327,6 +352,8 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
   std::vector<std::shared_ptr<RexSubQuery>> subqueries_;
   std::unordered_map<unsigned, AggregatedResult> leaf_results_;
   int64_t queue_time_ms_;
+  QueryProfile query_profile_;
+  std::shared_ptr<QueryMemoryBudget> query_memory_budget_;
   static SpeculativeTopNBlacklist speculative_topn_blacklist_;
   static const size_t max_groups_buffer_entry_default_guess{16384};
 
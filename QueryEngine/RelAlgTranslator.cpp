@@ -1564,16 +1564,107 @@ bool supported_upper_bound(const RexWindowFunctionOperator* rex_window_function)
   }
 }
 
+bool is_frame_offset_bound(const Analyzer::WindowFrameBound& frame_bound) {
+  return frame_bound.bound_type == SqlWindowFrameBoundType::EXPR_PRECEDING ||
+         frame_bound.bound_type == SqlWindowFrameBoundType::EXPR_FOLLOWING;
+}
+
+int64_t get_frame_offset_value(const Analyzer::Constant& offset_constant) {
+  const auto& offset_datum = offset_constant.get_constval();
+  switch (offset_constant.get_type_info().get_type()) {
+    case kTINYINT: {
+      return offset_datum.tinyintval;
+    }
+    case kSMALLINT: {
+      return offset_datum.smallintval;
+    }
+    case kINT: {
+      return offset_datum.intval;
+    }
+    case kBIGINT: {
+      return offset_datum.bigintval;
+    }
+    default: {
+      LOG(FATAL) << "Invalid type for the window frame offset";
+    }
+  }
+  return 0;
+}
+
+// Checks that an explicit frame can be computed: only for aggregates over a column or
+// COUNT(*), and offsets in RANGE frames need a single numeric order key.
+void check_window_frame_supported(
+    const RexWindowFunctionOperator* rex_window_function,
+    const Analyzer::WindowFrame& frame,
+    const std::vector<std::shared_ptr<Analyzer::Expr>>& args,
+    const std::vector<std::shared_ptr<Analyzer::Expr>>& order_keys) {
+  if (!window_function_is_aggregate(rex_window_function->getKind())) {
+    throw std::runtime_error("Frame specification not supported");
+  }
+  if (frame.lower_bound.bound_type == SqlWindowFrameBoundType::UNBOUNDED_FOLLOWING ||
+      frame.upper_bound.bound_type == SqlWindowFrameBoundType::UNBOUNDED_PRECEDING) {
+    throw std::runtime_error("Invalid window frame bounds");
+  }
+  if (args.size() > 1) {
+    throw std::runtime_error("Window frames not supported for this function");
+  }
+  if (!args.empty()) {
+    const auto arg_col = dynamic_cast<const Analyzer::ColumnVar*>(args.front().get());
+    const auto& arg_ti = args.front()->get_type_info();
+    if (!arg_col ||
+        !(arg_ti.is_integer() || arg_ti.is_decimal() || arg_ti.is_fp())) {
+      throw std::runtime_error(
+          "Only numeric columns supported as arguments of window functions with an "
+          "explicit frame");
+    }
+  }
+  if (!frame.is_rows && (is_frame_offset_bound(frame.lower_bound) ||
+                         is_frame_offset_bound(frame.upper_bound))) {
+    if (order_keys.size() != 1) {
+      throw std::runtime_error("RANGE frame offsets require exactly one order key");
+    }
+    const auto& order_key_ti = order_keys.front()->get_type_info();
+    if (!order_key_ti.is_integer() && !order_key_ti.is_fp()) {
+      throw std::runtime_error("RANGE frame offsets require a numeric order key");
+    }
+  }
+}
+
 }  // namespace
 
+Analyzer::WindowFrameBound RelAlgTranslator::translateWindowFrameBound(
+    const RexWindowFunctionOperator::RexWindowBound& window_bound) const {
+  if (window_bound.unbounded) {
+    return {window_bound.preceding ? SqlWindowFrameBoundType::UNBOUNDED_PRECEDING
+                                   : SqlWindowFrameBoundType::UNBOUNDED_FOLLOWING,
+            0};
+  }
+  if (window_bound.is_current_row) {
+    return {SqlWindowFrameBoundType::CURRENT_ROW, 0};
+  }
+  CHECK(window_bound.offset);
+  const auto offset = translateScalarRex(window_bound.offset.get());
+  const auto offset_constant = std::dynamic_pointer_cast<Analyzer::Constant>(offset);
+  if (!offset_constant || !offset_constant->get_type_info().is_integer() ||
+      offset_constant->get_is_null()) {
+    throw std::runtime_error("Only integer constants supported as window frame offsets");
+  }
+  const auto offset_val = get_frame_offset_value(*offset_constant);
+  if (offset_val < 0) {
+    throw std::runtime_error("Window frame offsets cannot be negative");
+  }
+  return {window_bound.preceding ? SqlWindowFrameBoundType::EXPR_PRECEDING
+                                 : SqlWindowFrameBoundType::EXPR_FOLLOWING,
+          offset_val};
+}
+
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
     const RexWindowFunctionOperator* rex_window_function) const {
-  if (!supported_lower_bound(rex_window_function->getLowerBound()) ||
-      !supported_upper_bound(rex_window_function) ||
-      ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
-       rex_window_function->isRows())) {
-    throw std::runtime_error("Frame specification not supported");
-  }
+  const bool has_default_frame =
+      supported_lower_bound(rex_window_function->getLowerBound()) &&
+      supported_upper_bound(rex_window_function) &&
+      ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) ==
+       rex_window_function->isRows());
   std::vector<std::shared_ptr<Analyzer::Expr>> args;
   for (size_t i = 0; i < rex_window_function->size(); ++i) {
     args.push_back(translateScalarRex(rex_window_function->getOperand(i)));
@@ -1586,6 +1677,14 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
   for (const auto& order_key : rex_window_function->getOrderKeys()) {
     order_keys.push_back(translateScalarRex(order_key.get()));
   }
+  std::shared_ptr<Analyzer::WindowFrame> frame;
+  if (!has_default_frame) {
+    frame = std::make_shared<Analyzer::WindowFrame>(Analyzer::WindowFrame{
+        rex_window_function->isRows(),
+        translateWindowFrameBound(rex_window_function->getLowerBound()),
+        translateWindowFrameBound(rex_window_function->getUpperBound())});
+    check_window_frame_supported(rex_window_function, *frame, args, order_keys);
+  }
   auto ti = rex_window_function->getType();
   if (window_function_is_value(rex_window_function->getKind())) {
     CHECK_GE(args.size(), 1u);
@@ -1597,7 +1696,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
       args,
       partition_keys,
       order_keys,
-      translate_collation(rex_window_function->getCollation()));
+      translate_collation(rex_window_function->getCollation()),
+      frame);
 }
 
 Analyzer::ExpressionPtrVector RelAlgTranslator::translateFunctionArgs(
@@ -127,6 +127,9 @@ class RelAlgTranslator {
   std::shared_ptr<Analyzer::Expr> translateWindowFunction(
       const RexWindowFunctionOperator*) const;
 
+  Analyzer::WindowFrameBound translateWindowFrameBound(
+      const RexWindowFunctionOperator::RexWindowBound&) const;
+
   Analyzer::ExpressionPtrVector translateFunctionArgs(const RexFunctionOperator*) const;
 
   std::shared_ptr<Analyzer::Expr> translateUnaryGeoFunction(
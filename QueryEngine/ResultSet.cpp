@@ -294,6 +294,19 @@ const ResultSetStorage* ResultSet::getStorage() const {
   return storage_.get();
 }
 
+std::vector<int8_t*> ResultSet::getProvidedStorageBuffers() const {
+  std::vector<int8_t*> buffers;
+  if (storage_ && storage_->buff_is_provided_) {
+    buffers.push_back(storage_->getUnderlyingBuffer());
+  }
+  for (const auto& storage : appended_storage_) {
+    if (storage && storage->buff_is_provided_) {
+      buffers.push_back(storage->getUnderlyingBuffer());
+    }
+  }
+  return buffers;
+}
+
 size_t ResultSet::colCount() const {
   return just_explain_ ? 1 : targets_.size();
 }
@@ -362,6 +362,13 @@ class ResultSet {
     storage_->updateEntryCount(new_entry_count);
   }
 
+  void updateStorageBuffer(int8_t* new_buff) {
+    CHECK(query_mem_desc_.getQueryDescriptionType() == QueryDescriptionType::Projection);
+    CHECK(storage_);
+    CHECK(storage_->buff_is_provided_);
+    storage_->buff_ = new_buff;
+  }
+
   std::vector<TargetValue> getNextRow(const bool translate_strings,
                                       const bool decimal_to_double) const;
 
@@ -395,6 +402,10 @@ class ResultSet {
 
   const ResultSetStorage* getStorage() const;
 
+  // Buffers backing the storage of this result set which have been provided by the
+  // caller (usually owned by the row set memory owner) rather than allocated by us.
+  std::vector<int8_t*> getProvidedStorageBuffers() const;
+
   size_t colCount() const;
 
   SQLTypeInfo getColType(const size_t col_idx) const;
@@ -497,6 +508,12 @@ class ResultSet {
                             int8_t* output_buffer,
                             const size_t output_buffer_size) const;
 
+  /*
+   * Returns the buffer holding all the entries of the given column in place, or nullptr
+   * if they are spread across several storages. Only for columnar projections.
+   */
+  const int8_t* getColumnarBuffer(const size_t column_idx) const;
+
   /*
    * Determines if it is possible to directly form a ColumnarResults class from this
    * result set, bypassing the default row-wise columnarization.
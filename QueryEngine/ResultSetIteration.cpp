@@ -1139,6 +1139,18 @@ void ResultSet::copyColumnIntoBuffer(const size_t column_idx,
   }
 }
 
+const int8_t* ResultSet::getColumnarBuffer(const size_t column_idx) const {
+  CHECK(isDirectColumnarConversionPossible());
+  CHECK_EQ(query_mem_desc_.getQueryDescriptionType(), QueryDescriptionType::Projection);
+  CHECK_LT(column_idx, query_mem_desc_.getSlotCount());
+  if (!storage_ || !appended_storage_.empty()) {
+    return nullptr;
+  }
+  CHECK_EQ(storage_->query_mem_desc_.getEntryCount(), entryCount());
+  return storage_->getUnderlyingBuffer() +
+         storage_->query_mem_desc_.getColOffInBytes(column_idx);
+}
+
 /**
  * For direct columnar conversion only
  */
@@ -1810,10 +1822,7 @@ TargetValue ResultSet::getTargetValueFromBufferRowwise(
                                           ? count_distinct_desc.bitmapSizeBytes()
                                           : count_distinct_desc.bitmapPaddedSizeBytes();
           auto count_distinct_buffer =
-              static_cast<int8_t*>(checked_malloc(bitmap_byte_sz));
-          memset(count_distinct_buffer, 0, bitmap_byte_sz);
-          row_set_mem_owner_->addCountDistinctBuffer(
-              count_distinct_buffer, bitmap_byte_sz, true);
+              row_set_mem_owner_->allocateCountDistinctBuffer(bitmap_byte_sz);
           *count_distinct_ptr_ptr = reinterpret_cast<int64_t>(count_distinct_buffer);
         }
       }
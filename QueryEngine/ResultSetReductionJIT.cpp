@@ -50,11 +50,13 @@ const size_t INTERP_THRESHOLD{0};
 // Make a shallow copy (just declarations) of the runtime module. Function definitions are
 // cloned only if they're used from the generated code.
 std::unique_ptr<llvm::Module> runtime_module_shallow_copy(CgenState* cgen_state) {
+  const auto rt_module =
+      cgen_state->rt_module_ ? cgen_state->rt_module_ : g_rt_module.get();
   return llvm::CloneModule(
 #if LLVM_VERSION_MAJOR >= 7
-      *g_rt_module.get(),
+      *rt_module,
 #else
-      g_rt_module.get(),
+      rt_module,
 #endif
       cgen_state->vmap_,
       [](const llvm::GlobalValue* gv) {
@@ -378,10 +380,14 @@ llvm::Function* setup_reduce_loop(const CgenState* cgen_state) {
 }
 
 // Setup the reduction function and helpers declarations, create a module and a code
-// generation state object.
-ReductionCode setup_functions_ir(const QueryDescriptionType hash_type) {
+// generation state object. Uses the global context unless another one is given, along
+// with the runtime module loaded in it.
+ReductionCode setup_functions_ir(const QueryDescriptionType hash_type,
+                                 llvm::LLVMContext* context,
+                                 llvm::Module* rt_module) {
   ReductionCode reduction_code{};
-  reduction_code.cgen_state.reset(new CgenState({}, false));
+  reduction_code.cgen_state.reset(context ? new CgenState({}, false, *context, rt_module)
+                                          : new CgenState({}, false));
   auto cgen_state = reduction_code.cgen_state.get();
   std::unique_ptr<llvm::Module> module(runtime_module_shallow_copy(cgen_state));
   cgen_state->module_ = module.get();
@@ -574,11 +580,42 @@ ResultSetReductionJIT::ResultSetReductionJIT(const QueryMemoryDescriptor& query_
 
 ReductionCode ResultSetReductionJIT::codegen() const {
   std::lock_guard<std::mutex> reduction_guard(ReductionCode::s_reduction_mutex);
+  return codegenImpl(nullptr, nullptr);
+}
+
+namespace {
+
+// Context used to compile the reduction code while the query code is generated in the
+// global context. Protected by the reduction mutex. It's never destroyed since the code
+// cache owns modules from it until the very end.
+struct ReductionWorkerContext {
+  llvm::LLVMContext context;
+  std::unique_ptr<llvm::Module> rt_module;
+};
+
+ReductionWorkerContext& get_reduction_worker_context() {
+  static auto worker_context = new ReductionWorkerContext();
+  if (!worker_context->rt_module) {
+    worker_context->rt_module.reset(read_template_module(worker_context->context));
+  }
+  return *worker_context;
+}
+
+}  // namespace
+
+void ResultSetReductionJIT::precompile() const {
+  std::lock_guard<std::mutex> reduction_guard(ReductionCode::s_reduction_mutex);
+  auto& worker_context = get_reduction_worker_context();
+  codegenImpl(&worker_context.context, worker_context.rt_module.get());
+}
+
+ReductionCode ResultSetReductionJIT::codegenImpl(llvm::LLVMContext* context,
+                                                 llvm::Module* rt_module) const {
   const auto hash_type = query_mem_desc_.getQueryDescriptionType();
   if (query_mem_desc_.didOutputColumnar() || !is_group_query(hash_type)) {
     return {};
   }
-  auto reduction_code = setup_functions_ir(hash_type);
+  auto reduction_code = setup_functions_ir(hash_type, context, rt_module);
   isEmpty(reduction_code);
   switch (query_mem_desc_.getQueryDescriptionType()) {
     case QueryDescriptionType::GroupByPerfectHash: {
@@ -73,6 +73,12 @@ class ResultSetReductionJIT {
   // Generate the code for the result set reduction loop.
   ReductionCode codegen() const;
 
+  // Generate and compile the code for the result set reduction loop in a private LLVM
+  // context, on the calling thread, so that a subsequent codegen() call with the same
+  // layout finds the native code in the cache. Safe to call while a query is generating
+  // code in the global context.
+  void precompile() const;
+
   static void clearCache();
 
  private:
@@ -131,6 +137,9 @@ class ResultSetReductionJIT {
                                   const size_t target_logical_idx,
                                   const ReductionCode& reduction_code) const;
 
+  // Implements codegen() and precompile(), in the global context if none is given.
+  ReductionCode codegenImpl(llvm::LLVMContext* context, llvm::Module* rt_module) const;
+
   ReductionCode finalizeReductionCode(ReductionCode reduction_code) const;
 
   // Returns true iff we will (should and is possible to) use the LLVM interpreter.
@@ -0,0 +1,433 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    RuntimeBench.cpp
+ * @brief   Microbenchmarks for the CPU runtime functions called from generated code.
+ *
+ * The functions are called through their regular (non-JIT) entry points, one row per
+ * call, which approximates the per-row cost seen by the generated query kernels.
+ */
+
+#include "DateTruncate.h"
+#include "ExtractFromTime.h"
+#include "MurmurHash.h"
+#include "RuntimeFunctions.h"
+#include "Shared/sqltypes.h"
+#include "Utils/StringLike.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" uint64_t agg_count(uint64_t* agg, const int64_t val);
+
+extern "C" int64_t hash_join_idx(int64_t hash_buff,
+                                 const int64_t key,
+                                 const int64_t min_key,
+                                 const int64_t max_key);
+
+extern "C" int64_t bucketized_hash_join_idx(int64_t hash_buff,
+                                            int64_t const key,
+                                            int64_t const min_key,
+                                            int64_t const max_key,
+                                            int64_t bucket_normalization);
+
+extern "C" int64_t get_composite_key_index_64(const int64_t* key,
+                                              const size_t key_component_count,
+                                              const int64_t* composite_key_dict,
+                                              const size_t entry_count);
+
+namespace {
+
+constexpr size_t kRowCount{1 << 20};
+constexpr uint64_t kSeed{42};
+
+// Uniform values in [min_val, max_val], with the given fraction replaced by null_val.
+std::vector<int64_t> gen_uniform(
+    const size_t count,
+    const int64_t min_val,
+    const int64_t max_val,
+    const double null_fraction = 0.,
+    const int64_t null_val = inline_int_null_value<int64_t>()) {
+  std::mt19937_64 gen(kSeed);
+  std::uniform_int_distribution<int64_t> val_dist(min_val, max_val);
+  std::bernoulli_distribution null_dist(null_fraction);
+  std::vector<int64_t> vals(count);
+  for (auto& val : vals) {
+    val = null_dist(gen) ? null_val : val_dist(gen);
+  }
+  return vals;
+}
+
+// Heavily skewed values in [0, cardinality), most rows hit a handful of keys.
+std::vector<int64_t> gen_skewed(const size_t count, const int64_t cardinality) {
+  std::mt19937_64 gen(kSeed);
+  std::exponential_distribution<double> dist(8. / cardinality);
+  std::vector<int64_t> vals(count);
+  for (auto& val : vals) {
+    val = std::min(static_cast<int64_t>(dist(gen)), cardinality - 1);
+  }
+  return vals;
+}
+
+template <typename T>
+std::vector<int8_t> to_byte_stream(const std::vector<int64_t>& vals) {
+  std::vector<int8_t> bytes(vals.size() * sizeof(T));
+  auto typed_bytes = reinterpret_cast<T*>(bytes.data());
+  for (size_t i = 0; i < vals.size(); ++i) {
+    typed_bytes[i] = static_cast<T>(vals[i]);
+  }
+  return bytes;
+}
+
+std::vector<std::string> gen_strings(const size_t count) {
+  static const std::vector<std::string> words{
+      "omnisci", "gpu", "database", "query", "engine", "fragment", "chunk", "string"};
+  std::mt19937_64 gen(kSeed);
+  std::uniform_int_distribution<size_t> word_dist(0, words.size() - 1);
+  std::uniform_int_distribution<size_t> len_dist(1, 6);
+  std::vector<std::string> strs(count);
+  for (auto& str : strs) {
+    const auto word_count = len_dist(gen);
+    for (size_t i = 0; i < word_count; ++i) {
+      str += (i ? " " : "") + words[word_count == 1 ? 0 : word_dist(gen)];
+    }
+  }
+  return strs;
+}
+
+}  // namespace
+
+static void BM_AggCount(benchmark::State& state) {
+  const auto vals = gen_uniform(kRowCount, -1000, 1000);
+  for (auto _ : state) {
+    uint64_t agg{0};
+    for (const auto val : vals) {
+      agg_count(&agg, val);
+    }
+    benchmark::DoNotOptimize(agg);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+BENCHMARK(BM_AggCount);
+
+static void BM_AggSum(benchmark::State& state) {
+  const auto vals = gen_uniform(kRowCount, -1000, 1000);
+  for (auto _ : state) {
+    int64_t agg{0};
+    for (const auto val : vals) {
+      agg_sum(&agg, val);
+    }
+    benchmark::DoNotOptimize(agg);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+BENCHMARK(BM_AggSum);
+
+// Argument: percentage of null rows.
+static void BM_AggSumSkipVal(benchmark::State& state) {
+  const auto null_val = inline_int_null_value<int64_t>();
+  const auto vals = gen_uniform(kRowCount, -1000, 1000, state.range(0) / 100., null_val);
+  for (auto _ : state) {
+    int64_t agg{null_val};
+    for (const auto val : vals) {
+      agg_sum_skip_val(&agg, val, null_val);
+    }
+    benchmark::DoNotOptimize(agg);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+BENCHMARK(BM_AggSumSkipVal)->Arg(0)->Arg(10)->Arg(50);
+
+static void BM_AggMaxSkipVal(benchmark::State& state) {
+  const auto null_val = inline_int_null_value<int64_t>();
+  const auto vals = gen_uniform(kRowCount, -1000, 1000, state.range(0) / 100., null_val);
+  for (auto _ : state) {
+    int64_t agg{null_val};
+    for (const auto val : vals) {
+      agg_max_skip_val(&agg, val, null_val);
+    }
+    benchmark::DoNotOptimize(agg);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+BENCHMARK(BM_AggMaxSkipVal)->Arg(0)->Arg(10)->Arg(50);
+
+static void BM_AggSumDouble(benchmark::State& state) {
+  const auto int_vals = gen_uniform(kRowCount, -1000000, 1000000);
+  std::vector<double> vals(int_vals.begin(), int_vals.end());
+  for (auto _ : state) {
+    double agg{0.};
+    for (const auto val : vals) {
+      agg_sum_double(reinterpret_cast<int64_t*>(&agg), val);
+    }
+    benchmark::DoNotOptimize(agg);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+BENCHMARK(BM_AggSumDouble);
+
+// Argument: byte width of the encoded column.
+static void BM_FixedWidthIntDecode(benchmark::State& state) {
+  const auto byte_width = static_cast<int32_t>(state.range(0));
+  const auto vals = gen_uniform(kRowCount, -100, 100);
+  std::vector<int8_t> bytes;
+  switch (byte_width) {
+    case 1:
+      bytes = to_byte_stream<int8_t>(vals);
+      break;
+    case 2:
+      bytes = to_byte_stream<int16_t>(vals);
+      break;
+    case 4:
+      bytes = to_byte_stream<int32_t>(vals);
+      break;
+    default:
+      bytes = to_byte_stream<int64_t>(vals);
+      break;
+  }
+  const int64_t row_count = vals.size();
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (int64_t pos = 0; pos < row_count; ++pos) {
+      sum += fixed_width_int_decode_noinline(bytes.data(), byte_width, pos);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * row_count);
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_FixedWidthIntDecode)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+static void BM_FixedWidthDoubleDecode(benchmark::State& state) {
+  const auto int_vals = gen_uniform(kRowCount, -1000000, 1000000);
+  std::vector<double> vals(int_vals.begin(), int_vals.end());
+  const auto bytes = reinterpret_cast<const int8_t*>(vals.data());
+  const int64_t row_count = vals.size();
+  for (auto _ : state) {
+    double sum{0.};
+    for (int64_t pos = 0; pos < row_count; ++pos) {
+      sum += fixed_width_double_decode_noinline(bytes, pos);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * row_count);
+}
+BENCHMARK(BM_FixedWidthDoubleDecode);
+
+static void BM_FixedWidthSmallDateDecode(benchmark::State& state) {
+  // Days since epoch, stored as 16-bit values.
+  const auto null_val = inline_int_null_value<int16_t>();
+  const auto vals = gen_uniform(kRowCount, 0, 20000, 0.05, null_val);
+  const auto bytes = to_byte_stream<int16_t>(vals);
+  const int64_t row_count = vals.size();
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (int64_t pos = 0; pos < row_count; ++pos) {
+      sum += fixed_width_small_date_decode_noinline(
+          bytes.data(), 2, null_val, inline_int_null_value<int64_t>(), pos);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * row_count);
+}
+BENCHMARK(BM_FixedWidthSmallDateDecode);
+
+// Argument: key length in bytes.
+static void BM_MurmurHash1(benchmark::State& state) {
+  const auto key_len = static_cast<size_t>(state.range(0));
+  const auto vals = gen_uniform(kRowCount / 8, 0, std::numeric_limits<int32_t>::max());
+  std::vector<int8_t> keys(vals.size() * key_len);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = static_cast<int8_t>(vals[i % vals.size()] >> (i % 8));
+  }
+  for (auto _ : state) {
+    uint32_t h{0};
+    for (size_t i = 0; i < vals.size(); ++i) {
+      h ^= MurmurHash1(&keys[i * key_len], key_len, 0);
+    }
+    benchmark::DoNotOptimize(h);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+  state.SetBytesProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_MurmurHash1)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+
+static void BM_MurmurHash64A(benchmark::State& state) {
+  const auto key_len = static_cast<size_t>(state.range(0));
+  const auto vals = gen_uniform(kRowCount / 8, 0, std::numeric_limits<int32_t>::max());
+  std::vector<int8_t> keys(vals.size() * key_len);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = static_cast<int8_t>(vals[i % vals.size()] >> (i % 8));
+  }
+  for (auto _ : state) {
+    uint64_t h{0};
+    for (size_t i = 0; i < vals.size(); ++i) {
+      h ^= MurmurHash64A(&keys[i * key_len], key_len, 0);
+    }
+    benchmark::DoNotOptimize(h);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+  state.SetBytesProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_MurmurHash64A)->Arg(8)->Arg(16)->Arg(32);
+
+static void string_like_bench(benchmark::State& state, const std::string& pattern) {
+  const auto strs = gen_strings(kRowCount / 16);
+  for (auto _ : state) {
+    size_t match_count{0};
+    for (const auto& str : strs) {
+      match_count += string_like(
+          str.c_str(), str.size(), pattern.c_str(), pattern.size(), '\\');
+    }
+    benchmark::DoNotOptimize(match_count);
+  }
+  state.SetItemsProcessed(state.iterations() * strs.size());
+}
+
+static void BM_StringLikePrefix(benchmark::State& state) {
+  string_like_bench(state, "omni%");
+}
+BENCHMARK(BM_StringLikePrefix);
+
+static void BM_StringLikeSubstring(benchmark::State& state) {
+  string_like_bench(state, "%engine%");
+}
+BENCHMARK(BM_StringLikeSubstring);
+
+static void BM_StringLikeWildcards(benchmark::State& state) {
+  string_like_bench(state, "%g_u%qu_ry%");
+}
+BENCHMARK(BM_StringLikeWildcards);
+
+// Timestamps in seconds spread over 1970-2070.
+static void BM_DateTruncate(benchmark::State& state) {
+  const auto field = static_cast<DatetruncField>(state.range(0));
+  const auto vals = gen_uniform(kRowCount, 0, 3155760000);
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (const auto val : vals) {
+      sum += DateTruncate(field, val);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+BENCHMARK(BM_DateTruncate)->Arg(dtYEAR)->Arg(dtMONTH)->Arg(dtDAY)->Arg(dtWEEK);
+
+static void BM_ExtractFromTime(benchmark::State& state) {
+  const auto field = static_cast<ExtractField>(state.range(0));
+  const auto vals = gen_uniform(kRowCount, 0, 3155760000);
+  for (auto _ : state) {
+    int64_t sum{0};
+    for (const auto val : vals) {
+      sum += ExtractFromTime(field, val);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+BENCHMARK(BM_ExtractFromTime)->Arg(kYEAR)->Arg(kMONTH)->Arg(kDAY)->Arg(kDOW)->Arg(kHOUR);
+
+// Arguments: inner key cardinality, whether the probe keys are skewed.
+static void BM_HashJoinIdx(benchmark::State& state) {
+  const int64_t cardinality = state.range(0);
+  std::vector<int32_t> hash_table(cardinality);
+  std::iota(hash_table.begin(), hash_table.end(), 0);
+  // Probe with a 10% miss rate just outside of the key range.
+  const auto probe_keys = state.range(1) ? gen_skewed(kRowCount, cardinality)
+                                         : gen_uniform(kRowCount, 0, cardinality * 1.1);
+  const auto hash_buff = reinterpret_cast<int64_t>(hash_table.data());
+  for (auto _ : state) {
+    int64_t match_count{0};
+    for (const auto key : probe_keys) {
+      match_count += hash_join_idx(hash_buff, key, 0, cardinality - 1) >= 0;
+    }
+    benchmark::DoNotOptimize(match_count);
+  }
+  state.SetItemsProcessed(state.iterations() * probe_keys.size());
+}
+BENCHMARK(BM_HashJoinIdx)
+    ->Args({1 << 10, 0})
+    ->Args({1 << 20, 0})
+    ->Args({1 << 24, 0})
+    ->Args({1 << 24, 1});
+
+static void BM_BucketizedHashJoinIdx(benchmark::State& state) {
+  const int64_t cardinality = state.range(0);
+  const int64_t bucket_normalization{86400};
+  std::vector<int32_t> hash_table(cardinality / bucket_normalization + 1);
+  std::iota(hash_table.begin(), hash_table.end(), 0);
+  const auto probe_keys = gen_uniform(kRowCount, 0, cardinality - 1);
+  const auto hash_buff = reinterpret_cast<int64_t>(hash_table.data());
+  for (auto _ : state) {
+    int64_t match_count{0};
+    for (const auto key : probe_keys) {
+      match_count += bucketized_hash_join_idx(
+                         hash_buff, key, 0, cardinality - 1, bucket_normalization) >= 0;
+    }
+    benchmark::DoNotOptimize(match_count);
+  }
+  state.SetItemsProcessed(state.iterations() * probe_keys.size());
+}
+BENCHMARK(BM_BucketizedHashJoinIdx)->Arg(int64_t(86400) * 365 * 30);
+
+// Arguments: composite key dictionary entry count, key component count.
+static void BM_CompositeKeyIndex(benchmark::State& state) {
+  const size_t entry_count = state.range(0);
+  const size_t key_component_count = state.range(1);
+  const auto empty_key = std::numeric_limits<int64_t>::max();
+  std::vector<int64_t> composite_key_dict(entry_count * key_component_count, empty_key);
+  // Fill half of the dictionary, like the baseline join hash table does.
+  const auto inserted_keys = gen_uniform(entry_count / 2, 0, entry_count * 4);
+  std::vector<int64_t> key(key_component_count);
+  for (const auto inserted_key : inserted_keys) {
+    std::fill(key.begin(), key.end(), inserted_key);
+    auto h = MurmurHash1(key.data(), key.size() * sizeof(int64_t), 0) % entry_count;
+    auto entry = &composite_key_dict[h * key_component_count];
+    while (*entry != empty_key && !std::equal(key.begin(), key.end(), entry)) {
+      h = (h + 1) % entry_count;
+      entry = &composite_key_dict[h * key_component_count];
+    }
+    std::copy(key.begin(), key.end(), entry);
+  }
+  const auto probe_keys = gen_uniform(kRowCount / 4, 0, entry_count * 4);
+  for (auto _ : state) {
+    int64_t match_count{0};
+    for (const auto probe_key : probe_keys) {
+      std::fill(key.begin(), key.end(), probe_key);
+      match_count += get_composite_key_index_64(key.data(),
+                                                key_component_count,
+                                                composite_key_dict.data(),
+                                                entry_count) >= 0;
+    }
+    benchmark::DoNotOptimize(match_count);
+  }
+  state.SetItemsProcessed(state.iterations() * probe_keys.size());
+}
+BENCHMARK(BM_CompositeKeyIndex)
+    ->Args({1 << 16, 2})
+    ->Args({1 << 22, 2})
+    ->Args({1 << 16, 4});
+
+BENCHMARK_MAIN();
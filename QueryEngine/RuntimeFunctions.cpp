@@ -337,6 +337,18 @@ extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
              : 0;
 }
 
+extern "C" ALWAYS_INLINE int32_t string_id_lookup(const int64_t table,
+                                                  const int32_t string_id,
+                                                  const int32_t min_id,
+                                                  const int32_t max_id,
+                                                  const int32_t null_val) {
+  // Also covers the null string id, which is the smallest 32-bit integer.
+  if (string_id < min_id || string_id > max_id) {
+    return null_val;
+  }
+  return reinterpret_cast<const int32_t*>(table)[string_id - min_id];
+}
+
 extern "C" ALWAYS_INLINE int64_t agg_sum(int64_t* agg, const int64_t val) {
   const auto old = *agg;
   *agg += val;
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StringIdLookupTable.h"
+#include "Allocators/CudaAllocator.h"
+#include "CodeGenerator.h"
+#include "Execute.h"
+#ifdef HAVE_CUDA
+#include "GpuMemUtils.h"
+#endif  // HAVE_CUDA
+#include "../Parser/ParserNode.h"
+#include "Shared/Logger.h"
+
+StringIdLookupTable::StringIdLookupTable(const std::vector<int32_t>& values,
+                                         const int32_t min_id,
+                                         const Data_Namespace::MemoryLevel memory_level,
+                                         const int device_count,
+                                         Data_Namespace::DataMgr* data_mgr)
+    : min_id_(min_id)
+    , max_id_(min_id + static_cast<int32_t>(values.size()) - 1)
+    , memory_level_(memory_level)
+    , data_mgr_(data_mgr) {
+  CHECK(!values.empty());
+#ifdef HAVE_CUDA
+  CHECK(memory_level_ == Data_Namespace::CPU_LEVEL ||
+        memory_level == Data_Namespace::GPU_LEVEL);
+  if (memory_level_ == Data_Namespace::GPU_LEVEL) {
+    const size_t table_bytes = values.size() * sizeof(int32_t);
+    for (int device_id = 0; device_id < device_count; ++device_id) {
+      auto gpu_buffer =
+          CudaAllocator::allocGpuAbstractBuffer(data_mgr_, table_bytes, device_id);
+      copy_to_gpu(data_mgr_,
+                  reinterpret_cast<CUdeviceptr>(gpu_buffer->getMemoryPtr()),
+                  &values[0],
+                  table_bytes,
+                  device_id);
+      gpu_buffers_.push_back(gpu_buffer);
+    }
+    return;
+  }
+#else
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, memory_level_);
+  CHECK_EQ(1, device_count);
+#endif  // HAVE_CUDA
+  cpu_values_ = values;
+}
+
+StringIdLookupTable::~StringIdLookupTable() {
+  for (auto gpu_buffer : gpu_buffers_) {
+    CudaAllocator::freeGpuAbstractBuffer(data_mgr_, gpu_buffer);
+  }
+}
+
+llvm::Value* StringIdLookupTable::codegen(llvm::Value* string_id,
+                                          const int32_t null_val,
+                                          Executor* executor) const {
+  std::vector<std::shared_ptr<const Analyzer::Constant>> constants_owned;
+  std::vector<const Analyzer::Constant*> constants;
+  std::vector<int64_t> table_handles;
+  if (memory_level_ == Data_Namespace::GPU_LEVEL) {
+    for (const auto gpu_buffer : gpu_buffers_) {
+      table_handles.push_back(reinterpret_cast<int64_t>(gpu_buffer->getMemoryPtr()));
+    }
+  } else {
+    table_handles.push_back(reinterpret_cast<int64_t>(&cpu_values_[0]));
+  }
+  for (const auto table_handle : table_handles) {
+    const auto table_handle_literal = std::dynamic_pointer_cast<Analyzer::Constant>(
+        Parser::IntLiteral::analyzeValue(table_handle));
+    CHECK(table_handle_literal);
+    CHECK_EQ(kENCODING_NONE, table_handle_literal->get_type_info().get_compression());
+    constants_owned.push_back(table_handle_literal);
+    constants.push_back(table_handle_literal.get());
+  }
+  CodeGenerator code_generator(executor);
+  const auto table_handle_lvs =
+      code_generator.codegenHoistedConstants(constants, kENCODING_NONE, 0);
+  CHECK_EQ(size_t(1), table_handle_lvs.size());
+  // The id range moves as the dictionary grows, hoisting it keeps the generated code
+  // the same and the code cache hit.
+  const auto codegen_hoisted_id = [&code_generator, &table_handles](const int32_t id) {
+    Datum id_datum;
+    id_datum.intval = id;
+    const Analyzer::Constant id_literal(kINT, false, id_datum);
+    const std::vector<const Analyzer::Constant*> id_constants(table_handles.size(),
+                                                              &id_literal);
+    const auto id_lvs =
+        code_generator.codegenHoistedConstants(id_constants, kENCODING_NONE, 0);
+    CHECK_EQ(size_t(1), id_lvs.size());
+    return id_lvs.front();
+  };
+  auto cgen_state = executor->cgen_state_.get();
+  return cgen_state->emitCall(
+      "string_id_lookup",
+      {cgen_state->castToTypeIn(table_handle_lvs.front(), 64),
+       cgen_state->castToTypeIn(string_id, 32),
+       codegen_hoisted_id(min_id_),
+       codegen_hoisted_id(max_id_),
+       cgen_state->llInt(null_val)});
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef QUERYENGINE_STRINGIDLOOKUPTABLE_H
+#define QUERYENGINE_STRINGIDLOOKUPTABLE_H
+
+#include "../DataMgr/DataMgr.h"
+
+#include <llvm/IR/Value.h>
+
+#include <cstdint>
+#include <vector>
+
+class Executor;
+
+// Result of a scalar string function for every id of a dictionary, computed once per
+// query. The generated code evaluates the function with a load from the table instead
+// of decoding the string of each row, which also allows running it on GPU.
+class StringIdLookupTable {
+ public:
+  // The value at position i is the result for the string id min_id + i.
+  StringIdLookupTable(const std::vector<int32_t>& values,
+                      const int32_t min_id,
+                      const Data_Namespace::MemoryLevel memory_level,
+                      const int device_count,
+                      Data_Namespace::DataMgr* data_mgr);
+  ~StringIdLookupTable();
+
+  // Returns the value for the string id, or null_val for a null or unknown id.
+  llvm::Value* codegen(llvm::Value* string_id,
+                       const int32_t null_val,
+                       Executor* executor) const;
+
+ private:
+  std::vector<int32_t> cpu_values_;
+  std::vector<Data_Namespace::AbstractBuffer*> gpu_buffers_;
+  const int32_t min_id_;
+  const int32_t max_id_;
+  const Data_Namespace::MemoryLevel memory_level_;
+  Data_Namespace::DataMgr* data_mgr_;
+};
+
+#endif  // QUERYENGINE_STRINGIDLOOKUPTABLE_H
@@ -55,6 +55,10 @@ extern "C" int32_t string_compress(const int64_t ptr_and_len,
 
 llvm::Value* CodeGenerator::codegen(const Analyzer::CharLengthExpr* expr,
                                     const CompilationOptions& co) {
+  const auto dict_char_length_lv = codegenDictCharLength(expr, co);
+  if (dict_char_length_lv) {
+    return dict_char_length_lv;
+  }
   auto str_lv = codegen(expr->get_arg(), true, co);
   if (str_lv.size() != 3) {
     CHECK_EQ(size_t(1), str_lv.size());
@@ -84,6 +88,43 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::CharLengthExpr* expr,
              : cgen_state_->emitCall(fn_name, charlength_args);
 }
 
+// Computes the length of every string in the dictionary once, then looks the length up
+// by string id instead of decoding the string of each row.
+llvm::Value* CodeGenerator::codegenDictCharLength(const Analyzer::CharLengthExpr* expr,
+                                                  const CompilationOptions& co) {
+  const auto cast_oper = dynamic_cast<const Analyzer::UOper*>(expr->get_arg());
+  if (!cast_oper || cast_oper->get_optype() != kCAST || !co.hoist_literals_) {
+    return nullptr;
+  }
+  const auto dict_arg = cast_oper->get_operand();
+  const auto& dict_arg_ti = dict_arg->get_type_info();
+  if (!dict_arg_ti.is_string() || dict_arg_ti.get_compression() != kENCODING_DICT) {
+    return nullptr;
+  }
+  const auto sdp = executor()->getStringDictionaryProxy(
+      dict_arg_ti.get_comp_param(), executor()->getRowSetMemoryOwner(), true);
+  if (sdp->storageEntryCount() > g_max_dict_lookup_table_entries) {
+    return nullptr;
+  }
+  const auto min_id_and_lengths = sdp->getCharLengths(expr->get_calc_encoded_length());
+  if (min_id_and_lengths.second.empty()) {
+    return nullptr;
+  }
+  auto lookup_table = std::make_unique<StringIdLookupTable>(
+      min_id_and_lengths.second,
+      min_id_and_lengths.first,
+      co.device_type_ == ExecutorDeviceType::GPU ? Data_Namespace::GPU_LEVEL
+                                                 : Data_Namespace::CPU_LEVEL,
+      executor()->deviceCount(co.device_type_),
+      &executor()->getCatalog()->getDataMgr());
+  const auto dict_arg_lvs = codegen(dict_arg, true, co);
+  CHECK_EQ(size_t(1), dict_arg_lvs.size());
+  return cgen_state_->addStringIdLookupTable(lookup_table)
+      ->codegen(dict_arg_lvs.front(),
+                inline_int_null_val(expr->get_type_info()),
+                executor());
+}
+
 llvm::Value* CodeGenerator::codegen(const Analyzer::KeyForStringExpr* expr,
                                     const CompilationOptions& co) {
   auto str_lv = codegen(expr->get_arg(), true, co);
@@ -15,14 +15,19 @@
  */
 
 #include "WindowContext.h"
+#include <atomic>
+#include <future>
+#include <limits>
 #include <numeric>
 #include "../Shared/checked_alloc.h"
 #include "../Shared/sql_window_function_to_string.h"
+#include "../Shared/thread_count.h"
 #include "Descriptors/CountDistinctDescriptor.h"
 #include "OutputBufferInitialization.h"
 #include "ResultSetBufferAccessors.h"
 #include "RuntimeFunctions.h"
 #include "TypePunning.h"
+#include "WindowSegmentTree.h"
 
 WindowFunctionContext::WindowFunctionContext(
     const Analyzer::WindowFunction* window_func,
@@ -35,6 +40,7 @@ WindowFunctionContext::WindowFunctionContext(
     , output_(nullptr)
     , partition_start_(nullptr)
     , partition_end_(nullptr)
+    , frame_arg_column_(nullptr)
     , device_type_(device_type) {}
 
 WindowFunctionContext::~WindowFunctionContext() {
@@ -51,6 +57,16 @@ void WindowFunctionContext::addOrderColumn(
   order_columns_.push_back(column);
 }
 
+void WindowFunctionContext::addFrameArgColumn(
+    const int8_t* column,
+    const Analyzer::ColumnVar* col_var,
+    const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
+  CHECK(window_func_->getFrame());
+  CHECK(!frame_arg_column_);
+  frame_arg_column_owner_ = chunks_owner;
+  frame_arg_column_ = column;
+}
+
 namespace {
 
 // Converts the sorted indices to a mapping from row position to row number.
@@ -65,7 +81,7 @@ std::vector<int64_t> index_to_row_number(const int64_t* index, const size_t inde
 // Returns true iff the current element is greater than the previous, according to the
 // comparator. This is needed because peer rows have to have the same rank.
 bool advance_current_rank(
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator,
+    const WindowFunctionContext::Comparator& comparator,
     const int64_t* index,
     const size_t i) {
   if (i == 0) {
@@ -78,7 +94,7 @@ bool advance_current_rank(
 std::vector<int64_t> index_to_rank(
     const int64_t* index,
     const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+    const WindowFunctionContext::Comparator& comparator) {
   std::vector<int64_t> rank(index_size);
   size_t crt_rank = 1;
   for (size_t i = 0; i < index_size; ++i) {
@@ -94,7 +110,7 @@ std::vector<int64_t> index_to_rank(
 std::vector<int64_t> index_to_dense_rank(
     const int64_t* index,
     const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+    const WindowFunctionContext::Comparator& comparator) {
   std::vector<int64_t> dense_rank(index_size);
   size_t crt_rank = 1;
   for (size_t i = 0; i < index_size; ++i) {
@@ -110,7 +126,7 @@ std::vector<int64_t> index_to_dense_rank(
 std::vector<double> index_to_percent_rank(
     const int64_t* index,
     const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+    const WindowFunctionContext::Comparator& comparator) {
   std::vector<double> percent_rank(index_size);
   size_t crt_rank = 1;
   for (size_t i = 0; i < index_size; ++i) {
@@ -127,7 +143,7 @@ std::vector<double> index_to_percent_rank(
 std::vector<double> index_to_cume_dist(
     const int64_t* index,
     const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+    const WindowFunctionContext::Comparator& comparator) {
   std::vector<double> cume_dist(index_size);
   size_t start_peer_group = 0;
   while (start_peer_group < index_size) {
@@ -262,20 +278,20 @@ void apply_last_value_to_partition(const int32_t* original_indices,
       original_indices, original_indices + partition_size, output_for_partition_buff);
 }
 
-void index_to_partition_end(
-    const int8_t* partition_end,
-    const size_t off,
-    const int64_t* index,
-    const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
-  int64_t partition_end_handle = reinterpret_cast<int64_t>(partition_end);
+// Collects the positions of the last rows of peer groups in the partition, to be set in
+// the partition end bitmap once all partitions have been processed.
+void index_to_partition_end(std::vector<int64_t>& partition_end_positions,
+                            const size_t off,
+                            const int64_t* index,
+                            const size_t index_size,
+                            const WindowFunctionContext::Comparator& comparator) {
   for (size_t i = 0; i < index_size; ++i) {
     if (advance_current_rank(comparator, index, i)) {
-      agg_count_distinct_bitmap(&partition_end_handle, off + i - 1, 0);
+      partition_end_positions.push_back(off + i - 1);
     }
   }
   CHECK(index_size);
-  agg_count_distinct_bitmap(&partition_end_handle, off + index_size - 1, 0);
+  partition_end_positions.push_back(off + index_size - 1);
 }
 
 bool pos_is_set(const int64_t bitset, const int64_t pos) {
@@ -379,7 +395,7 @@ extern "C" void add_window_pending_output(void* pending_output, const int64_t ha
 // Returns true iff the aggregate window function requires special multiplicity handling
 // to ensure that peer rows have the same value for the window function.
 bool window_function_requires_peer_handling(const Analyzer::WindowFunction* window_func) {
-  if (!window_function_is_aggregate(window_func->getKind())) {
+  if (!window_function_is_cumulative_aggregate(window_func)) {
     return false;
   }
   if (window_func->getOrderKeys().empty()) {
@@ -396,78 +412,109 @@ bool window_function_requires_peer_handling(const Analyzer::WindowFunction* wind
   }
 }
 
+namespace {
+
+// Partitions are sorted and computed in parallel only above this number of rows, the
+// cost of spawning the workers isn't worth it for smaller inputs.
+constexpr size_t parallel_window_partitions_min_elem_count{10000};
+
+}  // namespace
+
 void WindowFunctionContext::compute() {
   CHECK(!output_);
   output_ = static_cast<int8_t*>(checked_malloc(
       elem_count_ * window_function_buffer_element_size(window_func_->getKind())));
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  const bool is_cumulative_aggregate =
+      window_function_is_cumulative_aggregate(window_func_);
+  if (is_cumulative_aggregate) {
     fillPartitionStart();
     if (window_function_requires_peer_handling(window_func_)) {
       fillPartitionEnd();
     }
   }
   std::unique_ptr<int64_t[]> scratchpad(new int64_t[elem_count_]);
-  int64_t off = 0;
-  for (size_t i = 0; i < partitionCount(); ++i) {
-    auto partition_size = counts()[i];
-    if (partition_size == 0) {
-      continue;
-    }
-    auto output_for_partition_buff = scratchpad.get() + offsets()[i];
-    std::iota(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              int64_t(0));
-    std::vector<Comparator> comparators;
-    const auto& order_keys = window_func_->getOrderKeys();
-    const auto& collation = window_func_->getCollation();
-    CHECK_EQ(order_keys.size(), collation.size());
-    for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
-         ++order_column_idx) {
-      auto order_column_buffer = order_columns_[order_column_idx];
-      const auto order_col =
-          dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
-      CHECK(order_col);
-      const auto& order_col_collation = collation[order_column_idx];
-      const auto asc_comparator = makeComparator(order_col,
-                                                 order_column_buffer,
-                                                 payload() + offsets()[i],
-                                                 order_col_collation.nulls_first);
-      auto comparator = asc_comparator;
-      if (order_col_collation.is_desc) {
-        comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
-          return asc_comparator(rhs, lhs);
-        };
+  const size_t partition_count = partitionCount();
+  // Start of every partition in window order, partitions are laid out one after another.
+  std::vector<size_t> partition_window_offsets(partition_count);
+  size_t off = 0;
+  for (size_t i = 0; i < partition_count; ++i) {
+    partition_window_offsets[i] = off;
+    off += counts()[i];
+  }
+  if (window_function_is_value(window_func_->getKind()) || is_cumulative_aggregate) {
+    CHECK_EQ(off, elem_count_);
+  }
+  // Partitions are independent of each other, workers pick the next partition to sort
+  // and compute until none is left. The positions for the partition end bitmap are
+  // collected per worker since setting bits isn't thread safe.
+  std::atomic<size_t> next_partition{0};
+  const auto compute_partitions = [this,
+                                   &scratchpad,
+                                   &partition_window_offsets,
+                                   &next_partition,
+                                   partition_count](
+                                      std::vector<int64_t>& partition_end_positions) {
+    for (size_t i = next_partition++; i < partition_count; i = next_partition++) {
+      const size_t partition_size = counts()[i];
+      if (partition_size == 0) {
+        continue;
+      }
+      auto output_for_partition_buff = scratchpad.get() + offsets()[i];
+      std::iota(output_for_partition_buff,
+                output_for_partition_buff + partition_size,
+                int64_t(0));
+      const auto partition_indices = payload() + offsets()[i];
+      const auto comparator = makeComparator(partition_indices);
+      std::sort(output_for_partition_buff,
+                output_for_partition_buff + partition_size,
+                [&comparator](const int64_t lhs, const int64_t rhs) {
+                  return comparator(lhs, rhs);
+                });
+      if (window_func_->getFrame()) {
+        computeFramePartition(
+            output_for_partition_buff, partition_size, partition_indices, comparator);
+        continue;
       }
-      comparators.push_back(comparator);
+      computePartition(output_for_partition_buff,
+                       partition_size,
+                       partition_window_offsets[i],
+                       window_func_,
+                       comparator,
+                       partition_end_positions);
     }
-    const auto col_tuple_comparator = [&comparators](const int64_t lhs,
-                                                     const int64_t rhs) {
-      for (const auto& comparator : comparators) {
-        if (comparator(lhs, rhs)) {
-          return true;
-        }
+  };
+  const size_t worker_count =
+      elem_count_ < parallel_window_partitions_min_elem_count
+          ? 1
+          : std::min(static_cast<size_t>(cpu_threads()), partition_count);
+  std::vector<std::vector<int64_t>> partition_end_positions(std::max(worker_count,
+                                                                     size_t(1)));
+  if (worker_count <= 1) {
+    compute_partitions(partition_end_positions.front());
+  } else {
+    std::vector<std::future<void>> workers;
+    for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+      workers.emplace_back(std::async(std::launch::async,
+                                      compute_partitions,
+                                      std::ref(partition_end_positions[worker_idx])));
+    }
+    for (auto& worker : workers) {
+      worker.wait();
+    }
+    for (auto& worker : workers) {
+      worker.get();
+    }
+  }
+  if (partition_end_) {
+    auto partition_end_handle = reinterpret_cast<int64_t>(partition_end_);
+    for (const auto& worker_partition_end_positions : partition_end_positions) {
+      for (const auto pos : worker_partition_end_positions) {
+        agg_count_distinct_bitmap(&partition_end_handle, pos, 0);
       }
-      return false;
-    };
-    std::sort(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              col_tuple_comparator);
-    computePartition(output_for_partition_buff,
-                     partition_size,
-                     off,
-                     window_func_,
-                     col_tuple_comparator);
-    if (window_function_is_value(window_func_->getKind()) ||
-        window_function_is_aggregate(window_func_->getKind())) {
-      off += partition_size;
-    }
-  }
-  if (window_function_is_value(window_func_->getKind()) ||
-      window_function_is_aggregate(window_func_->getKind())) {
-    CHECK_EQ(static_cast<size_t>(off), elem_count_);
+    }
   }
   auto output_i64 = reinterpret_cast<int64_t*>(output_);
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  if (is_cumulative_aggregate) {
     std::copy(scratchpad.get(), scratchpad.get() + elem_count_, output_i64);
   } else {
     for (size_t i = 0; i < elem_count_; ++i) {
@@ -522,92 +569,72 @@ llvm::Value* WindowFunctionContext::getRowNumber() const {
 namespace {
 
 template <class T>
-bool integer_comparator(const int8_t* order_column_buffer,
-                        const SQLTypeInfo& ti,
-                        const int32_t* partition_indices,
-                        const int64_t lhs,
-                        const int64_t rhs,
-                        const bool nulls_first) {
+int integer_comparator(const int8_t* order_column_buffer,
+                       const int64_t null_val,
+                       const bool nulls_first,
+                       const int32_t* partition_indices,
+                       const int64_t lhs,
+                       const int64_t rhs) {
   const auto values = reinterpret_cast<const T*>(order_column_buffer);
   const auto lhs_val = values[partition_indices[lhs]];
   const auto rhs_val = values[partition_indices[rhs]];
-  const auto null_val = inline_fixed_encoding_null_val(ti);
-  if (lhs_val == null_val && rhs_val == null_val) {
-    return false;
+  const bool lhs_is_null = lhs_val == null_val;
+  const bool rhs_is_null = rhs_val == null_val;
+  if (lhs_is_null && rhs_is_null) {
+    return 0;
   }
-  if (lhs_val == null_val && rhs_val != null_val) {
-    return nulls_first;
+  if (lhs_is_null) {
+    return nulls_first ? -1 : 1;
   }
-  if (rhs_val == null_val && lhs_val != null_val) {
-    return !nulls_first;
+  if (rhs_is_null) {
+    return nulls_first ? 1 : -1;
   }
-  return lhs_val < rhs_val;
+  return lhs_val < rhs_val ? -1 : (rhs_val < lhs_val ? 1 : 0);
 }
 
 template <class T, class NullPatternType>
-bool fp_comparator(const int8_t* order_column_buffer,
-                   const SQLTypeInfo& ti,
-                   const int32_t* partition_indices,
-                   const int64_t lhs,
-                   const int64_t rhs,
-                   const bool nulls_first) {
+int fp_comparator(const int8_t* order_column_buffer,
+                  const int64_t null_bit_pattern,
+                  const bool nulls_first,
+                  const int32_t* partition_indices,
+                  const int64_t lhs,
+                  const int64_t rhs) {
   const auto values = reinterpret_cast<const T*>(order_column_buffer);
   const auto lhs_val = values[partition_indices[lhs]];
   const auto rhs_val = values[partition_indices[rhs]];
-  const auto null_bit_pattern = null_val_bit_pattern(ti, ti.get_type() == kFLOAT);
   const auto lhs_bit_pattern =
       *reinterpret_cast<const NullPatternType*>(may_alias_ptr(&lhs_val));
   const auto rhs_bit_pattern =
       *reinterpret_cast<const NullPatternType*>(may_alias_ptr(&rhs_val));
-  if (lhs_bit_pattern == null_bit_pattern && rhs_bit_pattern == null_bit_pattern) {
-    return false;
+  const bool lhs_is_null = lhs_bit_pattern == null_bit_pattern;
+  const bool rhs_is_null = rhs_bit_pattern == null_bit_pattern;
+  if (lhs_is_null && rhs_is_null) {
+    return 0;
   }
-  if (lhs_bit_pattern == null_bit_pattern && rhs_bit_pattern != null_bit_pattern) {
-    return nulls_first;
+  if (lhs_is_null) {
+    return nulls_first ? -1 : 1;
   }
-  if (rhs_bit_pattern == null_bit_pattern && lhs_bit_pattern != null_bit_pattern) {
-    return !nulls_first;
+  if (rhs_is_null) {
+    return nulls_first ? 1 : -1;
   }
-  return lhs_val < rhs_val;
+  return lhs_val < rhs_val ? -1 : (rhs_val < lhs_val ? 1 : 0);
 }
 
-}  // namespace
-
-std::function<bool(const int64_t lhs, const int64_t rhs)>
-WindowFunctionContext::makeComparator(const Analyzer::ColumnVar* col_var,
-                                      const int8_t* order_column_buffer,
-                                      const int32_t* partition_indices,
-                                      const bool nulls_first) {
-  const auto& ti = col_var->get_type_info();
+WindowFunctionContext::Comparator::CompareFunction get_compare_function(
+    const SQLTypeInfo& ti) {
   if (ti.is_integer() || ti.is_decimal() || ti.is_time() || ti.is_boolean()) {
     switch (ti.get_size()) {
       case 8: {
-        return [order_column_buffer, nulls_first, partition_indices, &ti](
-                   const int64_t lhs, const int64_t rhs) {
-          return integer_comparator<int64_t>(
-              order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-        };
+        return integer_comparator<int64_t>;
       }
       case 4: {
-        return [order_column_buffer, nulls_first, partition_indices, &ti](
-                   const int64_t lhs, const int64_t rhs) {
-          return integer_comparator<int32_t>(
-              order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-        };
+        return integer_comparator<int32_t>;
       }
       case 2: {
-        return [order_column_buffer, nulls_first, partition_indices, &ti](
-                   const int64_t lhs, const int64_t rhs) {
-          return integer_comparator<int16_t>(
-              order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-        };
+        return integer_comparator<int16_t>;
       }
       case 1: {
-        return [order_column_buffer, nulls_first, partition_indices, &ti](
-                   const int64_t lhs, const int64_t rhs) {
-          return integer_comparator<int8_t>(
-              order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-        };
+        return integer_comparator<int8_t>;
       }
       default: {
         LOG(FATAL) << "Invalid type size: " << ti.get_size();
@@ -617,18 +644,10 @@ WindowFunctionContext::makeComparator(const Analyzer::ColumnVar* col_var,
   if (ti.is_fp()) {
     switch (ti.get_type()) {
       case kFLOAT: {
-        return [order_column_buffer, nulls_first, partition_indices, &ti](
-                   const int64_t lhs, const int64_t rhs) {
-          return fp_comparator<float, int32_t>(
-              order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-        };
+        return fp_comparator<float, int32_t>;
       }
       case kDOUBLE: {
-        return [order_column_buffer, nulls_first, partition_indices, &ti](
-                   const int64_t lhs, const int64_t rhs) {
-          return fp_comparator<double, int64_t>(
-              order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-        };
+        return fp_comparator<double, int64_t>;
       }
       default: {
         LOG(FATAL) << "Invalid float type";
@@ -638,12 +657,39 @@ WindowFunctionContext::makeComparator(const Analyzer::ColumnVar* col_var,
   throw std::runtime_error("Type not supported yet");
 }
 
+}  // namespace
+
+WindowFunctionContext::Comparator WindowFunctionContext::makeComparator(
+    const int32_t* partition_indices) const {
+  Comparator comparator(partition_indices);
+  const auto& order_keys = window_func_->getOrderKeys();
+  const auto& collation = window_func_->getCollation();
+  CHECK_EQ(order_keys.size(), collation.size());
+  for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
+       ++order_column_idx) {
+    const auto order_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
+    CHECK(order_col);
+    const auto& ti = order_col->get_type_info();
+    const auto null_val = ti.is_fp() ? null_val_bit_pattern(ti, ti.get_type() == kFLOAT)
+                                     : inline_fixed_encoding_null_val(ti);
+    const auto& order_col_collation = collation[order_column_idx];
+    comparator.addOrderColumn(get_compare_function(ti),
+                              order_columns_[order_column_idx],
+                              null_val,
+                              order_col_collation.nulls_first,
+                              order_col_collation.is_desc);
+  }
+  return comparator;
+}
+
 void WindowFunctionContext::computePartition(
     int64_t* output_for_partition_buff,
     const size_t partition_size,
     const size_t off,
     const Analyzer::WindowFunction* window_func,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+    const Comparator& comparator,
+    std::vector<int64_t>& partition_end_positions) const {
   switch (window_func->getKind()) {
     case SqlWindowFunctionKind::ROW_NUMBER: {
       const auto row_numbers =
@@ -714,8 +760,11 @@ void WindowFunctionContext::computePartition(
     case SqlWindowFunctionKind::COUNT: {
       const auto partition_row_offsets = payload() + off;
       if (window_function_requires_peer_handling(window_func)) {
-        index_to_partition_end(
-            partitionEnd(), off, output_for_partition_buff, partition_size, comparator);
+        index_to_partition_end(partition_end_positions,
+                               off,
+                               output_for_partition_buff,
+                               partition_size,
+                               comparator);
       }
       apply_permutation_to_partition(
           output_for_partition_buff, partition_row_offsets, partition_size);
@@ -728,6 +777,337 @@ void WindowFunctionContext::computePartition(
   }
 }
 
+namespace {
+
+// Reads the value of an integer or decimal column at the given row, returns false for
+// nulls.
+bool read_integer_value(const int8_t* column,
+                        const SQLTypeInfo& ti,
+                        const int64_t row,
+                        int64_t& val) {
+  switch (ti.get_size()) {
+    case 8: {
+      val = reinterpret_cast<const int64_t*>(column)[row];
+      break;
+    }
+    case 4: {
+      val = reinterpret_cast<const int32_t*>(column)[row];
+      break;
+    }
+    case 2: {
+      val = reinterpret_cast<const int16_t*>(column)[row];
+      break;
+    }
+    case 1: {
+      val = reinterpret_cast<const int8_t*>(column)[row];
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid type size: " << ti.get_size();
+    }
+  }
+  return val != inline_fixed_encoding_null_val(ti);
+}
+
+// Reads the value of a floating point column at the given row, returns false for nulls.
+bool read_fp_value(const int8_t* column,
+                   const SQLTypeInfo& ti,
+                   const int64_t row,
+                   double& val) {
+  if (ti.get_type() == kFLOAT) {
+    const auto float_val = reinterpret_cast<const float*>(column)[row];
+    val = float_val;
+    return float_val != inline_fp_null_value<float>();
+  }
+  CHECK_EQ(kDOUBLE, ti.get_type());
+  val = reinterpret_cast<const double*>(column)[row];
+  return val != inline_fp_null_value<double>();
+}
+
+bool is_offset_frame_bound(const Analyzer::WindowFrameBound& bound) {
+  return bound.bound_type == SqlWindowFrameBoundType::EXPR_PRECEDING ||
+         bound.bound_type == SqlWindowFrameBoundType::EXPR_FOLLOWING;
+}
+
+// Aggregates the values of every frame using a segment tree built over the partition.
+template <class T, class AggOp>
+std::vector<T> aggregate_frames(
+    std::vector<T> values,
+    const std::vector<bool>& nulls,
+    const T identity,
+    const std::vector<std::pair<size_t, size_t>>& frame_bounds) {
+  for (size_t pos = 0; pos < values.size(); ++pos) {
+    if (nulls[pos]) {
+      values[pos] = identity;
+    }
+  }
+  const WindowSegmentTree<T, AggOp> segment_tree(values, identity);
+  std::vector<T> frame_aggregates;
+  frame_aggregates.reserve(frame_bounds.size());
+  for (const auto& bounds : frame_bounds) {
+    frame_aggregates.push_back(segment_tree.query(bounds.first, bounds.second));
+  }
+  return frame_aggregates;
+}
+
+int64_t to_output_slot(const int64_t val) {
+  return val;
+}
+
+int64_t to_output_slot(const double val) {
+  return *reinterpret_cast<const int64_t*>(may_alias_ptr(&val));
+}
+
+// Computes the aggregate over the frame of every row, given the argument values in window
+// order. The results are encoded the way the generated code reads them: integers for
+// COUNT and integer SUM, MIN and MAX, doubles for AVG and floating point results.
+template <class T>
+std::vector<int64_t> compute_frame_aggregates(
+    const Analyzer::WindowFunction* window_func,
+    const std::vector<T>& values,
+    const std::vector<bool>& nulls,
+    const std::vector<std::pair<size_t, size_t>>& frame_bounds) {
+  std::vector<int64_t> non_null_prefix(values.size() + 1, 0);
+  for (size_t pos = 0; pos < values.size(); ++pos) {
+    non_null_prefix[pos + 1] = non_null_prefix[pos] + (nulls[pos] ? 0 : 1);
+  }
+  const auto kind = window_func->getKind();
+  std::vector<T> frame_aggregates;
+  switch (kind) {
+    case SqlWindowFunctionKind::COUNT: {
+      break;
+    }
+    case SqlWindowFunctionKind::AVG:
+    case SqlWindowFunctionKind::SUM:
+    case SqlWindowFunctionKind::SUM_INTERNAL: {
+      frame_aggregates =
+          aggregate_frames<T, WindowSumOp<T>>(values, nulls, T(0), frame_bounds);
+      break;
+    }
+    case SqlWindowFunctionKind::MIN: {
+      frame_aggregates = aggregate_frames<T, WindowMinOp<T>>(
+          values, nulls, std::numeric_limits<T>::max(), frame_bounds);
+      break;
+    }
+    case SqlWindowFunctionKind::MAX: {
+      frame_aggregates = aggregate_frames<T, WindowMaxOp<T>>(
+          values, nulls, std::numeric_limits<T>::lowest(), frame_bounds);
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid aggregate for a window frame: "
+                 << sql_window_function_to_str(kind);
+    }
+  }
+  const auto& window_func_ti = window_func->get_type_info();
+  const auto null_output = window_func_ti.is_fp()
+                               ? to_output_slot(inline_fp_null_val(window_func_ti))
+                               : inline_int_null_val(window_func_ti);
+  const auto& arg_ti = window_func->getArgs().front()->get_type_info();
+  const double avg_scale = arg_ti.is_decimal() ? exp_to_scale(arg_ti.get_scale()) : 1;
+  std::vector<int64_t> output;
+  output.reserve(frame_bounds.size());
+  for (size_t pos = 0; pos < frame_bounds.size(); ++pos) {
+    const auto& bounds = frame_bounds[pos];
+    const auto non_null_count =
+        non_null_prefix[bounds.second] - non_null_prefix[bounds.first];
+    if (kind == SqlWindowFunctionKind::COUNT) {
+      output.push_back(non_null_count);
+      continue;
+    }
+    if (kind == SqlWindowFunctionKind::AVG) {
+      output.push_back(
+          non_null_count
+              ? to_output_slot(static_cast<double>(frame_aggregates[pos]) /
+                               non_null_count / avg_scale)
+              : to_output_slot(inline_fp_null_value<double>()));
+      continue;
+    }
+    if (!non_null_count && kind != SqlWindowFunctionKind::SUM_INTERNAL) {
+      output.push_back(null_output);
+      continue;
+    }
+    output.push_back(window_func_ti.is_fp()
+                         ? to_output_slot(static_cast<double>(frame_aggregates[pos]))
+                         : static_cast<int64_t>(frame_aggregates[pos]));
+  }
+  return output;
+}
+
+}  // namespace
+
+std::vector<std::pair<size_t, size_t>> WindowFunctionContext::computeFrameBounds(
+    const std::vector<int64_t>& window_order,
+    const int32_t* partition_indices,
+    const Comparator& comparator) const {
+  const auto& frame = window_func_->getFrame();
+  CHECK(frame);
+  const int64_t partition_size = window_order.size();
+  // The frame bound positions are relative to the current row for ROWS frames and to
+  // the order key of the current row for RANGE frames, in which case peer rows share
+  // the same frame.
+  std::vector<int64_t> peer_group_begin;
+  std::vector<int64_t> peer_group_end;
+  std::vector<double> keys;
+  std::vector<bool> key_is_null;
+  int64_t non_null_begin = 0;
+  int64_t non_null_end = 0;
+  if (!frame->is_rows) {
+    peer_group_begin.resize(partition_size);
+    peer_group_end.resize(partition_size);
+    for (int64_t pos = 0; pos < partition_size; ++pos) {
+      peer_group_begin[pos] =
+          pos > 0 && !comparator(window_order[pos - 1], window_order[pos])
+              ? peer_group_begin[pos - 1]
+              : pos;
+    }
+    for (int64_t pos = partition_size - 1; pos >= 0; --pos) {
+      peer_group_end[pos] = pos + 1 < partition_size &&
+                                    !comparator(window_order[pos], window_order[pos + 1])
+                                ? peer_group_end[pos + 1]
+                                : pos + 1;
+    }
+  }
+  if (!frame->is_rows &&
+      (is_offset_frame_bound(frame->lower_bound) ||
+       is_offset_frame_bound(frame->upper_bound))) {
+    CHECK_EQ(order_columns_.size(), size_t(1));
+    const auto order_col = dynamic_cast<const Analyzer::ColumnVar*>(
+        window_func_->getOrderKeys().front().get());
+    CHECK(order_col);
+    const auto& order_ti = order_col->get_type_info();
+    const bool is_desc = window_func_->getCollation().front().is_desc;
+    keys.resize(partition_size);
+    key_is_null.resize(partition_size);
+    for (int64_t pos = 0; pos < partition_size; ++pos) {
+      const auto row = partition_indices[window_order[pos]];
+      double key{0};
+      if (order_ti.is_fp()) {
+        key_is_null[pos] = !read_fp_value(order_columns_.front(), order_ti, row, key);
+      } else {
+        int64_t int_key{0};
+        key_is_null[pos] =
+            !read_integer_value(order_columns_.front(), order_ti, row, int_key);
+        key = int_key;
+      }
+      // Negating the keys of a descending order makes the search below uniform.
+      keys[pos] = is_desc ? -key : key;
+    }
+    // Nulls are sorted either first or last, the non-null keys are ascending in between.
+    while (non_null_begin < partition_size && key_is_null[non_null_begin]) {
+      ++non_null_begin;
+    }
+    non_null_end = partition_size;
+    while (non_null_end > non_null_begin && key_is_null[non_null_end - 1]) {
+      --non_null_end;
+    }
+  }
+  // Returns the position of the first row of the frame for the lower bound, the position
+  // past the last row of the frame for the upper bound.
+  const auto get_bound_pos = [&](const Analyzer::WindowFrameBound& bound,
+                                 const int64_t pos,
+                                 const bool is_lower) -> int64_t {
+    const int64_t past_current = is_lower ? 0 : 1;
+    switch (bound.bound_type) {
+      case SqlWindowFrameBoundType::UNBOUNDED_PRECEDING: {
+        return 0;
+      }
+      case SqlWindowFrameBoundType::UNBOUNDED_FOLLOWING: {
+        return partition_size;
+      }
+      case SqlWindowFrameBoundType::CURRENT_ROW: {
+        if (frame->is_rows) {
+          return pos + past_current;
+        }
+        return is_lower ? peer_group_begin[pos] : peer_group_end[pos];
+      }
+      case SqlWindowFrameBoundType::EXPR_PRECEDING:
+      case SqlWindowFrameBoundType::EXPR_FOLLOWING: {
+        const bool is_preceding =
+            bound.bound_type == SqlWindowFrameBoundType::EXPR_PRECEDING;
+        if (frame->is_rows) {
+          const auto offset = std::min(bound.offset, partition_size);
+          return (is_preceding ? pos - offset : pos + offset) + past_current;
+        }
+        if (key_is_null[pos]) {
+          return is_lower ? peer_group_begin[pos] : peer_group_end[pos];
+        }
+        const double offset = bound.offset;
+        const auto target = is_preceding ? keys[pos] - offset : keys[pos] + offset;
+        const auto non_null_keys_begin = keys.begin() + non_null_begin;
+        const auto non_null_keys_end = keys.begin() + non_null_end;
+        const auto it =
+            is_lower ? std::lower_bound(non_null_keys_begin, non_null_keys_end, target)
+                     : std::upper_bound(non_null_keys_begin, non_null_keys_end, target);
+        return it - keys.begin();
+      }
+      default: {
+        LOG(FATAL) << "Invalid window frame bound";
+      }
+    }
+    return 0;
+  };
+  std::vector<std::pair<size_t, size_t>> frame_bounds;
+  frame_bounds.reserve(partition_size);
+  for (int64_t pos = 0; pos < partition_size; ++pos) {
+    const auto begin = std::min(
+        std::max(get_bound_pos(frame->lower_bound, pos, true), int64_t(0)),
+        partition_size);
+    const auto end = std::min(
+        std::max(get_bound_pos(frame->upper_bound, pos, false), begin), partition_size);
+    frame_bounds.emplace_back(begin, end);
+  }
+  return frame_bounds;
+}
+
+void WindowFunctionContext::computeFramePartition(int64_t* output_for_partition_buff,
+                                                  const size_t partition_size,
+                                                  const int32_t* partition_indices,
+                                                  const Comparator& comparator) const {
+  const std::vector<int64_t> window_order(output_for_partition_buff,
+                                          output_for_partition_buff + partition_size);
+  const auto frame_bounds =
+      computeFrameBounds(window_order, partition_indices, comparator);
+  std::vector<int64_t> frame_aggregates;
+  const auto& args = window_func_->getArgs();
+  if (args.empty()) {
+    // COUNT(*) counts all the rows in the frame.
+    CHECK(window_func_->getKind() == SqlWindowFunctionKind::COUNT);
+    frame_aggregates.reserve(partition_size);
+    for (const auto& bounds : frame_bounds) {
+      frame_aggregates.push_back(bounds.second - bounds.first);
+    }
+  } else {
+    CHECK(frame_arg_column_);
+    const auto& arg_ti = args.front()->get_type_info();
+    std::vector<bool> nulls(partition_size);
+    if (arg_ti.is_fp()) {
+      std::vector<double> values(partition_size);
+      for (size_t pos = 0; pos < partition_size; ++pos) {
+        nulls[pos] = !read_fp_value(frame_arg_column_,
+                                    arg_ti,
+                                    partition_indices[window_order[pos]],
+                                    values[pos]);
+      }
+      frame_aggregates =
+          compute_frame_aggregates(window_func_, values, nulls, frame_bounds);
+    } else {
+      std::vector<int64_t> values(partition_size);
+      for (size_t pos = 0; pos < partition_size; ++pos) {
+        nulls[pos] = !read_integer_value(frame_arg_column_,
+                                         arg_ti,
+                                         partition_indices[window_order[pos]],
+                                         values[pos]);
+      }
+      frame_aggregates =
+          compute_frame_aggregates(window_func_, values, nulls, frame_bounds);
+    }
+  }
+  for (size_t pos = 0; pos < partition_size; ++pos) {
+    output_for_partition_buff[window_order[pos]] = frame_aggregates[pos];
+  }
+}
+
 void WindowFunctionContext::fillPartitionStart() {
   CountDistinctDescriptor partition_start_bitmap{CountDistinctImplType::Bitmap,
                                                  0,
@@ -55,6 +55,15 @@ inline bool window_function_is_aggregate(const SqlWindowFunctionKind kind) {
   }
 }
 
+// Returns true for aggregate window functions computed over the default frame, which are
+// evaluated by the generated code while iterating the partition in window order. Window
+// functions with an explicit frame are entirely computed by the window context instead.
+inline bool window_function_is_cumulative_aggregate(
+    const Analyzer::WindowFunction* window_func) {
+  return window_function_is_aggregate(window_func->getKind()) &&
+         !window_func->getFrame();
+}
+
 // Per-window function context which encapsulates the logic for computing the various
 // window function kinds and keeps ownership of buffers which contain the results. For
 // rank functions, the code generated for the projection simply reads the values and
@@ -79,6 +88,13 @@ class WindowFunctionContext {
                       const Analyzer::ColumnVar* col_var,
                       const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
 
+  // Adds the argument column buffer of an aggregate with an explicit frame to the context
+  // and keeps ownership of it.
+  void addFrameArgColumn(
+      const int8_t* column,
+      const Analyzer::ColumnVar* col_var,
+      const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
+
   // Computes the window function result to be used during the actual projection query.
   void compute();
 
@@ -112,7 +128,59 @@ class WindowFunctionContext {
   // Gets the row number expression for this window function.
   llvm::Value* getRowNumber() const;
 
-  using Comparator = std::function<bool(const int64_t lhs, const int64_t rhs)>;
+  // Lexicographic comparator on the order keys for the rows of a partition, given as
+  // positions in the partition. Uses a comparison specialized for the type of each order
+  // column, which avoids the indirect calls of a chain of std::function objects on the
+  // sort hot path.
+  class Comparator {
+   public:
+    // Three-way comparison of two rows on a single order column, ascending.
+    using CompareFunction = int (*)(const int8_t* order_column_buffer,
+                                    const int64_t null_val,
+                                    const bool nulls_first,
+                                    const int32_t* partition_indices,
+                                    const int64_t lhs,
+                                    const int64_t rhs);
+
+    Comparator(const int32_t* partition_indices)
+        : partition_indices_(partition_indices) {}
+
+    void addOrderColumn(const CompareFunction compare,
+                        const int8_t* order_column_buffer,
+                        const int64_t null_val,
+                        const bool nulls_first,
+                        const bool is_desc) {
+      order_columns_.push_back(
+          {compare, order_column_buffer, null_val, nulls_first, is_desc});
+    }
+
+    bool operator()(const int64_t lhs, const int64_t rhs) const {
+      for (const auto& order_column : order_columns_) {
+        const auto result = order_column.compare(order_column.buffer,
+                                                 order_column.null_val,
+                                                 order_column.nulls_first,
+                                                 partition_indices_,
+                                                 lhs,
+                                                 rhs);
+        if (result) {
+          return order_column.is_desc ? result > 0 : result < 0;
+        }
+      }
+      return false;
+    }
+
+   private:
+    struct OrderColumn {
+      CompareFunction compare;
+      const int8_t* buffer;
+      int64_t null_val;
+      bool nulls_first;
+      bool is_desc;
+    };
+
+    const int32_t* partition_indices_;
+    std::vector<OrderColumn> order_columns_;
+  };
 
  private:
   // State for a window aggregate. The count field is only used for average.
@@ -123,17 +191,28 @@ class WindowFunctionContext {
     llvm::Value* row_number = nullptr;
   };
 
-  static Comparator makeComparator(const Analyzer::ColumnVar* col_var,
-                                   const int8_t* partition_values,
-                                   const int32_t* partition_indices,
-                                   const bool nulls_first);
-
-  void computePartition(
-      int64_t* output_for_partition_buff,
-      const size_t partition_size,
-      const size_t off,
-      const Analyzer::WindowFunction* window_func,
-      const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator);
+  Comparator makeComparator(const int32_t* partition_indices) const;
+
+  void computePartition(int64_t* output_for_partition_buff,
+                        const size_t partition_size,
+                        const size_t off,
+                        const Analyzer::WindowFunction* window_func,
+                        const Comparator& comparator,
+                        std::vector<int64_t>& partition_end_positions) const;
+
+  // Computes an aggregate with an explicit frame for every row of the sorted partition
+  // and writes the results in the partition buffer, indexed by position in the
+  // partition.
+  void computeFramePartition(int64_t* output_for_partition_buff,
+                             const size_t partition_size,
+                             const int32_t* partition_indices,
+                             const Comparator& comparator) const;
+
+  // Returns the [begin, end) range of every row's frame, in window order.
+  std::vector<std::pair<size_t, size_t>> computeFrameBounds(
+      const std::vector<int64_t>& window_order,
+      const int32_t* partition_indices,
+      const Comparator& comparator) const;
 
   void fillPartitionStart();
 
@@ -152,6 +231,10 @@ class WindowFunctionContext {
   std::vector<std::vector<std::shared_ptr<Chunk_NS::Chunk>>> order_columns_owner_;
   // Order column buffers.
   std::vector<const int8_t*> order_columns_;
+  // Keeps ownership of the argument column of an aggregate with an explicit frame.
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> frame_arg_column_owner_;
+  // Argument column buffer of an aggregate with an explicit frame.
+  const int8_t* frame_arg_column_;
   // Hash table which contains the partitions specified by the window.
   std::shared_ptr<JoinHashTableInterface> partitions_;
   // The number of elements in the table.
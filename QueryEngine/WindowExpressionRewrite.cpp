@@ -36,11 +36,25 @@ bool matches_gt_bigint_zero(const Analyzer::BinOper* window_gt_zero) {
          zero->get_constval().bigintval == 0;
 }
 
+// Returns true iff both window functions have the default frame or the same explicit one.
+bool frames_match(const Analyzer::WindowFunction* lhs_window_expr,
+                  const Analyzer::WindowFunction* rhs_window_expr) {
+  const auto& lhs_frame = lhs_window_expr->getFrame();
+  const auto& rhs_frame = rhs_window_expr->getFrame();
+  if (!lhs_frame || !rhs_frame) {
+    return !lhs_frame && !rhs_frame;
+  }
+  return *lhs_frame == *rhs_frame;
+}
+
 // Returns true iff the sum and the count match in type and arguments. Used to replace
 // combination can be replaced with an explicit average.
 bool window_sum_and_count_match(const Analyzer::WindowFunction* sum_window_expr,
                                 const Analyzer::WindowFunction* count_window_expr) {
   CHECK_EQ(count_window_expr->get_type_info().get_type(), kBIGINT);
+  if (!frames_match(sum_window_expr, count_window_expr)) {
+    return false;
+  }
   return expr_list_match(sum_window_expr->getArgs(), count_window_expr->getArgs());
 }
 
@@ -91,7 +105,8 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_sum_window(const Analyzer::Exp
                                             sum_window_expr->getArgs(),
                                             sum_window_expr->getPartitionKeys(),
                                             sum_window_expr->getOrderKeys(),
-                                            sum_window_expr->getCollation());
+                                            sum_window_expr->getCollation(),
+                                            sum_window_expr->getFrame());
 }
 
 std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Expr* expr) {
@@ -121,7 +136,8 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Exp
                                sum_window_expr->get_type_info().get_type()) {
     return nullptr;
   }
-  if (!expr_list_match(sum_window_expr.get()->getArgs(), count_window->getArgs())) {
+  if (!expr_list_match(sum_window_expr.get()->getArgs(), count_window->getArgs()) ||
+      !frames_match(sum_window_expr.get(), count_window)) {
     return nullptr;
   }
   return makeExpr<Analyzer::WindowFunction>(SQLTypeInfo(kDOUBLE),
@@ -129,5 +145,6 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Exp
                                             sum_window_expr->getArgs(),
                                             sum_window_expr->getPartitionKeys(),
                                             sum_window_expr->getOrderKeys(),
-                                            sum_window_expr->getCollation());
+                                            sum_window_expr->getCollation(),
+                                            sum_window_expr->getFrame());
 }
@@ -24,6 +24,9 @@ llvm::Value* Executor::codegenWindowFunction(const size_t target_index,
   const auto window_func_context =
       WindowProjectNodeContext::get()->activateWindowFunctionContext(target_index);
   const auto window_func = window_func_context->getWindowFunction();
+  if (window_func->getFrame()) {
+    return codegenWindowFunctionFrame(window_func_context);
+  }
   switch (window_func->getKind()) {
     case SqlWindowFunctionKind::ROW_NUMBER:
     case SqlWindowFunctionKind::RANK:
@@ -119,6 +122,31 @@ SQLTypeInfo get_adjusted_window_type_info(const Analyzer::WindowFunction* window
 
 }  // namespace
 
+llvm::Value* Executor::codegenWindowFunctionFrame(
+    const WindowFunctionContext* window_func_context) {
+  // Aggregates with an explicit frame are entirely computed by the window context, the
+  // generated code only reads the result for the current row.
+  const auto window_func = window_func_context->getWindowFunction();
+  const auto& window_func_ti = window_func->get_type_info();
+  CodeGenerator code_generator(this);
+  const auto output_lv =
+      cgen_state_->llInt(reinterpret_cast<const int64_t>(window_func_context->output()));
+  if (window_func->getKind() == SqlWindowFunctionKind::AVG) {
+    return cgen_state_->emitCall("percent_window_func",
+                                 {output_lv, code_generator.posArg(nullptr)});
+  }
+  if (window_func_ti.is_fp()) {
+    const auto double_lv = cgen_state_->emitCall(
+        "percent_window_func", {output_lv, code_generator.posArg(nullptr)});
+    return window_func_ti.get_type() == kFLOAT
+               ? cgen_state_->ir_builder_.CreateFPTrunc(
+                     double_lv, get_fp_type(32, cgen_state_->context_))
+               : double_lv;
+  }
+  return cgen_state_->emitCall("row_number_window_func",
+                               {output_lv, code_generator.posArg(nullptr)});
+}
+
 llvm::Value* Executor::aggregateWindowStatePtr() {
   const auto window_func_context =
       WindowProjectNodeContext::getActiveWindowFunctionContext();
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Shared/Logger.h"
+
+#include <algorithm>
+#include <vector>
+
+// Aggregates a window partition laid out in window order, answering the aggregate over
+// any range of rows in O(log n). Used for window functions with an explicit frame, where
+// the frames of consecutive rows overlap and recomputing each of them from scratch would
+// be quadratic in the frame size. AggOp must be associative and commutative, nulls are
+// expected to be replaced by the identity of the operation.
+template <class T, class AggOp>
+class WindowSegmentTree {
+ public:
+  WindowSegmentTree(const std::vector<T>& values, const T identity)
+      : leaf_count_(values.size()), identity_(identity), nodes_(2 * values.size()) {
+    std::copy(values.begin(), values.end(), nodes_.begin() + leaf_count_);
+    for (size_t i = leaf_count_; i-- > 1;) {
+      nodes_[i] = AggOp()(nodes_[2 * i], nodes_[2 * i + 1]);
+    }
+  }
+
+  // Returns the aggregate of the values in the [begin, end) range.
+  T query(size_t begin, size_t end) const {
+    CHECK_LE(begin, end);
+    CHECK_LE(end, leaf_count_);
+    T result = identity_;
+    for (begin += leaf_count_, end += leaf_count_; begin < end; begin /= 2, end /= 2) {
+      if (begin & 1) {
+        result = AggOp()(result, nodes_[begin++]);
+      }
+      if (end & 1) {
+        result = AggOp()(result, nodes_[--end]);
+      }
+    }
+    return result;
+  }
+
+ private:
+  const size_t leaf_count_;
+  const T identity_;
+  std::vector<T> nodes_;
+};
+
+template <class T>
+struct WindowSumOp {
+  T operator()(const T lhs, const T rhs) const { return lhs + rhs; }
+};
+
+template <class T>
+struct WindowMinOp {
+  T operator()(const T lhs, const T rhs) const { return std::min(lhs, rhs); }
+};
+
+template <class T>
+struct WindowMaxOp {
+  T operator()(const T lhs, const T rhs) const { return std::max(lhs, rhs); }
+};
@@ -343,12 +343,13 @@ ExecutionResult run_select_query_with_filter_push_down(
     const bool hoist_literals,
     const bool allow_loop_joins,
     const bool just_explain,
+    const ExecutorExplainType explain_type,
     const bool with_filter_push_down) {
   auto const& query_state = query_state_proxy.getQueryState();
   const auto& cat = query_state.getConstSessionInfo()->getCatalog();
   auto executor = Executor::getExecutor(cat.getCurrentDB().dbId);
   CompilationOptions co = {
-      device_type, true, ExecutorOptLevel::LoopStrengthReduction, false};
+      device_type, true, ExecutorOptLevel::LoopStrengthReduction, false, explain_type};
   ExecutionOptions eo = {g_enable_columnar_output,
                          true,
                          just_explain,
@@ -415,7 +416,8 @@ ExecutionResult QueryRunner::runSelectQuery(const std::string& query_str,
                                             const ExecutorDeviceType device_type,
                                             const bool hoist_literals,
                                             const bool allow_loop_joins,
-                                            const bool just_explain) {
+                                            const bool just_explain,
+                                            const ExecutorExplainType explain_type) {
   CHECK(session_info_);
   CHECK(!Catalog_Namespace::SysCatalog::instance().isAggregator());
   auto query_state = create_query_state(session_info_, query_str);
@@ -426,13 +428,14 @@ ExecutionResult QueryRunner::runSelectQuery(const std::string& query_str,
                                                   hoist_literals,
                                                   allow_loop_joins,
                                                   just_explain,
+                                                  explain_type,
                                                   g_enable_filter_push_down);
   }
 
   const auto& cat = session_info_->getCatalog();
   auto executor = Executor::getExecutor(cat.getCurrentDB().dbId);
   CompilationOptions co = {
-      device_type, true, ExecutorOptLevel::LoopStrengthReduction, false};
+      device_type, true, ExecutorOptLevel::LoopStrengthReduction, false, explain_type};
   ExecutionOptions eo = {g_enable_columnar_output,
                          true,
                          just_explain,
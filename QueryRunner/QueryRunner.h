@@ -143,7 +143,9 @@ class QueryRunner {
                                          const ExecutorDeviceType device_type,
                                          const bool hoist_literals,
                                          const bool allow_loop_joins,
-                                         const bool just_explain = false);
+                                         const bool just_explain = false,
+                                         const ExecutorExplainType explain_type =
+                                             ExecutorExplainType::Default);
   virtual std::vector<std::shared_ptr<ResultSet>> runMultipleStatements(
       const std::string&,
       const ExecutorDeviceType);
@@ -768,6 +768,10 @@ void print_memory_info(ClientContext& context, std::string memory_level) {
           << " MB" << std::endl;
       tss << "Memory allocated: " << (nodeIt.num_pages_allocated * nodeIt.page_size) / MB
           << " MB" << std::endl;
+      if (nodeIt.join_hash_table_cache_bytes) {
+        tss << "Join hash table cache: " << nodeIt.join_hash_table_cache_bytes / MB
+            << " MB" << std::endl;
+      }
     } else {
       ++mgr_num;
     }
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHARED_HOSTBUFFERPOOL_H
+#define SHARED_HOSTBUFFERPOOL_H
+
+#include "Shared/checked_alloc.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+// Keeps large host buffers released by their users for reuse by the next allocations
+// of a similar size. The pages of a reused buffer are already faulted in, which saves
+// the page faults and the kernel zeroing a fresh allocation pays on first touch.
+//
+// Buffers are rounded up to power of two size classes, each with its own free list and
+// lock. Smaller buffers aren't worth caching and go straight to malloc. The memory kept
+// idle in the pool is capped, buffers released beyond the cap are freed. Buffers of a
+// size class the cap can't hold, which includes all of them when the pool is disabled,
+// are allocated with their exact size and freed on release.
+class HostBufferPool {
+ public:
+  static constexpr size_t kMinSizeClassLog2{16};  // 64 KB
+  static constexpr size_t kMaxSizeClassLog2{40};  // 1 TB
+
+  explicit HostBufferPool(const size_t max_cached_bytes)
+      : max_cached_bytes_(max_cached_bytes), cached_bytes_(0) {}
+
+  ~HostBufferPool() { setMaxCachedBytes(0); }
+
+  // Returns a buffer of at least num_bytes, which must be given back through release()
+  // with the same size. The first num_bytes are zeroed if zero_fill is set.
+  int8_t* allocate(const size_t num_bytes, const bool zero_fill) {
+    const auto size_class_log2 = getSizeClassLog2(num_bytes);
+    const size_t class_bytes = size_t(1) << size_class_log2;
+    // rounding up to the size class only pays off if the pool can keep the buffer
+    if (!size_class_log2 || class_bytes > max_cached_bytes_.load()) {
+      return static_cast<int8_t*>(zero_fill ? checked_calloc(num_bytes, 1)
+                                            : checked_malloc(num_bytes));
+    }
+    auto& free_list = free_lists_[size_class_log2 - kMinSizeClassLog2];
+    int8_t* buffer{nullptr};
+    {
+      std::lock_guard<std::mutex> lock(free_list.mutex);
+      if (!free_list.buffers.empty()) {
+        buffer = free_list.buffers.back();
+        free_list.buffers.pop_back();
+        free_list.allocated_buffers.insert(buffer);
+      }
+    }
+    if (buffer) {
+      cached_bytes_ -= class_bytes;
+      if (zero_fill) {
+        memset(buffer, 0, num_bytes);
+      }
+      return buffer;
+    }
+    buffer = static_cast<int8_t*>(zero_fill ? checked_calloc(class_bytes, 1)
+                                            : checked_malloc(class_bytes));
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    free_list.allocated_buffers.insert(buffer);
+    return buffer;
+  }
+
+  void release(int8_t* buffer, const size_t num_bytes) {
+    if (!buffer) {
+      return;
+    }
+    const auto size_class_log2 = getSizeClassLog2(num_bytes);
+    if (!size_class_log2) {
+      free(buffer);
+      return;
+    }
+    const size_t class_bytes = size_t(1) << size_class_log2;
+    auto& free_list = free_lists_[size_class_log2 - kMinSizeClassLog2];
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    if (!free_list.allocated_buffers.erase(buffer)) {
+      // allocated with its exact size while the pool couldn't keep it
+      free(buffer);
+      return;
+    }
+    auto cached_bytes = cached_bytes_.load();
+    do {
+      if (cached_bytes + class_bytes > max_cached_bytes_.load()) {
+        free(buffer);
+        return;
+      }
+    } while (!cached_bytes_.compare_exchange_weak(cached_bytes,
+                                                  cached_bytes + class_bytes));
+    free_list.buffers.push_back(buffer);
+  }
+
+  // Frees cached buffers, starting with the largest ones, until the pool fits the cap.
+  void setMaxCachedBytes(const size_t max_cached_bytes) {
+    max_cached_bytes_ = max_cached_bytes;
+    for (size_t i = free_lists_.size(); i > 0 && cached_bytes_ > max_cached_bytes; --i) {
+      auto& free_list = free_lists_[i - 1];
+      const size_t class_bytes = size_t(1) << (i - 1 + kMinSizeClassLog2);
+      std::lock_guard<std::mutex> lock(free_list.mutex);
+      while (!free_list.buffers.empty() && cached_bytes_ > max_cached_bytes) {
+        free(free_list.buffers.back());
+        free_list.buffers.pop_back();
+        cached_bytes_ -= class_bytes;
+      }
+    }
+  }
+
+  size_t getMaxCachedBytes() const { return max_cached_bytes_; }
+
+  size_t getCachedBytes() const { return cached_bytes_; }
+
+ private:
+  // Returns zero for the sizes which aren't pooled.
+  static size_t getSizeClassLog2(const size_t num_bytes) {
+    if (num_bytes <= (size_t(1) << (kMinSizeClassLog2 - 1)) ||
+        num_bytes > (size_t(1) << kMaxSizeClassLog2)) {
+      return 0;
+    }
+    size_t size_class_log2{kMinSizeClassLog2};
+    while ((size_t(1) << size_class_log2) < num_bytes) {
+      ++size_class_log2;
+    }
+    return size_class_log2;
+  }
+
+  struct FreeList {
+    std::vector<int8_t*> buffers;
+    std::unordered_set<int8_t*> allocated_buffers;  // size class sized, in use
+    std::mutex mutex;
+  };
+
+  std::array<FreeList, kMaxSizeClassLog2 - kMinSizeClassLog2 + 1> free_lists_;
+  std::atomic<size_t> max_cached_bytes_;
+  std::atomic<size_t> cached_bytes_;
+};
+
+#endif  // SHARED_HOSTBUFFERPOOL_H
@@ -39,6 +39,14 @@ struct MapDParameters {
   bool is_decr_start_epoch;         // are we doing a start epoch decrement?
   size_t cpu_buffer_mem_bytes = 0;  // max size of memory reserved for CPU buffers [bytes]
   size_t gpu_buffer_mem_bytes = 0;  // max size of memory reserved for GPU buffers [bytes]
+  bool cpu_buffer_huge_pages = false;       // back the CPU buffer pool with huge pages
+  bool cpu_buffer_numa_interleave = false;  // interleave CPU buffers across NUMA nodes
+  bool cpu_buffer_mmap_reads = false;       // map eligible chunks instead of reading them
+  size_t cpu_buffer_compressed_cache_bytes = 0;  // evicted chunks kept compressed [bytes]
+  size_t hot_chunks_record_interval = 0;  // seconds between hot chunk records, 0 is off
+  size_t hot_chunks_preload_bytes_per_sec = 256 << 20;  // hot chunk preload rate cap
+  size_t query_memory_budget_bytes = 0;     // host memory a query may hold, 0 is no cap
+  size_t query_memory_watermark_bytes = 0;  // queue queries over this, 0 admits all
   double gpu_input_mem_limit = 0.9;  // Punt query to CPU if input mem exceeds % GPU mem
   std::string ssl_cert_file = "";    // file path to server's certified PKI certificate
   std::string ssl_key_file = "";     // file path to server's' private PKI key
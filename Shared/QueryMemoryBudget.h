@@ -0,0 +1,70 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHARED_QUERYMEMORYBUDGET_H
+#define SHARED_QUERYMEMORYBUDGET_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+class QueryMemoryBudgetExceeded : public std::runtime_error {
+ public:
+  QueryMemoryBudgetExceeded(const size_t requested_bytes,
+                            const size_t used_bytes,
+                            const size_t max_bytes)
+      : std::runtime_error("Query memory budget of " + std::to_string(max_bytes) +
+                           " bytes exceeded, " + std::to_string(requested_bytes) +
+                           " bytes requested with " + std::to_string(used_bytes) +
+                           " bytes in use") {}
+};
+
+// Accounts for the host memory a query holds: its output buffers, the buffer pool
+// chunks it has pinned and the hash tables it builds. Charges which would take the
+// query over its budget throw QueryMemoryBudgetExceeded. A zero budget only accounts.
+class QueryMemoryBudget {
+ public:
+  explicit QueryMemoryBudget(const size_t max_bytes)
+      : max_bytes_(max_bytes), used_bytes_(0), peak_bytes_(0) {}
+
+  void charge(const size_t num_bytes) {
+    const size_t used_bytes = used_bytes_.fetch_add(num_bytes) + num_bytes;
+    if (max_bytes_ && used_bytes > max_bytes_) {
+      used_bytes_ -= num_bytes;
+      throw QueryMemoryBudgetExceeded(num_bytes, used_bytes - num_bytes, max_bytes_);
+    }
+    auto peak_bytes = peak_bytes_.load();
+    while (used_bytes > peak_bytes &&
+           !peak_bytes_.compare_exchange_weak(peak_bytes, used_bytes)) {
+    }
+  }
+
+  void release(const size_t num_bytes) { used_bytes_ -= num_bytes; }
+
+  size_t getMaxBytes() const { return max_bytes_; }
+
+  size_t getUsedBytes() const { return used_bytes_; }
+
+  size_t getPeakBytes() const { return peak_bytes_; }
+
+ private:
+  const size_t max_bytes_;
+  std::atomic<size_t> used_bytes_;
+  std::atomic<size_t> peak_bytes_;
+};
+
+#endif  // SHARED_QUERYMEMORYBUDGET_H
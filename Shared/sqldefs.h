@@ -89,6 +89,14 @@ enum class SqlWindowFunctionKind {
   SUM_INTERNAL  // For deserialization from Calcite only. Gets rewritten to a regular SUM.
 };
 
+enum class SqlWindowFrameBoundType {
+  UNBOUNDED_PRECEDING,
+  EXPR_PRECEDING,
+  CURRENT_ROW,
+  EXPR_FOLLOWING,
+  UNBOUNDED_FOLLOWING
+};
+
 enum SQLStmtType { kSELECT, kUPDATE, kINSERT, kDELETE, kCREATE_TABLE };
 
 enum StorageOption { kDISK = 0, kGPU = 1, kCPU = 2 };
@@ -0,0 +1,290 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STRINGDICTIONARY_CONCURRENTLRUCACHE_HPP
+#define STRINGDICTIONARY_CONCURRENTLRUCACHE_HPP
+
+#include "../Shared/mapd_shared_mutex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Thread safe cache, for caches shared by concurrent queries. Entries are spread over
+// independently locked shards by the hash of their key, and lookups only take a shared
+// lock on their shard: recency is tracked with a reference counter per entry and
+// eviction follows the CLOCK approximation of LRU. Entries which are expensive to
+// recompute can be inserted with more credits, the number of sweeps of the clock hand
+// they survive after their last use. Each shard gets an equal part of the entry count
+// budget. The size budget applies to the whole cache, an insertion evicts from its own
+// shard first and from the other shards if that isn't enough, one shard at a time; the
+// size of an entry is given by an optional function of the value.
+// Lookups return shared ownership of the value, which remains valid after a concurrent
+// eviction.
+template <typename key_t, typename value_t, class hash_t = std::hash<key_t>>
+class ConcurrentLruCache {
+ public:
+  using value_ptr_t = std::shared_ptr<value_t>;
+  using size_func_t = std::function<size_t(const value_t&)>;
+  // Called with the shard lock held, must not access the cache.
+  using eviction_callback_t = std::function<void(const key_t&, const value_t&)>;
+
+  ConcurrentLruCache(const size_t max_entries,
+                     const size_t shard_count = default_shard_count,
+                     const size_t max_size_bytes = 0,
+                     size_func_t size_func = nullptr,
+                     eviction_callback_t eviction_callback = nullptr)
+      : shards_(std::max(std::min(shard_count, max_entries), size_t(1)))
+      , size_func_(std::move(size_func))
+      , eviction_callback_(std::move(eviction_callback)) {
+    setBudget(max_entries, max_size_bytes);
+  }
+
+  ConcurrentLruCache(const ConcurrentLruCache&) = delete;
+  ConcurrentLruCache& operator=(const ConcurrentLruCache&) = delete;
+
+  // Inserts the value or replaces the value for an existing key, then evicts entries
+  // until the shard and the cache fit their budgets again. A value larger than the size
+  // budget isn't inserted.
+  void put(const key_t& key, value_t&& value, const size_t credits = 1) {
+    putImpl(key, std::make_shared<value_t>(std::move(value)), credits);
+  }
+
+  void put(const key_t& key, const value_t& value, const size_t credits = 1) {
+    putImpl(key, std::make_shared<value_t>(value), credits);
+  }
+
+  // Shares ownership of the value with the caller instead of copying it.
+  void put(const key_t& key, value_ptr_t value, const size_t credits = 1) {
+    putImpl(key, std::move(value), credits);
+  }
+
+  value_ptr_t get(const key_t& key) const {
+    auto& shard = getShard(key);
+    mapd_shared_lock<mapd_shared_mutex> lock(shard.mutex);
+    const auto it = shard.entries_map.find(key);
+    if (it == shard.entries_map.end()) {
+      return nullptr;
+    }
+    auto& entry = *it->second;
+    entry.credits.store(entry.max_credits, std::memory_order_relaxed);
+    return entry.value;
+  }
+
+  bool erase(const key_t& key) {
+    auto& shard = getShard(key);
+    mapd_unique_lock<mapd_shared_mutex> lock(shard.mutex);
+    const auto it = shard.entries_map.find(key);
+    if (it == shard.entries_map.end()) {
+      return false;
+    }
+    remove(shard, it->second);
+    return true;
+  }
+
+  // Erases the entries whose key matches the predicate, without running the eviction
+  // callback. Returns the number of erased entries.
+  template <typename KeyPredicate>
+  size_t eraseIf(KeyPredicate predicate) {
+    size_t erased_count{0};
+    for (auto& shard : shards_) {
+      mapd_unique_lock<mapd_shared_mutex> lock(shard.mutex);
+      for (auto entry_it = shard.entries.begin(); entry_it != shard.entries.end();) {
+        const auto current_it = entry_it++;
+        if (predicate(current_it->key)) {
+          remove(shard, current_it);
+          ++erased_count;
+        }
+      }
+    }
+    return erased_count;
+  }
+
+  void clear() {
+    for (auto& shard : shards_) {
+      mapd_unique_lock<mapd_shared_mutex> lock(shard.mutex);
+      shard.entries_map.clear();
+      shard.entries.clear();
+      shard.clock_hand = shard.entries.end();
+      size_bytes_ -= shard.size_bytes;
+      shard.size_bytes = 0;
+    }
+  }
+
+  // Changes the budgets and evicts the entries which no longer fit. A zero size budget
+  // means the size isn't limited.
+  void setBudget(const size_t max_entries, const size_t max_size_bytes) {
+    const size_t shard_count = shards_.size();
+    const auto max_entries_per_shard = std::max(
+        max_entries / shard_count + (max_entries % shard_count ? 1 : 0), size_t(1));
+    const auto prev_max_entries_per_shard =
+        max_entries_per_shard_.exchange(max_entries_per_shard);
+    const auto prev_max_size_bytes = max_size_bytes_.exchange(max_size_bytes);
+    if (prev_max_entries_per_shard == max_entries_per_shard &&
+        prev_max_size_bytes == max_size_bytes) {
+      return;
+    }
+    for (auto& shard : shards_) {
+      mapd_unique_lock<mapd_shared_mutex> lock(shard.mutex);
+      evict(shard, 0, 0);
+    }
+  }
+
+  size_t size() const {
+    size_t entry_count{0};
+    for (const auto& shard : shards_) {
+      mapd_shared_lock<mapd_shared_mutex> lock(shard.mutex);
+      entry_count += shard.entries_map.size();
+    }
+    return entry_count;
+  }
+
+  size_t sizeBytes() const { return size_bytes_; }
+
+  static constexpr size_t default_shard_count{16};
+  static constexpr size_t max_entry_credits{8};
+
+ private:
+  struct Entry {
+    Entry(const key_t& key,
+          value_ptr_t value,
+          const size_t size_bytes,
+          const uint8_t max_credits)
+        : key(key)
+        , value(std::move(value))
+        , size_bytes(size_bytes)
+        , max_credits(max_credits)
+        , credits(max_credits - 1) {}
+
+    const key_t key;
+    const value_ptr_t value;
+    const size_t size_bytes;
+    const uint8_t max_credits;
+    // Set back to the maximum on every lookup, which only holds the shared lock.
+    std::atomic<uint8_t> credits;
+  };
+
+  using entry_list_t = std::list<Entry>;
+  using entry_iterator_t = typename entry_list_t::iterator;
+
+  struct Shard {
+    Shard() : clock_hand(entries.end()) {}
+
+    mutable mapd_shared_mutex mutex;
+    entry_list_t entries;
+    std::unordered_map<key_t, entry_iterator_t, hash_t> entries_map;
+    entry_iterator_t clock_hand;
+    size_t size_bytes{0};
+  };
+
+  Shard& getShard(const key_t& key) const {
+    return shards_[hash_t()(key) % shards_.size()];
+  }
+
+  void remove(Shard& shard, const entry_iterator_t entry_it) {
+    if (shard.clock_hand == entry_it) {
+      ++shard.clock_hand;
+    }
+    shard.size_bytes -= entry_it->size_bytes;
+    size_bytes_ -= entry_it->size_bytes;
+    shard.entries_map.erase(entry_it->key);
+    shard.entries.erase(entry_it);
+  }
+
+  void putImpl(const key_t& key, value_ptr_t value, const size_t credits) {
+    const size_t size_bytes = size_func_ ? size_func_(*value) : 0;
+    const size_t max_size_bytes = max_size_bytes_;
+    auto& shard = getShard(key);
+    {
+      mapd_unique_lock<mapd_shared_mutex> lock(shard.mutex);
+      const auto it = shard.entries_map.find(key);
+      if (it != shard.entries_map.end()) {
+        remove(shard, it->second);
+      }
+      if (max_size_bytes && size_bytes > max_size_bytes) {
+        return;
+      }
+      evict(shard, 1, size_bytes);
+      // New entries go right behind the clock hand, they're the last ones it reaches.
+      const auto entry_it = shard.entries.emplace(
+          shard.clock_hand,
+          key,
+          value,
+          size_bytes,
+          static_cast<uint8_t>(
+              std::min(std::max(credits, size_t(1)), max_entry_credits)));
+      shard.entries_map.emplace(key, entry_it);
+      shard.size_bytes += size_bytes;
+      size_bytes_ += size_bytes;
+    }
+    // Only holds one shard lock at a time, the cache may exceed its size budget until
+    // the other shards are done evicting.
+    const size_t shard_idx = &shard - shards_.data();
+    for (size_t i = 1; i < shards_.size(); ++i) {
+      if (!max_size_bytes || size_bytes_ <= max_size_bytes) {
+        break;
+      }
+      auto& other_shard = shards_[(shard_idx + i) % shards_.size()];
+      mapd_unique_lock<mapd_shared_mutex> lock(other_shard.mutex);
+      evict(other_shard, 0, 0);
+    }
+  }
+
+  // Evicts entries from the shard until it has room for the incoming ones, and the cache
+  // too, or the shard is empty. Entries with credits left get another chance: the hand
+  // takes one of their credits and moves on.
+  void evict(Shard& shard,
+             const size_t incoming_entries,
+             const size_t incoming_size_bytes) {
+    const size_t max_entries_per_shard = max_entries_per_shard_;
+    const size_t max_size_bytes = max_size_bytes_;
+    while (!shard.entries.empty() &&
+           (shard.entries.size() + incoming_entries > max_entries_per_shard ||
+            (max_size_bytes && size_bytes_ + incoming_size_bytes > max_size_bytes))) {
+      if (shard.clock_hand == shard.entries.end()) {
+        shard.clock_hand = shard.entries.begin();
+      }
+      // No lookup runs concurrently, they'd need the shared lock.
+      const auto credits = shard.clock_hand->credits.load(std::memory_order_relaxed);
+      if (credits) {
+        shard.clock_hand->credits.store(credits - 1, std::memory_order_relaxed);
+        ++shard.clock_hand;
+        continue;
+      }
+      if (eviction_callback_) {
+        eviction_callback_(shard.clock_hand->key, *shard.clock_hand->value);
+      }
+      remove(shard, shard.clock_hand);
+    }
+  }
+
+  mutable std::vector<Shard> shards_;
+  std::atomic<size_t> max_entries_per_shard_{0};
+  std::atomic<size_t> max_size_bytes_{0};
+  // Sum of the sizes of the entries of all shards.
+  std::atomic<size_t> size_bytes_{0};
+  const size_func_t size_func_;
+  const eviction_callback_t eviction_callback_;
+};
+
+#endif  // STRINGDICTIONARY_CONCURRENTLRUCACHE_HPP
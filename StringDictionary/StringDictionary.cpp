@@ -28,6 +28,7 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/sort/spreadsort/string_sort.hpp>
 
+#include <algorithm>
 #include <future>
 #include <thread>
 
@@ -494,6 +495,49 @@ std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
   return result;
 }
 
+int32_t StringDictionary::getCharLength(const char* str,
+                                        const size_t str_len,
+                                        const bool utf8_chars) {
+  if (!utf8_chars) {
+    return str_len;
+  }
+  // Count the bytes which don't continue a multi-byte character.
+  int32_t char_count{0};
+  for (size_t i = 0; i < str_len; ++i) {
+    if ((str[i] & 0xc0) != 0x80) {
+      ++char_count;
+    }
+  }
+  return char_count;
+}
+
+std::vector<int32_t> StringDictionary::getCharLengths(const bool utf8_chars,
+                                                      const size_t generation) const {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  if (client_) {
+    return {};
+  }
+  CHECK_LE(generation, str_count_);
+  std::vector<int32_t> result(generation);
+  std::vector<std::thread> workers;
+  const size_t worker_count = std::min(static_cast<size_t>(cpu_threads()),
+                                       std::max(generation / 10000, size_t(1)));
+  const size_t stride = (generation + worker_count - 1) / worker_count;
+  for (size_t start = 0; start < generation; start += stride) {
+    const size_t end = std::min(start + stride, generation);
+    workers.emplace_back([&result, utf8_chars, start, end, this]() {
+      for (size_t string_id = start; string_id < end; ++string_id) {
+        const auto str_bytes = getStringBytesChecked(string_id);
+        result[string_id] = getCharLength(str_bytes.first, str_bytes.second, utf8_chars);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return result;
+}
+
 std::vector<int32_t> StringDictionary::getEquals(std::string pattern,
                                                  std::string comp_operator,
                                                  size_t generation) {
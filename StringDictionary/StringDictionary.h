@@ -77,6 +77,15 @@ class StringDictionary {
                                      const char escape,
                                      const size_t generation) const;
 
+  // Length of every string with an id below the generation, in UTF-8 characters or in
+  // bytes. Empty for a dictionary hosted on a remote server.
+  std::vector<int32_t> getCharLengths(const bool utf8_chars,
+                                      const size_t generation) const;
+
+  static int32_t getCharLength(const char* str,
+                               const size_t str_len,
+                               const bool utf8_chars);
+
   std::shared_ptr<const std::vector<std::string>> copyStrings() const;
 
   bool checkpoint() noexcept;
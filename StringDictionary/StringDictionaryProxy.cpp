@@ -202,6 +202,27 @@ std::vector<int32_t> StringDictionaryProxy::getRegexpLike(const std::string& pat
   return result;
 }
 
+std::pair<int32_t, std::vector<int32_t>> StringDictionaryProxy::getCharLengths(
+    const bool utf8_chars) const {
+  CHECK_GE(generation_, 0);
+  auto dict_lengths = string_dict_->getCharLengths(utf8_chars, generation_);
+  if (dict_lengths.size() != static_cast<size_t>(generation_)) {
+    return {0, {}};
+  }
+  if (transient_int_to_str_.empty()) {
+    return {0, std::move(dict_lengths)};
+  }
+  // The invalid id (-1) sits between the transient ids and the dictionary ones.
+  const int32_t min_id = transient_int_to_str_.begin()->first;
+  std::vector<int32_t> lengths(-min_id, 0);
+  for (const auto& kv : transient_int_to_str_) {
+    lengths[kv.first - min_id] =
+        StringDictionary::getCharLength(kv.second.data(), kv.second.size(), utf8_chars);
+  }
+  lengths.insert(lengths.end(), dict_lengths.begin(), dict_lengths.end());
+  return {min_id, std::move(lengths)};
+}
+
 int32_t StringDictionaryProxy::getOrAdd(const std::string& str) noexcept {
   return string_dict_->getOrAdd(str);
 }
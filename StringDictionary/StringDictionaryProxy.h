@@ -56,6 +56,10 @@ class StringDictionaryProxy {
 
   std::vector<int32_t> getRegexpLike(const std::string& pattern, const char escape) const;
 
+  // Lengths of the transient and dictionary strings, for the consecutive ids starting
+  // at the returned one. Transient ids are negative, below the dictionary ones.
+  std::pair<int32_t, std::vector<int32_t>> getCharLengths(const bool utf8_chars) const;
+
   const std::map<int32_t, std::string> getTransientMapping() const {
     return transient_int_to_str_;
   }
@@ -0,0 +1,566 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../DataMgr/BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
+#include "../DataMgr/FileMgr/GlobalFileMgr.h"
+#include "../DataMgr/HotChunks.h"
+#include "Shared/Logger.h"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using namespace Buffer_Namespace;
+using namespace File_Namespace;
+
+namespace {
+
+const std::string kDataPath{std::string(BASE_PATH) + "/buffer_mgr_test"};
+constexpr size_t kFilePageSize{2 << 20};
+constexpr size_t kChunkInts{256 * 1024};
+constexpr size_t kChunkBytes{kChunkInts * sizeof(int32_t)};
+constexpr int kNumChunks{8};
+// the last chunk is random and doesn't compress
+constexpr int kRandomChunk{kNumChunks - 1};
+
+ChunkKey chunk_key(const int chunk_id) {
+  return {1, 1, 1, chunk_id};
+}
+
+std::vector<int32_t> chunk_values(const int chunk_id) {
+  std::vector<int32_t> values(kChunkInts);
+  std::mt19937 gen(chunk_id);
+  for (size_t i = 0; i < kChunkInts; ++i) {
+    values[i] =
+        chunk_id == kRandomChunk ? static_cast<int32_t>(gen()) : i % 1000 + chunk_id;
+  }
+  return values;
+}
+
+class EvictedChunkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    boost::filesystem::remove_all(kDataPath);
+    boost::filesystem::create_directories(kDataPath);
+    file_mgr_.reset(new GlobalFileMgr(0, kDataPath, 0, kFilePageSize));
+    for (int chunk_id = 0; chunk_id < kNumChunks; ++chunk_id) {
+      auto buffer = file_mgr_->createBuffer(chunk_key(chunk_id), kFilePageSize, 0);
+      buffer->initEncoder(SQLTypeInfo(kINT, false));
+      auto values = chunk_values(chunk_id);
+      buffer->append(reinterpret_cast<int8_t*>(values.data()), kChunkBytes);
+    }
+    file_mgr_->checkpoint();
+    // room for three chunks in the slabs
+    cpu_mgr_.reset(new CpuBufferMgr(0,
+                                    3 * kChunkBytes,
+                                    nullptr,
+                                    3 * kChunkBytes,
+                                    512,
+                                    file_mgr_.get(),
+                                    false,
+                                    false,
+                                    false,
+                                    64 << 20));
+  }
+
+  void TearDown() override {
+    cpu_mgr_.reset();
+    file_mgr_.reset();
+    boost::filesystem::remove_all(kDataPath);
+  }
+
+  // Reads the first num_bytes of the chunk through the CPU buffer pool
+  std::vector<int32_t> read_chunk(const int chunk_id,
+                                  const size_t num_bytes = kChunkBytes) {
+    auto buffer = cpu_mgr_->getBuffer(chunk_key(chunk_id), num_bytes);
+    EXPECT_EQ(num_bytes, buffer->size());
+    std::vector<int32_t> values(buffer->size() / sizeof(int32_t));
+    buffer->read(reinterpret_cast<int8_t*>(values.data()), buffer->size());
+    buffer->unPin();
+    return values;
+  }
+
+  // Evicts the chunk by reading the chunks after it
+  void evict_chunk(const int chunk_id) {
+    for (int offset = 1; offset <= 3; ++offset) {
+      read_chunk((chunk_id + offset) % kRandomChunk);
+    }
+    ASSERT_FALSE(cpu_mgr_->isBufferOnDevice(chunk_key(chunk_id)));
+  }
+
+  std::unique_ptr<GlobalFileMgr> file_mgr_;
+  std::unique_ptr<CpuBufferMgr> cpu_mgr_;
+};
+
+constexpr size_t kPoolPageSize{512};
+constexpr size_t kSlabPages{16};
+constexpr size_t kChunkPages{4};
+
+// Two slabs of four chunks each, without a parent: the chunks only live in the pool
+class SegmentIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    cpu_mgr_.reset(new CpuBufferMgr(0,
+                                    2 * kSlabPages * kPoolPageSize,
+                                    nullptr,
+                                    kSlabPages * kPoolPageSize,
+                                    kPoolPageSize));
+  }
+
+  void TearDown() override { cpu_mgr_.reset(); }
+
+  AbstractBuffer* create_chunk(const int chunk_id,
+                               const size_t num_pages = kChunkPages,
+                               const bool pinned = false) {
+    auto buffer = cpu_mgr_->createBuffer(
+        chunk_key(chunk_id), kPoolPageSize, num_pages * kPoolPageSize);
+    if (!pinned) {
+      buffer->unPin();
+    }
+    return buffer;
+  }
+
+  void fill_slabs() {
+    for (int chunk_id = 0; chunk_id < 2 * int(kSlabPages / kChunkPages); ++chunk_id) {
+      create_chunk(chunk_id);
+    }
+    ASSERT_EQ(2 * kSlabPages * kPoolPageSize, cpu_mgr_->getInUseSize());
+  }
+
+  // Touches the chunks in order, the first one becomes the least recently used
+  void touch_chunks(const std::vector<int>& chunk_ids) {
+    for (const auto chunk_id : chunk_ids) {
+      cpu_mgr_->getBuffer(chunk_key(chunk_id))->unPin();
+    }
+  }
+
+  std::vector<int> chunks_on_device(const int num_chunks) {
+    std::vector<int> chunk_ids;
+    for (int chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+      if (cpu_mgr_->isBufferOnDevice(chunk_key(chunk_id))) {
+        chunk_ids.push_back(chunk_id);
+      }
+    }
+    return chunk_ids;
+  }
+
+  std::unique_ptr<CpuBufferMgr> cpu_mgr_;
+};
+
+// Chunks of a parent file manager with mapped reads: a single page fixed width chunk,
+// which gets mapped, and chunks which don't qualify
+enum MappedChunkId { kSinglePage, kMultiPage, kVarlen, kFixedEncoded, kNumMappedChunks };
+constexpr size_t kMappedChunkInts{1000};
+constexpr size_t kMultiPageSize{4096};
+
+std::vector<int32_t> mapped_chunk_values(const int chunk_id) {
+  const size_t num_values = chunk_id == kMultiPage ? 10 * kMappedChunkInts
+                                                   : kMappedChunkInts;
+  std::vector<int32_t> values(num_values);
+  for (size_t i = 0; i < num_values; ++i) {
+    values[i] = i * 7 + chunk_id;
+  }
+  return values;
+}
+
+class MappedChunkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    boost::filesystem::remove_all(kDataPath);
+    boost::filesystem::create_directories(kDataPath);
+    file_mgr_.reset(new GlobalFileMgr(0, kDataPath, 0, kFilePageSize));
+    for (int chunk_id = 0; chunk_id < kNumMappedChunks; ++chunk_id) {
+      SQLTypeInfo sql_type(chunk_id == kVarlen ? kTEXT : kINT, false);
+      if (chunk_id == kFixedEncoded) {
+        sql_type.set_compression(kENCODING_FIXED);
+        sql_type.set_comp_param(16);
+      }
+      const auto page_size = chunk_id == kMultiPage ? kMultiPageSize : kFilePageSize;
+      auto buffer = file_mgr_->createBuffer(chunk_key(chunk_id), page_size, 0);
+      buffer->initEncoder(sql_type);
+      // the bytes are only read back, what they encode doesn't matter
+      auto values = mapped_chunk_values(chunk_id);
+      buffer->append(reinterpret_cast<int8_t*>(values.data()),
+                     values.size() * sizeof(int32_t));
+    }
+    file_mgr_->checkpoint();
+    cpu_mgr_.reset(new CpuBufferMgr(0,
+                                    kChunkBytes,
+                                    nullptr,
+                                    kChunkBytes,
+                                    512,
+                                    file_mgr_.get(),
+                                    false,
+                                    false,
+                                    true));
+  }
+
+  void TearDown() override {
+    cpu_mgr_.reset();
+    file_mgr_.reset();
+    boost::filesystem::remove_all(kDataPath);
+  }
+
+  std::vector<int32_t> read_buffer(AbstractBuffer* buffer) {
+    std::vector<int32_t> values(buffer->size() / sizeof(int32_t));
+    buffer->read(reinterpret_cast<int8_t*>(values.data()), buffer->size());
+    return values;
+  }
+
+  // Reads the first num_values of the chunk through the CPU buffer pool
+  std::vector<int32_t> read_chunk(const int chunk_id, const size_t num_values = 0) {
+    auto buffer = cpu_mgr_->getBuffer(chunk_key(chunk_id), num_values * sizeof(int32_t));
+    auto values = read_buffer(buffer);
+    buffer->unPin();
+    return values;
+  }
+
+  std::unique_ptr<GlobalFileMgr> file_mgr_;
+  std::unique_ptr<CpuBufferMgr> cpu_mgr_;
+};
+
+}  // namespace
+
+TEST_F(EvictedChunkTest, Restore) {
+  for (int round = 0; round < 2; ++round) {
+    for (int chunk_id = 0; chunk_id < kNumChunks; ++chunk_id) {
+      EXPECT_EQ(chunk_values(chunk_id), read_chunk(chunk_id));
+    }
+  }
+  // every compressible chunk has been evicted and restored on the second round
+  EXPECT_EQ(size_t(kNumChunks - 1), cpu_mgr_->getNumRestoredChunks());
+}
+
+TEST_F(EvictedChunkTest, UpdatedAfterEviction) {
+  read_chunk(0);
+  evict_chunk(0);
+  auto values = chunk_values(0);
+  values[10] = -42;
+  // updates rewrite the whole chunk, as when the pool flushes an updated buffer
+  file_mgr_->getBuffer(chunk_key(0))
+      ->write(reinterpret_cast<int8_t*>(values.data()), kChunkBytes);
+  file_mgr_->checkpoint();
+  const auto num_restored_chunks = cpu_mgr_->getNumRestoredChunks();
+  // the copy of the chunk is stale, the data comes from the parent
+  EXPECT_EQ(values, read_chunk(0));
+  EXPECT_EQ(num_restored_chunks, cpu_mgr_->getNumRestoredChunks());
+}
+
+TEST_F(EvictedChunkTest, AppendedAfterEviction) {
+  read_chunk(0);
+  evict_chunk(0);
+  std::vector<int32_t> tail(1000, 5);
+  file_mgr_->getBuffer(chunk_key(0))
+      ->append(reinterpret_cast<int8_t*>(tail.data()), tail.size() * sizeof(int32_t));
+  file_mgr_->checkpoint();
+  const auto num_restored_chunks = cpu_mgr_->getNumRestoredChunks();
+  // the copy of the chunk is restored, only the tail comes from the parent
+  auto values = chunk_values(0);
+  values.insert(values.end(), tail.begin(), tail.end());
+  EXPECT_EQ(values, read_chunk(0, values.size() * sizeof(int32_t)));
+  EXPECT_EQ(num_restored_chunks + 1, cpu_mgr_->getNumRestoredChunks());
+}
+
+TEST_F(EvictedChunkTest, RecreatedAfterEviction) {
+  read_chunk(0);
+  evict_chunk(0);
+  // same key and size, different data
+  file_mgr_->deleteBuffer(chunk_key(0));
+  auto buffer = file_mgr_->createBuffer(chunk_key(0), kFilePageSize, 0);
+  buffer->initEncoder(SQLTypeInfo(kINT, false));
+  auto values = chunk_values(1);
+  buffer->append(reinterpret_cast<int8_t*>(values.data()), kChunkBytes);
+  file_mgr_->checkpoint();
+  const auto num_restored_chunks = cpu_mgr_->getNumRestoredChunks();
+  EXPECT_EQ(values, read_chunk(0));
+  EXPECT_EQ(num_restored_chunks, cpu_mgr_->getNumRestoredChunks());
+}
+
+TEST_F(EvictedChunkTest, DroppedAfterEviction) {
+  read_chunk(0);
+  evict_chunk(0);
+  cpu_mgr_->deleteBuffersWithPrefix({1, 1});
+  const auto num_restored_chunks = cpu_mgr_->getNumRestoredChunks();
+  EXPECT_EQ(chunk_values(0), read_chunk(0));
+  EXPECT_EQ(num_restored_chunks, cpu_mgr_->getNumRestoredChunks());
+}
+
+TEST_F(SegmentIndexTest, AllocateFreeCoalesce) {
+  for (int chunk_id = 0; chunk_id < 4; ++chunk_id) {
+    create_chunk(chunk_id);
+  }
+  EXPECT_EQ(kSlabPages * kPoolPageSize, cpu_mgr_->getAllocated());
+  // the free segments of two adjacent chunks are merged into one
+  cpu_mgr_->deleteBuffer(chunk_key(1));
+  cpu_mgr_->deleteBuffer(chunk_key(2));
+  create_chunk(4, 2 * kChunkPages);
+  EXPECT_EQ(kSlabPages * kPoolPageSize, cpu_mgr_->getAllocated());
+  EXPECT_EQ((std::vector<int>{0, 3, 4}), chunks_on_device(5));
+  // and with the free segments on both sides of a freed chunk
+  cpu_mgr_->deleteBuffer(chunk_key(0));
+  cpu_mgr_->deleteBuffer(chunk_key(3));
+  cpu_mgr_->deleteBuffer(chunk_key(4));
+  EXPECT_EQ(size_t(0), cpu_mgr_->getInUseSize());
+  create_chunk(5, kSlabPages);
+  EXPECT_EQ(kSlabPages * kPoolPageSize, cpu_mgr_->getAllocated());
+  EXPECT_EQ(size_t(1), cpu_mgr_->getNumChunks());
+}
+
+TEST_F(SegmentIndexTest, EvictLeastRecentlyUsed) {
+  fill_slabs();
+  touch_chunks({0, 1, 2, 3, 4, 6, 7});
+  create_chunk(8);
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 6, 7, 8}), chunks_on_device(9));
+  // chunk 0 was touched before chunk 8 was created
+  touch_chunks({1, 2, 3, 4, 6, 7});
+  create_chunk(9);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 6, 7, 8, 9}), chunks_on_device(10));
+}
+
+TEST_F(SegmentIndexTest, PinnedChunksStay) {
+  fill_slabs();
+  auto pinned_buffer = cpu_mgr_->getBuffer(chunk_key(0));
+  touch_chunks({1, 2, 3, 4, 5, 6, 7});
+  create_chunk(8);
+  EXPECT_EQ((std::vector<int>{0, 2, 3, 4, 5, 6, 7, 8}), chunks_on_device(9));
+  pinned_buffer->unPin();
+}
+
+TEST_F(SegmentIndexTest, EvictUnpinnedWindowAcrossSegments) {
+  fill_slabs();
+  auto pinned_buffer = cpu_mgr_->getBuffer(chunk_key(2));
+  // chunk 1 is the oldest, but chunk 2 is pinned and chunk 0 is newer than 5 and 6
+  touch_chunks({1, 6, 3, 5, 0, 4, 7});
+  create_chunk(8, 2 * kChunkPages);
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 7, 8}), chunks_on_device(9));
+  // the window takes the free pages of a deleted chunk and the two chunks after them
+  pinned_buffer->unPin();
+  cpu_mgr_->deleteBuffer(chunk_key(0));
+  touch_chunks({2, 1, 4, 7, 8, 3});
+  create_chunk(9, 3 * kChunkPages);
+  EXPECT_EQ((std::vector<int>{3, 4, 7, 8, 9}), chunks_on_device(10));
+}
+
+TEST_F(SegmentIndexTest, OutOfMemoryWhenPinned) {
+  fill_slabs();
+  auto pinned_buffer = cpu_mgr_->getBuffer(chunk_key(2));
+  auto other_pinned_buffer = cpu_mgr_->getBuffer(chunk_key(6));
+  EXPECT_THROW(create_chunk(8, kSlabPages), OutOfMemory);
+  EXPECT_FALSE(cpu_mgr_->isBufferOnDevice(chunk_key(8)));
+  // the failed allocation evicted nothing
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}), chunks_on_device(9));
+  pinned_buffer->unPin();
+  other_pinned_buffer->unPin();
+}
+
+TEST_F(MappedChunkTest, MapSinglePageChunk) {
+  EXPECT_EQ(mapped_chunk_values(kSinglePage), read_chunk(kSinglePage));
+  EXPECT_EQ(size_t(1), cpu_mgr_->getNumMappedChunks());
+  // the chunk takes no pages of the slabs
+  EXPECT_EQ(size_t(0), cpu_mgr_->getInUseSize());
+  EXPECT_EQ(mapped_chunk_values(kSinglePage), read_chunk(kSinglePage));
+}
+
+TEST_F(MappedChunkTest, FetchMovesToSlab) {
+  auto values = mapped_chunk_values(kSinglePage);
+  const std::vector<int32_t> head(values.begin(), values.begin() + values.size() / 2);
+  EXPECT_EQ(head, read_chunk(kSinglePage, head.size()));
+  EXPECT_EQ(size_t(1), cpu_mgr_->getNumMappedChunks());
+  // the rest of the chunk is read after the mapped head, in a slab
+  EXPECT_EQ(values, read_chunk(kSinglePage, values.size()));
+  EXPECT_EQ(size_t(0), cpu_mgr_->getNumMappedChunks());
+  EXPECT_LT(size_t(0), cpu_mgr_->getInUseSize());
+  EXPECT_EQ(values, read_chunk(kSinglePage));
+}
+
+TEST_F(MappedChunkTest, WriteMovesToSlab) {
+  auto buffer = cpu_mgr_->getBuffer(chunk_key(kSinglePage));
+  EXPECT_EQ(size_t(1), cpu_mgr_->getNumMappedChunks());
+  std::vector<int32_t> tail(100, -3);
+  buffer->append(reinterpret_cast<int8_t*>(tail.data()), tail.size() * sizeof(int32_t));
+  EXPECT_EQ(size_t(0), cpu_mgr_->getNumMappedChunks());
+  auto values = mapped_chunk_values(kSinglePage);
+  values.insert(values.end(), tail.begin(), tail.end());
+  EXPECT_EQ(values, read_buffer(buffer));
+  buffer->unPin();
+  // the data file is unchanged
+  EXPECT_EQ(mapped_chunk_values(kSinglePage).size() * sizeof(int32_t),
+            file_mgr_->getBuffer(chunk_key(kSinglePage))->size());
+}
+
+TEST_F(MappedChunkTest, DeleteReleasesMapping) {
+  read_chunk(kSinglePage);
+  ASSERT_EQ(size_t(1), cpu_mgr_->getNumMappedChunks());
+  cpu_mgr_->deleteBuffer(chunk_key(kSinglePage));
+  EXPECT_EQ(size_t(0), cpu_mgr_->getNumMappedChunks());
+  EXPECT_FALSE(cpu_mgr_->isBufferOnDevice(chunk_key(kSinglePage)));
+  EXPECT_EQ(mapped_chunk_values(kSinglePage), read_chunk(kSinglePage));
+}
+
+TEST_F(MappedChunkTest, ClearSlabsReleasesMapping) {
+  read_chunk(kSinglePage);
+  read_chunk(kMultiPage);
+  ASSERT_EQ(size_t(1), cpu_mgr_->getNumMappedChunks());
+  cpu_mgr_->clearSlabs();
+  EXPECT_EQ(size_t(0), cpu_mgr_->getNumMappedChunks());
+  EXPECT_EQ(size_t(0), cpu_mgr_->getNumChunks());
+  EXPECT_EQ(mapped_chunk_values(kSinglePage), read_chunk(kSinglePage));
+}
+
+TEST_F(MappedChunkTest, ReadOtherChunksIntoSlabs) {
+  size_t in_use_size{0};
+  for (const auto chunk_id : {kMultiPage, kVarlen, kFixedEncoded}) {
+    EXPECT_EQ(mapped_chunk_values(chunk_id), read_chunk(chunk_id));
+    EXPECT_EQ(size_t(0), cpu_mgr_->getNumMappedChunks());
+    EXPECT_LT(in_use_size, cpu_mgr_->getInUseSize());
+    in_use_size = cpu_mgr_->getInUseSize();
+  }
+}
+
+TEST(HotChunks, RoundTrip) {
+  const std::string path{std::string(BASE_PATH) + "/hot_chunks_test"};
+  const Data_Namespace::HotChunks hot_chunks{
+      {{1, 2, 3, 0}, 300}, {{1, 2, 4, 1, 2}, 200}, {{5, 6, 7, 8}, 100}};
+  Data_Namespace::write_hot_chunks(path, hot_chunks);
+  EXPECT_FALSE(boost::filesystem::exists(path + ".tmp"));
+  EXPECT_EQ(hot_chunks, Data_Namespace::read_hot_chunks(path, 1000));
+  // the previous record is replaced
+  Data_Namespace::write_hot_chunks(path, {hot_chunks[2]});
+  EXPECT_EQ(Data_Namespace::HotChunks{hot_chunks[2]},
+            Data_Namespace::read_hot_chunks(path, 1000));
+  boost::filesystem::remove(path);
+  EXPECT_TRUE(Data_Namespace::read_hot_chunks(path, 1000).empty());
+}
+
+TEST(HotChunks, SkipMalformedLines) {
+  const std::string path{std::string(BASE_PATH) + "/hot_chunks_test"};
+  {
+    std::ofstream hot_chunks_file(path, std::ios::trunc);
+    hot_chunks_file << "1,2,3,4 10\n"
+                    << "\n"
+                    << "1,2,3 10\n"
+                    << "1,2,3,4,5,6 10\n"
+                    << "1,2,x,4 10\n"
+                    << "1,2,3,4\n"
+                    << "1,2,3,4 ten\n"
+                    << "1,2,3,4 10 20\n"
+                    << "5,6,7,8,9 20\n";
+  }
+  const Data_Namespace::HotChunks hot_chunks{{{1, 2, 3, 4}, 10}, {{5, 6, 7, 8, 9}, 20}};
+  EXPECT_EQ(hot_chunks, Data_Namespace::read_hot_chunks(path, 1000));
+  boost::filesystem::remove(path);
+}
+
+TEST(HotChunks, PoolSizeCutoff) {
+  const std::string path{std::string(BASE_PATH) + "/hot_chunks_test"};
+  const Data_Namespace::HotChunks hot_chunks{
+      {{1, 1, 1, 0}, 400}, {{1, 1, 2, 0}, 500}, {{1, 1, 3, 0}, 300}, {{1, 1, 4, 0}, 50}};
+  Data_Namespace::write_hot_chunks(path, hot_chunks);
+  EXPECT_EQ(hot_chunks, Data_Namespace::read_hot_chunks(path, 1250));
+  // the hottest chunks which fit, a colder chunk doesn't skip ahead of a hotter one
+  EXPECT_EQ(Data_Namespace::HotChunks(hot_chunks.begin(), hot_chunks.begin() + 2),
+            Data_Namespace::read_hot_chunks(path, 1000));
+  EXPECT_EQ(Data_Namespace::HotChunks(hot_chunks.begin(), hot_chunks.begin() + 1),
+            Data_Namespace::read_hot_chunks(path, 899));
+  EXPECT_TRUE(Data_Namespace::read_hot_chunks(path, 399).empty());
+  boost::filesystem::remove(path);
+}
+
+TEST(NumaNodeList, Parse) {
+  // the list, its mask and its number of nodes
+  using NodeList = std::tuple<std::string, std::vector<unsigned long>, size_t>;
+  const std::vector<NodeList> node_lists{{"0", {0x1}, 1},
+                                         {"0-1,3", {0xb}, 3},
+                                         {"0-1,3\n", {0xb}, 3},
+                                         {"0,,2,", {0x5}, 2},
+                                         {"0-1,1", {0x3}, 2},
+                                         {"0-3,64-65", {0xf, 0x3}, 6},
+                                         {"65", {0x0, 0x2}, 1},
+                                         {"", {}, 0},
+                                         {"1-0", {}, 0},
+                                         {"0-x", {}, 0},
+                                         {"node0", {}, 0}};
+  for (const auto& node_list : node_lists) {
+    size_t node_count{42};
+    EXPECT_EQ(std::get<1>(node_list),
+              parse_numa_node_list(std::get<0>(node_list), node_count))
+        << std::get<0>(node_list);
+    EXPECT_EQ(std::get<2>(node_list), node_count) << std::get<0>(node_list);
+  }
+}
+
+TEST(HugePages, AddAndFreeSlabs) {
+  // the mapping of the slab is rounded up to whole huge pages
+  constexpr size_t slab_size{3 << 20};
+  constexpr size_t mapping_size{4 << 20};
+  size_t huge_pages_free{0};
+  {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+      if (line.find("HugePages_Free:") == 0) {
+        huge_pages_free = std::stoul(line.substr(line.find(':') + 1));
+      }
+    }
+  }
+  // without enough reserved huge pages MAP_HUGETLB fails, and the slab falls back to
+  // transparent huge pages
+  const size_t huge_tlb_slabs = huge_pages_free * (2 << 20) >= mapping_size ? 1 : 0;
+  CpuBufferMgr cpu_mgr(0, slab_size, nullptr, slab_size, 512, nullptr, true);
+  for (int round = 0; round < 2; ++round) {
+    auto buffer = cpu_mgr.createBuffer(chunk_key(0), 512, slab_size);
+    EXPECT_EQ(slab_size, cpu_mgr.getAllocated());
+    EXPECT_EQ(huge_tlb_slabs, cpu_mgr.getNumHugeTlbSlabs());
+    std::vector<int32_t> values(slab_size / sizeof(int32_t));
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = i;
+    }
+    buffer->write(reinterpret_cast<int8_t*>(values.data()), slab_size);
+    std::vector<int32_t> read_values(values.size());
+    buffer->read(reinterpret_cast<int8_t*>(read_values.data()), slab_size);
+    EXPECT_EQ(values, read_values);
+    buffer->unPin();
+    // nothing is pinned, the slabs are freed
+    cpu_mgr.clearSlabs();
+    EXPECT_EQ(size_t(0), cpu_mgr.getAllocated());
+    EXPECT_EQ(size_t(0), cpu_mgr.getNumHugeTlbSlabs());
+  }
+}
+
+int main(int argc, char** argv) {
+  logger::LogOptions log_options(argv[0]);
+  log_options.max_files_ = 0;  // stderr only
+  logger::init(log_options);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ColumnarResultsBench.cpp
+ * @brief   Microbenchmarks for the conversion of projection results into
+ *          ColumnarResults.
+ *
+ * Compares the row-wise conversion of a row-wise projection with the conversion of a
+ * columnar one, which either copies the columns or uses them in place.
+ */
+
+#include "../QueryEngine/ColumnarResults.h"
+#include "../QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "../QueryEngine/ResultSet.h"
+#include "ResultSetTestUtils.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+const std::vector<SQLTypes> kTargetTypes{kBIGINT, kINT, kDOUBLE, kBIGINT};
+
+void convert_projection(benchmark::State& state,
+                        const bool output_columnar,
+                        const bool share_result_set) {
+  const size_t entry_count = state.range(0);
+  const auto target_infos = generate_projection_target_infos(kTargetTypes);
+  const auto query_mem_desc =
+      projection_query_mem_desc(target_infos, entry_count, output_columnar);
+  auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  auto result_set = std::make_shared<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = result_set->allocateStorage();
+  fill_storage_buffer_projection(
+      storage->getUnderlyingBuffer(), target_infos, query_mem_desc);
+  std::vector<SQLTypeInfo> col_types;
+  for (const auto& target_info : target_infos) {
+    col_types.push_back(target_info.sql_type);
+  }
+
+  for (auto _ : state) {
+    // the copied columns are owned by the memory owner, use a fresh one per iteration
+    ColumnarResults columnar_results(std::make_shared<RowSetMemoryOwner>(),
+                                     *result_set,
+                                     col_types.size(),
+                                     col_types,
+                                     share_result_set ? result_set : nullptr);
+    benchmark::DoNotOptimize(columnar_results.getColumnBuffer(0));
+  }
+  state.SetItemsProcessed(state.iterations() * entry_count);
+}
+
+}  // namespace
+
+// Row-wise projection, converted row by row through the result set iterator.
+static void BM_RowWise(benchmark::State& state) {
+  convert_projection(state, false, false);
+}
+BENCHMARK(BM_RowWise)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+
+// Columnar projection, each column is copied with a single memcpy.
+static void BM_ColumnarCopy(benchmark::State& state) {
+  convert_projection(state, true, false);
+}
+BENCHMARK(BM_ColumnarCopy)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+
+// Columnar projection, the columns are used in place.
+static void BM_ColumnarInPlace(benchmark::State& state) {
+  convert_projection(state, true, true);
+}
+BENCHMARK(BM_ColumnarInPlace)->Arg(1 << 16)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
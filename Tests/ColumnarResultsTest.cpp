@@ -135,7 +135,83 @@ TEST(Construct, Empty) {
 }
 
 // Projections:
-// TODO(Saman): add tests for Projections
+void validate_projection_conversion(const ColumnarResults& columnar_results,
+                                    const std::vector<TargetInfo>& target_infos,
+                                    const size_t entry_count) {
+  for (size_t row_idx = 0; row_idx < entry_count; ++row_idx) {
+    for (size_t target_idx = 0; target_idx < target_infos.size(); ++target_idx) {
+      const auto v = projection_value(row_idx, target_idx);
+      switch (target_infos[target_idx].sql_type.get_type()) {
+        case kBIGINT:
+          ASSERT_EQ(v, columnar_results.getEntryAt<int64_t>(row_idx, target_idx));
+          break;
+        case kINT:
+          ASSERT_EQ(v, columnar_results.getEntryAt<int32_t>(row_idx, target_idx));
+          break;
+        case kFLOAT:
+          ASSERT_FLOAT_EQ(static_cast<float>(v),
+                          columnar_results.getEntryAt<float>(row_idx, target_idx));
+          break;
+        case kDOUBLE:
+          ASSERT_DOUBLE_EQ(static_cast<double>(v),
+                           columnar_results.getEntryAt<double>(row_idx, target_idx));
+          break;
+        default:
+          UNREACHABLE() << "Invalid type info encountered.";
+      }
+    }
+  }
+}
+
+void test_projection_conversion(const std::vector<TargetInfo>& target_infos,
+                                const size_t entry_count,
+                                const bool output_columnar,
+                                const bool share_result_set) {
+  const auto query_mem_desc =
+      projection_query_mem_desc(target_infos, entry_count, output_columnar);
+  auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  auto result_set = std::make_shared<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = result_set->allocateStorage();
+  fill_storage_buffer_projection(
+      storage->getUnderlyingBuffer(), target_infos, query_mem_desc);
+
+  std::vector<SQLTypeInfo> col_types;
+  for (const auto& target_info : target_infos) {
+    col_types.push_back(target_info.sql_type);
+  }
+  ColumnarResults columnar_results(row_set_mem_owner,
+                                   *result_set,
+                                   col_types.size(),
+                                   col_types,
+                                   share_result_set ? result_set : nullptr);
+
+  EXPECT_EQ(entry_count, columnar_results.size());
+  for (size_t target_idx = 0; target_idx < target_infos.size(); ++target_idx) {
+    const bool in_place = output_columnar && share_result_set;
+    EXPECT_EQ(in_place, columnar_results.isColumnInPlace(target_idx));
+    if (in_place) {
+      EXPECT_EQ(storage->getUnderlyingBuffer() +
+                    query_mem_desc.getColOffInBytes(target_idx),
+                columnar_results.getColumnBuffer(target_idx));
+    }
+  }
+  validate_projection_conversion(columnar_results, target_infos, entry_count);
+}
+
+TEST(Projection, RowWise) {
+  const auto target_infos =
+      generate_projection_target_infos({kBIGINT, kINT, kFLOAT, kDOUBLE});
+  test_projection_conversion(target_infos, 1000, false, false);
+  test_projection_conversion(target_infos, 1000, false, true);
+}
+
+TEST(Projection, Columnar) {
+  const auto target_infos =
+      generate_projection_target_infos({kBIGINT, kINT, kFLOAT, kDOUBLE});
+  test_projection_conversion(target_infos, 1000, true, false);
+  test_projection_conversion(target_infos, 1000, true, true);
+}
 
 // Perfect Hash:
 TEST(PerfectHash, RowWise_64Key_64Agg) {
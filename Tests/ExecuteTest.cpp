@@ -35,6 +35,7 @@
 #include <boost/any.hpp>
 #include <boost/program_options.hpp>
 #include <cmath>
+#include <regex>
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -50,6 +51,12 @@ extern bool g_enable_smem_group_by;
 extern bool g_allow_cpu_retry;
 extern bool g_enable_watchdog;
 extern bool g_skip_intermediate_count;
+extern bool g_release_intermediate_results;
+extern bool g_enable_late_materialization;
+extern bool g_enable_cpu_vectorization;
+extern bool g_enable_tiered_compilation;
+extern bool g_enable_runtime_join_filters;
+extern bool g_enable_async_reduction_compilation;
 
 extern unsigned g_trivial_loop_join_threshold;
 extern bool g_enable_overlaps_hashjoin;
@@ -57,6 +64,7 @@ extern double g_gpu_mem_limit_percent;
 
 extern bool g_enable_window_functions;
 extern bool g_enable_bump_allocator;
+extern bool g_enable_cpu_bump_allocator;
 
 extern size_t g_leaf_count;
 
@@ -1381,6 +1389,177 @@ TEST(Select, FloatAndDoubleTests) {
   }
 }
 
+TEST(Select, QueryProfile) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto executor =
+      Executor::getExecutor(QR::get()->getCatalog()->getCurrentDB().dbId);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    const auto row_count =
+        v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test WHERE x > 0;", dt));
+    if (dt == ExecutorDeviceType::CPU) {
+      QR::get()->clearCpuMemory();
+    }
+    run_simple_agg("SELECT SUM(y) FROM test WHERE x > 0;", dt);
+    auto profile = executor->getQueryProfile();
+    ASSERT_EQ(row_count, profile.rows_scanned);
+    ASSERT_GT(profile.fragments_scanned, 0);
+    ASSERT_EQ(0, profile.fragments_skipped);
+    ASSERT_FALSE(profile.kernel_times_us.empty());
+    if (dt == ExecutorDeviceType::CPU) {
+      // the query holds no more than the chunks it fetched and its output buffers
+      ASSERT_GT(profile.peak_memory_bytes, 0);
+      ASSERT_LE(profile.peak_memory_bytes,
+                profile.cpu_fetch_bytes + profile.output_buffer_bytes);
+      ASSERT_GT(profile.cpu_fetch_bytes, 0);
+      ASSERT_EQ(profile.cpu_fetch_bytes, profile.cpu_fetch_bytes_from_parent);
+      ASSERT_EQ(0, profile.gpu_fetch_bytes);
+    } else {
+      ASSERT_GT(profile.gpu_fetch_bytes, 0);
+    }
+
+    // Same query again: the code comes from the cache and the chunks are resident.
+    run_simple_agg("SELECT SUM(y) FROM test WHERE x > 0;", dt);
+    profile = executor->getQueryProfile();
+    ASSERT_GT(profile.code_cache_hits, 0);
+    ASSERT_EQ(0, profile.code_cache_misses);
+    if (dt == ExecutorDeviceType::CPU) {
+      ASSERT_EQ(0, profile.cpu_fetch_bytes_from_parent);
+    } else {
+      ASSERT_EQ(0, profile.gpu_fetch_bytes_from_parent);
+    }
+
+    // The filter excludes every fragment based on its metadata.
+    run_simple_agg("SELECT COUNT(*) FROM test WHERE x > 1000;", dt);
+    profile = executor->getQueryProfile();
+    ASSERT_EQ(0, profile.fragments_scanned);
+    ASSERT_GT(profile.fragments_skipped, 0);
+    ASSERT_EQ(0, profile.rows_scanned);
+  }
+}
+
+TEST(Select, CpuVectorization) {
+  const auto enable_cpu_vectorization = g_enable_cpu_vectorization;
+  ScopeGuard reset_cpu_vectorization = [&enable_cpu_vectorization] {
+    g_enable_cpu_vectorization = enable_cpu_vectorization;
+  };
+
+  // Same results as the row-wise code for filters, aggregates and group by.
+  for (const bool vectorize : {false, true}) {
+    g_enable_cpu_vectorization = vectorize;
+    const auto dt = ExecutorDeviceType::CPU;
+    c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+    c("SELECT SUM(x + y), MIN(z), MAX(t) FROM test WHERE y > 41 AND z < 102;", dt);
+    c("SELECT SUM(x * y), AVG(z) FROM test WHERE x = 7;", dt);
+    c("SELECT COUNT(*), SUM(ofd) FROM test WHERE ofd IS NOT NULL;", dt);
+    c("SELECT x, COUNT(*), SUM(y) FROM test GROUP BY x ORDER BY x;", dt);
+    c("SELECT y, z FROM test WHERE x * 2 > 15 ORDER BY y, z;", dt);
+  }
+}
+
+TEST(Select, CpuVectorizationIR) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_cpu_vectorization = g_enable_cpu_vectorization;
+  ScopeGuard reset_cpu_vectorization = [&enable_cpu_vectorization] {
+    g_enable_cpu_vectorization = enable_cpu_vectorization;
+  };
+  const auto get_optimized_ir = [](const std::string& query) {
+    const auto result = QR::get()->runSelectQuery(query,
+                                                  ExecutorDeviceType::CPU,
+                                                  true,
+                                                  true,
+                                                  true,
+                                                  ExecutorExplainType::Optimized);
+    const auto crt_row = result.getRows()->getNextRow(true, true);
+    CHECK_EQ(size_t(1), crt_row.size());
+    return boost::get<std::string>(v<NullableString>(crt_row[0]));
+  };
+  // e.g. the vector phi of the count: "phi <4 x i64>"
+  const std::regex vector_type{"<[0-9]+ x i[0-9]+>"};
+
+  // The filter and the count of the query loop are vectorized into the integer vectors
+  // of any host target.
+  const std::string query{"SELECT COUNT(*) FROM test WHERE x > 7;"};
+  g_enable_cpu_vectorization = false;
+  ASSERT_FALSE(std::regex_search(get_optimized_ir(query), vector_type));
+  g_enable_cpu_vectorization = true;
+  ASSERT_TRUE(std::regex_search(get_optimized_ir(query), vector_type));
+  c(query, ExecutorDeviceType::CPU);
+}
+
+TEST(Select, TieredCompilation) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_tiered_compilation = g_enable_tiered_compilation;
+  ScopeGuard reset_tiered_compilation = [&enable_tiered_compilation] {
+    g_enable_tiered_compilation = enable_tiered_compilation;
+  };
+  g_enable_tiered_compilation = true;
+
+  const auto executor =
+      Executor::getExecutor(QR::get()->getCatalog()->getCurrentDB().dbId);
+  const auto dt = ExecutorDeviceType::CPU;
+  const std::vector<std::string> queries{
+      "SELECT SUM(x - y), MAX(z * 3) FROM test WHERE t > 1000 AND y < 50;",
+      "SELECT z, COUNT(*), SUM(x * t) FROM test WHERE y > 41 GROUP BY z ORDER BY z;",
+      "SELECT x, y FROM test WHERE z - x > 90 ORDER BY x, y;"};
+  for (const auto& query : queries) {
+    c(query, dt);
+  }
+
+  // Same results once the optimized code has replaced the unoptimized one in the cache.
+  executor->waitForTieredCompilations();
+  for (const auto& query : queries) {
+    c(query, dt);
+    const auto profile = executor->getQueryProfile();
+    ASSERT_GT(profile.code_cache_hits, 0);
+    ASSERT_EQ(0, profile.code_cache_misses);
+  }
+}
+
+TEST(Select, AsyncReductionCompilation) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_async_reduction_compilation = g_enable_async_reduction_compilation;
+  ScopeGuard reset_async_reduction_compilation = [&enable_async_reduction_compilation] {
+    g_enable_async_reduction_compilation = enable_async_reduction_compilation;
+  };
+  g_enable_async_reduction_compilation = true;
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT z, COUNT(*), SUM(x), MIN(y), MAX(t) FROM test GROUP BY z ORDER BY z;", dt);
+    c("SELECT x, y, COUNT(*), AVG(f) FROM test GROUP BY x, y ORDER BY x, y;", dt);
+    c("SELECT str, COUNT(*) FROM test GROUP BY str ORDER BY str;", dt);
+  }
+}
+
+TEST(Select, CpuBumpAllocator) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_cpu_bump_allocator = g_enable_cpu_bump_allocator;
+  ScopeGuard reset_cpu_bump_allocator = [&enable_cpu_bump_allocator] {
+    g_enable_cpu_bump_allocator = enable_cpu_bump_allocator;
+  };
+  g_enable_cpu_bump_allocator = true;
+
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT x, y, str FROM test WHERE x > 7;", dt);
+  c("SELECT x, z FROM test WHERE y = 42 AND z > 100;", dt);
+  c("SELECT x FROM test WHERE x < 0;", dt);
+  // The join produces more rows than its input fragments hold, the output buffers have
+  // to grow.
+  const auto join_count = v<int64_t>(
+      run_simple_agg("SELECT COUNT(*) FROM test a, test b, test c WHERE a.x = b.x AND "
+                     "b.x = c.x;",
+                     dt));
+  const auto rows = run_multiple_agg(
+      "SELECT a.x, c.y FROM test a, test b, test c WHERE a.x = b.x AND b.x = c.x;", dt);
+  ASSERT_EQ(static_cast<size_t>(join_count), rows->rowCount());
+}
+
 TEST(Select, FilterShortCircuit) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2075,6 +2254,51 @@ TEST(Select, MultiStepQueries) {
   }
 }
 
+TEST(Select, MultiStepQueriesReleaseIntermediateResults) {
+  const auto release_intermediate_results = g_release_intermediate_results;
+  ScopeGuard reset_release_intermediate_results = [&release_intermediate_results] {
+    g_release_intermediate_results = release_intermediate_results;
+  };
+  g_release_intermediate_results = true;
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT z, (z * SUM(x)) / SUM(y) + 1 FROM test GROUP BY z ORDER BY z;", dt);
+    c("SELECT a, COUNT(*) FROM (SELECT x + y AS a, SUM(z) AS b FROM test GROUP BY a) "
+      "GROUP BY a ORDER BY a;",
+      dt);
+    c("SELECT n, COUNT(*) FROM (SELECT x, COUNT(*) AS n FROM test GROUP BY x) GROUP BY "
+      "n ORDER BY n;",
+      dt);
+    c("SELECT x, n FROM (SELECT x, COUNT(*) AS n FROM test GROUP BY x) WHERE n > 1 "
+      "ORDER BY x;",
+      dt);
+  }
+}
+
+TEST(Select, OrderByLimitLateMaterialization) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_late_materialization = g_enable_late_materialization;
+  ScopeGuard reset_late_materialization = [&enable_late_materialization] {
+    g_enable_late_materialization = enable_late_materialization;
+  };
+  g_enable_late_materialization = true;
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, y, z, t, f, d, str, real_str FROM test WHERE y > 41 ORDER BY x DESC, y, "
+      "z, t LIMIT 5;",
+      dt);
+    c("SELECT x, y, z, t, f, d, str, real_str FROM test ORDER BY x, y, z, t LIMIT 20 "
+      "OFFSET 3;",
+      dt);
+    c("SELECT z + t, str, dd, real_str FROM test WHERE x < 8 ORDER BY 1 DESC, 2 LIMIT 5;",
+      dt);
+    c("SELECT x, str, real_str FROM test WHERE x > 100 ORDER BY x LIMIT 5;", dt);
+  }
+}
+
 TEST(Select, GroupByPushDownFilterIntoExprRange) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2403,6 +2627,23 @@ TEST(Select, Strings) {
   }
 }
 
+TEST(Select, DictionaryStringLength) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT LENGTH(str), COUNT(*) FROM test GROUP BY LENGTH(str) ORDER BY 1;", dt);
+    c("SELECT CHAR_LENGTH(str), COUNT(*) FROM test GROUP BY 1 ORDER BY 1;",
+      "SELECT LENGTH(str), COUNT(*) FROM test GROUP BY 1 ORDER BY 1;",
+      dt);
+    c("SELECT SUM(LENGTH(str)), SUM(LENGTH(fixed_str)), SUM(LENGTH(shared_dict)) FROM "
+      "test;",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE LENGTH(null_str) IS NULL;", dt);
+    c("SELECT COUNT(LENGTH(null_str)) FROM test;", dt);
+  }
+}
+
 TEST(Select, SharedDictionary) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7164,6 +7405,222 @@ TEST(Select, Joins_BuildHashTable) {
   }
 }
 
+TEST(Select, Joins_MultiFragmentInnerTable) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // Both inner tables span several fragments; the second join is one-to-many.
+    c("SELECT COUNT(*) FROM test, hash_join_test WHERE test.x = hash_join_test.x;", dt);
+    c("SELECT COUNT(*) FROM hash_join_test, test WHERE hash_join_test.x = test.x;", dt);
+    c("SELECT hash_join_test.t, COUNT(*) FROM hash_join_test, test WHERE "
+      "hash_join_test.x = test.x GROUP BY hash_join_test.t ORDER BY hash_join_test.t;",
+      dt);
+    c("SELECT hash_join_test.x, test.y FROM hash_join_test LEFT JOIN test ON "
+      "hash_join_test.x = test.x ORDER BY hash_join_test.x, test.y;",
+      dt);
+  }
+}
+
+TEST(Select, Joins_RuntimeFilters) {
+  const auto enable_runtime_join_filters = g_enable_runtime_join_filters;
+  ScopeGuard reset_runtime_join_filters = [enable_runtime_join_filters] {
+    g_enable_runtime_join_filters = enable_runtime_join_filters;
+  };
+  for (const auto enable : {false, true}) {
+    g_enable_runtime_join_filters = enable;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      // The filters are built along with the hash tables, drop the cached ones.
+      QR::get()->clearCpuMemory();
+      c("SELECT COUNT(*) FROM test JOIN test_inner ON test.x = test_inner.x;", dt);
+      c("SELECT COUNT(*) FROM test, hash_join_test WHERE test.x = hash_join_test.x;",
+        dt);
+      c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x = b.x AND a.y = b.y;", dt);
+      c("SELECT a.z, b.str FROM test a JOIN test_inner b ON a.x = b.x AND a.y = b.y "
+        "ORDER BY a.z, b.str;",
+        dt);
+      c("SELECT COUNT(*) FROM test a LEFT JOIN test_inner b ON a.x = b.x AND a.y = b.y;",
+        dt);
+    }
+  }
+}
+
+TEST(Select, Joins_RuntimeFiltersSkipFragments) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_runtime_join_filters = g_enable_runtime_join_filters;
+  const auto drop = [] {
+    for (const auto table : {"runtime_filter_outer", "runtime_filter_inner"}) {
+      const auto drop_table = "DROP TABLE IF EXISTS "s + table + ";";
+      run_ddl_statement(drop_table);
+      g_sqlite_comparator.query(drop_table);
+    }
+  };
+  drop();
+  ScopeGuard reset = [enable_runtime_join_filters, &drop] {
+    g_enable_runtime_join_filters = enable_runtime_join_filters;
+    drop();
+  };
+  // four fragments of outer keys, 1 to 40
+  run_ddl_statement(
+      "CREATE TABLE runtime_filter_outer (x int, y int) WITH (fragment_size=10);");
+  g_sqlite_comparator.query("CREATE TABLE runtime_filter_outer (x int, y int);");
+  run_ddl_statement("CREATE TABLE runtime_filter_inner (x int, y int);");
+  g_sqlite_comparator.query("CREATE TABLE runtime_filter_inner (x int, y int);");
+  const auto insert_row = [](const std::string& table, const int x) {
+    const auto insert_query = "INSERT INTO " + table + " VALUES(" + std::to_string(x) +
+                              ", " + std::to_string(x % 3) + ");";
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  };
+  for (int x = 1; x <= 40; ++x) {
+    insert_row("runtime_filter_outer", x);
+  }
+  for (const auto x : {1, 2, 3, 4, 5, 35}) {
+    insert_row("runtime_filter_inner", x);
+  }
+  // The chunk metadata of the inner key still covers 35, the hash table keys don't.
+  const std::string update_query{"UPDATE runtime_filter_inner SET x = 3 WHERE x = 35;"};
+  run_multiple_agg(update_query, ExecutorDeviceType::CPU);
+  g_sqlite_comparator.query(update_query);
+
+  const auto executor =
+      Executor::getExecutor(QR::get()->getCatalog()->getCurrentDB().dbId);
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const auto enable : {false, true}) {
+    g_enable_runtime_join_filters = enable;
+    QR::get()->clearCpuMemory();
+    c("SELECT COUNT(*) FROM runtime_filter_outer JOIN runtime_filter_inner ON "
+      "runtime_filter_outer.x = runtime_filter_inner.x;",
+      dt);
+    auto profile = executor->getQueryProfile();
+    // only the first outer fragment holds keys from 1 to 5
+    ASSERT_EQ(enable ? 3 : 0, profile.fragments_skipped);
+    c("SELECT COUNT(*) FROM runtime_filter_outer a JOIN runtime_filter_inner b ON a.x = "
+      "b.x AND a.y = b.y;",
+      dt);
+    profile = executor->getQueryProfile();
+    ASSERT_EQ(enable ? 3 : 0, profile.fragments_skipped);
+    // the outer fragments of a left join are all scanned
+    c("SELECT COUNT(*) FROM runtime_filter_outer LEFT JOIN runtime_filter_inner ON "
+      "runtime_filter_outer.x = runtime_filter_inner.x;",
+      dt);
+    profile = executor->getQueryProfile();
+    ASSERT_EQ(0, profile.fragments_skipped);
+  }
+}
+
+TEST(Select, Joins_RuntimeFiltersBitwiseEqNullKeys) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_runtime_join_filters = g_enable_runtime_join_filters;
+  const auto drop = [] {
+    for (const auto table : {"runtime_filter_null_outer", "runtime_filter_null_inner"}) {
+      run_ddl_statement("DROP TABLE IF EXISTS "s + table + ";");
+    }
+  };
+  drop();
+  ScopeGuard reset = [enable_runtime_join_filters, &drop] {
+    g_enable_runtime_join_filters = enable_runtime_join_filters;
+    drop();
+  };
+  run_ddl_statement(
+      "CREATE TABLE runtime_filter_null_outer (x int) WITH (fragment_size=2);");
+  run_ddl_statement("CREATE TABLE runtime_filter_null_inner (x int);");
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const auto x : {"1", "NULL", "2", "NULL", "3"}) {
+    run_multiple_agg("INSERT INTO runtime_filter_null_outer VALUES("s + x + ");", dt);
+  }
+  for (int i = 0; i < 3; ++i) {
+    run_multiple_agg("INSERT INTO runtime_filter_null_inner VALUES(NULL);", dt);
+  }
+
+  const std::string join_query{
+      "SELECT COUNT(*) FROM runtime_filter_null_outer a JOIN runtime_filter_null_inner "
+      "b ON a.x IS NOT DISTINCT FROM b.x;"};
+  g_enable_runtime_join_filters = true;
+  // the table has only the slot of the null key, the column range is empty
+  QR::get()->clearCpuMemory();
+  ASSERT_EQ(int64_t(6), v<int64_t>(run_simple_agg(join_query, dt)));
+  // the chunk metadata still covers the key updated to null
+  run_multiple_agg("INSERT INTO runtime_filter_null_inner VALUES(7);", dt);
+  run_multiple_agg("UPDATE runtime_filter_null_inner SET x = NULL WHERE x = 7;", dt);
+  QR::get()->clearCpuMemory();
+  ASSERT_EQ(int64_t(8), v<int64_t>(run_simple_agg(join_query, dt)));
+}
+
+TEST(Select, Joins_ColumnStatistics) {
+  const std::string drop_column_stats_test{"DROP TABLE IF EXISTS column_stats_test;"};
+  run_ddl_statement(drop_column_stats_test);
+  g_sqlite_comparator.query(drop_column_stats_test);
+  ScopeGuard drop_table = [&drop_column_stats_test] {
+    run_ddl_statement(drop_column_stats_test);
+    g_sqlite_comparator.query(drop_column_stats_test);
+  };
+  run_ddl_statement(
+      "CREATE TABLE column_stats_test (x int, y int, str text encoding dict) WITH "
+      "(fragment_size=4);");
+  g_sqlite_comparator.query("CREATE TABLE column_stats_test (x int, y int, str text);");
+  const auto insert_row = [](const std::string& values) {
+    const std::string insert_query{"INSERT INTO column_stats_test VALUES(" + values +
+                                   ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  };
+  for (int i = 0; i < 20; ++i) {
+    insert_row(std::to_string(7 + i % 3) + ", " +
+               (i % 4 ? std::to_string(i) : std::string("NULL")) + ", 'str" +
+               std::to_string(i % 5) + "'");
+  }
+  run_ddl_statement("ANALYZE TABLE column_stats_test;");
+
+  const auto& cat = *QR::get()->getCatalog();
+  const auto td = cat.getMetadataForTable("column_stats_test");
+  CHECK(td);
+  const auto get_stats = [&cat, td](const std::string& column_name) {
+    const auto cd = cat.getMetadataForColumn(td->tableId, column_name);
+    CHECK(cd);
+    return cat.getColumnStatistics(td->tableId, cd->columnId);
+  };
+  auto x_stats = get_stats("x");
+  ASSERT_TRUE(x_stats);
+  ASSERT_EQ(int64_t(20), x_stats->num_rows);
+  ASSERT_EQ(size_t(3), x_stats->getNdv());
+  ASSERT_NEAR(1., x_stats->getFractionInRange(7, 9), 0.01);
+  const auto y_stats = get_stats("y");
+  ASSERT_TRUE(y_stats);
+  ASSERT_EQ(int64_t(5), y_stats->num_nulls);
+  ASSERT_EQ(size_t(15), y_stats->getNdv());
+  const auto str_stats = get_stats("str");
+  ASSERT_TRUE(str_stats);
+  ASSERT_EQ(size_t(5), str_stats->getNdv());
+
+  // Appended rows are merged into the existing statistics.
+  insert_row("10, 100, 'str5'");
+  x_stats = get_stats("x");
+  ASSERT_EQ(int64_t(21), x_stats->num_rows);
+  ASSERT_EQ(size_t(4), x_stats->getNdv());
+  ASSERT_EQ(size_t(16), get_stats("y")->getNdv());
+  ASSERT_EQ(size_t(6), get_stats("str")->getNdv());
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    QR::get()->clearCpuMemory();
+    c("SELECT COUNT(*) FROM test JOIN column_stats_test ON test.x = "
+      "column_stats_test.x;",
+      dt);
+    c("SELECT COUNT(*) FROM test a JOIN column_stats_test b ON a.x = b.x JOIN test_inner "
+      "c ON b.x = c.x;",
+      dt);
+    c("SELECT COUNT(*) FROM test a JOIN column_stats_test b ON a.x = b.x AND a.str = "
+      "b.str;",
+      dt);
+    c("SELECT x, str, COUNT(*) FROM column_stats_test GROUP BY x, str ORDER BY x, str;",
+      dt);
+    c("SELECT y, COUNT(*) AS n FROM column_stats_test GROUP BY y ORDER BY n DESC, y;",
+      dt);
+  }
+}
+
 TEST(Select, Joins_CoalesceColumns) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -15274,6 +15731,32 @@ TEST(Select, WindowFunctionSum) {
   c(query + " NULLS FIRST;", query + ";", dt);
 }
 
+TEST(Select, WindowFunctionFrames) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  {
+    std::string query =
+        "SELECT x, y, t, SUM(x) OVER (PARTITION BY y ORDER BY t ROWS BETWEEN 2 PRECEDING "
+        "AND CURRENT ROW) s, AVG(x) OVER (PARTITION BY y ORDER BY t ROWS BETWEEN 1 "
+        "PRECEDING AND 1 FOLLOWING) a, MIN(f) OVER (PARTITION BY y ORDER BY t ROWS "
+        "BETWEEN 1 FOLLOWING AND 3 FOLLOWING) m1, MAX(dd) OVER (PARTITION BY y ORDER BY "
+        "t DESC ROWS BETWEEN UNBOUNDED PRECEDING AND 1 PRECEDING) m2, COUNT(*) OVER "
+        "(PARTITION BY y ORDER BY t ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING) c "
+        "FROM test_window_func ORDER BY t ASC;";
+    c(query, query, dt);
+  }
+  {
+    std::string part1 =
+        "SELECT x, y, SUM(x) OVER (PARTITION BY y ORDER BY x RANGE BETWEEN 3 PRECEDING "
+        "AND 1 FOLLOWING) s, COUNT(x) OVER (PARTITION BY y ORDER BY x DESC RANGE BETWEEN "
+        "CURRENT ROW AND 2 FOLLOWING) c FROM test_window_func ORDER BY x ASC";
+    std::string part2 = "s ASC, c ASC;";
+    c(part1 + " NULLS FIRST, y ASC NULLS FIRST, " + part2,
+      part1 + ", y ASC, " + part2,
+      dt);
+  }
+}
+
 TEST(Select, WindowFunctionComplexExpressions) {
   SKIP_ALL_ON_AGGREGATOR();
   const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
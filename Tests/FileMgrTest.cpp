@@ -0,0 +1,197 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../DataMgr/FileMgr/GlobalFileMgr.h"
+#include "Shared/Logger.h"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include <string>
+#include <vector>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using namespace File_Namespace;
+
+namespace {
+
+const std::string kDataPath{std::string(BASE_PATH) + "/file_mgr_test"};
+const std::string kSnapshotPath{kDataPath + "/table_1_1/header_snapshot"};
+constexpr size_t kPageSize{65536};
+constexpr int kNumChunks{4};
+
+ChunkKey chunk_key(const int column_id) {
+  return {1, 1, column_id, 0};
+}
+
+void append_ints(GlobalFileMgr& gfm,
+                 const int column_id,
+                 const int32_t first,
+                 const size_t count) {
+  const auto key = chunk_key(column_id);
+  AbstractBuffer* buffer{nullptr};
+  if (gfm.isBufferOnDevice(key)) {
+    buffer = gfm.getBuffer(key);
+  } else {
+    buffer = gfm.createBuffer(key, kPageSize, 0);
+    buffer->initEncoder(SQLTypeInfo(kINT, false));
+  }
+  std::vector<int32_t> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = first + i;
+  }
+  buffer->append(reinterpret_cast<int8_t*>(values.data()), count * sizeof(int32_t));
+}
+
+// the contents of every chunk, read back through the file manager
+std::vector<std::vector<int32_t>> read_chunks(GlobalFileMgr& gfm) {
+  std::vector<std::vector<int32_t>> chunks;
+  for (int column_id = 0; column_id < kNumChunks; ++column_id) {
+    const auto key = chunk_key(column_id);
+    std::vector<int32_t> values;
+    if (gfm.isBufferOnDevice(key)) {
+      auto buffer = gfm.getBuffer(key);
+      values.resize(buffer->size() / sizeof(int32_t));
+      buffer->read(reinterpret_cast<int8_t*>(values.data()), buffer->size());
+    }
+    chunks.push_back(values);
+  }
+  return chunks;
+}
+
+bool opened_from_snapshot(GlobalFileMgr& gfm) {
+  return gfm.getFileMgr(1, 1)->isOpenedFromHeaderSnapshot();
+}
+
+class HeaderSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    boost::filesystem::remove_all(kDataPath);
+    boost::filesystem::create_directories(kDataPath);
+    // a few multi-page chunks, one of them deleted and one appended to after a
+    // checkpoint, so that the files have free pages and multiple page versions
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    for (int column_id = 0; column_id < kNumChunks; ++column_id) {
+      append_ints(gfm, column_id, column_id * 1000, 40000 * (column_id + 1));
+    }
+    gfm.checkpoint(1, 1);
+    append_ints(gfm, 1, -5, 1000);
+    gfm.checkpoint(1, 1);
+    gfm.deleteBuffer(chunk_key(2));
+    gfm.checkpoint(1, 1);
+    expected_chunks_ = read_chunks(gfm);
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(kDataPath); }
+
+  std::vector<std::vector<int32_t>> expected_chunks_;
+};
+
+}  // namespace
+
+TEST_F(HeaderSnapshotTest, ReopenFromSnapshot) {
+  ASSERT_TRUE(boost::filesystem::exists(kSnapshotPath));
+  {
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    EXPECT_TRUE(opened_from_snapshot(gfm));
+    EXPECT_EQ(expected_chunks_, read_chunks(gfm));
+    // the free pages come from the snapshot too
+    append_ints(gfm, 2, 7, 50000);
+    gfm.checkpoint(1, 1);
+    expected_chunks_ = read_chunks(gfm);
+  }
+  // a table opened from a scan gives the same chunks
+  boost::filesystem::remove(kSnapshotPath);
+  {
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    EXPECT_FALSE(opened_from_snapshot(gfm));
+    EXPECT_EQ(expected_chunks_, read_chunks(gfm));
+  }
+  {
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    EXPECT_TRUE(opened_from_snapshot(gfm));
+    EXPECT_EQ(expected_chunks_, read_chunks(gfm));
+  }
+}
+
+TEST_F(HeaderSnapshotTest, StaleSnapshotFallsBackToScan) {
+  const std::string old_snapshot_path{kDataPath + "/old_header_snapshot"};
+  boost::filesystem::copy_file(kSnapshotPath, old_snapshot_path);
+  {
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    append_ints(gfm, 0, 3, 50000);
+    gfm.checkpoint(1, 1);
+    expected_chunks_ = read_chunks(gfm);
+  }
+  // the snapshot of an earlier epoch doesn't describe the files anymore
+  boost::filesystem::rename(old_snapshot_path, kSnapshotPath);
+  {
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    EXPECT_FALSE(opened_from_snapshot(gfm));
+    EXPECT_EQ(expected_chunks_, read_chunks(gfm));
+  }
+}
+
+TEST_F(HeaderSnapshotTest, SnapshotIsStaleOnceOpened) {
+  const std::string crash_data_path{kDataPath + "_crash"};
+  boost::filesystem::remove_all(crash_data_path);
+  {
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    EXPECT_TRUE(opened_from_snapshot(gfm));
+    // not checkpointed, the epoch file still matches the snapshot
+    append_ints(gfm, 1, 13, 50000);
+    append_ints(gfm, 2, 11, 50000);
+
+    // what a crash would leave on disk
+    boost::filesystem::create_directories(crash_data_path + "/table_1_1");
+    for (boost::filesystem::directory_iterator file_it(kDataPath + "/table_1_1"), end_it;
+         file_it != end_it;
+         ++file_it) {
+      boost::filesystem::copy_file(
+          file_it->path(),
+          crash_data_path + "/table_1_1/" + file_it->path().filename().string());
+    }
+  }
+  {
+    GlobalFileMgr gfm(0, crash_data_path, 0, kPageSize);
+    EXPECT_FALSE(opened_from_snapshot(gfm));
+    EXPECT_EQ(expected_chunks_, read_chunks(gfm));
+  }
+  // changes since the last checkpoint at shutdown leave no snapshot to open from
+  {
+    GlobalFileMgr gfm(0, kDataPath, 0, kPageSize);
+    EXPECT_FALSE(opened_from_snapshot(gfm));
+  }
+  boost::filesystem::remove_all(crash_data_path);
+}
+
+int main(int argc, char** argv) {
+  logger::LogOptions log_options(argv[0]);
+  log_options.max_files_ = 0;  // stderr only
+  logger::init(log_options);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -25,8 +25,11 @@
 #include "Catalog/Catalog.h"
 #include "Catalog/DBObject.h"
 #include "DataMgr/DataMgr.h"
+#include "QueryEngine/BaselineJoinHashTable.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
+#include "QueryEngine/ExternalCacheInvalidators.h"
+#include "QueryEngine/JoinHashTable.h"
 #include "QueryEngine/OverlapsJoinHashTable.h"
 #include "QueryEngine/ResultSet.h"
 #include "QueryEngine/UDFCompiler.h"
@@ -128,6 +131,96 @@ TEST(Memcmp, OverlapsJoinHashTable) {
   CHECK_EQ(*ptr2, -1);
 }
 
+namespace {
+
+// What get_memory reports for the CPU level, next to the buffer pool
+size_t join_hash_table_cache_bytes() {
+  return JoinHashTable::getCacheSizeBytes() + BaselineJoinHashTable::getCacheSizeBytes();
+}
+
+}  // namespace
+
+class JoinHashTableCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    g_device_type = ExecutorDeviceType::CPU;
+    sql(R"(
+      drop table if exists cache_outer;
+      drop table if exists cache_inner;
+      create table cache_outer (x int, y int);
+      create table cache_inner (x int, y int);
+    )");
+    // the larger table is the outer one, the hash tables are built on cache_inner
+    for (int i = 1; i <= 20; ++i) {
+      const auto values = "(" + std::to_string(i) + ", " + std::to_string(i) + ")";
+      sql("insert into cache_outer values " + values + ";");
+      if (i <= 10) {
+        sql("insert into cache_inner values " + values + ";");
+      }
+    }
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    ASSERT_EQ(size_t(0), join_hash_table_cache_bytes());
+  }
+
+  void TearDown() override {
+    sql(R"(
+      drop table if exists cache_outer;
+      drop table if exists cache_inner;
+    )");
+  }
+
+  // Builds a perfect hash table on x and a baseline one on (x, y)
+  void join() {
+    sql(R"(
+      select count(*) from cache_outer, cache_inner where cache_outer.x = cache_inner.x;
+      select count(*) from cache_outer, cache_inner
+          where cache_outer.x = cache_inner.x and cache_outer.y = cache_inner.y;
+    )");
+    ASSERT_GT(JoinHashTable::getCacheSizeBytes(), size_t(0));
+    ASSERT_GT(BaselineJoinHashTable::getCacheSizeBytes(), size_t(0));
+  }
+};
+
+TEST_F(JoinHashTableCacheTest, ReportedSize) {
+  sql(R"(
+    select count(*) from cache_outer, cache_inner where cache_outer.x = cache_inner.x;
+  )");
+  // one slot per value of the range of cache_inner.x
+  EXPECT_EQ(size_t(10) * sizeof(int32_t), JoinHashTable::getCacheSizeBytes());
+  EXPECT_EQ(size_t(0), BaselineJoinHashTable::getCacheSizeBytes());
+  EXPECT_EQ(size_t(10) * sizeof(int32_t), join_hash_table_cache_bytes());
+  join();
+  const auto cache_bytes = join_hash_table_cache_bytes();
+  EXPECT_EQ(
+      JoinHashTable::getCacheSizeBytes() + BaselineJoinHashTable::getCacheSizeBytes(),
+      cache_bytes);
+  // the cached tables are reused
+  join();
+  EXPECT_EQ(cache_bytes, join_hash_table_cache_bytes());
+}
+
+TEST_F(JoinHashTableCacheTest, InvalidateOnAppend) {
+  join();
+  const auto cache_bytes = join_hash_table_cache_bytes();
+  // no hash table is built on cache_outer
+  sql("insert into cache_outer values (21, 21);");
+  EXPECT_EQ(cache_bytes, join_hash_table_cache_bytes());
+  sql("insert into cache_inner values (11, 11);");
+  EXPECT_EQ(size_t(0), join_hash_table_cache_bytes());
+}
+
+TEST_F(JoinHashTableCacheTest, InvalidateOnTruncate) {
+  join();
+  sql("truncate table cache_inner;");
+  EXPECT_EQ(size_t(0), join_hash_table_cache_bytes());
+}
+
+TEST_F(JoinHashTableCacheTest, InvalidateOnDrop) {
+  join();
+  sql("drop table cache_inner;");
+  EXPECT_EQ(size_t(0), join_hash_table_cache_bytes());
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
 
@@ -210,6 +210,49 @@ size_t random_fill_dates(int8_t* buf, size_t num_elems) {
   return hash;
 }
 
+template <typename T>
+size_t range_fill_int(int8_t* buf,
+                      size_t num_elems,
+                      const ColumnValueRange& range,
+                      const unsigned seed) {
+  std::default_random_engine gen(seed);
+  std::uniform_int_distribution<int64_t> dist(range.min, range.max);
+  auto p = reinterpret_cast<T*>(buf);
+  size_t hash = 0;
+  for (size_t i = 0; i < num_elems; i++) {
+    p[i] = static_cast<T>(range.sequential ? range.min + static_cast<int64_t>(i)
+                                           : dist(gen));
+    boost::hash_combine(hash, p[i]);
+  }
+  return hash;
+}
+
+size_t range_fill(const ColumnDescriptor* cd,
+                  DataBlockPtr p,
+                  size_t num_elems,
+                  const ColumnValueRange& range,
+                  size_t& data_volumn) {
+  size_t hash = 0;
+  switch (cd->columnType.get_type()) {
+    case kSMALLINT:
+      hash = range_fill_int<int16_t>(p.numbersPtr, num_elems, range, cd->columnId);
+      data_volumn += num_elems * sizeof(int16_t);
+      break;
+    case kINT:
+      hash = range_fill_int<int32_t>(p.numbersPtr, num_elems, range, cd->columnId);
+      data_volumn += num_elems * sizeof(int32_t);
+      break;
+    case kBIGINT:
+      hash = range_fill_int<int64_t>(p.numbersPtr, num_elems, range, cd->columnId);
+      data_volumn += num_elems * sizeof(int64_t);
+      break;
+    default:
+      CHECK(false) << "Value ranges are only supported for integer columns, column "
+                   << cd->columnName << " is " << cd->columnType.get_type_name();
+  }
+  return hash;
+}
+
 #define MAX_TEXT_LEN 255
 
 size_t random_fill(const ColumnDescriptor* cd,
@@ -278,7 +321,8 @@ size_t random_fill(const ColumnDescriptor* cd,
 
 std::vector<size_t> populate_table_random(const std::string& table_name,
                                           const size_t num_rows,
-                                          const Catalog& cat) {
+                                          const Catalog& cat,
+                                          const ColumnValueRanges& value_ranges) {
   const TableDescriptor* td = cat.getMetadataForTable(table_name);
   const auto cds = cat.getAllColumnMetadataForTable(td->tableId, false, false, false);
   InsertData insert_data;
@@ -314,7 +358,11 @@ std::vector<size_t> populate_table_random(const std::string& table_name,
   int i = 0;
   size_t data_volumn = 0;
   for (auto cd : cds) {
-    col_hashs[i] = random_fill(cd, insert_data.data[i], num_rows, data_volumn);
+    const auto range_it = value_ranges.find(cd->columnName);
+    col_hashs[i] =
+        range_it != value_ranges.end()
+            ? range_fill(cd, insert_data.data[i], num_rows, range_it->second, data_volumn)
+            : random_fill(cd, insert_data.data[i], num_rows, data_volumn);
     i++;
   }
 
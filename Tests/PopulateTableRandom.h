@@ -26,12 +26,26 @@
 #define POPULATE_TABLE_RANDOM_H
 
 #include <cstdlib>
+#include <map>
 #include <string>
 #include <vector>
 #include "../Catalog/Catalog.h"
 
+// Value range for an integer column. Values are drawn uniformly from [min, max], or
+// assigned min, min + 1, ... in row order when sequential is set.
+struct ColumnValueRange {
+  int64_t min;
+  int64_t max;
+  bool sequential;
+};
+
+using ColumnValueRanges = std::map<std::string, ColumnValueRange>;
+
+// Integer columns named in value_ranges are filled from their range, using a random
+// sequence seeded by the column id. All other columns span their whole domain.
 std::vector<size_t> populate_table_random(const std::string& table_name,
                                           const size_t num_rows,
-                                          const Catalog_Namespace::Catalog& cat);
+                                          const Catalog_Namespace::Catalog& cat,
+                                          const ColumnValueRanges& value_ranges = {});
 
 #endif  // POPULATE_TABLE_RANDOM_H
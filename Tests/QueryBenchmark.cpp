@@ -0,0 +1,409 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    QueryBenchmark.cpp
+ * @brief   In-process CPU query benchmark over synthetic star schema tables.
+ *
+ * Generates SSB-like tables with PopulateTableRandom, runs a fixed set of star join,
+ * filter / aggregate and projection queries on the CPU and writes the per-phase
+ * timings of every iteration as JSON, so that results can be compared across builds.
+ */
+
+#include "../Calcite/Calcite.h"
+#include "../Catalog/Catalog.h"
+#include "../QueryEngine/CalciteAdapter.h"
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/RelAlgExecutor.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/Logger.h"
+#include "../Shared/measure.h"
+#include "../Shared/thread_count.h"
+#include "../ThriftHandler/QueryState.h"
+#include "PopulateTableRandom.h"
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using QR = QueryRunner::QueryRunner;
+
+extern bool g_enable_cpu_vectorization;
+extern bool g_enable_tiered_compilation;
+
+namespace {
+
+struct BenchmarkQuery {
+  std::string name;
+  std::string sql;
+};
+
+// Star schema loosely modeled after SSB: a lineorder fact table joined with date,
+// customer, supplier and part dimensions on dense primary keys. Dimension attributes
+// are small integer domains, uniformly distributed and independent of the keys.
+constexpr int64_t kDateCount{2556};  // 7 years of days, 1992 to 1998
+
+const std::vector<std::string> kTables{
+    "bench_lineorder", "bench_date", "bench_customer", "bench_supplier", "bench_part"};
+
+const std::vector<BenchmarkQuery> kQueries{
+    {"tpch_q1",
+     "SELECT lo_returnflag, lo_linestatus, SUM(lo_quantity) AS sum_qty, "
+     "SUM(lo_extendedprice) AS sum_base_price, SUM(lo_extendedprice * (100 - "
+     "lo_discount)) AS sum_disc_price, AVG(lo_quantity) AS avg_qty, "
+     "AVG(lo_extendedprice) AS avg_price, AVG(lo_discount) AS avg_disc, COUNT(*) AS "
+     "count_order FROM bench_lineorder WHERE lo_orderdate <= 2400 GROUP BY "
+     "lo_returnflag, lo_linestatus ORDER BY lo_returnflag, lo_linestatus;"},
+    {"tpch_q6",
+     "SELECT SUM(lo_extendedprice * lo_discount) AS revenue FROM bench_lineorder WHERE "
+     "lo_orderdate >= 365 AND lo_orderdate < 730 AND lo_discount BETWEEN 5 AND 7 AND "
+     "lo_quantity < 24;"},
+    {"ssb_q1_1",
+     "SELECT SUM(lo_extendedprice * lo_discount) AS revenue FROM bench_lineorder, "
+     "bench_date WHERE lo_orderdate = d_datekey AND d_year = 1993 AND lo_discount "
+     "BETWEEN 1 AND 3 AND lo_quantity < 25;"},
+    {"ssb_q2_1",
+     "SELECT SUM(lo_revenue) AS revenue, d_year, p_brand FROM bench_lineorder, "
+     "bench_date, bench_part, bench_supplier WHERE lo_orderdate = d_datekey AND "
+     "lo_partkey = p_partkey AND lo_suppkey = s_suppkey AND p_category = 12 AND "
+     "s_region = 1 GROUP BY d_year, p_brand ORDER BY d_year, p_brand;"},
+    {"ssb_q3_1",
+     "SELECT c_nation, s_nation, d_year, SUM(lo_revenue) AS revenue FROM "
+     "bench_customer, bench_lineorder, bench_supplier, bench_date WHERE lo_custkey = "
+     "c_custkey AND lo_suppkey = s_suppkey AND lo_orderdate = d_datekey AND c_region = "
+     "2 AND s_region = 2 AND d_year >= 1992 AND d_year <= 1997 GROUP BY c_nation, "
+     "s_nation, d_year ORDER BY d_year ASC, revenue DESC;"},
+    {"ssb_q4_1",
+     "SELECT d_year, c_nation, SUM(lo_revenue - lo_supplycost) AS profit FROM "
+     "bench_date, bench_customer, bench_supplier, bench_part, bench_lineorder WHERE "
+     "lo_custkey = c_custkey AND lo_suppkey = s_suppkey AND lo_partkey = p_partkey AND "
+     "lo_orderdate = d_datekey AND c_region = 1 AND s_region = 1 AND (p_mfgr = 1 OR "
+     "p_mfgr = 2) GROUP BY d_year, c_nation ORDER BY d_year, c_nation;"},
+    {"high_cardinality_group_by",
+     "SELECT lo_custkey, SUM(lo_revenue) AS revenue FROM bench_lineorder GROUP BY "
+     "lo_custkey ORDER BY revenue DESC LIMIT 10;"},
+    {"projection_top_n",
+     "SELECT lo_orderdate, lo_custkey, lo_revenue FROM bench_lineorder WHERE "
+     "lo_quantity = 1 ORDER BY lo_revenue DESC LIMIT 100;"}};
+
+void create_tables(const size_t fact_rows, const size_t fragment_size) {
+  const auto& cat = *QR::get()->getCatalog();
+  const std::string with_fragment_size{" WITH (fragment_size=" +
+                                       std::to_string(fragment_size) + ");"};
+  const size_t customer_count = std::max(fact_rows / 200, size_t(1000));
+  const size_t supplier_count = std::max(fact_rows / 3000, size_t(100));
+  const size_t part_count = std::max(fact_rows / 30, size_t(1000));
+
+  for (const auto& table : kTables) {
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS " + table + ";");
+  }
+  QR::get()->runDDLStatement(
+      "CREATE TABLE bench_date (d_datekey INT, d_year SMALLINT, d_month SMALLINT, "
+      "d_weeknuminyear SMALLINT);");
+  populate_table_random("bench_date",
+                        kDateCount,
+                        cat,
+                        {{"d_datekey", {0, kDateCount - 1, true}},
+                         {"d_year", {1992, 1998, false}},
+                         {"d_month", {1, 12, false}},
+                         {"d_weeknuminyear", {1, 53, false}}});
+  QR::get()->runDDLStatement(
+      "CREATE TABLE bench_customer (c_custkey INT, c_city SMALLINT, c_nation SMALLINT, "
+      "c_region SMALLINT);");
+  populate_table_random(
+      "bench_customer",
+      customer_count,
+      cat,
+      {{"c_custkey", {0, static_cast<int64_t>(customer_count) - 1, true}},
+       {"c_city", {0, 249, false}},
+       {"c_nation", {0, 24, false}},
+       {"c_region", {0, 4, false}}});
+  QR::get()->runDDLStatement(
+      "CREATE TABLE bench_supplier (s_suppkey INT, s_city SMALLINT, s_nation SMALLINT, "
+      "s_region SMALLINT);");
+  populate_table_random(
+      "bench_supplier",
+      supplier_count,
+      cat,
+      {{"s_suppkey", {0, static_cast<int64_t>(supplier_count) - 1, true}},
+       {"s_city", {0, 249, false}},
+       {"s_nation", {0, 24, false}},
+       {"s_region", {0, 4, false}}});
+  QR::get()->runDDLStatement(
+      "CREATE TABLE bench_part (p_partkey INT, p_mfgr SMALLINT, p_category SMALLINT, "
+      "p_brand SMALLINT);");
+  populate_table_random("bench_part",
+                        part_count,
+                        cat,
+                        {{"p_partkey", {0, static_cast<int64_t>(part_count) - 1, true}},
+                         {"p_mfgr", {1, 5, false}},
+                         {"p_category", {1, 25, false}},
+                         {"p_brand", {1, 1000, false}}});
+  QR::get()->runDDLStatement(
+      "CREATE TABLE bench_lineorder (lo_orderdate INT, lo_custkey INT, lo_suppkey INT, "
+      "lo_partkey INT, lo_quantity SMALLINT, lo_discount SMALLINT, lo_returnflag "
+      "SMALLINT, lo_linestatus SMALLINT, lo_extendedprice BIGINT, lo_revenue BIGINT, "
+      "lo_supplycost BIGINT)" +
+      with_fragment_size);
+  populate_table_random(
+      "bench_lineorder",
+      fact_rows,
+      cat,
+      {{"lo_orderdate", {0, kDateCount - 1, false}},
+       {"lo_custkey", {0, static_cast<int64_t>(customer_count) - 1, false}},
+       {"lo_suppkey", {0, static_cast<int64_t>(supplier_count) - 1, false}},
+       {"lo_partkey", {0, static_cast<int64_t>(part_count) - 1, false}},
+       {"lo_quantity", {1, 50, false}},
+       {"lo_discount", {0, 10, false}},
+       {"lo_returnflag", {0, 2, false}},
+       {"lo_linestatus", {0, 1, false}},
+       {"lo_extendedprice", {90000, 10000000, false}},
+       {"lo_revenue", {80000, 9000000, false}},
+       {"lo_supplycost", {50000, 120000, false}}});
+}
+
+struct IterationTimings {
+  double total_ms;
+  double calcite_ms;
+  QueryProfile profile;
+};
+
+IterationTimings run_query(const std::string& sql, size_t& result_row_count) {
+  auto session = QR::get()->getSession();
+  const auto& cat = session->getCatalog();
+  auto executor = Executor::getExecutor(cat.getCurrentDB().dbId);
+  auto query_state = query_state::QueryState::create(session, sql);
+
+  CompilationOptions co = {
+      ExecutorDeviceType::CPU, true, ExecutorOptLevel::Default, false};
+  ExecutionOptions eo = {
+      false, true, false, false, true, false, false, false, 0, false, false, 0.9};
+
+  IterationTimings timings;
+  const auto query_start = timer_start<std::chrono::steady_clock::time_point>();
+  const auto query_ra =
+      cat.getCalciteMgr()
+          ->process(
+              query_state->createQueryStateProxy(), pg_shim(sql), {}, true, false, false)
+          .plan_result;
+  timings.calcite_ms =
+      timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+          query_start) /
+      1000.;
+  RelAlgExecutor ra_executor(executor.get(), cat);
+  const auto result = ra_executor.executeRelAlgQuery(query_ra, co, eo, nullptr);
+  timings.total_ms =
+      timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+          query_start) /
+      1000.;
+  timings.profile = ra_executor.getQueryProfile();
+  result_row_count = result.getRows()->rowCount();
+  return timings;
+}
+
+template <typename Writer>
+void write_timings(Writer& writer, const IterationTimings& timings) {
+  writer.StartObject();
+  writer.Key("total_ms");
+  writer.Double(timings.total_ms);
+  writer.Key("calcite_ms");
+  writer.Double(timings.calcite_ms);
+  writer.Key("compilation_ms");
+  writer.Double(timings.profile.compilation_us / 1000.);
+  writer.Key("fetch_ms");
+  writer.Double(timings.profile.fetch_us / 1000.);
+  writer.Key("kernel_ms");
+  writer.Double(timings.profile.kernel_us / 1000.);
+  writer.Key("reduction_ms");
+  writer.Double(timings.profile.reduction_us / 1000.);
+  writer.Key("code_cache_hits");
+  writer.Int64(timings.profile.code_cache_hits);
+  writer.Key("cpu_fetch_bytes_from_disk");
+  writer.Int64(timings.profile.cpu_fetch_bytes_from_parent);
+  writer.Key("rows_scanned");
+  writer.Int64(timings.profile.rows_scanned);
+  writer.Key("fragments_skipped");
+  writer.Int64(timings.profile.fragments_skipped);
+  writer.EndObject();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  namespace po = boost::program_options;
+
+  std::string db_path{BASE_PATH};
+  std::string output_path{"query_benchmark.json"};
+  std::string query_filter;
+  size_t fact_rows{10000000};
+  size_t fragment_size{2000000};
+  size_t iterations{5};
+  size_t warmup_iterations{1};
+
+  po::options_description desc("Options");
+  desc.add_options()("help,h", "Print help messages");
+  desc.add_options()("path",
+                     po::value<std::string>(&db_path)->default_value(db_path),
+                     "Directory path to an initialized OmniSci data directory");
+  desc.add_options()("output",
+                     po::value<std::string>(&output_path)->default_value(output_path),
+                     "JSON results file");
+  desc.add_options()("rows",
+                     po::value<size_t>(&fact_rows)->default_value(fact_rows),
+                     "Number of rows in the fact table");
+  desc.add_options()("fragment-size",
+                     po::value<size_t>(&fragment_size)->default_value(fragment_size),
+                     "Fragment size of the fact table");
+  desc.add_options()("iterations",
+                     po::value<size_t>(&iterations)->default_value(iterations),
+                     "Number of timed iterations per query");
+  desc.add_options()(
+      "warmup",
+      po::value<size_t>(&warmup_iterations)->default_value(warmup_iterations),
+      "Number of untimed iterations per query, to populate the code and buffer caches");
+  desc.add_options()("query",
+                     po::value<std::string>(&query_filter),
+                     "Only run the queries whose name contains this string");
+  desc.add_options()("enable-cpu-vectorization",
+                     po::value<bool>(&g_enable_cpu_vectorization)
+                         ->default_value(g_enable_cpu_vectorization)
+                         ->implicit_value(true),
+                     "Vectorize the generated CPU code for the host instruction set");
+  desc.add_options()("enable-tiered-compilation",
+                     po::value<bool>(&g_enable_tiered_compilation)
+                         ->default_value(g_enable_tiered_compilation)
+                         ->implicit_value(true),
+                     "Run new CPU queries unoptimized, optimize them in background");
+  desc.add_options()("use-existing-data", "Don't generate the tables");
+  desc.add_options()("keep-data", "Don't drop the tables at the end of the run");
+  desc.add_options()("clear-cpu-memory",
+                     "Evict the CPU buffer pool before every iteration (cold fetches)");
+
+  logger::LogOptions log_options(argv[0]);
+  log_options.max_files_ = 0;  // stderr only by default
+  desc.add(log_options.get_options());
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+    po::notify(vm);
+  } catch (po::error& err) {
+    std::cerr << err.what() << std::endl;
+    return 1;
+  }
+  if (vm.count("help")) {
+    std::cout << "Usage: QueryBenchmark [--path <data dir>] [options]" << std::endl
+              << desc << std::endl;
+    return 0;
+  }
+  logger::init(log_options);
+
+  QR::init(db_path.c_str());
+  if (!vm.count("use-existing-data")) {
+    create_tables(fact_rows, fragment_size);
+  }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("fact_rows");
+  writer.Uint64(fact_rows);
+  writer.Key("fragment_size");
+  writer.Uint64(fragment_size);
+  writer.Key("cpu_threads");
+  writer.Int(cpu_threads());
+  writer.Key("iterations");
+  writer.Uint64(iterations);
+  writer.Key("cpu_vectorization");
+  writer.Bool(g_enable_cpu_vectorization);
+  writer.Key("tiered_compilation");
+  writer.Bool(g_enable_tiered_compilation);
+  writer.Key("queries");
+  writer.StartArray();
+  int err{0};
+  for (const auto& query : kQueries) {
+    if (!query_filter.empty() && query.name.find(query_filter) == std::string::npos) {
+      continue;
+    }
+    size_t result_row_count{0};
+    std::vector<IterationTimings> all_timings;
+    try {
+      for (size_t i = 0; i < warmup_iterations + iterations; ++i) {
+        if (vm.count("clear-cpu-memory")) {
+          QR::get()->clearCpuMemory();
+        }
+        const auto timings = run_query(query.sql, result_row_count);
+        if (i >= warmup_iterations) {
+          all_timings.push_back(timings);
+        }
+      }
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Query " << query.name << " failed: " << e.what();
+      err = 1;
+      continue;
+    }
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(query.name.c_str());
+    writer.Key("sql");
+    writer.String(query.sql.c_str());
+    writer.Key("result_rows");
+    writer.Uint64(result_row_count);
+    writer.Key("iterations");
+    writer.StartArray();
+    for (const auto& timings : all_timings) {
+      write_timings(writer, timings);
+    }
+    writer.EndArray();
+    if (!all_timings.empty()) {
+      // Report the phases of the iteration with the median total time.
+      std::sort(all_timings.begin(),
+                all_timings.end(),
+                [](const IterationTimings& lhs, const IterationTimings& rhs) {
+                  return lhs.total_ms < rhs.total_ms;
+                });
+      writer.Key("median");
+      write_timings(writer, all_timings[all_timings.size() / 2]);
+    }
+    writer.EndObject();
+    LOG(INFO) << "Query " << query.name << " done, " << all_timings.size()
+              << " iterations";
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  std::ofstream output(output_path);
+  output << buffer.GetString() << std::endl;
+  LOG(INFO) << "Results written to " << output_path;
+
+  if (!vm.count("keep-data") && !vm.count("use-existing-data")) {
+    for (const auto& table : kTables) {
+      QR::get()->runDDLStatement("DROP TABLE " + table + ";");
+    }
+  }
+  QR::reset();
+  return err;
+}
@@ -710,3 +710,63 @@ std::unordered_map<size_t, size_t> get_slot_to_target_mapping(
   }
   return mapping;
 }
+
+std::vector<TargetInfo> generate_projection_target_infos(
+    const std::vector<SQLTypes>& sql_types) {
+  std::vector<TargetInfo> target_infos;
+  for (const auto sql_type : sql_types) {
+    target_infos.push_back(TargetInfo{false,
+                                      kMIN,
+                                      SQLTypeInfo{sql_type, false},
+                                      SQLTypeInfo{kNULLT, false},
+                                      false,
+                                      false});
+  }
+  return target_infos;
+}
+
+QueryMemoryDescriptor projection_query_mem_desc(
+    const std::vector<TargetInfo>& target_infos,
+    const size_t entry_count,
+    const bool output_columnar) {
+  QueryMemoryDescriptor query_mem_desc(
+      QueryDescriptionType::Projection, 0, 0, false, {8});
+  for (const auto& target_info : target_infos) {
+    // columnar projections keep their targets in logical size, row-wise ones in 64 bits
+    const int8_t slot_bytes =
+        output_columnar ? static_cast<int8_t>(target_info.sql_type.get_size()) : 8;
+    query_mem_desc.addColSlotInfo({std::make_tuple(slot_bytes, slot_bytes)});
+  }
+  query_mem_desc.setEntryCount(entry_count);
+  query_mem_desc.setOutputColumnar(output_columnar);
+  return query_mem_desc;
+}
+
+int64_t projection_value(const size_t row_idx, const size_t target_idx) {
+  return static_cast<int64_t>(row_idx * (target_idx + 1)) - 1000;
+}
+
+void fill_storage_buffer_projection(int8_t* buff,
+                                    const std::vector<TargetInfo>& target_infos,
+                                    const QueryMemoryDescriptor& query_mem_desc) {
+  const auto entry_count = query_mem_desc.getEntryCount();
+  const bool output_columnar = query_mem_desc.didOutputColumnar();
+  for (size_t row_idx = 0; row_idx < entry_count; ++row_idx) {
+    // the index column marks the entry as non-empty
+    auto row_ptr = output_columnar ? buff : buff + row_idx * query_mem_desc.getRowSize();
+    reinterpret_cast<int64_t*>(row_ptr)[output_columnar ? row_idx : 0] = row_idx;
+    for (size_t target_idx = 0; target_idx < target_infos.size(); ++target_idx) {
+      const auto slot_bytes = query_mem_desc.getPaddedSlotWidthBytes(target_idx);
+      auto slot_ptr = output_columnar
+                          ? buff + query_mem_desc.getColOffInBytes(target_idx) +
+                                row_idx * slot_bytes
+                          : row_ptr + query_mem_desc.getColOffInBytes(target_idx);
+      const auto v = projection_value(row_idx, target_idx);
+      if (target_infos[target_idx].sql_type.is_fp()) {
+        write_fp(slot_ptr, v, slot_bytes);
+      } else {
+        write_int(slot_ptr, v, slot_bytes);
+      }
+    }
+  }
+}
@@ -172,6 +172,22 @@ std::vector<TargetInfo> generate_custom_agg_target_infos(std::vector<int8_t> key
                                                          std::vector<SQLTypes> agg_types,
                                                          std::vector<SQLTypes> arg_types);
 
+std::vector<TargetInfo> generate_projection_target_infos(
+    const std::vector<SQLTypes>& sql_types);
+
+// Projection with one slot per target, in logical size when the output is columnar.
+QueryMemoryDescriptor projection_query_mem_desc(
+    const std::vector<TargetInfo>& target_infos,
+    const size_t entry_count,
+    const bool output_columnar);
+
+// Value fill_storage_buffer_projection() writes for the given row and target.
+int64_t projection_value(const size_t row_idx, const size_t target_idx);
+
+void fill_storage_buffer_projection(int8_t* buff,
+                                    const std::vector<TargetInfo>& target_infos,
+                                    const QueryMemoryDescriptor& query_mem_desc);
+
 template <class T>
 inline T v(const TargetValue& r) {
   auto scalar_r = boost::get<ScalarTargetValue>(&r);
@@ -14,12 +14,19 @@
  * limitations under the License.
  */
 
+#include "../Shared/HostBufferPool.h"
+#include "../StringDictionary/ConcurrentLruCache.hpp"
+#include "../ThriftHandler/QueryAdmissionController.h"
 #include "../Utils/Regexp.h"
 #include "../Utils/StringLike.h"
 #include "TestHelpers.h"
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <thread>
+#include <vector>
+
 TEST(Utils, StringLike) {
   ASSERT_TRUE(string_like("abc", 3, "abc", 3, '\\'));
   ASSERT_FALSE(string_like("abc", 3, "ABC", 3, '\\'));
@@ -45,6 +52,211 @@ TEST(Utils, Regexp) {
   ASSERT_TRUE(regexp_like("hello [", 7, ".*\\[.*", 6, '\\'));
 }
 
+TEST(Utils, ConcurrentLruCache) {
+  ConcurrentLruCache<int, std::string> cache(4, 1);
+  for (int i = 0; i < 4; ++i) {
+    cache.put(i, std::to_string(i));
+  }
+  ASSERT_EQ(size_t(4), cache.size());
+  const auto cached = cache.get(0);
+  ASSERT_TRUE(cached);
+  ASSERT_EQ("0", *cached);
+  // 0 has been referenced since insertion, 1 is the first entry evicted instead.
+  cache.put(4, "4");
+  ASSERT_EQ(size_t(4), cache.size());
+  ASSERT_TRUE(cache.get(0));
+  ASSERT_FALSE(cache.get(1));
+  cache.put(4, "four");
+  ASSERT_EQ("four", *cache.get(4));
+  ASSERT_TRUE(cache.erase(4));
+  ASSERT_FALSE(cache.get(4));
+  cache.clear();
+  ASSERT_EQ(size_t(0), cache.size());
+  // Values handed out remain valid after they're evicted.
+  ASSERT_EQ("0", *cached);
+}
+
+TEST(Utils, ConcurrentLruCacheSizeBudget) {
+  std::vector<int> evicted;
+  ConcurrentLruCache<int, std::vector<int8_t>> cache(
+      100,
+      1,
+      10,
+      [](const std::vector<int8_t>& value) { return value.size(); },
+      [&evicted](const int key, const std::vector<int8_t>&) { evicted.push_back(key); });
+  cache.put(1, std::vector<int8_t>(6));
+  cache.put(2, std::vector<int8_t>(4));
+  ASSERT_EQ(size_t(10), cache.sizeBytes());
+  cache.put(3, std::vector<int8_t>(5));
+  ASSERT_EQ(std::vector<int>{1}, evicted);
+  ASSERT_EQ(size_t(9), cache.sizeBytes());
+  // Larger than the whole budget, not cached.
+  cache.put(4, std::vector<int8_t>(11));
+  ASSERT_FALSE(cache.get(4));
+  ASSERT_EQ(size_t(2), cache.size());
+  cache.setBudget(100, 5);
+  ASSERT_EQ(size_t(1), cache.size());
+  ASSERT_LE(cache.sizeBytes(), size_t(5));
+}
+
+TEST(Utils, ConcurrentLruCacheShardedSizeBudget) {
+  ConcurrentLruCache<int, std::vector<int8_t>> cache(
+      100, 4, 10, [](const std::vector<int8_t>& value) { return value.size(); });
+  for (int i = 0; i < 16; ++i) {
+    cache.put(i, std::vector<int8_t>(3));
+    ASSERT_LE(cache.sizeBytes(), size_t(10));
+  }
+  ASSERT_EQ(size_t(3), cache.size());
+  // The budget isn't split across the shards, the whole cache holds a value this large.
+  cache.put(16, std::vector<int8_t>(9));
+  ASSERT_TRUE(cache.get(16));
+  ASSERT_EQ(size_t(1), cache.size());
+  ASSERT_EQ(size_t(9), cache.sizeBytes());
+  ASSERT_EQ(size_t(1), cache.eraseIf([](const int key) { return key == 16; }));
+  ASSERT_EQ(size_t(0), cache.sizeBytes());
+}
+
+TEST(Utils, ConcurrentLruCacheCredits) {
+  ConcurrentLruCache<int, int> cache(3, 1);
+  // Expensive entry, survives two more sweeps of the clock hand than the others.
+  cache.put(1, 1, 3);
+  cache.put(2, 2);
+  cache.put(3, 3);
+  cache.put(4, 4);
+  ASSERT_TRUE(cache.get(1));
+  ASSERT_FALSE(cache.get(2));
+  cache.put(5, 5);
+  ASSERT_TRUE(cache.get(1));
+  ASSERT_FALSE(cache.get(3));
+  ASSERT_EQ(size_t(2), cache.eraseIf([](const int key) { return key >= 4; }));
+  ASSERT_EQ(size_t(1), cache.size());
+  ASSERT_TRUE(cache.get(1));
+}
+
+TEST(Utils, ConcurrentLruCacheThreads) {
+  ConcurrentLruCache<int, int> cache(64);
+  std::vector<std::thread> threads;
+  for (int thread_idx = 0; thread_idx < 8; ++thread_idx) {
+    threads.emplace_back([&cache, thread_idx] {
+      for (int i = 0; i < 10000; ++i) {
+        const int key = (i * 7 + thread_idx) % 256;
+        cache.put(key, key);
+        const auto cached = cache.get(i % 256);
+        if (cached) {
+          ASSERT_EQ(i % 256, *cached);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_LE(cache.size(), size_t(64));
+}
+
+TEST(Utils, HostBufferPool) {
+  HostBufferPool pool(size_t(1) << 20);
+  const size_t num_bytes{100000};
+  auto buffer = pool.allocate(num_bytes, false);
+  memset(buffer, 0xff, num_bytes);
+  pool.release(buffer, num_bytes);
+  ASSERT_EQ(size_t(1) << 17, pool.getCachedBytes());
+  // Same size class, the cached buffer is reused and zeroed.
+  auto reused_buffer = pool.allocate(70000, true);
+  ASSERT_EQ(buffer, reused_buffer);
+  ASSERT_EQ(size_t(0), pool.getCachedBytes());
+  for (size_t i = 0; i < 70000; ++i) {
+    ASSERT_EQ(0, reused_buffer[i]);
+  }
+  pool.release(reused_buffer, 70000);
+  // Small buffers aren't pooled.
+  auto small_buffer = pool.allocate(1000, true);
+  pool.release(small_buffer, 1000);
+  ASSERT_EQ(size_t(1) << 17, pool.getCachedBytes());
+  pool.setMaxCachedBytes(0);
+  ASSERT_EQ(size_t(0), pool.getCachedBytes());
+}
+
+TEST(Utils, HostBufferPoolCap) {
+  HostBufferPool pool(size_t(3) << 16);
+  std::vector<int8_t*> buffers;
+  for (size_t i = 0; i < 4; ++i) {
+    buffers.push_back(pool.allocate(size_t(1) << 16, false));
+  }
+  for (auto buffer : buffers) {
+    pool.release(buffer, size_t(1) << 16);
+  }
+  // The buffer which didn't fit under the cap has been freed.
+  ASSERT_EQ(size_t(3) << 16, pool.getCachedBytes());
+  pool.setMaxCachedBytes(size_t(1) << 16);
+  ASSERT_EQ(size_t(1) << 16, pool.getCachedBytes());
+}
+
+TEST(Utils, HostBufferPoolDisabled) {
+  HostBufferPool pool(0);
+  const size_t num_bytes{100000};
+  auto buffer = pool.allocate(num_bytes, true);
+  // Allocated with its exact size, so it can't be cached once the pool is enabled.
+  pool.setMaxCachedBytes(size_t(1) << 20);
+  pool.release(buffer, num_bytes);
+  ASSERT_EQ(size_t(0), pool.getCachedBytes());
+  buffer = pool.allocate(num_bytes, false);
+  pool.release(buffer, num_bytes);
+  ASSERT_EQ(size_t(1) << 17, pool.getCachedBytes());
+  // A size class larger than the cap isn't rounded up either.
+  auto large_buffer = pool.allocate(size_t(3) << 20, false);
+  pool.release(large_buffer, size_t(3) << 20);
+  ASSERT_EQ(size_t(1) << 17, pool.getCachedBytes());
+}
+
+TEST(Utils, QueryMemoryBudget) {
+  QueryMemoryBudget budget(1000);
+  budget.charge(600);
+  ASSERT_THROW(budget.charge(500), QueryMemoryBudgetExceeded);
+  // The failed charge isn't accounted.
+  ASSERT_EQ(size_t(600), budget.getUsedBytes());
+  budget.release(200);
+  budget.charge(500);
+  ASSERT_EQ(size_t(900), budget.getUsedBytes());
+  ASSERT_EQ(size_t(900), budget.getPeakBytes());
+  budget.release(900);
+  ASSERT_EQ(size_t(0), budget.getUsedBytes());
+  ASSERT_EQ(size_t(900), budget.getPeakBytes());
+  // A zero budget only accounts.
+  QueryMemoryBudget unlimited_budget(0);
+  unlimited_budget.charge(size_t(1) << 40);
+  ASSERT_EQ(size_t(1) << 40, unlimited_budget.getUsedBytes());
+}
+
+TEST(Utils, QueryAdmissionController) {
+  QueryAdmissionController controller(1000);
+  auto first = controller.admit("session_a", 600);
+  auto second = controller.admit("session_b", 400);
+  first->getBudget().charge(100);
+  second->getBudget().charge(300);
+  ASSERT_EQ(size_t(100), controller.getSessionUsedBytes("session_a"));
+  ASSERT_EQ(size_t(400), controller.getUsedBytes());
+  // The budgets of the running queries are committed, the third query has to wait.
+  std::atomic<bool> admitted{false};
+  std::thread waiting_query([&controller, &admitted] {
+    auto third = controller.admit("session_a", 500);
+    admitted = true;
+  });
+  while (controller.getQueuedQueryCount() == 0) {
+    std::this_thread::yield();
+  }
+  ASSERT_FALSE(admitted);
+  second.reset();
+  ASSERT_FALSE(admitted);
+  first.reset();
+  waiting_query.join();
+  ASSERT_TRUE(admitted);
+  ASSERT_EQ(size_t(0), controller.getRunningQueryCount());
+  // A query is admitted when nothing else runs, even over the watermark.
+  auto large = controller.admit("session_a", 2000);
+  ASSERT_EQ(size_t(1), controller.getRunningQueryCount());
+}
+
 int main(int argc, char* argv[]) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -57,11 +57,13 @@
 #include "Parser/parser.h"
 #include "Planner/Planner.h"
 #include "QueryEngine/ArrowResultSet.h"
+#include "QueryEngine/BaselineJoinHashTable.h"
 #include "QueryEngine/CalciteAdapter.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/JoinFilterPushDown.h"
+#include "QueryEngine/JoinHashTable.h"
 #include "QueryEngine/JsonAccessors.h"
 #include "QueryEngine/TableOptimizer.h"
 #include "QueryEngine/ThriftSerializers.h"
@@ -170,6 +172,7 @@ MapDHandler::MapDHandler(const std::vector<LeafHostInfo>& db_leaves,
     , authMetadata_(authMetadata)
     , mapd_parameters_(mapd_parameters)
     , legacy_syntax_(legacy_syntax)
+    , query_admission_controller_(mapd_parameters.query_memory_watermark_bytes)
     , super_user_rights_(false)
     , idle_session_duration_(idle_session_duration * 60)
     , max_session_duration_(max_session_duration * 60)
@@ -275,9 +278,25 @@ MapDHandler::MapDHandler(const std::vector<LeafHostInfo>& db_leaves,
       LOG(ERROR) << "Distributed leaf support disabled: " << e.what();
     }
   }
+
+  if (mapd_parameters_.hot_chunks_record_interval > 0) {
+    auto catalogs = std::make_shared<HotChunkCatalogs>();
+    hot_chunks_recorder_.reset(new Data_Namespace::HotChunksRecorder(
+        data_mgr_.get(),
+        base_data_path_,
+        mapd_parameters_.hot_chunks_record_interval,
+        mapd_parameters_.hot_chunks_preload_bytes_per_sec,
+        num_reader_threads,
+        read_only_,
+        [this, catalogs](const ChunkKey& key, const std::function<size_t()>& preload) {
+          return preload_hot_chunk(*catalogs, key, preload);
+        }));
+  }
 }
 
-MapDHandler::~MapDHandler() {}
+MapDHandler::~MapDHandler() {
+  hot_chunks_recorder_.reset();
+}
 
 void MapDHandler::check_read_only(const std::string& str) {
   if (MapDHandler::read_only_) {
@@ -541,6 +560,8 @@ void MapDHandler::get_session_info(TSessionInfo& _return, const TSessionId& sess
   _return.database = session_ptr->getCatalog().getCurrentDB().dbName;
   _return.start_time = session_ptr->get_start_time();
   _return.is_super = user_metadata.isSuper;
+  _return.query_memory_used_bytes =
+      query_admission_controller_.getSessionUsedBytes(session);
 }
 
 void MapDHandler::value_to_thrift_column(const TargetValue& tv,
@@ -795,6 +816,10 @@ void MapDHandler::sql_execute(TQueryResult& _return,
       _return.nonce = nonce;
     });
   } else {
+    // the query is queued while the running ones hold more memory than the watermark
+    const auto admission = query_admission_controller_.admit(
+        session, mapd_parameters_.query_memory_budget_bytes);
+    query_state->set_memory_budget(admission->getBudgetPtr());
     _return.total_time_ms = measure<>::execution([&]() {
       MapDHandler::sql_execute_impl(_return,
                                     query_state->createQueryStateProxy(),
@@ -804,6 +829,10 @@ void MapDHandler::sql_execute(TQueryResult& _return,
                                     first_n,
                                     at_most_n);
     });
+    stdlog.appendNameValuePairs("admission_wait_ms",
+                                admission->getWaitTimeMs(),
+                                "query_memory_peak_bytes",
+                                admission->getBudget().getPeakBytes());
   }
 
   // if the SQL statement we just executed was a geo COPY FROM, the import
@@ -1985,6 +2014,11 @@ void MapDHandler::get_memory(std::vector<TNodeMemoryInfo>& _return,
     nodeInfo.max_num_pages = memInfo.maxNumPages;
     nodeInfo.num_pages_allocated = memInfo.numPageAllocated;
     nodeInfo.is_allocation_capped = memInfo.isAllocationCapped;
+    // The join hash tables built on CPU live outside of the buffer pool.
+    if (mem_level == Data_Namespace::MemoryLevel::CPU_LEVEL) {
+      nodeInfo.join_hash_table_cache_bytes = JoinHashTable::getCacheSizeBytes() +
+                                             BaselineJoinHashTable::getCacheSizeBytes();
+    }
     for (auto gpu : memInfo.nodeMemoryData) {
       TMemoryData md;
       md.slab = gpu.slabNum;
@@ -4347,6 +4381,30 @@ void MapDHandler::set_execution_mode_nolock(Catalog_Namespace::SessionInfo* sess
   }
 }
 
+namespace {
+
+// Copies the executor side of the query profile. Calcite and serialization times are
+// measured by the handler.
+void query_profile_to_thrift(TQueryProfile& profile, const QueryProfile& query_profile) {
+  profile.compilation_time_us = query_profile.compilation_us;
+  profile.code_cache_hits = query_profile.code_cache_hits;
+  profile.code_cache_misses = query_profile.code_cache_misses;
+  profile.fetch_time_us = query_profile.fetch_us;
+  profile.cpu_fetch_bytes = query_profile.cpu_fetch_bytes;
+  profile.cpu_fetch_bytes_from_disk = query_profile.cpu_fetch_bytes_from_parent;
+  profile.gpu_fetch_bytes = query_profile.gpu_fetch_bytes;
+  profile.gpu_fetch_bytes_from_host = query_profile.gpu_fetch_bytes_from_parent;
+  profile.fragments_scanned = query_profile.fragments_scanned;
+  profile.fragments_skipped = query_profile.fragments_skipped;
+  profile.rows_scanned = query_profile.rows_scanned;
+  profile.kernel_time_us = query_profile.kernel_us;
+  profile.kernel_times_us = query_profile.kernel_times_us;
+  profile.reduction_time_us = query_profile.reduction_us;
+  profile.peak_memory_bytes = query_profile.peak_memory_bytes;
+}
+
+}  // namespace
+
 std::vector<PushedDownFilterInfo> MapDHandler::execute_rel_alg(
     TQueryResult& _return,
     QueryStateProxy query_state_proxy,
@@ -4387,6 +4445,7 @@ std::vector<PushedDownFilterInfo> MapDHandler::execute_rel_alg(
                                         mapd_parameters_,
                                         nullptr);
   RelAlgExecutor ra_executor(executor.get(), cat);
+  ra_executor.setQueryMemoryBudget(query_state_proxy.getQueryState().get_memory_budget());
   ExecutionResult result{std::make_shared<ResultSet>(std::vector<TargetInfo>{},
                                                      ExecutorDeviceType::CPU,
                                                      QueryMemoryDescriptor(),
@@ -4397,6 +4456,7 @@ std::vector<PushedDownFilterInfo> MapDHandler::execute_rel_alg(
       [&]() { result = ra_executor.executeRelAlgQuery(query_ra, co, eo, nullptr); });
   // reduce execution time by the time spent during queue waiting
   _return.execution_time_ms -= result.getRows()->getQueueTime();
+  query_profile_to_thrift(_return.profile, ra_executor.getQueryProfile());
   const auto& filter_push_down_info = result.getPushedDownFilterInfo();
   if (!filter_push_down_info.empty()) {
     return filter_push_down_info;
@@ -4404,13 +4464,16 @@ std::vector<PushedDownFilterInfo> MapDHandler::execute_rel_alg(
   if (just_explain) {
     convert_explain(_return, *result.getRows(), column_format);
   } else if (!just_calcite_explain) {
-    convert_rows(_return,
-                 timer.createQueryStateProxy(),
-                 result.getTargetsMeta(),
-                 *result.getRows(),
-                 column_format,
-                 first_n,
-                 at_most_n);
+    _return.profile.serialization_time_us =
+        measure<std::chrono::microseconds>::execution([&]() {
+          convert_rows(_return,
+                       timer.createQueryStateProxy(),
+                       result.getTargetsMeta(),
+                       *result.getRows(),
+                       column_format,
+                       first_n,
+                       at_most_n);
+        });
   }
   return {};
 }
@@ -4785,10 +4848,12 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
     OptionalTableMap tableNames(table_map);
     if (pw.isCalcitePathPermissable(read_only_)) {
       std::string query_ra;
-      _return.execution_time_ms += measure<>::execution([&]() {
-        query_ra =
-            parse_to_ra(query_state_proxy, query_str, {}, tableNames, mapd_parameters_);
-      });
+      _return.profile.calcite_time_us =
+          measure<std::chrono::microseconds>::execution([&]() {
+            query_ra = parse_to_ra(
+                query_state_proxy, query_str, {}, tableNames, mapd_parameters_);
+          });
+      _return.execution_time_ms += _return.profile.calcite_time_us / 1000;
 
       std::string query_ra_calcite_explain;
       if (pw.isCalciteExplain() && (!g_enable_filter_push_down || g_cluster)) {
@@ -5055,6 +5120,12 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
       table_locks.back().write_lock = TableLockMgr::getWriteLockForTable(
           session_ptr->getCatalog(), *truncate_stmt->get_table());
     }
+    auto analyze_stmt = dynamic_cast<Parser::AnalyzeTableStmt*>(ddl);
+    if (analyze_stmt) {
+      table_locks.emplace_back();
+      table_locks.back().read_lock = TableLockMgr::getReadLockForTable(
+          session_ptr->getCatalog(), *analyze_stmt->get_table());
+    }
     auto add_col_stmt = dynamic_cast<Parser::AddColumnStmt*>(ddl);
     if (add_col_stmt) {
       add_col_stmt->check_executable(*session_ptr);
@@ -5159,13 +5230,15 @@ void MapDHandler::execute_rel_alg_with_filter_push_down(
     filter_push_down_info.push_back(filter_push_down_info_for_request);
   }
   // deriving the new relational algebra plan with respect to the pushed down filters
-  _return.execution_time_ms += measure<>::execution([&]() {
+  const auto calcite_time_us = measure<std::chrono::microseconds>::execution([&]() {
     query_ra = parse_to_ra(query_state_proxy,
                            query_state_proxy.getQueryState().get_query_str(),
                            filter_push_down_info,
                            boost::none,
                            mapd_parameters_);
   });
+  _return.profile.calcite_time_us += calcite_time_us;
+  _return.execution_time_ms += calcite_time_us / 1000;
 
   if (just_calcite_explain) {
     // return the new ra as the result
@@ -5543,6 +5616,9 @@ void MapDHandler::get_license_claims(TLicenseInfo& _return,
 }
 
 void MapDHandler::shutdown() {
+  if (hot_chunks_recorder_) {
+    hot_chunks_recorder_->stop();
+  }
   emergency_shutdown();
 
   if (render_handler_) {
@@ -5556,6 +5632,46 @@ void MapDHandler::emergency_shutdown() {
   }
 }
 
+size_t MapDHandler::preload_hot_chunk(HotChunkCatalogs& catalogs,
+                                      const ChunkKey& key,
+                                      const std::function<size_t()>& preload) {
+  std::shared_ptr<Catalog> cat;
+  {
+    std::lock_guard<std::mutex> catalogs_lock(catalogs.mutex);
+    const int db_id = key[0];
+    auto catalog_it = catalogs.catalogs.find(db_id);
+    if (catalog_it == catalogs.catalogs.end()) {
+      // catalogs are opened under the sessions lock, like the connect calls do
+      mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
+      Catalog_Namespace::DBMetadata db;
+      if (SysCatalog::instance().getMetadataForDBById(db_id, db)) {
+        try {
+          cat = Catalog::get(
+              base_data_path_, db, data_mgr_, string_leaves_, calcite_, false);
+        } catch (const std::exception& e) {
+          LOG(WARNING) << "Hot chunks of database " << db.dbName
+                       << " not preloaded: " << e.what();
+        }
+      }
+      catalog_it = catalogs.catalogs.emplace(db_id, cat).first;
+    }
+    cat = catalog_it->second;
+  }
+  if (!cat) {
+    return 0;
+  }
+  const int table_id = key[1];
+  // holding the table read lock keeps the table from being dropped or truncated
+  // while its chunk is loaded, the records may be stale so check it still exists
+  const auto read_lock = TableLockMgr::getReadLockForTable(
+      ChunkKey{key[0], cat->getLogicalTableId(table_id)});
+  const auto td = cat->getMetadataForTableImpl(table_id, false);
+  if (!td || td->isView || !cat->getMetadataForColumn(table_id, key[2])) {
+    return 0;
+  }
+  return preload();
+}
+
 extern std::map<std::string, std::string> get_device_parameters();
 
 void MapDHandler::get_device_parameters(std::map<std::string, std::string>& _return) {
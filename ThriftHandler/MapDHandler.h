@@ -41,6 +41,7 @@
 
 #include "Calcite/Calcite.h"
 #include "Catalog/Catalog.h"
+#include "DataMgr/HotChunks.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "Import/Importer.h"
 #include "LockMgr/LockMgr.h"
@@ -60,6 +61,7 @@
 #include "Shared/GenericTypeUtilities.h"
 #include "Shared/Logger.h"
 #include "Shared/MapDParameters.h"
+#include "ThriftHandler/QueryAdmissionController.h"
 #include "Shared/StringTransform.h"
 #include "Shared/geosupport.h"
 #include "Shared/mapd_shared_mutex.h"
@@ -462,6 +464,7 @@ class MapDHandler : public MapDIf {
   std::unique_ptr<MapDLeafHandler> leaf_handler_;
   std::shared_ptr<Calcite> calcite_;
   const bool legacy_syntax_;
+  QueryAdmissionController query_admission_controller_;
 
   template <typename... ARGS>
   std::shared_ptr<query_state::QueryState> create_query_state(ARGS&&... args) {
@@ -673,6 +676,16 @@ class MapDHandler : public MapDIf {
       const std::vector<std::string>& table_names,
       const TSessionId& session);
 
+  // The catalogs of the databases of the hot chunks, opened once for the preload
+  struct HotChunkCatalogs {
+    std::mutex mutex;
+    std::map<int, std::shared_ptr<Catalog_Namespace::Catalog>> catalogs;
+  };
+  // The PreloadGuard of the hot chunks recorder
+  size_t preload_hot_chunk(HotChunkCatalogs& catalogs,
+                           const ChunkKey& key,
+                           const std::function<size_t()>& preload);
+
   query_state::QueryStates query_states_;
   SessionMap sessions_;
 
@@ -694,6 +707,8 @@ class MapDHandler : public MapDIf {
   mutable std::mutex handle_to_dev_ptr_mutex_;
   mutable std::unordered_map<std::string, int8_t*> ipc_handle_to_dev_ptr_;
 
+  std::unique_ptr<Data_Namespace::HotChunksRecorder> hot_chunks_recorder_;
+
   friend void run_warmup_queries(mapd::shared_ptr<MapDHandler> handler,
                                  std::string base_path,
                                  std::string query_file_path);
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef THRIFTHANDLER_QUERYADMISSIONCONTROLLER_H
+#define THRIFTHANDLER_QUERYADMISSIONCONTROLLER_H
+
+#include "Shared/QueryMemoryBudget.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Keeps the memory held by the running queries under a watermark. A query is admitted
+// when the memory committed to the running queries plus its own budget fits under the
+// watermark, otherwise it waits for the running queries to release memory. A running
+// query commits the larger of its budget and the memory it actually holds, so queries
+// without a budget are admitted on their actual usage. A query is always admitted when
+// nothing else runs, and a zero watermark admits all queries.
+class QueryAdmissionController {
+ public:
+  class Admission : boost::noncopyable {
+   public:
+    ~Admission() { controller_.release(query_it_); }
+
+    QueryMemoryBudget& getBudget() const { return *query_it_->budget; }
+    std::shared_ptr<QueryMemoryBudget> getBudgetPtr() const { return query_it_->budget; }
+
+    // Time spent queued before the query was admitted.
+    int64_t getWaitTimeMs() const { return wait_time_ms_; }
+
+   private:
+    struct RunningQuery {
+      std::string session_id;
+      std::shared_ptr<QueryMemoryBudget> budget;
+    };
+    using RunningQueryList = std::list<RunningQuery>;
+
+    Admission(QueryAdmissionController& controller,
+              const RunningQueryList::iterator query_it,
+              const int64_t wait_time_ms)
+        : controller_(controller), query_it_(query_it), wait_time_ms_(wait_time_ms) {}
+
+    QueryAdmissionController& controller_;
+    const RunningQueryList::iterator query_it_;
+    const int64_t wait_time_ms_;
+
+    friend class QueryAdmissionController;
+  };
+
+  explicit QueryAdmissionController(const size_t watermark_bytes)
+      : watermark_bytes_(watermark_bytes), queued_query_count_(0) {}
+
+  // Blocks until the query fits under the watermark. The returned admission holds the
+  // query's memory budget and must live until the query is done with its memory.
+  std::unique_ptr<Admission> admit(const std::string& session_id,
+                                   const size_t budget_bytes) {
+    const auto clock_begin = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!fitsUnderWatermark(budget_bytes)) {
+      ++queued_query_count_;
+      // charges don't notify, recheck the usage of the running queries periodically
+      while (!fitsUnderWatermark(budget_bytes)) {
+        cv_.wait_for(lock, kRecheckInterval);
+      }
+      --queued_query_count_;
+    }
+    running_queries_.push_back(
+        {session_id, std::make_shared<QueryMemoryBudget>(budget_bytes)});
+    const auto wait_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::steady_clock::now() - clock_begin)
+                                  .count();
+    return std::unique_ptr<Admission>(
+        new Admission(*this, std::prev(running_queries_.end()), wait_time_ms));
+  }
+
+  // Memory held by the running queries of the given session.
+  size_t getSessionUsedBytes(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t used_bytes{0};
+    for (const auto& running_query : running_queries_) {
+      if (running_query.session_id == session_id) {
+        used_bytes += running_query.budget->getUsedBytes();
+      }
+    }
+    return used_bytes;
+  }
+
+  // Memory held by all the running queries.
+  size_t getUsedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t used_bytes{0};
+    for (const auto& running_query : running_queries_) {
+      used_bytes += running_query.budget->getUsedBytes();
+    }
+    return used_bytes;
+  }
+
+  size_t getRunningQueryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_queries_.size();
+  }
+
+  size_t getQueuedQueryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_query_count_;
+  }
+
+ private:
+  static constexpr std::chrono::milliseconds kRecheckInterval{50};
+
+  bool fitsUnderWatermark(const size_t budget_bytes) const {
+    if (!watermark_bytes_ || running_queries_.empty()) {
+      return true;
+    }
+    size_t committed_bytes{0};
+    for (const auto& running_query : running_queries_) {
+      const auto& budget = *running_query.budget;
+      committed_bytes += std::max(budget.getMaxBytes(), budget.getUsedBytes());
+    }
+    return committed_bytes + budget_bytes <= watermark_bytes_;
+  }
+
+  void release(const Admission::RunningQueryList::iterator query_it) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_queries_.erase(query_it);
+    }
+    cv_.notify_all();
+  }
+
+  const size_t watermark_bytes_;
+  Admission::RunningQueryList running_queries_;
+  size_t queued_query_count_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+#endif  // THRIFTHANDLER_QUERYADMISSIONCONTROLLER_H
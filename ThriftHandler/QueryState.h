@@ -24,6 +24,7 @@
 #define OMNISCI_THRIFTHANDLER_QUERYSTATE_H
 
 #include "Shared/Logger.h"
+#include "Shared/QueryMemoryBudget.h"
 #include "Shared/StringTransform.h"
 #include "gen-cpp/mapd_types.h"
 
@@ -127,6 +128,7 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   Events events_;
   mutable std::mutex events_mutex_;
   std::atomic<bool> logged_;
+  std::shared_ptr<QueryMemoryBudget> memory_budget_;
   void logCallStack(std::stringstream&, unsigned const depth, Events::iterator parent);
 
   // Only shared_ptr instances are allowed due to call to shared_from_this().
@@ -154,6 +156,13 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   inline bool is_logged() const { return logged_.load(); }
   void logCallStack(std::stringstream&);
   inline void set_logged(bool logged) { logged_.store(logged); }
+  // Budget charged by the query's memory, set when the query is admitted.
+  inline std::shared_ptr<QueryMemoryBudget> get_memory_budget() const {
+    return memory_budget_;
+  }
+  inline void set_memory_budget(std::shared_ptr<QueryMemoryBudget> memory_budget) {
+    memory_budget_ = std::move(memory_budget);
+  }
   friend class QueryStates;
 };
 
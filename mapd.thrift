@@ -122,11 +122,36 @@ struct TRowSet {
   4: bool is_columnar
 }
 
+# Execution profile of a query. Fetch and kernel times are summed over all kernels,
+# kernel_times_us holds the time of each kernel. Fetch bytes count the chunks used at
+# each memory level and the part of them which wasn't resident there yet.
+# peak_memory_bytes is the high-water mark of the host memory held by the query.
+struct TQueryProfile {
+  1: i64 calcite_time_us
+  2: i64 compilation_time_us
+  3: i64 code_cache_hits
+  4: i64 code_cache_misses
+  5: i64 fetch_time_us
+  6: i64 cpu_fetch_bytes
+  7: i64 cpu_fetch_bytes_from_disk
+  8: i64 gpu_fetch_bytes
+  9: i64 gpu_fetch_bytes_from_host
+  10: i64 fragments_scanned
+  11: i64 fragments_skipped
+  12: i64 rows_scanned
+  13: i64 kernel_time_us
+  14: list<i64> kernel_times_us
+  15: i64 reduction_time_us
+  16: i64 serialization_time_us
+  17: i64 peak_memory_bytes
+}
+
 struct TQueryResult {
   1: TRowSet row_set
   2: i64 execution_time_ms
   3: i64 total_time_ms
   4: string nonce
+  5: TQueryProfile profile
 }
 
 struct TDataFrame {
@@ -277,6 +302,7 @@ struct TNodeMemoryInfo {
   4: i64 num_pages_allocated
   5: bool is_allocation_capped
   6: list<TMemoryData> node_memory_data
+  7: i64 join_hash_table_cache_bytes
 }
 
 struct TTableMeta {
@@ -475,6 +501,7 @@ struct TSessionInfo {
   2: string database;
   3: i64 start_time;
   4: bool is_super;
+  5: i64 query_memory_used_bytes;
 }
 
 struct TGeoFileLayerInfo {